@@ -409,13 +409,10 @@ error_status can_txbuf_write(can_type* can_x, can_txbuf_select_type txbuf_type,
   can_x->tbfmt_bit.fdf = can_txbuf_struct->fd_format;
 #endif
   
-  /* write tx payload to the buffer ram. */
+  /* write tx payload to the buffer ram, one word load per access. */
   for (byte_cnt = 0; byte_cnt < len; byte_cnt += 4U)
   {
-    *wp++ = (((uint32_t)rp[byte_cnt + 3U] << 24U) |
-             ((uint32_t)rp[byte_cnt + 2U] << 16U) |
-             ((uint32_t)rp[byte_cnt + 1U] << 8U)  |
-              (uint32_t)rp[byte_cnt]);
+    *wp++ = __UNALIGNED_UINT32_READ(&rp[byte_cnt]);
   }
   
   can_x->tbtyp = 0;
@@ -446,9 +443,9 @@ error_status can_rxbuf_read(can_type* can_x, can_rxbuf_type* can_rxbuf_struct)
 #ifdef SUPPORT_CAN_FD
   uint8_t len = dlc_to_bytes[can_x->rbfmt_bit.dlc];
 #else
-  uint8_t len = can_x->rbfmt_bit.dlc;
+  uint8_t len = (can_x->rbfmt_bit.dlc > 8) ? 8 : can_x->rbfmt_bit.dlc;
 #endif
-  uint32_t* rp = (uint32_t*)can_x->rbdat;
+  __IO uint32_t* rp = can_x->rbdat;
   uint8_t* wp = can_rxbuf_struct->data;
   uint8_t byte_cnt;
   uint16_t pos;
@@ -485,14 +482,11 @@ error_status can_rxbuf_read(can_type* can_x, can_rxbuf_type* can_rxbuf_struct)
   can_rxbuf_struct->recv_frame = (can_recv_frame_type)can_x->rbfmt_bit.lbf;
   can_rxbuf_struct->data_length = (can_data_length_type)can_x->rbfmt_bit.dlc;
   
-  /* read the buffer ram to rx payload */
+  /* read the buffer ram to rx payload, one word per access, the data field
+     of the structure is not guaranteed to be word aligned. */
   for (byte_cnt = 0; byte_cnt < len; byte_cnt += 4U)
   {
-    wp[byte_cnt] = *rp & 0xFF;
-    wp[byte_cnt+1U] = (*rp >> 8U) & 0xFF;
-    wp[byte_cnt+2U] = (*rp >> 16U) & 0xFF;
-    wp[byte_cnt+3U] = (*rp >> 24U) & 0xFF;
-    rp++;
+    __UNALIGNED_UINT32_WRITE(&wp[byte_cnt], *rp++);
   }
   
   can_x->llcformat = can_x->rbfmt;
@@ -1234,13 +1228,10 @@ error_status can_ttcan_txbuf_write(can_type* can_x,  can_ttcan_txbuf_type txbuf_
   can_x->tbfmt_bit.fdf = can_txbuf_struct->fd_format;
 #endif
   
-  /* Write Tx payload to the message RAM */
+  /* Write Tx payload to the message RAM, one word load per access */
   for (byte_cnt = 0; byte_cnt < len; byte_cnt += 4U)
   {
-    *wp++ = (((uint32_t)rp[byte_cnt + 3U] << 24U) |
-             ((uint32_t)rp[byte_cnt + 2U] << 16U) |
-             ((uint32_t)rp[byte_cnt + 1U] << 8U)  |
-              (uint32_t)rp[byte_cnt]);
+    *wp++ = __UNALIGNED_UINT32_READ(&rp[byte_cnt]);
   }
   
   can_x->tbtyp = 0;
@@ -0,0 +1,694 @@
+/**
+  **************************************************************************
+  * @file     adc_stream_application.c
+  * @brief    adc streaming acquisition application libray source file
+  **************************************************************************
+  *
+  * Copyright (c) 2025, Artery Technology, All rights reserved.
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+#include "adc_stream_application.h"
+
+/** @addtogroup AT32F422_426_middlewares_adc_stream_application_library
+  * @{
+  */
+
+
+/**
+  * @brief  initializes peripherals used by the stream: clocks, gpio, the adc
+  *         ordinary sequence with its timer trigger, repeat mode off, and the
+  *         calibration, the trigger timer with its trgout and the adc and dma
+  *         interrupts. hstream->tmrx may be set here.
+  * @param  hstream: the handle points to the stream information.
+  * @retval none
+  */
+__WEAK void adc_stream_lowlevel_init(adc_stream_handle_type* hstream)
+{
+
+}
+
+/**
+  * @brief  free running tick of the block timestamps, the default is the dwt
+  *         cycle counter started by adc_stream_init().
+  * @param  none
+  * @retval tick value.
+  */
+__WEAK uint32_t adc_stream_tick_get(void)
+{
+  return DWT->CYCCNT;
+}
+
+/**
+  * @brief  give a complete block to the callback. the dma is in the other block
+  *         unless the interrupt came too late.
+  * @param  hstream: the handle points to the stream information.
+  * @param  half: 0 for the first block, 1 for the second.
+  * @retval none
+  */
+static void adc_stream_block_done(adc_stream_handle_type* hstream, uint8_t half)
+{
+  uint32_t timestamp = adc_stream_tick_get();
+  uint16_t pos = hstream->block_size * 2 - (uint16_t)hstream->dma.channel->dtcnt;
+
+  if((pos >= hstream->block_size) != (half == 0))
+  {
+    hstream->overrun_count++;
+  }
+
+  if(hstream->callback != 0)
+  {
+    hstream->callback(hstream, hstream->buf + half * hstream->block_size, hstream->block_size, timestamp);
+  }
+  hstream->block_count++;
+
+  if(hstream->monitor != 0)
+  {
+    adc_stream_monitor_check(hstream->monitor, hstream->buf + half * hstream->block_size, hstream->block_size);
+    adc_stream_monitor_next(hstream->monitor);
+  }
+}
+
+/**
+  * @brief  dma half transfer, the first block is complete.
+  * @param  hdma: the dma handle, first member of the stream handle.
+  * @param  desc: the loop mode descriptor.
+  * @retval none
+  */
+static void adc_stream_half_callback(dma_handle_type* hdma, dma_desc_type* desc)
+{
+  adc_stream_block_done((adc_stream_handle_type *)hdma, 0);
+}
+
+/**
+  * @brief  dma full transfer, the second block is complete.
+  * @param  hdma: the dma handle, first member of the stream handle.
+  * @param  desc: the loop mode descriptor.
+  * @retval none
+  */
+static void adc_stream_full_callback(dma_handle_type* hdma, dma_desc_type* desc)
+{
+  adc_stream_block_done((adc_stream_handle_type *)hdma, 1);
+}
+
+/**
+  * @brief  stream initialization, calls adc_stream_lowlevel_init() then sets up
+  *         the dma in loop mode over two blocks of depth ordinary sequences.
+  * @note   the interrupt of hstream->dma.channel_index should call
+  *         dma_irq_handler(&hstream->dma), the adc interrupt should call
+  *         adc_stream_irq_handler(hstream).
+  * @param  hstream: the handle points to the stream information, adcx,
+  *         callback and monitor set by the caller.
+  * @param  buf: two blocks, 2 * depth * sequence length samples.
+  * @param  depth: ordinary sequences in one block.
+  * @retval adc stream status.
+  */
+adc_stream_status_type adc_stream_init(adc_stream_handle_type* hstream, uint16_t* buf, uint16_t depth)
+{
+  dma_init_type dma_init_struct;
+
+  if((buf == 0) || (depth == 0) || (hstream->adcx != ADC1))
+  {
+    return ADC_STREAM_ERR_PARAM;
+  }
+
+  adc_stream_lowlevel_init(hstream);
+
+  hstream->sequence_length = hstream->adcx->osq1_bit.oclen + 1;
+  if(((uint32_t)depth * hstream->sequence_length * 2) > 0xFFFF)
+  {
+    return ADC_STREAM_ERR_PARAM;
+  }
+
+  hstream->buf = buf;
+  hstream->block_size = depth * hstream->sequence_length;
+  hstream->block_count = 0;
+  hstream->overrun_count = 0;
+  hstream->fail_count = 0;
+
+  /* start the dwt cycle counter of the default timestamp */
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+  if(dma_channel_alloc(&hstream->dma, DMA_REQ_ADC) != DMA_APP_OK)
+  {
+    return ADC_STREAM_ERR_BUSY;
+  }
+  hstream->dma.half_callback = adc_stream_half_callback;
+  hstream->dma.full_callback = adc_stream_full_callback;
+  hstream->dma.error_callback = 0;
+
+  dma_default_para_init(&dma_init_struct);
+  dma_init_struct.buffer_size = hstream->block_size * 2;
+  dma_init_struct.direction = DMA_DIR_PERIPHERAL_TO_MEMORY;
+  dma_init_struct.memory_base_addr = (uint32_t)buf;
+  dma_init_struct.memory_data_width = DMA_MEMORY_DATA_WIDTH_HALFWORD;
+  dma_init_struct.memory_inc_enable = TRUE;
+  dma_init_struct.peripheral_base_addr = (uint32_t)&hstream->adcx->odt;
+  dma_init_struct.peripheral_data_width = DMA_PERIPHERAL_DATA_WIDTH_HALFWORD;
+  dma_init_struct.peripheral_inc_enable = FALSE;
+  dma_init_struct.priority = DMA_PRIORITY_HIGH;
+  dma_init_struct.loop_mode_enable = TRUE;
+  dma_desc_build(&hstream->desc, &dma_init_struct);
+
+  /* a lost sample shifts the channels, restart on overflow or trigger fail */
+  adc_convert_fail_auto_abort_enable(hstream->adcx, TRUE);
+  adc_interrupt_enable(hstream->adcx, ADC_OCCO_INT | ADC_TCF_INT, TRUE);
+
+  return ADC_STREAM_OK;
+}
+
+/**
+  * @brief  stop the stream and give the dma channel back.
+  * @param  hstream: the handle points to the stream information.
+  * @retval none
+  */
+void adc_stream_deinit(adc_stream_handle_type* hstream)
+{
+  adc_stream_stop(hstream);
+  adc_interrupt_enable(hstream->adcx, ADC_OCCO_INT | ADC_TCF_INT, FALSE);
+  dma_channel_free(&hstream->dma);
+}
+
+/**
+  * @brief  start the dma, then the trigger timer when hstream->tmrx is set.
+  * @param  hstream: the handle points to the stream information.
+  * @retval none
+  */
+void adc_stream_start(adc_stream_handle_type* hstream)
+{
+  dma_chain_start(&hstream->dma, &hstream->desc);
+  adc_dma_mode_enable(hstream->adcx, TRUE);
+
+  if(hstream->tmrx != 0)
+  {
+    tmr_counter_enable(hstream->tmrx, TRUE);
+  }
+}
+
+/**
+  * @brief  stop the trigger timer when hstream->tmrx is set, then the dma.
+  * @param  hstream: the handle points to the stream information.
+  * @retval none
+  */
+void adc_stream_stop(adc_stream_handle_type* hstream)
+{
+  if(hstream->tmrx != 0)
+  {
+    tmr_counter_enable(hstream->tmrx, FALSE);
+  }
+
+  adc_dma_mode_enable(hstream->adcx, FALSE);
+  dma_chain_stop(&hstream->dma);
+}
+
+/**
+  * @brief  adc interrupt handler, an overflow or a trigger conversion fail
+  *         restarts the dma at the first block so that the samples stay in
+  *         sequence order. the block being filled is lost.
+  * @param  hstream: the handle points to the stream information.
+  * @retval none
+  */
+void adc_stream_irq_handler(adc_stream_handle_type* hstream)
+{
+  confirm_state fail = FALSE;
+
+  if(hstream->monitor != 0)
+  {
+    adc_stream_monitor_irq_handler(hstream->monitor);
+  }
+
+  if(adc_interrupt_flag_get(hstream->adcx, ADC_TCF_FLAG) != RESET)
+  {
+    adc_flag_clear(hstream->adcx, ADC_TCF_FLAG);
+    fail = TRUE;
+  }
+  if(adc_interrupt_flag_get(hstream->adcx, ADC_OCCO_FLAG) != RESET)
+  {
+    adc_flag_clear(hstream->adcx, ADC_OCCO_FLAG);
+    fail = TRUE;
+  }
+
+  if(fail)
+  {
+    hstream->fail_count++;
+
+    adc_enable(hstream->adcx, FALSE);
+    dma_chain_stop(&hstream->dma);
+    dma_chain_start(&hstream->dma, &hstream->desc);
+    adc_enable(hstream->adcx, TRUE);
+  }
+}
+
+/**
+  * @brief  oversample stage initialization.
+  * @param  hos: the oversample stage.
+  * @param  channels: channels of the ordinary sequence, 1 ~ 16.
+  * @param  ratio: sequences summed for one output, 1 ~ 4096.
+  * @param  shift: right shift of the sums, the result must fit 16 bits.
+  * @retval adc stream status.
+  */
+adc_stream_status_type adc_stream_oversample_init(adc_stream_oversample_type* hos, uint8_t channels, uint16_t ratio, uint8_t shift)
+{
+  uint8_t index;
+
+  if((channels == 0) || (channels > ADC_STREAM_OVERSAMPLE_CHANNELS) || (ratio == 0) || (ratio > 4096) || (shift > 31))
+  {
+    return ADC_STREAM_ERR_PARAM;
+  }
+
+  hos->channels = channels;
+  hos->ratio = ratio;
+  hos->shift = shift;
+  hos->count = 0;
+  hos->channel = 0;
+
+  for(index = 0; index < ADC_STREAM_OVERSAMPLE_CHANNELS; index++)
+  {
+    hos->sum[index] = 0;
+  }
+
+  return ADC_STREAM_OK;
+}
+
+/**
+  * @brief  oversample a block of samples, typically from the stream callback.
+  *         one or two channels of right aligned data in a word aligned block
+  *         are summed two samples at a time with the simd instructions, other
+  *         blocks one sample at a time with the same result.
+  * @param  hos: the oversample stage.
+  * @param  block: samples, channels interleaved in sequence order.
+  * @param  size: number of samples.
+  * @param  out: outputs, channels interleaved, room for size / ratio + channels.
+  * @retval number of outputs.
+  */
+uint16_t adc_stream_oversample_process(adc_stream_oversample_type* hos, const uint16_t* block, uint16_t size, uint16_t* out)
+{
+  const uint32_t *word = (const uint32_t *)block;
+  uint16_t number = 0;
+  uint16_t index;
+  uint32_t lanes;
+  uint8_t added;
+  uint8_t ch;
+
+  if((((uint32_t)block & 3) == 0) && ((size & 1) == 0) && (hos->channel == 0))
+  {
+    /* one channel, a word is two sequences, smlad adds both halves */
+    if((hos->channels == 1) && ((hos->ratio & 1) == 0) && ((hos->count & 1) == 0))
+    {
+      for(index = 0; index < size / 2; index++)
+      {
+        hos->sum[0] = __SMLAD(word[index], 0x00010001, hos->sum[0]);
+        hos->count += 2;
+
+        if(hos->count == hos->ratio)
+        {
+          out[number++] = (uint16_t)(hos->sum[0] >> hos->shift);
+          hos->sum[0] = 0;
+          hos->count = 0;
+        }
+      }
+
+      return number;
+    }
+
+    /* two channels, a word is one sequence, uadd16 sums each channel in its
+       half, 16 samples of 12 bits fit before the halves are moved out */
+    if(hos->channels == 2)
+    {
+      lanes = 0;
+      added = 0;
+
+      for(index = 0; index < size / 2; index++)
+      {
+        lanes = __UADD16(lanes, word[index]);
+        added++;
+        hos->count++;
+
+        if((added == 16) || (hos->count == hos->ratio))
+        {
+          hos->sum[0] += lanes & 0xFFFF;
+          hos->sum[1] += lanes >> 16;
+          lanes = 0;
+          added = 0;
+        }
+
+        if(hos->count == hos->ratio)
+        {
+          out[number++] = (uint16_t)(hos->sum[0] >> hos->shift);
+          out[number++] = (uint16_t)(hos->sum[1] >> hos->shift);
+          hos->sum[0] = 0;
+          hos->sum[1] = 0;
+          hos->count = 0;
+        }
+      }
+
+      hos->sum[0] += lanes & 0xFFFF;
+      hos->sum[1] += lanes >> 16;
+
+      return number;
+    }
+  }
+
+  for(index = 0; index < size; index++)
+  {
+    hos->sum[hos->channel] += block[index];
+
+    if(++hos->channel == hos->channels)
+    {
+      hos->channel = 0;
+
+      if(++hos->count == hos->ratio)
+      {
+        for(ch = 0; ch < hos->channels; ch++)
+        {
+          out[number++] = (uint16_t)(hos->sum[ch] >> hos->shift);
+          hos->sum[ch] = 0;
+        }
+        hos->count = 0;
+      }
+    }
+  }
+
+  return number;
+}
+
+/**
+  * @brief  rank of a channel in the ordinary sequence.
+  * @param  adcx: adc registers base address.
+  * @param  channel: adc channel.
+  * @retval first rank of the channel from 0, 0xFF when it is not converted.
+  */
+static uint8_t adc_stream_rank_get(adc_type* adcx, adc_channel_select_type channel)
+{
+  uint8_t length = adcx->osq1_bit.oclen + 1;
+  uint32_t osq;
+  uint8_t rank;
+
+  for(rank = 0; rank < length; rank++)
+  {
+    /* osq3 holds the ranks 1 ~ 6, osq2 7 ~ 12 and osq1 13 ~ 16 */
+    if(rank < 6)
+    {
+      osq = adcx->osq3;
+    }
+    else if(rank < 12)
+    {
+      osq = adcx->osq2;
+    }
+    else
+    {
+      osq = adcx->osq1;
+    }
+
+    if(((osq >> ((rank % 6) * 5)) & 0x1F) == (uint32_t)channel)
+    {
+      return rank;
+    }
+  }
+
+  return 0xFF;
+}
+
+/**
+  * @brief  level of a guarded channel after a sample.
+  * @param  guard: the guarded channel.
+  * @param  value: sample of the channel.
+  * @retval new level.
+  */
+static adc_stream_level_type adc_stream_level_get(adc_stream_guard_type* guard, uint16_t value)
+{
+  if(guard->level == ADC_STREAM_LEVEL_NORMAL)
+  {
+    if(value > guard->high)
+    {
+      return ADC_STREAM_LEVEL_HIGH;
+    }
+    if(value < guard->low)
+    {
+      return ADC_STREAM_LEVEL_LOW;
+    }
+  }
+  else if(guard->level == ADC_STREAM_LEVEL_HIGH)
+  {
+    if((value + guard->hysteresis) < guard->high)
+    {
+      return ADC_STREAM_LEVEL_NORMAL;
+    }
+  }
+  else if(value > (guard->low + guard->hysteresis))
+  {
+    return ADC_STREAM_LEVEL_NORMAL;
+  }
+
+  return guard->level;
+}
+
+/**
+  * @brief  program the voltage monitor for the current channel, the window of
+  *         a channel out of range is its way back.
+  * @param  hmon: the supervisor.
+  * @retval none
+  */
+static void adc_stream_monitor_program(adc_stream_monitor_type* hmon)
+{
+  adc_stream_guard_type *guard = &hmon->guard[hmon->current];
+  uint16_t high = guard->high;
+  uint16_t low = guard->low;
+
+  if(guard->level == ADC_STREAM_LEVEL_HIGH)
+  {
+    low = (guard->high > guard->hysteresis) ? (guard->high - guard->hysteresis) : 0;
+    high = 0xFFF;
+  }
+  else if(guard->level == ADC_STREAM_LEVEL_LOW)
+  {
+    high = ((guard->low + guard->hysteresis) < 0xFFF) ? (guard->low + guard->hysteresis) : 0xFFF;
+    low = 0;
+  }
+
+  /* no comparison against a half written window */
+  adc_voltage_monitor_enable(hmon->adcx, ADC_VMONITOR_NONE);
+  adc_voltage_monitor_single_channel_select(hmon->adcx, guard->channel);
+  adc_voltage_monitor_threshold_value_set(hmon->adcx, high, low);
+  adc_flag_clear(hmon->adcx, ADC_VMOR_FLAG);
+  adc_voltage_monitor_enable(hmon->adcx, ADC_VMONITOR_SINGLE_ORDINARY);
+}
+
+/**
+  * @brief  supervisor initialization, every channel starts at the normal level
+  *         and the voltage monitor guards the first one.
+  * @note   the data must be right aligned. the adc interrupt should call
+  *         adc_stream_monitor_irq_handler(hmon) and the complete blocks be
+  *         given to adc_stream_monitor_check(), the stream does both for a
+  *         supervisor set in hstream->monitor.
+  * @param  hmon: the supervisor.
+  * @param  adcx: adc registers base address.
+  * @param  guard: guarded channels, kept by the supervisor.
+  * @param  guard_num: number of guarded channels.
+  * @retval adc stream status.
+  */
+adc_stream_status_type adc_stream_monitor_init(adc_stream_monitor_type* hmon, adc_type* adcx, adc_stream_guard_type* guard, uint8_t guard_num)
+{
+  uint8_t index;
+
+  if((adcx != ADC1) || (guard == 0) || (guard_num == 0))
+  {
+    return ADC_STREAM_ERR_PARAM;
+  }
+
+  for(index = 0; index < guard_num; index++)
+  {
+    if((guard[index].high > 0xFFF) || (guard[index].low > guard[index].high))
+    {
+      return ADC_STREAM_ERR_PARAM;
+    }
+    guard[index].level = ADC_STREAM_LEVEL_NORMAL;
+  }
+
+  hmon->adcx = adcx;
+  hmon->guard = guard;
+  hmon->guard_num = guard_num;
+  hmon->current = 0;
+  hmon->pending = 0;
+  hmon->log_head = 0;
+  hmon->log_tail = 0;
+  hmon->dropped_count = 0;
+  hmon->excursion_count = 0;
+
+  /* start the dwt cycle counter of the default timestamp */
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+  adc_stream_monitor_program(hmon);
+  adc_interrupt_enable(adcx, ADC_VMOR_INT, TRUE);
+
+  return ADC_STREAM_OK;
+}
+
+/**
+  * @brief  stop the voltage monitor.
+  * @param  hmon: the supervisor.
+  * @retval none
+  */
+void adc_stream_monitor_deinit(adc_stream_monitor_type* hmon)
+{
+  adc_interrupt_enable(hmon->adcx, ADC_VMOR_INT, FALSE);
+  adc_voltage_monitor_enable(hmon->adcx, ADC_VMONITOR_NONE);
+  adc_flag_clear(hmon->adcx, ADC_VMOR_FLAG);
+}
+
+/**
+  * @brief  move the voltage monitor to the next guarded channel. a channel is
+  *         only compared while it is under the monitor, call this often enough
+  *         for the slowest reaction wanted, the stream does it every block.
+  * @param  hmon: the supervisor.
+  * @retval none
+  */
+void adc_stream_monitor_next(adc_stream_monitor_type* hmon)
+{
+  uint32_t primask;
+
+  if(hmon->guard_num < 2)
+  {
+    return;
+  }
+
+  primask = __get_PRIMASK();
+  __disable_irq();
+
+  /* a fired monitor stays on its channel until it is checked */
+  if(hmon->pending == 0)
+  {
+    hmon->current = (hmon->current + 1 < hmon->guard_num) ? (hmon->current + 1) : 0;
+    adc_stream_monitor_program(hmon);
+  }
+
+  __set_PRIMASK(primask);
+}
+
+/**
+  * @brief  voltage monitor interrupt. the data register may already hold a
+  *         sample of the next channel of the sequence, so the level is not
+  *         taken here: the monitor is stopped and the guarded channel is left
+  *         for adc_stream_monitor_check() on the next complete block.
+  * @param  hmon: the supervisor.
+  * @retval none
+  */
+void adc_stream_monitor_irq_handler(adc_stream_monitor_type* hmon)
+{
+  if(adc_interrupt_flag_get(hmon->adcx, ADC_VMOR_FLAG) == RESET)
+  {
+    return;
+  }
+
+  adc_voltage_monitor_enable(hmon->adcx, ADC_VMONITOR_NONE);
+  adc_flag_clear(hmon->adcx, ADC_VMOR_FLAG);
+
+  if(hmon->pending == 0)
+  {
+    hmon->pending = 1;
+    hmon->pending_tick = adc_stream_tick_get();
+  }
+}
+
+/**
+  * @brief  after the voltage monitor fired, run the samples of the guarded
+  *         channel in a complete block through its levels, log every change
+  *         with the tick of the interrupt and program the monitor again. an
+  *         excursion that ended within the block of the interrupt is only
+  *         seen when that block is the one checked. the stream calls it on
+  *         every block, it returns at once when the monitor has not fired.
+  * @param  hmon: the supervisor.
+  * @param  block: samples, ordinary sequences from the first rank.
+  * @param  size: number of samples.
+  * @retval none
+  */
+void adc_stream_monitor_check(adc_stream_monitor_type* hmon, const uint16_t* block, uint16_t size)
+{
+  adc_stream_guard_type *guard;
+  adc_stream_excursion_type *excursion;
+  adc_stream_level_type level;
+  uint32_t primask;
+  uint16_t index;
+  uint8_t length;
+  uint8_t rank;
+
+  if(hmon->pending == 0)
+  {
+    return;
+  }
+
+  guard = &hmon->guard[hmon->current];
+  length = hmon->adcx->osq1_bit.oclen + 1;
+  rank = adc_stream_rank_get(hmon->adcx, guard->channel);
+
+  for(index = rank; (rank != 0xFF) && (index < size); index += length)
+  {
+    level = adc_stream_level_get(guard, block[index]);
+    if(level == guard->level)
+    {
+      continue;
+    }
+
+    guard->level = level;
+    hmon->excursion_count++;
+
+    if((hmon->log_head - hmon->log_tail) >= ADC_STREAM_MONITOR_LOG_NUM)
+    {
+      hmon->dropped_count++;
+      continue;
+    }
+
+    excursion = &hmon->log[hmon->log_head & (ADC_STREAM_MONITOR_LOG_NUM - 1)];
+    excursion->timestamp = hmon->pending_tick;
+    excursion->channel = guard->channel;
+    excursion->level = level;
+    excursion->value = block[index];
+    hmon->log_head++;
+  }
+
+  primask = __get_PRIMASK();
+  __disable_irq();
+  hmon->pending = 0;
+  adc_stream_monitor_program(hmon);
+  __set_PRIMASK(primask);
+}
+
+/**
+  * @brief  take the oldest excursion from the log.
+  * @param  hmon: the supervisor.
+  * @param  excursion: destination.
+  * @retval 1 if an excursion was read, 0 if the log is empty.
+  */
+uint8_t adc_stream_monitor_read(adc_stream_monitor_type* hmon, adc_stream_excursion_type* excursion)
+{
+  if(hmon->log_tail == hmon->log_head)
+  {
+    return 0;
+  }
+
+  *excursion = hmon->log[hmon->log_tail & (ADC_STREAM_MONITOR_LOG_NUM - 1)];
+  hmon->log_tail++;
+
+  return 1;
+}
+
+/**
+  * @}
+  */
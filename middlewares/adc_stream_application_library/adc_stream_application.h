@@ -0,0 +1,221 @@
+/**
+  **************************************************************************
+  * @file     adc_stream_application.h
+  * @brief    adc streaming acquisition application libray header file
+  **************************************************************************
+  *
+  * Copyright (c) 2025, Artery Technology, All rights reserved.
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+/*!< define to prevent recursive inclusion -------------------------------------*/
+#ifndef __ADC_STREAM_APPLICATION_H
+#define __ADC_STREAM_APPLICATION_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* includes ------------------------------------------------------------------*/
+#include "at32f422_426.h"
+#include "dma_application.h"
+
+/** @addtogroup AT32F422_426_middlewares_adc_stream_application_library
+  * @{
+  */
+
+
+/** @defgroup ADC_STREAM_library_definition
+  * @{
+  */
+
+#define ADC_STREAM_OVERSAMPLE_CHANNELS   16                       /*!< channels of an ordinary sequence */
+#define ADC_STREAM_MONITOR_LOG_NUM       16                       /*!< excursions kept in the log ring, power of 2 */
+
+/**
+  * @}
+  */
+
+/** @defgroup ADC_STREAM_library_status_code
+  * @{
+  */
+
+typedef enum
+{
+  ADC_STREAM_OK = 0,      /*!< no error */
+  ADC_STREAM_ERR_PARAM,   /*!< invalid parameter */
+  ADC_STREAM_ERR_BUSY,    /*!< no dma channel left */
+} adc_stream_status_type;
+
+/**
+  * @}
+  */
+
+/** @defgroup ADC_STREAM_library_monitor
+  * @{
+  */
+
+typedef enum
+{
+  ADC_STREAM_LEVEL_NORMAL = 0,  /*!< inside the thresholds */
+  ADC_STREAM_LEVEL_HIGH,        /*!< above the high threshold */
+  ADC_STREAM_LEVEL_LOW,         /*!< below the low threshold */
+} adc_stream_level_type;
+
+/**
+  * @brief  a channel guarded by the voltage monitor. a channel that went out of
+  *         range comes back when it is hysteresis inside the threshold again.
+  */
+typedef struct
+{
+  adc_channel_select_type                channel;                 /*!< adc channel                     */
+  uint16_t                               high;                    /*!< high threshold, 0x000 ~ 0xFFF   */
+  uint16_t                               low;                     /*!< low threshold, 0x000 ~ 0xFFF    */
+  uint16_t                               hysteresis;              /*!< return distance from the threshold */
+  __IO adc_stream_level_type             level;                   /*!< current level                   */
+} adc_stream_guard_type;
+
+/**
+  * @brief  excursion log entry, level is the level entered.
+  */
+typedef struct
+{
+  uint32_t                               timestamp;               /*!< adc_stream_tick_get() of the event */
+  adc_channel_select_type                channel;                 /*!< adc channel                     */
+  adc_stream_level_type                  level;                   /*!< level entered                   */
+  uint16_t                               value;                   /*!< sample that changed the level   */
+} adc_stream_excursion_type;
+
+/**
+  * @brief  supervisor moving the voltage monitor from one guarded channel to
+  *         the next, the hardware compares the samples and only a sample out
+  *         of the window interrupts. the level is then taken from the samples
+  *         of the channel in the next complete block.
+  */
+typedef struct
+{
+  adc_type                               *adcx;                   /*!< adc registers base address      */
+  adc_stream_guard_type                  *guard;                  /*!< guarded channels                */
+  uint8_t                                guard_num;               /*!< number of guarded channels      */
+  __IO uint8_t                           current;                 /*!< channel under the monitor       */
+  __IO uint8_t                           pending;                 /*!< monitor fired, current is checked on the next block */
+  uint32_t                               pending_tick;            /*!< adc_stream_tick_get() when the monitor fired */
+  adc_stream_excursion_type              log[ADC_STREAM_MONITOR_LOG_NUM]; /*!< excursion ring        */
+  __IO uint32_t                          log_head;                /*!< entries written                 */
+  uint32_t                               log_tail;                /*!< entries read                    */
+  __IO uint32_t                          dropped_count;           /*!< entries lost to a full ring     */
+  __IO uint32_t                          excursion_count;         /*!< level changes                   */
+} adc_stream_monitor_type;
+
+/**
+  * @}
+  */
+
+/** @defgroup ADC_STREAM_library_handle
+  * @{
+  */
+
+typedef struct adc_stream_handle_struct adc_stream_handle_type;
+
+/**
+  * @brief  block callback, called in the dma interrupt with a complete block
+  *         while the dma fills the other one. the block holds depth ordinary
+  *         sequences, one sample per channel in sequence order.
+  */
+typedef void (*adc_stream_callback_type)(adc_stream_handle_type* hstream, const uint16_t* block, uint16_t size, uint32_t timestamp);
+
+struct adc_stream_handle_struct
+{
+  dma_handle_type                        dma;                     /*!< adc dma, first member           */
+  dma_desc_type                          desc;                    /*!< loop mode register image        */
+  adc_type                               *adcx;                   /*!< adc registers base address      */
+  tmr_type                               *tmrx;                   /*!< trigger timer started with the stream, may be NULL */
+  uint16_t                               *buf;                    /*!< two blocks of samples           */
+  uint16_t                               block_size;              /*!< samples in one block            */
+  uint8_t                                sequence_length;         /*!< channels of the ordinary sequence */
+  adc_stream_callback_type               callback;                /*!< block callback                  */
+  adc_stream_monitor_type                *monitor;                /*!< supervisor moved on every block, may be NULL */
+  __IO uint32_t                          block_count;             /*!< blocks given to the callback    */
+  __IO uint32_t                          overrun_count;           /*!< blocks partly overwritten before the callback */
+  __IO uint32_t                          fail_count;              /*!< adc overflow or trigger fail restarts */
+};
+
+/**
+  * @}
+  */
+
+/** @defgroup ADC_STREAM_library_oversample
+  * @{
+  */
+
+/**
+  * @brief  oversample and decimate stage, every ratio sequences give one output
+  *         per channel, the sum of the samples shifted right by shift. a 12-bit
+  *         adc reaches 14 bits with ratio 16 and shift 2, 16 bits with ratio 256
+  *         and shift 4. partial sums are kept from one block to the next.
+  */
+typedef struct
+{
+  uint8_t                                channels;                /*!< channels of the sequence        */
+  uint8_t                                shift;                   /*!< right shift of the sums         */
+  uint16_t                               ratio;                   /*!< sequences summed for one output */
+  uint16_t                               count;                   /*!< sequences in the sums           */
+  uint8_t                                channel;                 /*!< next channel of a partial sequence */
+  uint32_t                               sum[ADC_STREAM_OVERSAMPLE_CHANNELS]; /*!< partial sums      */
+} adc_stream_oversample_type;
+
+/**
+  * @}
+  */
+
+/** @defgroup ADC_STREAM_library_exported_functions
+  * @{
+  */
+
+void                   adc_stream_lowlevel_init (adc_stream_handle_type* hstream);
+uint32_t               adc_stream_tick_get      (void);
+adc_stream_status_type adc_stream_init          (adc_stream_handle_type* hstream, uint16_t* buf, uint16_t depth);
+void                   adc_stream_deinit        (adc_stream_handle_type* hstream);
+void                   adc_stream_start         (adc_stream_handle_type* hstream);
+void                   adc_stream_stop          (adc_stream_handle_type* hstream);
+void                   adc_stream_irq_handler   (adc_stream_handle_type* hstream);
+
+adc_stream_status_type adc_stream_oversample_init   (adc_stream_oversample_type* hos, uint8_t channels, uint16_t ratio, uint8_t shift);
+uint16_t               adc_stream_oversample_process(adc_stream_oversample_type* hos, const uint16_t* block, uint16_t size, uint16_t* out);
+
+adc_stream_status_type adc_stream_monitor_init       (adc_stream_monitor_type* hmon, adc_type* adcx, adc_stream_guard_type* guard, uint8_t guard_num);
+void                   adc_stream_monitor_deinit     (adc_stream_monitor_type* hmon);
+void                   adc_stream_monitor_next       (adc_stream_monitor_type* hmon);
+void                   adc_stream_monitor_check      (adc_stream_monitor_type* hmon, const uint16_t* block, uint16_t size);
+void                   adc_stream_monitor_irq_handler(adc_stream_monitor_type* hmon);
+uint8_t                adc_stream_monitor_read       (adc_stream_monitor_type* hmon, adc_stream_excursion_type* excursion);
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,350 @@
+/**
+  **************************************************************************
+  * @file     bldc_application.c
+  * @brief    bldc six-step commutation application libray source file
+  **************************************************************************
+  *
+  * Copyright (c) 2025, Artery Technology, All rights reserved.
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+#include "bldc_application.h"
+
+/** @addtogroup AT32F422_426_middlewares_bldc_application_library
+  * @{
+  */
+
+
+/* phase driven by the pwm and phase tied low in each step, 0 ~ 2 for a ~ c */
+static const uint8_t bldc_step_phase[6][2] =
+{
+  {0, 1}, {0, 2}, {1, 2}, {1, 0}, {2, 0}, {2, 1}
+};
+
+/**
+  * @brief  initializes peripherals used by the kernel: clocks, gpio of the
+  *         outputs, hall sensors and brake input, the time bases of both
+  *         timers, the pwm channels 1 ~ 3 with their polarities and idle
+  *         states, and the pwm timer interrupt.
+  * @param  hbldc: the handle points to the motor information.
+  * @retval none
+  */
+__WEAK void bldc_lowlevel_init(bldc_handle_type* hbldc)
+{
+
+}
+
+/**
+  * @brief  build the output images of the six steps from the channel
+  *         configuration left by bldc_lowlevel_init().
+  * @param  hbldc: the handle points to the motor information.
+  * @retval none
+  */
+static void bldc_image_build(bldc_handle_type* hbldc)
+{
+  uint32_t mode[3];
+  uint32_t enable;
+  uint8_t step;
+  uint8_t phase;
+
+  for(step = 0; step < 6; step++)
+  {
+    enable = 0;
+    for(phase = 0; phase < 3; phase++)
+    {
+      mode[phase] = TMR_OUTPUT_CONTROL_FORCE_LOW;
+    }
+
+    /* driven phase, the complementary output follows with the dead time */
+    phase = bldc_step_phase[step][0];
+    mode[phase] = TMR_OUTPUT_CONTROL_PWM_MODE_A;
+    enable |= (hbldc->synchronous ? 0x5 : 0x1) << (phase * 4);
+
+    /* low phase, reference forced low, complementary output active */
+    phase = bldc_step_phase[step][1];
+    enable |= 0x5 << (phase * 4);
+
+    hbldc->image[step].cm1 = (hbldc->pwm_tmrx->cm1 & ~0x7070) | (mode[0] << 4) | (mode[1] << 12);
+    hbldc->image[step].cm2 = (hbldc->pwm_tmrx->cm2 & ~0x0070) | (mode[2] << 4);
+    hbldc->image[step].cctrl = (hbldc->pwm_tmrx->cctrl & ~0x0555) | enable;
+  }
+}
+
+/**
+  * @brief  step of a sector in the current direction.
+  * @param  hbldc: the handle points to the motor information.
+  * @param  sector: sector of the hall code, 0 ~ 5.
+  * @retval step 0 ~ 5.
+  */
+static uint8_t bldc_sector_step(bldc_handle_type* hbldc, uint8_t sector)
+{
+  return (hbldc->direction == BLDC_FORWARD) ? sector : ((sector + 3) % 6);
+}
+
+/**
+  * @brief  write a step image to the buffered channel control bits.
+  * @param  hbldc: the handle points to the motor information.
+  * @param  step: step 0 ~ 5.
+  * @retval none
+  */
+static void bldc_image_load(bldc_handle_type* hbldc, uint8_t step)
+{
+  tmr_type *tmrx = hbldc->pwm_tmrx;
+
+  tmrx->cm1 = hbldc->image[step].cm1;
+  tmrx->cm2 = hbldc->image[step].cm2;
+  tmrx->cctrl = hbldc->image[step].cctrl;
+}
+
+/**
+  * @brief  sector of the hall sensors.
+  * @param  hbldc: the handle points to the motor information.
+  * @retval sector 0 ~ 5, or BLDC_HALL_INVALID.
+  */
+static uint8_t bldc_hall_sector_get(bldc_handle_type* hbldc)
+{
+  uint16_t input = gpio_input_data_read(hbldc->hall_gpio);
+  uint8_t code = 0;
+
+  if(input & hbldc->hall_pin[0])
+  {
+    code |= 1;
+  }
+  if(input & hbldc->hall_pin[1])
+  {
+    code |= 2;
+  }
+  if(input & hbldc->hall_pin[2])
+  {
+    code |= 4;
+  }
+
+  return (hbldc->hall_table[code] < 6) ? hbldc->hall_table[code] : BLDC_HALL_INVALID;
+}
+
+/**
+  * @brief  kernel initialization, calls bldc_lowlevel_init() then connects the
+  *         hall timer to the commutation of the pwm timer and sets the dead
+  *         time and brake. the hall sensors are xored on channel 1 of the hall
+  *         timer, every edge captures the sector time and resets the counter,
+  *         channel 2 gives the trgout edge hall_delay counts later. that edge
+  *         moves the buffered channel control bits to the outputs without the
+  *         cpu, the hall interrupt then loads the image of the next step.
+  * @note   the pwm timer brake and hall interrupt should call
+  *         bldc_irq_handler(hbldc).
+  * @param  hbldc: the handle points to the motor information, every field up
+  *         to synchronous set by the caller.
+  * @retval bldc status.
+  */
+bldc_status_type bldc_init(bldc_handle_type* hbldc)
+{
+  tmr_output_config_type output_struct;
+  tmr_input_config_type input_struct;
+  tmr_brkdt_config_type brkdt_struct;
+
+  if((hbldc->pwm_tmrx != TMR1) || (hbldc->hall_tmrx != TMR3) || (hbldc->hall_gpio == 0) || (hbldc->hall_delay == 0))
+  {
+    return BLDC_ERR_PARAM;
+  }
+
+  bldc_lowlevel_init(hbldc);
+
+  hbldc->fault = 0;
+  hbldc->latency_max = 0;
+  hbldc->isr_cycles_max = 0;
+  hbldc->commutation_count = 0;
+  hbldc->hall_error_count = 0;
+  hbldc->brk_count = 0;
+
+  /* hall timer: xor of the sensors, capture and reset on every edge */
+  tmr_channel1_input_select(hbldc->hall_tmrx, TMR_CHANEL1_2_3_CONNECTED_C1IRAW_XOR);
+  input_struct.input_channel_select = TMR_SELECT_CHANNEL_1;
+  input_struct.input_polarity_select = TMR_INPUT_RISING_EDGE;
+  input_struct.input_mapped_select = TMR_CC_CHANNEL_MAPPED_STI;
+  input_struct.input_filter_value = 0x0F;
+  tmr_input_channel_init(hbldc->hall_tmrx, &input_struct, TMR_CHANNEL_INPUT_DIV_1);
+  tmr_trigger_input_select(hbldc->hall_tmrx, TMR_SUB_INPUT_SEL_C1INC);
+  tmr_sub_mode_select(hbldc->hall_tmrx, TMR_SUB_RESET_MODE);
+
+  /* channel 2 rises hall_delay counts after the edge and commutates */
+  tmr_output_default_para_init(&output_struct);
+  output_struct.oc_mode = TMR_OUTPUT_CONTROL_PWM_MODE_B;
+  tmr_output_channel_config(hbldc->hall_tmrx, TMR_SELECT_CHANNEL_2, &output_struct);
+  tmr_channel_value_set(hbldc->hall_tmrx, TMR_SELECT_CHANNEL_2, hbldc->hall_delay);
+  tmr_primary_mode_select(hbldc->hall_tmrx, TMR_PRIMARY_SEL_C2ORAW);
+
+  /* pwm timer: dead time, brake keeping the outputs off until restarted */
+  tmr_brkdt_default_para_init(&brkdt_struct);
+  brkdt_struct.deadtime = hbldc->deadtime;
+  brkdt_struct.brk_enable = TRUE;
+  brkdt_struct.brk_polarity = hbldc->brk_polarity;
+  brkdt_struct.auto_output_enable = FALSE;
+  brkdt_struct.fcsodis_state = TRUE;
+  brkdt_struct.fcsoen_state = TRUE;
+  brkdt_struct.wp_level = TMR_WP_OFF;
+  tmr_brkdt_config(hbldc->pwm_tmrx, &brkdt_struct);
+
+  tmr_output_channel_buffer_enable(hbldc->pwm_tmrx, TMR_SELECT_CHANNEL_1, TRUE);
+  tmr_output_channel_buffer_enable(hbldc->pwm_tmrx, TMR_SELECT_CHANNEL_2, TRUE);
+  tmr_output_channel_buffer_enable(hbldc->pwm_tmrx, TMR_SELECT_CHANNEL_3, TRUE);
+  bldc_image_build(hbldc);
+
+  /* commutation on the rising edge of the hall timer trgout */
+  tmr_trigger_input_select(hbldc->pwm_tmrx, hbldc->hall_trigger);
+  tmr_channel_buffer_enable(hbldc->pwm_tmrx, TRUE);
+  tmr_hall_select(hbldc->pwm_tmrx, TRUE);
+
+  /* start the dwt cycle counter of the interrupt measurement */
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+  return BLDC_OK;
+}
+
+/**
+  * @brief  apply the step of the hall sensors now, load the next one and
+  *         enable the outputs. a brake input still active is reported.
+  * @param  hbldc: the handle points to the motor information.
+  * @param  direction: direction of rotation.
+  * @retval bldc status.
+  */
+bldc_status_type bldc_start(bldc_handle_type* hbldc, bldc_direction_type direction)
+{
+  uint8_t sector;
+
+  sector = bldc_hall_sector_get(hbldc);
+  if(sector == BLDC_HALL_INVALID)
+  {
+    return BLDC_ERR_HALL;
+  }
+
+  hbldc->direction = direction;
+  hbldc->fault = 0;
+
+  bldc_image_load(hbldc, bldc_sector_step(hbldc, sector));
+  tmr_event_sw_trigger(hbldc->pwm_tmrx, TMR_HALL_SWTRIG);
+
+  hbldc->sector = (direction == BLDC_FORWARD) ? ((sector + 1) % 6) : ((sector + 5) % 6);
+  bldc_image_load(hbldc, bldc_sector_step(hbldc, hbldc->sector));
+
+  tmr_flag_clear(hbldc->pwm_tmrx, TMR_HALL_FLAG | TMR_BRK_FLAG);
+  tmr_interrupt_enable(hbldc->pwm_tmrx, TMR_HALL_INT | TMR_BRK_INT, TRUE);
+  tmr_counter_enable(hbldc->hall_tmrx, TRUE);
+  tmr_counter_enable(hbldc->pwm_tmrx, TRUE);
+  tmr_output_enable(hbldc->pwm_tmrx, TRUE);
+
+  if(tmr_flag_get(hbldc->pwm_tmrx, TMR_BRK_FLAG) != RESET)
+  {
+    bldc_stop(hbldc);
+    hbldc->fault = 1;
+    return BLDC_ERR_FAULT;
+  }
+
+  return BLDC_OK;
+}
+
+/**
+  * @brief  disable the outputs, the timers keep running.
+  * @param  hbldc: the handle points to the motor information.
+  * @retval none
+  */
+void bldc_stop(bldc_handle_type* hbldc)
+{
+  tmr_output_enable(hbldc->pwm_tmrx, FALSE);
+  tmr_interrupt_enable(hbldc->pwm_tmrx, TMR_HALL_INT, FALSE);
+}
+
+/**
+  * @brief  set the compare value of the pwm phases, taken on the next overflow.
+  * @param  hbldc: the handle points to the motor information.
+  * @param  duty: compare value, 0 ~ period of the pwm timer.
+  * @retval none
+  */
+void bldc_duty_set(bldc_handle_type* hbldc, uint16_t duty)
+{
+  hbldc->pwm_tmrx->c1dt = duty;
+  hbldc->pwm_tmrx->c2dt = duty;
+  hbldc->pwm_tmrx->c3dt = duty;
+}
+
+/**
+  * @brief  pwm timer interrupt handler. on a hall event the outputs already
+  *         changed, the sector is checked and the image of the next step is
+  *         loaded, the step is applied at once if the sector was unexpected.
+  *         on a brake the outputs stay off until bldc_start().
+  * @param  hbldc: the handle points to the motor information.
+  * @retval none
+  */
+void bldc_irq_handler(bldc_handle_type* hbldc)
+{
+  uint32_t start = DWT->CYCCNT;
+  uint16_t latency = (uint16_t)hbldc->hall_tmrx->cval;
+  uint8_t sector;
+
+  if(tmr_interrupt_flag_get(hbldc->pwm_tmrx, TMR_BRK_FLAG) != RESET)
+  {
+    tmr_flag_clear(hbldc->pwm_tmrx, TMR_BRK_FLAG);
+    bldc_stop(hbldc);
+    hbldc->fault = 1;
+    hbldc->brk_count++;
+  }
+
+  if(tmr_interrupt_flag_get(hbldc->pwm_tmrx, TMR_HALL_FLAG) == RESET)
+  {
+    return;
+  }
+  tmr_flag_clear(hbldc->pwm_tmrx, TMR_HALL_FLAG);
+
+  hbldc->latency = latency;
+  if(latency > hbldc->latency_max)
+  {
+    hbldc->latency_max = latency;
+  }
+  hbldc->hall_period = (uint16_t)hbldc->hall_tmrx->c1dt;
+  hbldc->commutation_count++;
+
+  sector = bldc_hall_sector_get(hbldc);
+  if(sector == BLDC_HALL_INVALID)
+  {
+    hbldc->hall_error_count++;
+    bldc_stop(hbldc);
+    hbldc->fault = 1;
+    return;
+  }
+
+  if(sector != hbldc->sector)
+  {
+    hbldc->hall_error_count++;
+    bldc_image_load(hbldc, bldc_sector_step(hbldc, sector));
+    tmr_event_sw_trigger(hbldc->pwm_tmrx, TMR_HALL_SWTRIG);
+    tmr_flag_clear(hbldc->pwm_tmrx, TMR_HALL_FLAG);
+  }
+
+  hbldc->sector = (hbldc->direction == BLDC_FORWARD) ? ((sector + 1) % 6) : ((sector + 5) % 6);
+  bldc_image_load(hbldc, bldc_sector_step(hbldc, hbldc->sector));
+
+  hbldc->isr_cycles = DWT->CYCCNT - start;
+  if(hbldc->isr_cycles > hbldc->isr_cycles_max)
+  {
+    hbldc->isr_cycles_max = hbldc->isr_cycles;
+  }
+}
+
+/**
+  * @}
+  */
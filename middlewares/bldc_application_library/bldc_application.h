@@ -0,0 +1,143 @@
+/**
+  **************************************************************************
+  * @file     bldc_application.h
+  * @brief    bldc six-step commutation application libray header file
+  **************************************************************************
+  *
+  * Copyright (c) 2025, Artery Technology, All rights reserved.
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+/*!< define to prevent recursive inclusion -------------------------------------*/
+#ifndef __BLDC_APPLICATION_H
+#define __BLDC_APPLICATION_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* includes ------------------------------------------------------------------*/
+#include "at32f422_426.h"
+
+/** @addtogroup AT32F422_426_middlewares_bldc_application_library
+  * @{
+  */
+
+
+/** @defgroup BLDC_library_definition
+  * @{
+  */
+
+#define BLDC_HALL_INVALID                0xFF                     /*!< hall code without a sector      */
+
+/**
+  * @}
+  */
+
+/** @defgroup BLDC_library_status_code
+  * @{
+  */
+
+typedef enum
+{
+  BLDC_OK = 0,            /*!< no error */
+  BLDC_ERR_PARAM,         /*!< invalid parameter */
+  BLDC_ERR_HALL,          /*!< invalid hall code */
+  BLDC_ERR_FAULT,         /*!< brake input active */
+} bldc_status_type;
+
+/**
+  * @}
+  */
+
+/** @defgroup BLDC_library_handle
+  * @{
+  */
+
+typedef enum
+{
+  BLDC_FORWARD = 0,       /*!< sector order of the hall table */
+  BLDC_REVERSE,           /*!< reverse sector order */
+} bldc_direction_type;
+
+/**
+  * @brief  output register image of one step, written to the buffered channel
+  *         control bits and moved to the outputs by the hall event.
+  */
+typedef struct
+{
+  uint32_t                               cm1;                     /*!< channel 1 and 2 mode            */
+  uint32_t                               cm2;                     /*!< channel 3 mode                  */
+  uint32_t                               cctrl;                   /*!< channel enables and polarities  */
+} bldc_image_type;
+
+typedef struct
+{
+  tmr_type                               *pwm_tmrx;               /*!< TMR1, channels 1 ~ 3 and complementary */
+  tmr_type                               *hall_tmrx;              /*!< TMR3, hall sensors on channels 1 ~ 3 */
+  sub_tmr_input_sel_type                 hall_trigger;            /*!< pwm timer input of the hall timer trgout, TMR_SUB_INPUT_SEL_IS2 for TMR3 */
+  uint16_t                               hall_delay;              /*!< hall timer counts from a hall edge to the commutation, at least 1 */
+  gpio_type                              *hall_gpio;              /*!< port of the hall sensors        */
+  uint16_t                               hall_pin[3];             /*!< pins of the hall sensors 1 ~ 3  */
+  uint8_t                                hall_table[8];           /*!< forward step of each hall code, BLDC_HALL_INVALID if none */
+  uint8_t                                deadtime;                /*!< dead time of the complementary outputs */
+  tmr_brk_polarity_type                  brk_polarity;            /*!< brake input active level        */
+  confirm_state                          synchronous;             /*!< low side switched with the pwm  */
+  bldc_image_type                        image[6];                /*!< output images of the steps      */
+  bldc_direction_type                    direction;               /*!< direction of rotation           */
+  __IO uint8_t                           sector;                  /*!< sector expected after the next hall event */
+  __IO uint8_t                           fault;                   /*!< brake input seen, outputs off   */
+  __IO uint16_t                          hall_period;             /*!< hall timer counts of the last sector */
+  __IO uint16_t                          latency;                 /*!< hall timer counts from the hall edge to the interrupt */
+  __IO uint16_t                          latency_max;             /*!< longest latency                 */
+  __IO uint32_t                          isr_cycles;              /*!< cpu cycles of the last hall interrupt */
+  __IO uint32_t                          isr_cycles_max;          /*!< longest hall interrupt          */
+  __IO uint32_t                          commutation_count;       /*!< hall events                     */
+  __IO uint32_t                          hall_error_count;        /*!< unexpected or invalid hall codes */
+  __IO uint32_t                          brk_count;               /*!< brake events                    */
+} bldc_handle_type;
+
+/**
+  * @}
+  */
+
+/** @defgroup BLDC_library_exported_functions
+  * @{
+  */
+
+void             bldc_lowlevel_init    (bldc_handle_type* hbldc);
+bldc_status_type bldc_init             (bldc_handle_type* hbldc);
+bldc_status_type bldc_start            (bldc_handle_type* hbldc, bldc_direction_type direction);
+void             bldc_stop             (bldc_handle_type* hbldc);
+void             bldc_duty_set         (bldc_handle_type* hbldc, uint16_t duty);
+void             bldc_irq_handler      (bldc_handle_type* hbldc);
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,1091 @@
+/**
+  **************************************************************************
+  * @file     can_application.c
+  * @brief    the application library of the can peripheral
+  **************************************************************************
+  *
+  * Copyright (c) 2025, Artery Technology, All rights reserved.
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+#include "can_application.h"
+
+/** @addtogroup AT32F422_426_middlewares_can_application_library
+  * @{
+  */
+
+
+#ifdef SUPPORT_CAN_FD
+static const uint8_t can_dlc_to_bytes[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 12, 16, 20, 24, 32, 48, 64};
+#define CAN_DLC_TO_BYTES(dlc)            (can_dlc_to_bytes[(dlc) & 0x0F])
+#else
+#define CAN_DLC_TO_BYTES(dlc)            (((dlc) > 8) ? 8 : (dlc))
+#endif
+
+/**
+  * @brief  load one queued frame into the next secondary transmit buffer slot.
+  *         the payload words are stored as they are, without repacking.
+  * @param  can_x: the can peripheral.
+  * @param  frame: the frame descriptor.
+  * @retval SUCCESS or ERROR
+  */
+static error_status can_txq_stb_load(can_type* can_x, can_txq_frame_type* frame)
+{
+  uint8_t len = CAN_DLC_TO_BYTES(frame->data_length);
+  const uint32_t* rp = frame->data;
+  __IO uint32_t* wp = can_x->tbdat;
+  uint8_t byte_cnt;
+  uint8_t* reg;
+  uint8_t tmp;
+
+  if((can_x->ctrlstat_bit.tsnext == TRUE) || (can_x->ctrlstat_bit.tsstat == CAN_STB_STATUS_FULL))
+  {
+    return ERROR;
+  }
+
+  /* select the secondary transmit buffer, keep TSA, TSALL, TSONE, TPA and TPE untouched. */
+  reg = (uint8_t*)&can_x->ctrlstat + 1;
+  tmp = *reg & 0x60;
+  *reg = tmp | (CAN_TXBUF_STB << 7);
+
+  if(frame->id_type == CAN_ID_STANDARD)
+  {
+    can_x->tbid = ((0x7FF & frame->id) << 18) | ((uint32_t)frame->tx_timestamp << 31);
+  }
+  else
+  {
+    can_x->tbid = (0x1FFFFFFF & frame->id) | ((uint32_t)frame->tx_timestamp << 31);
+  }
+
+  can_x->tbfmt = 0;
+  can_x->tbfmt_bit.ide = frame->id_type;
+  can_x->tbfmt_bit.rmf = frame->frame_type;
+  can_x->tbfmt_bit.dlc = frame->data_length;
+#ifdef SUPPORT_CAN_FD
+  can_x->tbfmt_bit.brs = frame->fd_rate_switch;
+  can_x->tbfmt_bit.fdf = frame->fd_format;
+#endif
+
+  if(frame->frame_type == CAN_FRAME_DATA)
+  {
+    for(byte_cnt = 0; byte_cnt < len; byte_cnt += 4U)
+    {
+      *wp++ = *rp++;
+    }
+  }
+
+  can_x->tbtyp = 0;
+  can_x->tbtyp_bit.handle = frame->handle;
+  can_x->reserved8 = 0;
+
+  /* write TSNEXT, mark the slot filled and point to the next slot. */
+  reg = (uint8_t*)&can_x->ctrlstat + 2;
+  tmp = *reg;
+  *reg = tmp | 0x40;
+
+  return SUCCESS;
+}
+
+/**
+  * @brief  fill every free secondary transmit buffer slot with queued frames
+  *         and, when no frame is on its way, send the next one with TSONE.
+  * @note   one frame per TSONE gives one TSIF and one TSTAT per frame, the
+  *         stb keeps the following frames loaded so the next TSONE starts from
+  *         the interrupt without waiting for a load. a TSONE refused by the
+  *         hardware (standby) is retried at the next submit.
+  * @param  htxq: the handle points to the transmit queue information.
+  * @retval none.
+  */
+static void can_txq_refill(can_txq_handle_type* htxq)
+{
+  uint16_t tail = htxq->tail;
+
+  while(tail != htxq->head)
+  {
+    if(can_txq_stb_load(htxq->canx, htxq->queue[tail & htxq->size_mask]) != SUCCESS)
+    {
+      break;
+    }
+    tail++;
+    htxq->inflight++;
+  }
+  htxq->tail = tail;
+
+  if((htxq->sending == FALSE) && (htxq->inflight != 0))
+  {
+    if(can_txbuf_transmit(htxq->canx, CAN_TRANSMIT_STB_ONE) == SUCCESS)
+    {
+      htxq->sending = TRUE;
+    }
+  }
+}
+
+/**
+  * @brief  initialize the software transmit queue on top of the secondary transmit buffer.
+  *         htxq->canx, htxq->stb_mode and htxq->complete_callback shall be set before.
+  * @note   the stb transmit mode can be switched only while the can software reset is active.
+  * @param  htxq: the handle points to the transmit queue information.
+  * @param  queue_buf: descriptor pointer array used as ring.
+  * @param  queue_size: number of entries of queue_buf, must be a power of 2.
+  * @retval can application status.
+  */
+can_app_status_type can_txq_init(can_txq_handle_type* htxq, can_txq_frame_type** queue_buf, uint16_t queue_size)
+{
+  if((queue_size == 0) || (queue_size > 0x8000) || ((queue_size & (queue_size - 1)) != 0))
+  {
+    return CAN_APP_ERR_PARAM;
+  }
+
+  htxq->queue = queue_buf;
+  htxq->size_mask = queue_size - 1;
+  htxq->head = 0;
+  htxq->tail = 0;
+  htxq->done = 0;
+  htxq->inflight = 0;
+  htxq->sending = FALSE;
+  htxq->sent_count = 0;
+  htxq->error_count = 0;
+
+  can_stb_transmit_mode_set(htxq->canx, htxq->stb_mode);
+  can_interrupt_enable(htxq->canx, CAN_TSIE_INT, TRUE);
+
+  return CAN_APP_OK;
+}
+
+/**
+  * @brief  append a frame to the transmit queue, this function never waits.
+  *         the frame is loaded right away when the stb has a free slot,
+  *         otherwise from the transmit complete interrupt once one frees.
+  * @param  htxq: the handle points to the transmit queue information.
+  * @param  frame: frame descriptor, frame->data must be word aligned.
+  * @retval can application status.
+  */
+can_app_status_type can_txq_submit(can_txq_handle_type* htxq, can_txq_frame_type* frame)
+{
+  uint16_t head = htxq->head;
+
+  if(((uint32_t)frame->data & 0x3) != 0)
+  {
+    return CAN_APP_ERR_PARAM;
+  }
+
+  /* the ring keeps the descriptors of the loaded frames until their completion. */
+  if((uint16_t)(head - htxq->done) > htxq->size_mask)
+  {
+    return CAN_APP_ERR_FULL;
+  }
+
+  htxq->queue[head & htxq->size_mask] = frame;
+  __DMB();
+  htxq->head = head + 1;
+
+  /* refill under a masked transmit complete interrupt, the interrupt handler
+     is the only other place which touches the secondary transmit buffer. */
+  can_interrupt_enable(htxq->canx, CAN_TSIE_INT, FALSE);
+  can_txq_refill(htxq);
+  can_interrupt_enable(htxq->canx, CAN_TSIE_INT, TRUE);
+
+  return CAN_APP_OK;
+}
+
+/**
+  * @brief  get the number of frames not yet completed, queued or in the stb.
+  * @param  htxq: the handle points to the transmit queue information.
+  * @retval number of frames.
+  */
+uint16_t can_txq_pending_get(can_txq_handle_type* htxq)
+{
+  return (uint16_t)(htxq->head - htxq->done);
+}
+
+/**
+  * @brief  transmit queue interrupt handler, call it in the can interrupt which
+  *         services TSIF.
+  * @param  htxq: the handle points to the transmit queue information.
+  * @retval none.
+  */
+void can_txq_irq_handler(can_txq_handle_type* htxq)
+{
+  can_transmit_status_type status;
+  can_txq_frame_type* frame;
+  uint16_t done, index;
+
+  if(can_interrupt_flag_get(htxq->canx, CAN_TSIF_FLAG) != SET)
+  {
+    return;
+  }
+
+  can_flag_clear(htxq->canx, CAN_TSIF_FLAG);
+  can_transmit_status_get(htxq->canx, &status);
+  htxq->sending = FALSE;
+
+  if(htxq->inflight == 0)
+  {
+    return;
+  }
+
+  /* the TSIF of a TSONE ends one frame, TSTAT holds its handle and status.
+     in fifo mode it is the oldest loaded frame, in priority mode any of them:
+     the frame of that handle is moved to the oldest position and released. */
+  done = htxq->done;
+  for(index = done; index != htxq->tail; index++)
+  {
+    if(htxq->queue[index & htxq->size_mask]->handle == status.final_handle)
+    {
+      break;
+    }
+  }
+  if(index == htxq->tail)
+  {
+    index = done;
+  }
+  frame = htxq->queue[index & htxq->size_mask];
+  htxq->queue[index & htxq->size_mask] = htxq->queue[done & htxq->size_mask];
+  htxq->queue[done & htxq->size_mask] = frame;
+  htxq->done = done + 1;
+  htxq->inflight--;
+
+  if(status.final_tstat == CAN_TSTAT_TRANSMITTED)
+  {
+    htxq->sent_count++;
+  }
+  else
+  {
+    htxq->error_count++;
+  }
+
+  /* start the next frame before calling back to the application. */
+  can_txq_refill(htxq);
+
+  if(htxq->complete_callback != 0)
+  {
+    htxq->complete_callback(htxq, frame->handle, status.final_tstat);
+  }
+}
+
+/**
+  * @brief  initialize the receive queue, hrxq->canx shall be set before.
+  * @param  hrxq: the handle points to the receive queue information.
+  * @param  slot_buf: preallocated frame slots of the ring.
+  * @param  slot_num: number of entries of slot_buf, must be a power of 2.
+  * @retval can application status.
+  */
+can_app_status_type can_rxq_init(can_rxq_handle_type* hrxq, can_rxbuf_type* slot_buf, uint16_t slot_num)
+{
+  if((slot_num == 0) || (slot_num > 0x8000) || ((slot_num & (slot_num - 1)) != 0))
+  {
+    return CAN_APP_ERR_PARAM;
+  }
+
+  hrxq->slot = slot_buf;
+  hrxq->size_mask = slot_num - 1;
+  hrxq->head = 0;
+  hrxq->tail = 0;
+  hrxq->high_water = 0;
+  hrxq->overflow_count = 0;
+
+  return CAN_APP_OK;
+}
+
+/**
+  * @brief  receive queue interrupt handler, call it in the can interrupt which
+  *         services RIF. every frame of the receive buffer is read straight into
+  *         a free slot of the ring and released, a frame finding the ring full
+  *         is released and counted in overflow_count.
+  * @param  hrxq: the handle points to the receive queue information.
+  * @retval number of frames stored.
+  */
+uint16_t can_rxq_irq_handler(can_rxq_handle_type* hrxq)
+{
+  uint16_t head = hrxq->head;
+  uint16_t used, stored = 0;
+
+  while(1)
+  {
+    used = (uint16_t)(head - hrxq->tail);
+    if(used > hrxq->size_mask)
+    {
+      if(can_rxbuf_release(hrxq->canx) != SUCCESS)
+      {
+        break;
+      }
+      hrxq->overflow_count++;
+      continue;
+    }
+
+    if(can_rxbuf_read(hrxq->canx, &hrxq->slot[head & hrxq->size_mask]) != SUCCESS)
+    {
+      break;
+    }
+    head++;
+    stored++;
+
+    if(++used > hrxq->high_water)
+    {
+      hrxq->high_water = used;
+    }
+  }
+
+  /* the slot contents must be visible before the new head is published. */
+  __DMB();
+  hrxq->head = head;
+
+  return stored;
+}
+
+/**
+  * @brief  take up to max frames from the receive queue in one call.
+  * @param  hrxq: the handle points to the receive queue information.
+  * @param  frames: array that receives the frames in arrival order.
+  * @param  max: number of elements of frames.
+  * @retval number of frames copied.
+  */
+uint16_t can_rxq_drain(can_rxq_handle_type* hrxq, can_rxbuf_type frames[], uint16_t max)
+{
+  uint16_t tail = hrxq->tail;
+  uint16_t avail, cnt;
+
+  avail = (uint16_t)(hrxq->head - tail);
+  __DMB();
+
+  if(avail > max)
+  {
+    avail = max;
+  }
+
+  for(cnt = 0; cnt < avail; cnt++)
+  {
+    frames[cnt] = hrxq->slot[tail & hrxq->size_mask];
+    tail++;
+  }
+
+  /* the slots must be read out before they are handed back to the interrupt. */
+  __DMB();
+  hrxq->tail = tail;
+
+  return avail;
+}
+
+/**
+  * @brief  number of identifiers accepted by one filter.
+  * @param  mask: acceptance mask, 1 means "don't care".
+  * @param  id_mask: valid identifier bits.
+  * @retval number of identifiers.
+  */
+static uint32_t can_filter_block_span(uint32_t mask, uint32_t id_mask)
+{
+  uint32_t span = 1;
+
+  mask &= id_mask;
+  while(mask != 0)
+  {
+    if(mask & 0x1)
+    {
+      span <<= 1;
+    }
+    mask >>= 1;
+  }
+
+  return span;
+}
+
+/**
+  * @brief  second stage hash slot of an identifier.
+  * @param  id: the identifier.
+  * @param  hash_mask: hash table size minus one.
+  * @retval slot index.
+  */
+static uint16_t can_filter_hash_index(uint32_t id, uint16_t hash_mask)
+{
+  return (uint16_t)((id * 0x9E3779B1U) >> 16) & hash_mask;
+}
+
+/**
+  * @brief  number of identifiers a merge of two blocks adds to them.
+  * @param  a: first block.
+  * @param  b: second block.
+  * @param  id_mask: valid identifier bits.
+  * @retval number of identifiers, 0 when the blocks overlap.
+  */
+static uint32_t can_filter_merge_cost(const can_filter_block_type* a, const can_filter_block_type* b, uint32_t id_mask)
+{
+  uint32_t cost = can_filter_block_span(a->mask | b->mask | (a->code ^ b->code), id_mask) -
+                  can_filter_block_span(a->mask, id_mask) -
+                  can_filter_block_span(b->mask, id_mask);
+
+  /* overlapping blocks give a negative cost, which wraps to a large value. */
+  if((int32_t)cost < 0)
+  {
+    cost = 0;
+  }
+
+  return cost;
+}
+
+/**
+  * @brief  find the cheapest merge of a block with the blocks after it, the first one on a tie.
+  * @param  hflt: the handle points to the filter compiler information.
+  * @param  i: the block.
+  * @param  id_mask: valid identifier bits.
+  * @retval none.
+  */
+static void can_filter_pair_find(can_filter_compile_type* hflt, uint16_t i, uint32_t id_mask)
+{
+  uint32_t cost;
+  uint16_t j;
+
+  hflt->block[i].pair_cost = 0xFFFFFFFF;
+  hflt->block[i].pair = i;
+  for(j = i + 1; j < hflt->block_num; j++)
+  {
+    cost = can_filter_merge_cost(&hflt->block[i], &hflt->block[j], id_mask);
+    if(cost < hflt->block[i].pair_cost)
+    {
+      hflt->block[i].pair_cost = cost;
+      hflt->block[i].pair = j;
+    }
+  }
+}
+
+/**
+  * @brief  take a changed block j as a merge candidate of block i before it.
+  * @param  hflt: the handle points to the filter compiler information.
+  * @param  i: the block.
+  * @param  j: the changed block, after i.
+  * @param  id_mask: valid identifier bits.
+  * @retval none.
+  */
+static void can_filter_pair_update(can_filter_compile_type* hflt, uint16_t i, uint16_t j, uint32_t id_mask)
+{
+  uint32_t cost = can_filter_merge_cost(&hflt->block[i], &hflt->block[j], id_mask);
+
+  if((cost < hflt->block[i].pair_cost) || ((cost == hflt->block[i].pair_cost) && (j < hflt->block[i].pair)))
+  {
+    hflt->block[i].pair_cost = cost;
+    hflt->block[i].pair = j;
+  }
+}
+
+/**
+  * @brief  split a range into aligned power of 2 blocks, each one fits a code and mask pair.
+  * @param  hflt: the handle points to the filter compiler information.
+  * @param  low: first identifier.
+  * @param  high: last identifier.
+  * @retval can application status.
+  */
+static can_app_status_type can_filter_range_split(can_filter_compile_type* hflt, uint32_t low, uint32_t high)
+{
+  uint32_t size;
+
+  while(low <= high)
+  {
+    /* largest block aligned on low which does not pass high. */
+    size = (low == 0) ? 0x20000000 : (low & (~low + 1));
+    while((size - 1) > (high - low))
+    {
+      size >>= 1;
+    }
+
+    if(hflt->block_num >= hflt->block_size)
+    {
+      return CAN_APP_ERR_NOMEM;
+    }
+    hflt->block[hflt->block_num].code = low;
+    hflt->block[hflt->block_num].mask = size - 1;
+    hflt->block_num++;
+
+    if((high - low) < size)
+    {
+      break;
+    }
+    low += size;
+  }
+
+  return CAN_APP_OK;
+}
+
+/**
+  * @brief  compile the identifier list into the hardware acceptance filters.
+  *         the ranges are split into aligned blocks, then the pair of blocks whose
+  *         union lets the fewest extra identifiers through is merged until the blocks
+  *         fit filter_num filters, the first pair on a tie. every block keeps its
+  *         cheapest merge with a later block, a merge searches again only for the
+  *         blocks whose pair it changed. the identifiers of the list also fill the second
+  *         stage hash which can_filter_match() uses to drop the residual frames.
+  * @note   the acceptance filters can be configured only while the can software reset is active.
+  * @param  hflt: the handle points to the filter compiler information.
+  * @retval can application status.
+  */
+can_app_status_type can_filter_compile(can_filter_compile_type* hflt)
+{
+  uint32_t id_mask = (hflt->id_type == CAN_ID_STANDARD) ? 0x7FF : 0x1FFFFFFF;
+  can_filter_config_type filter_config_struct;
+  can_filter_block_type merge;
+  uint32_t id;
+  uint16_t i, j, k, last, slot;
+  can_app_status_type status;
+
+  if((hflt->filter_num == 0) || (hflt->filter_num > 16) || (hflt->range_num == 0) ||
+     (hflt->hash_size == 0) || ((hflt->hash_size & (hflt->hash_size - 1)) != 0))
+  {
+    return CAN_APP_ERR_PARAM;
+  }
+
+  /* first stage: split every range and fill the second stage hash */
+  for(i = 0; i < hflt->hash_size; i++)
+  {
+    hflt->hash[i] = CAN_FILTER_HASH_EMPTY;
+  }
+
+  hflt->block_num = 0;
+  hflt->want_count = 0;
+  for(i = 0; i < hflt->range_num; i++)
+  {
+    if((hflt->range[i].id_low > hflt->range[i].id_high) || (hflt->range[i].id_high > id_mask))
+    {
+      return CAN_APP_ERR_PARAM;
+    }
+
+    status = can_filter_range_split(hflt, hflt->range[i].id_low, hflt->range[i].id_high);
+    if(status != CAN_APP_OK)
+    {
+      return status;
+    }
+    hflt->want_count += hflt->range[i].id_high - hflt->range[i].id_low + 1;
+
+    if((hflt->range[i].id_high - hflt->range[i].id_low) < CAN_FILTER_HASH_SPAN_MAX)
+    {
+      for(id = hflt->range[i].id_low; id <= hflt->range[i].id_high; id++)
+      {
+        slot = can_filter_hash_index(id, hflt->hash_size - 1);
+        for(j = 0; j < hflt->hash_size; j++)
+        {
+          if((hflt->hash[slot] == CAN_FILTER_HASH_EMPTY) || (hflt->hash[slot] == id))
+          {
+            break;
+          }
+          slot = (slot + 1) & (hflt->hash_size - 1);
+        }
+        if(j == hflt->hash_size)
+        {
+          return CAN_APP_ERR_NOMEM;
+        }
+        hflt->hash[slot] = id;
+      }
+    }
+  }
+
+  /* second stage: merge the cheapest pair until the blocks fit the filters */
+  for(k = 0; k < hflt->block_num; k++)
+  {
+    can_filter_pair_find(hflt, k, id_mask);
+  }
+
+  while(hflt->block_num > hflt->filter_num)
+  {
+    i = 0;
+    for(k = 1; k < hflt->block_num; k++)
+    {
+      if(hflt->block[k].pair_cost < hflt->block[i].pair_cost)
+      {
+        i = k;
+      }
+    }
+    j = hflt->block[i].pair;
+
+    /* the merge takes block i, the last block moves to j */
+    merge.mask = hflt->block[i].mask | hflt->block[j].mask | (hflt->block[i].code ^ hflt->block[j].code);
+    merge.code = hflt->block[i].code & ~merge.mask;
+    hflt->block[i].code = merge.code;
+    hflt->block[i].mask = merge.mask;
+    last = --hflt->block_num;
+    if(j != last)
+    {
+      hflt->block[j].code = hflt->block[last].code;
+      hflt->block[j].mask = hflt->block[last].mask;
+    }
+
+    for(k = 0; k < hflt->block_num; k++)
+    {
+      if((k == i) || (k == j) || (hflt->block[k].pair == i) ||
+         (hflt->block[k].pair == j) || (hflt->block[k].pair == last))
+      {
+        can_filter_pair_find(hflt, k, id_mask);
+      }
+      else
+      {
+        if(k < i)
+        {
+          can_filter_pair_update(hflt, k, i, id_mask);
+        }
+        if((k < j) && (j != last))
+        {
+          can_filter_pair_update(hflt, k, j, id_mask);
+        }
+      }
+    }
+  }
+
+  /* third stage: program the acceptance filters */
+  hflt->accept_count = 0;
+  for(i = 0; i < hflt->filter_num; i++)
+  {
+    if(i < hflt->block_num)
+    {
+      can_filter_default_para_init(&filter_config_struct);
+      filter_config_struct.code_para.id = hflt->block[i].code;
+      filter_config_struct.code_para.id_type = hflt->id_type;
+      filter_config_struct.mask_para.id = hflt->block[i].mask;
+      filter_config_struct.mask_para.id_type = FALSE;     /* not mask, filter id_type. */
+      can_filter_set(hflt->canx, (can_filter_type)i, &filter_config_struct);
+      can_filter_enable(hflt->canx, (can_filter_type)i, TRUE);
+      hflt->accept_count += can_filter_block_span(hflt->block[i].mask, id_mask);
+    }
+    else
+    {
+      can_filter_enable(hflt->canx, (can_filter_type)i, FALSE);
+    }
+  }
+
+  /* standard identifiers are few enough to count the accepted set and the list exactly,
+     for extended identifiers the sum of the filters and of the ranges are upper bounds. */
+  if(hflt->id_type == CAN_ID_STANDARD)
+  {
+    hflt->accept_count = 0;
+    hflt->want_count = 0;
+    for(id = 0; id <= id_mask; id++)
+    {
+      for(i = 0; i < hflt->block_num; i++)
+      {
+        if(((id ^ hflt->block[i].code) & ~hflt->block[i].mask) == 0)
+        {
+          hflt->accept_count++;
+          break;
+        }
+      }
+      for(i = 0; i < hflt->range_num; i++)
+      {
+        if((id >= hflt->range[i].id_low) && (id <= hflt->range[i].id_high))
+        {
+          hflt->want_count++;
+          break;
+        }
+      }
+    }
+  }
+
+  return CAN_APP_OK;
+}
+
+/**
+  * @brief  get the share of the frames passed by the hardware filters which are not
+  *         in the identifier list, assuming all identifiers are equally likely.
+  * @param  hflt: the handle points to the filter compiler information.
+  * @retval false accept rate in parts per million.
+  */
+uint32_t can_filter_false_accept_ppm_get(can_filter_compile_type* hflt)
+{
+  if((hflt->accept_count == 0) || (hflt->accept_count <= hflt->want_count))
+  {
+    return 0;
+  }
+
+  return (uint32_t)(((uint64_t)(hflt->accept_count - hflt->want_count) * 1000000) / hflt->accept_count);
+}
+
+/**
+  * @brief  second stage check of a frame passed by the hardware filters.
+  * @param  hflt: the handle points to the filter compiler information.
+  * @param  id: identifier of the received frame.
+  * @retval SET when the identifier is in the list, otherwise RESET.
+  */
+flag_status can_filter_match(can_filter_compile_type* hflt, uint32_t id)
+{
+  uint16_t slot = can_filter_hash_index(id, hflt->hash_size - 1);
+  uint16_t i;
+
+  for(i = 0; i < hflt->hash_size; i++)
+  {
+    if(hflt->hash[slot] == id)
+    {
+      return SET;
+    }
+    if(hflt->hash[slot] == CAN_FILTER_HASH_EMPTY)
+    {
+      break;
+    }
+    slot = (slot + 1) & (hflt->hash_size - 1);
+  }
+
+  /* the wide ranges are not in the hash */
+  for(i = 0; i < hflt->range_num; i++)
+  {
+    if(((hflt->range[i].id_high - hflt->range[i].id_low) >= CAN_FILTER_HASH_SPAN_MAX) &&
+       (id >= hflt->range[i].id_low) && (id <= hflt->range[i].id_high))
+    {
+      return SET;
+    }
+  }
+
+  return RESET;
+}
+
+/**
+  * @brief  check whether a schedule entry is active in a basic cycle.
+  * @param  entry: the schedule entry.
+  * @param  cycle: the basic cycle count.
+  * @retval TRUE or FALSE.
+  */
+static confirm_state can_tts_entry_active(const can_tts_entry_type* entry, uint8_t cycle)
+{
+  return (((cycle ^ entry->cycle_offset) & entry->repeat_mask) == 0) ? TRUE : FALSE;
+}
+
+/**
+  * @brief  arm the next active entry of the schedule in the hardware, starting at htts->index.
+  *         the frame of a transmit trigger is loaded into its slot before the trigger time is written.
+  * @param  htts: the handle points to the ttcan schedule information.
+  * @retval none.
+  */
+static void can_tts_arm(can_tts_handle_type* htts)
+{
+  const can_tts_entry_type* entry;
+  uint8_t cnt;
+
+  for(cnt = 0; cnt < htts->entry_num; cnt++)
+  {
+    if(can_tts_entry_active(&htts->entry[htts->index], htts->cycle_count) == TRUE)
+    {
+      break;
+    }
+
+    if(++htts->index >= htts->entry_num)
+    {
+      htts->index = 0;
+      htts->cycle_count++;
+    }
+  }
+
+  entry = &htts->entry[htts->index];
+
+  if((entry->frame != 0) && (entry->trigger_type != CAN_TTCAN_TRIGGER_TIME))
+  {
+    if(can_ttcan_txbuf_status_get(htts->canx, entry->txbuf_number) == CAN_TTCAN_TXBUF_FILLED)
+    {
+      /* the frame of an earlier window was never sent, drop it. */
+      can_ttcan_txbuf_status_set(htts->canx, entry->txbuf_number, CAN_TTCAN_TXBUF_EMPTY);
+      htts->missed_count++;
+    }
+    can_ttcan_txbuf_write(htts->canx, entry->txbuf_number, entry->frame);
+  }
+
+  can_ttcan_trigger_type_set(htts->canx, entry->trigger_type);
+  can_ttcan_txbuf_transmit_set(htts->canx, entry->txbuf_number);
+  can_ttcan_transmit_window_set(htts->canx, entry->window_ticks);
+  can_ttcan_trigger_set(htts->canx, entry->trigger_time);
+}
+
+/**
+  * @brief  step to the entry after the one which has just fired.
+  * @param  htts: the handle points to the ttcan schedule information.
+  * @retval none.
+  */
+static void can_tts_advance(can_tts_handle_type* htts)
+{
+  if(++htts->index >= htts->entry_num)
+  {
+    htts->index = 0;
+    htts->cycle_count++;
+  }
+}
+
+/**
+  * @brief  ttcan schedule initialization, configures the reference message, the timer
+  *         and the watch trigger and enables the ttcan interrupts.
+  * @param  htts: the handle points to the ttcan schedule information.
+  * @retval none.
+  */
+void can_tts_init(can_tts_handle_type* htts)
+{
+  htts->index = 0;
+  htts->cycle_count = 0;
+  htts->trigger_error_count = 0;
+  htts->watch_count = 0;
+  htts->missed_count = 0;
+
+  can_ttcan_ref_message_set(htts->canx, htts->ref_id_type, htts->ref_id);
+  can_ttcan_txbuf_enable(htts->canx, TRUE);
+  can_ttcan_timer_div_set(htts->canx, htts->timer_div);
+  can_ttcan_watch_trigger_set(htts->canx, htts->watch_time);
+  can_interrupt_enable(htts->canx, CAN_TTIE_INT | CAN_TEIE_INT | CAN_WTIE_INT, TRUE);
+}
+
+/**
+  * @brief  start the ttcan timer and arm the first entry of the schedule.
+  * @note   every basic cycle should hold at least one active entry, otherwise an entry
+  *         of a later cycle fires one cycle early.
+  * @param  htts: the handle points to the ttcan schedule information.
+  * @retval none.
+  */
+void can_tts_start(can_tts_handle_type* htts)
+{
+  if(htts->entry_num == 0)
+  {
+    return;
+  }
+
+  htts->index = 0;
+  htts->cycle_count = 0;
+  can_ttcan_enable(htts->canx, TRUE);
+  can_tts_arm(htts);
+}
+
+/**
+  * @brief  ttcan schedule interrupt handler, call it in the can interrupt which
+  *         services TTIF, TEIF and WTIF.
+  * @param  htts: the handle points to the ttcan schedule information.
+  * @param  rx_frame: the frame received in this interrupt, 0 when none. a reference
+  *         message reloads the basic cycle counter from bits 5:0 of its first data byte.
+  * @retval none.
+  */
+void can_tts_irq_handler(can_tts_handle_type* htts, const can_rxbuf_type* rx_frame)
+{
+  uint8_t ref_cycle;
+
+  if(htts->entry_num == 0)
+  {
+    return;
+  }
+
+  /* reference message, a new basic cycle has started. resync the software cycle
+     counter with the time master, it would otherwise drift after a missed trigger
+     or a watch restart, and re-arm from the first entry when it was off. */
+  if((rx_frame != 0) && (rx_frame->id_type == htts->ref_id_type) && (rx_frame->id == htts->ref_id) &&
+     (rx_frame->frame_type == CAN_FRAME_DATA) && (rx_frame->data_length != CAN_DLC_BYTES_0))
+  {
+    ref_cycle = rx_frame->data[0] & CAN_TTS_REF_CYCLE_MASK;
+    if((htts->index != 0) || ((htts->cycle_count & CAN_TTS_REF_CYCLE_MASK) != ref_cycle))
+    {
+      htts->index = 0;
+      htts->cycle_count = ref_cycle;
+      can_tts_arm(htts);
+    }
+  }
+
+  /* trigger error, the armed trigger is skipped */
+  if(can_interrupt_flag_get(htts->canx, CAN_TEIF_FLAG) != RESET)
+  {
+    can_flag_clear(htts->canx, CAN_TEIF_FLAG);
+    htts->trigger_error_count++;
+    can_tts_advance(htts);
+    can_tts_arm(htts);
+  }
+
+  /* time trigger, arm the next entry */
+  if(can_interrupt_flag_get(htts->canx, CAN_TTIF_FLAG) != RESET)
+  {
+    can_flag_clear(htts->canx, CAN_TTIF_FLAG);
+    can_tts_advance(htts);
+    can_tts_arm(htts);
+  }
+
+  /* watch trigger, no reference message in time, restart with the next cycle */
+  if(can_interrupt_flag_get(htts->canx, CAN_WTIF_FLAG) != RESET)
+  {
+    can_flag_clear(htts->canx, CAN_WTIF_FLAG);
+    htts->watch_count++;
+    if(htts->index != 0)
+    {
+      htts->index = 0;
+      htts->cycle_count++;
+    }
+    can_tts_arm(htts);
+  }
+}
+
+/**
+  * @brief  worst case bus time of a classic frame with bit stuffing and intermission.
+  *         can-fd frames are counted at the nominal bit rate, which is an upper bound.
+  * @param  frame: the frame.
+  * @param  timer_div: ttcan tick in nominal bit times.
+  * @retval number of ttcan ticks.
+  */
+uint16_t can_tts_frame_ticks(can_txbuf_type* frame, can_ttcan_timer_div_type timer_div)
+{
+  uint32_t bits = CAN_DLC_TO_BYTES(frame->data_length) * 8;
+
+  if(frame->frame_type != CAN_FRAME_DATA)
+  {
+    bits = 0;
+  }
+
+  if(frame->id_type == CAN_ID_STANDARD)
+  {
+    bits = bits + 44 + (34 + bits - 1) / 4;
+  }
+  else
+  {
+    bits = bits + 64 + (54 + bits - 1) / 4;
+  }
+  bits += 3;
+
+  return (uint16_t)((bits + (1U << timer_div) - 1) >> timer_div);
+}
+
+/**
+  * @brief  check a schedule without touching the hardware, so it can be run on the host.
+  *         the active entries of 64 basic cycles are laid on one timeline, the
+  *         transmit windows of one cycle running on into the next and the last
+  *         cycle into the first. a window conflicts when it starts before an
+  *         earlier one ends, a frame when it is loaded into a slot, at the
+  *         trigger before its own, while the window of an earlier entry on the
+  *         same slot is still open. the timeline is walked twice, the first
+  *         pass only to carry the windows of the last cycle round.
+  * @param  htts: the handle points to the ttcan schedule information.
+  * @param  report: validation result.
+  * @retval CAN_APP_OK when the schedule has no conflict, otherwise CAN_APP_ERR_PARAM.
+  */
+can_app_status_type can_tts_validate(can_tts_handle_type* htts, can_tts_report_type* report)
+{
+  const can_tts_entry_type *a;
+  uint32_t slot_end[CAN_TTS_TXBUF_SLOTS];
+  uint8_t slot_entry[CAN_TTS_TXBUF_SLOTS];
+  uint32_t start, end, load, win_end;
+  uint8_t win_entry, first;
+  uint16_t dur;
+  uint8_t i, pass, cycle;
+
+  report->conflict_num = 0;
+  report->conflict_first = 0;
+  report->conflict_second = 0;
+  report->order_error = 0;
+  report->busy_ticks = 0;
+  report->utilization = 0;
+
+  if((htts->cycle_time == 0) || (htts->watch_time <= htts->cycle_time))
+  {
+    report->order_error++;
+  }
+
+  for(i = 0; i < htts->entry_num; i++)
+  {
+    a = &htts->entry[i];
+    if(((i > 0) && (a->trigger_time < htts->entry[i - 1].trigger_time)) ||
+       (a->trigger_time >= htts->cycle_time) || ((a->cycle_offset & ~a->repeat_mask) != 0) ||
+       (a->txbuf_number >= CAN_TTS_TXBUF_SLOTS))
+    {
+      report->order_error++;
+    }
+  }
+
+  if(report->order_error != 0)
+  {
+    return CAN_APP_ERR_PARAM;
+  }
+
+  for(i = 0; i < CAN_TTS_TXBUF_SLOTS; i++)
+  {
+    slot_end[i] = 0;
+    slot_entry[i] = 0;
+  }
+  win_end = 0;
+  win_entry = 0;
+  load = 0;
+
+  for(pass = 0; pass < 2; pass++)
+  {
+    for(cycle = 0; cycle < 64; cycle++)
+    {
+      for(i = 0; i < htts->entry_num; i++)
+      {
+        a = &htts->entry[i];
+        if(can_tts_entry_active(a, cycle) != TRUE)
+        {
+          continue;
+        }
+
+        start = ((uint32_t)pass * 64 + cycle) * htts->cycle_time + a->trigger_time;
+        first = 0xFF;
+
+        /* the frame is written when the trigger before this one fires */
+        if((a->frame != 0) && (a->trigger_type != CAN_TTCAN_TRIGGER_TIME) &&
+           (slot_end[a->txbuf_number] > load))
+        {
+          first = slot_entry[a->txbuf_number];
+        }
+        load = start;
+
+        if((a->trigger_type != CAN_TTCAN_TRIGGER_TIME) && (a->trigger_type != CAN_TTCAN_TRIGGER_TRANSMIT_STOP))
+        {
+          dur = a->duration;
+          if((dur == 0) && (a->frame != 0))
+          {
+            dur = can_tts_frame_ticks(a->frame, htts->timer_div);
+          }
+          end = start + a->window_ticks + dur;
+
+          if(pass == 1)
+          {
+            report->busy_ticks += dur;
+          }
+
+          if(start < win_end)
+          {
+            first = win_entry;
+          }
+          if(end > win_end)
+          {
+            win_end = end;
+            win_entry = i;
+          }
+          if(end > slot_end[a->txbuf_number])
+          {
+            slot_end[a->txbuf_number] = end;
+            slot_entry[a->txbuf_number] = i;
+          }
+        }
+
+        if((pass == 1) && (first != 0xFF))
+        {
+          if(report->conflict_num == 0)
+          {
+            report->conflict_first = first;
+            report->conflict_second = i;
+          }
+          report->conflict_num++;
+        }
+      }
+    }
+  }
+
+  if(htts->cycle_time != 0)
+  {
+    report->utilization = (uint16_t)((report->busy_ticks * 1000) / (64 * (uint32_t)htts->cycle_time));
+  }
+
+  if(report->conflict_num != 0)
+  {
+    return CAN_APP_ERR_PARAM;
+  }
+
+  return CAN_APP_OK;
+}
+
+/**
+  * @}
+  */
@@ -0,0 +1,281 @@
+/**
+  **************************************************************************
+  * @file     can_application.h
+  * @brief    can application libray header file
+  **************************************************************************
+  *
+  * Copyright (c) 2025, Artery Technology, All rights reserved.
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+/*!< define to prevent recursive inclusion -------------------------------------*/
+#ifndef __CAN_APPLICATION_H
+#define __CAN_APPLICATION_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* includes ------------------------------------------------------------------*/
+#include "at32f422_426.h"
+
+/** @addtogroup AT32F422_426_middlewares_can_application_library
+  * @{
+  */
+
+
+/** @defgroup CAN_library_status_code
+  * @{
+  */
+
+typedef enum
+{
+  CAN_APP_OK = 0,      /*!< no error */
+  CAN_APP_ERR_PARAM,   /*!< invalid parameter */
+  CAN_APP_ERR_FULL,    /*!< software queue is full */
+  CAN_APP_ERR_NOMEM,   /*!< work buffer is too small */
+} can_app_status_type;
+
+/**
+  * @}
+  */
+
+/** @defgroup CAN_library_transmit_queue
+  * @{
+  */
+
+/**
+  * @brief  can transmit queue frame descriptor, the descriptor and the payload
+  *         are owned by the caller until the completion callback of its handle.
+  */
+typedef struct
+{
+  uint32_t                               id;                      /*!< 11 or 29 bits standard or extended identifier */
+  can_identifier_type                    id_type;                 /*!< identifier type                 */
+  can_frame_type                         frame_type;              /*!< data or remote frame            */
+  can_data_length_type                   data_length;             /*!< data length code                */
+#ifdef SUPPORT_CAN_FD
+  can_format_type                        fd_format;               /*!< classic or can-fd format        */
+  can_rate_switch_type                   fd_rate_switch;          /*!< bit rate switch                 */
+#endif
+  confirm_state                          tx_timestamp;            /*!< capture the transmit timestamp  */
+  uint8_t                                handle;                  /*!< frame identification in TSTAT, unique among loaded frames in priority mode */
+  const uint32_t                         *data;                   /*!< word aligned payload, not copied */
+} can_txq_frame_type;
+
+typedef struct can_txq_handle_struct can_txq_handle_type;
+
+/**
+  * @brief  can transmit queue completion callback, called in the interrupt once
+  *         per frame with the TSTAT status of that frame, in transmit order.
+  */
+typedef void (*can_txq_callback_type)(can_txq_handle_type* htxq, uint8_t handle, can_tstat_encoding_type tstat);
+
+struct can_txq_handle_struct
+{
+  can_type                               *canx;                   /*!< can registers base address      */
+  can_stb_transmit_mode_type             stb_mode;                /*!< stb fifo or priority order      */
+  can_txq_frame_type                     **queue;                 /*!< descriptor pointer ring         */
+  uint16_t                               size_mask;               /*!< ring size minus one             */
+  __IO uint16_t                          head;                    /*!< write index, caller side        */
+  __IO uint16_t                          tail;                    /*!< load index, interrupt side      */
+  __IO uint16_t                          done;                    /*!< completion index, oldest frame in the stb */
+  __IO uint8_t                           inflight;                /*!< frames loaded in the stb        */
+  __IO confirm_state                     sending;                 /*!< a TSONE is running              */
+  can_txq_callback_type                  complete_callback;       /*!< per frame completion callback   */
+  __IO uint32_t                          sent_count;              /*!< frames transmitted              */
+  __IO uint32_t                          error_count;             /*!< frames ended with an error      */
+};
+
+/**
+  * @}
+  */
+
+/** @defgroup CAN_library_receive_queue
+  * @{
+  */
+
+/**
+  * @brief  can receive queue, a ring of frame slots filled by
+  *         can_rxq_irq_handler() in the receive interrupt and emptied by
+  *         can_rxq_drain(), one producer and one consumer without lock.
+  */
+typedef struct
+{
+  can_type                               *canx;                   /*!< can registers base address      */
+  can_rxbuf_type                         *slot;                   /*!< preallocated frame slots        */
+  uint16_t                               size_mask;               /*!< number of slots minus one       */
+  __IO uint16_t                          head;                    /*!< write index, interrupt side     */
+  __IO uint16_t                          tail;                    /*!< read index, caller side         */
+  __IO uint16_t                          high_water;              /*!< most frames held at once        */
+  __IO uint32_t                          overflow_count;          /*!< frames dropped on a full ring   */
+} can_rxq_handle_type;
+
+/**
+  * @}
+  */
+
+/** @defgroup CAN_library_filter_compiler
+  * @{
+  */
+
+#define CAN_FILTER_HASH_EMPTY            ((uint32_t)0xFFFFFFFF)   /*!< free second stage hash entry */
+#define CAN_FILTER_HASH_SPAN_MAX         8                        /*!< ranges wider than this stay out of the hash */
+
+/**
+  * @brief  can identifier range, a single identifier has id_low equal to id_high.
+  */
+typedef struct
+{
+  uint32_t                               id_low;                  /*!< first identifier of the range   */
+  uint32_t                               id_high;                 /*!< last identifier of the range    */
+} can_id_range_type;
+
+/**
+  * @brief  one acceptance filter, a mask bit set to 1 means "don't care".
+  *         pair and pair_cost are kept by the compiler while it merges.
+  */
+typedef struct
+{
+  uint32_t                               code;                    /*!< acceptance code                 */
+  uint32_t                               mask;                    /*!< acceptance mask                 */
+  uint32_t                               pair_cost;               /*!< identifiers added by the cheapest merge */
+  uint16_t                               pair;                    /*!< later block of the cheapest merge */
+} can_filter_block_type;
+
+typedef struct
+{
+  can_type                               *canx;                   /*!< can registers base address      */
+  can_identifier_type                    id_type;                 /*!< standard or extended identifiers */
+  const can_id_range_type                *range;                  /*!< identifiers to be received      */
+  uint16_t                               range_num;               /*!< number of ranges                */
+  uint8_t                                filter_num;              /*!< hardware filters used from CAN_FILTER_NUM_0, 1~16 */
+  can_filter_block_type                  *block;                  /*!< compiler work buffer            */
+  uint16_t                               block_size;              /*!< number of entries of block      */
+  uint32_t                               *hash;                   /*!< second stage hash table         */
+  uint16_t                               hash_size;               /*!< entries of hash, a power of 2   */
+  uint16_t                               block_num;               /*!< filters programmed              */
+  uint32_t                               want_count;              /*!< identifiers requested, overlapping extended ranges count twice */
+  uint32_t                               accept_count;            /*!< identifiers passed by hardware  */
+} can_filter_compile_type;
+
+/**
+  * @}
+  */
+
+/** @defgroup CAN_library_ttcan_schedule
+  * @{
+  */
+
+#define CAN_TTS_REPEAT_1                 0x00                     /*!< entry active in every basic cycle */
+#define CAN_TTS_REPEAT_2                 0x01                     /*!< entry active in one of 2 basic cycles */
+#define CAN_TTS_REPEAT_4                 0x03                     /*!< entry active in one of 4 basic cycles */
+#define CAN_TTS_REPEAT_8                 0x07                     /*!< entry active in one of 8 basic cycles */
+#define CAN_TTS_REPEAT_16                0x0F                     /*!< entry active in one of 16 basic cycles */
+#define CAN_TTS_REPEAT_32                0x1F                     /*!< entry active in one of 32 basic cycles */
+#define CAN_TTS_REPEAT_64                0x3F                     /*!< entry active in one of 64 basic cycles */
+#define CAN_TTS_REF_CYCLE_MASK           0x3F                     /*!< cycle count in the first data byte of the reference message */
+#define CAN_TTS_TXBUF_SLOTS              4                        /*!< ttcan txbuf slots, CAN_TTCAN_TXBUF_NUM_0~3 */
+
+/**
+  * @brief  one trigger of the basic cycle, the entries of a schedule are sorted
+  *         by trigger_time.
+  */
+typedef struct
+{
+  uint16_t                               trigger_time;            /*!< cycle time of the trigger, in ttcan ticks */
+  can_ttcan_trigger_type                 trigger_type;            /*!< single shot, merged window start/stop or time trigger */
+  can_ttcan_txbuf_type                   txbuf_number;            /*!< txbuf slot of transmit triggers */
+  uint8_t                                window_ticks;            /*!< transmit enable window minus one, 0~15 */
+  uint8_t                                repeat_mask;             /*!< CAN_TTS_REPEAT_x, cycle count filter */
+  uint8_t                                cycle_offset;            /*!< active when (cycle & repeat_mask) == cycle_offset */
+  uint16_t                               duration;                /*!< bus time reserved for the frame in ticks, 0: computed by the validator */
+  can_txbuf_type                         *frame;                  /*!< frame loaded before the trigger, NULL keeps the slot */
+} can_tts_entry_type;
+
+typedef struct
+{
+  can_type                               *canx;                   /*!< can registers base address      */
+  can_identifier_type                    ref_id_type;             /*!< reference message identifier type */
+  uint32_t                               ref_id;                  /*!< reference message identifier    */
+  can_ttcan_timer_div_type               timer_div;               /*!< ttcan tick in nominal bit times */
+  uint16_t                               cycle_time;              /*!< length of the basic cycle in ticks */
+  uint16_t                               watch_time;              /*!< watch trigger, after the end of the basic cycle */
+  const can_tts_entry_type               *entry;                  /*!< the schedule                    */
+  uint8_t                                entry_num;               /*!< number of entries               */
+  __IO uint8_t                           index;                   /*!< entry armed in the hardware     */
+  __IO uint8_t                           cycle_count;             /*!< basic cycle counter             */
+  __IO uint32_t                          trigger_error_count;     /*!< trigger errors                  */
+  __IO uint32_t                          watch_count;             /*!< cycles without reference message */
+  __IO uint32_t                          missed_count;            /*!< frames replaced before sent     */
+} can_tts_handle_type;
+
+/**
+  * @brief  schedule validation report.
+  */
+typedef struct
+{
+  uint16_t                               conflict_num;            /*!< conflicts over 64 basic cycles  */
+  uint8_t                                conflict_first;          /*!< first entry of the first conflict */
+  uint8_t                                conflict_second;         /*!< second entry of the first conflict */
+  uint8_t                                order_error;             /*!< entries not sorted or beyond the cycle */
+  uint32_t                               busy_ticks;              /*!< ticks reserved over 64 basic cycles */
+  uint16_t                               utilization;             /*!< bus utilization in 1/1000 */
+} can_tts_report_type;
+
+/**
+  * @}
+  */
+
+/** @defgroup CAN_library_exported_functions
+  * @{
+  */
+
+can_app_status_type can_txq_init          (can_txq_handle_type* htxq, can_txq_frame_type** queue_buf, uint16_t queue_size);
+can_app_status_type can_txq_submit        (can_txq_handle_type* htxq, can_txq_frame_type* frame);
+uint16_t            can_txq_pending_get   (can_txq_handle_type* htxq);
+void                can_txq_irq_handler   (can_txq_handle_type* htxq);
+
+can_app_status_type can_rxq_init          (can_rxq_handle_type* hrxq, can_rxbuf_type* slot_buf, uint16_t slot_num);
+uint16_t            can_rxq_irq_handler   (can_rxq_handle_type* hrxq);
+uint16_t            can_rxq_drain         (can_rxq_handle_type* hrxq, can_rxbuf_type frames[], uint16_t max);
+
+can_app_status_type can_filter_compile    (can_filter_compile_type* hflt);
+uint32_t            can_filter_false_accept_ppm_get(can_filter_compile_type* hflt);
+flag_status         can_filter_match      (can_filter_compile_type* hflt, uint32_t id);
+
+void                can_tts_init          (can_tts_handle_type* htts);
+void                can_tts_start         (can_tts_handle_type* htts);
+void                can_tts_irq_handler   (can_tts_handle_type* htts, const can_rxbuf_type* rx_frame);
+uint16_t            can_tts_frame_ticks   (can_txbuf_type* frame, can_ttcan_timer_div_type timer_div);
+can_app_status_type can_tts_validate      (can_tts_handle_type* htts, can_tts_report_type* report);
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
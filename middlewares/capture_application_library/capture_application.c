@@ -0,0 +1,352 @@
+/**
+  **************************************************************************
+  * @file     capture_application.c
+  * @brief    input capture frequency and duty meter application libray source file
+  **************************************************************************
+  *
+  * Copyright (c) 2025, Artery Technology, All rights reserved.
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+#include "capture_application.h"
+#include <math.h>
+
+/** @addtogroup AT32F422_426_middlewares_capture_application_library
+  * @{
+  */
+
+
+/**
+  * @brief  initializes peripherals used by the meter: clocks, gpio, the timer
+  *         counting up with period 0xFFFF and running, and the dma interrupt.
+  *         several meters may share the timer on different channels.
+  * @param  hcap: the handle points to the meter information.
+  * @retval none
+  */
+__WEAK void capture_lowlevel_init(capture_handle_type* hcap)
+{
+
+}
+
+/**
+  * @brief  dma request of a capture channel.
+  * @param  hcap: the handle points to the meter information.
+  * @param  request: the dma request.
+  * @retval 1 if the channel has a dma request, 0 if not.
+  */
+static uint8_t capture_request_get(capture_handle_type* hcap, dma_request_type* request)
+{
+  uint8_t index = hcap->channel / 2;
+
+  if((hcap->channel & 1) || (index > 3))
+  {
+    return 0;
+  }
+
+  if(hcap->tmrx == TMR1)
+  {
+    *request = (dma_request_type)(DMA_REQ_TMR1_CH1 + index);
+  }
+  else if((hcap->tmrx == TMR3) && (index != 1))
+  {
+    *request = (index == 0) ? DMA_REQ_TMR3_CH1 : (dma_request_type)(DMA_REQ_TMR3_CH3 + index - 2);
+  }
+  else if(hcap->tmrx == TMR4)
+  {
+    *request = (index == 3) ? DMA_REQ_TMR4_CH1 : (dma_request_type)(DMA_REQ_TMR4_CH1 + index);
+  }
+  else
+  {
+    return 0;
+  }
+
+  return 1;
+}
+
+/**
+  * @brief  enable the capture at a known input level, the level is read on
+  *         both sides of the enable until it did not change.
+  * @param  hcap: the handle points to the meter information.
+  * @retval none
+  */
+static void capture_channel_sync(capture_handle_type* hcap)
+{
+  uint32_t primask;
+  flag_status level;
+
+  hcap->first = 1;
+  hcap->have_high = 0;
+
+  while(1)
+  {
+    primask = __get_PRIMASK();
+    __disable_irq();
+    level = (hcap->gpio != 0) ? gpio_input_data_bit_read(hcap->gpio, hcap->pin) : RESET;
+    tmr_channel_enable(hcap->tmrx, hcap->channel, TRUE);
+    if((hcap->gpio == 0) || (gpio_input_data_bit_read(hcap->gpio, hcap->pin) == level))
+    {
+      __set_PRIMASK(primask);
+      break;
+    }
+    tmr_channel_enable(hcap->tmrx, hcap->channel, FALSE);
+    __set_PRIMASK(primask);
+  }
+
+  hcap->level = (level == SET) ? 1 : 0;
+}
+
+/**
+  * @brief  measure a block of edges and publish the result. the edges are
+  *         alternately rising and falling, a period ends on a rising edge.
+  * @param  hcap: the handle points to the meter information.
+  * @param  half: 0 for the first block, 1 for the second.
+  * @retval none
+  */
+static void capture_block_done(capture_handle_type* hcap, uint8_t half)
+{
+  const uint16_t *edge = hcap->buf + half * hcap->block;
+  uint16_t pos = hcap->block * 2 - (uint16_t)hcap->dma.channel->dtcnt;
+  uint32_t recapture = TMR_C1_RECAPTURE_FLAG << (hcap->channel / 2);
+  uint16_t period_min = 0xFFFF;
+  uint16_t period_max = 0;
+  uint32_t periods = 0;
+  uint32_t high_sum = 0;
+  uint32_t sum = 0;
+  uint64_t square = 0;
+  uint16_t period;
+  uint16_t delta;
+  uint16_t index;
+  float variance;
+
+  /* a lost edge swaps rising and falling, start again */
+  if(tmr_flag_get(hcap->tmrx, recapture) != RESET)
+  {
+    hcap->lost_count++;
+    capture_stop(hcap);
+    capture_start(hcap);
+    return;
+  }
+
+  if((pos >= hcap->block) != (half == 0))
+  {
+    hcap->overrun_count++;
+  }
+
+  for(index = 0; index < hcap->block; index++)
+  {
+    delta = edge[index] - hcap->last;
+    hcap->last = edge[index];
+
+    if(hcap->first)
+    {
+      hcap->first = 0;
+    }
+    else if(hcap->level)
+    {
+      hcap->high = delta;
+      hcap->have_high = 1;
+    }
+    else if(hcap->have_high)
+    {
+      period = hcap->high + delta;
+      sum += period;
+      high_sum += hcap->high;
+      square += (uint32_t)period * period;
+      periods++;
+      if(period < period_min)
+      {
+        period_min = period;
+      }
+      if(period > period_max)
+      {
+        period_max = period;
+      }
+    }
+    hcap->level ^= 1;
+  }
+
+  hcap->seq++;
+  __DMB();
+  hcap->result.periods = (uint16_t)periods;
+  hcap->result.update++;
+  if(periods != 0)
+  {
+    variance = (float)(square * periods - (uint64_t)sum * sum) / ((float)periods * periods);
+    hcap->result.frequency = (float)hcap->clock * periods / sum;
+    hcap->result.duty = (float)high_sum / sum;
+    hcap->result.jitter = sqrtf(variance) / hcap->clock;
+    hcap->result.period_min = period_min;
+    hcap->result.period_max = period_max;
+  }
+  else
+  {
+    hcap->result.frequency = 0;
+    hcap->result.duty = 0;
+    hcap->result.jitter = 0;
+    hcap->result.period_min = 0;
+    hcap->result.period_max = 0;
+  }
+  __DMB();
+  hcap->seq++;
+}
+
+/**
+  * @brief  dma half transfer, the first block is complete.
+  * @param  hdma: the dma handle, first member of the meter handle.
+  * @param  desc: the loop mode descriptor.
+  * @retval none
+  */
+static void capture_half_callback(dma_handle_type* hdma, dma_desc_type* desc)
+{
+  capture_block_done((capture_handle_type *)hdma, 0);
+}
+
+/**
+  * @brief  dma full transfer, the second block is complete.
+  * @param  hdma: the dma handle, first member of the meter handle.
+  * @param  desc: the loop mode descriptor.
+  * @retval none
+  */
+static void capture_full_callback(dma_handle_type* hdma, dma_desc_type* desc)
+{
+  capture_block_done((capture_handle_type *)hdma, 1);
+}
+
+/**
+  * @brief  meter initialization, calls capture_lowlevel_init() then sets the
+  *         channel to capture both edges and the dma to copy every capture in
+  *         loop mode over two blocks.
+  * @note   the interrupt of hcap->dma.channel_index should call
+  *         dma_irq_handler(&hcap->dma). the periods must be shorter than the
+  *         timer period. without hcap->gpio the first edge is taken as rising
+  *         and the duty may be the one of the low time.
+  * @param  hcap: the handle points to the meter information, tmrx, channel,
+  *         filter, clock, gpio and pin set by the caller.
+  * @param  buf: two blocks, 2 * block timestamps.
+  * @param  block: edges in one block, the result is published once a block.
+  * @retval capture status.
+  */
+capture_status_type capture_init(capture_handle_type* hcap, uint16_t* buf, uint16_t block)
+{
+  tmr_input_config_type input_struct;
+  dma_init_type dma_init_struct;
+  dma_request_type request;
+
+  if((buf == 0) || (block < 2) || (block > 0x7FFF) || (hcap->clock == 0) || \
+     (capture_request_get(hcap, &request) == 0))
+  {
+    return CAPTURE_ERR_PARAM;
+  }
+
+  hcap->buf = buf;
+  hcap->block = block;
+
+  capture_lowlevel_init(hcap);
+
+  if(dma_channel_alloc(&hcap->dma, request) != DMA_APP_OK)
+  {
+    return CAPTURE_ERR_BUSY;
+  }
+  hcap->dma.half_callback = capture_half_callback;
+  hcap->dma.full_callback = capture_full_callback;
+  hcap->dma.error_callback = 0;
+
+  dma_default_para_init(&dma_init_struct);
+  dma_init_struct.buffer_size = block * 2;
+  dma_init_struct.direction = DMA_DIR_PERIPHERAL_TO_MEMORY;
+  dma_init_struct.memory_base_addr = (uint32_t)buf;
+  dma_init_struct.memory_data_width = DMA_MEMORY_DATA_WIDTH_HALFWORD;
+  dma_init_struct.memory_inc_enable = TRUE;
+  dma_init_struct.peripheral_base_addr = (uint32_t)&hcap->tmrx->c1dt + (hcap->channel / 2) * 4;
+  dma_init_struct.peripheral_data_width = DMA_PERIPHERAL_DATA_WIDTH_HALFWORD;
+  dma_init_struct.peripheral_inc_enable = FALSE;
+  dma_init_struct.priority = DMA_PRIORITY_VERY_HIGH;
+  dma_init_struct.loop_mode_enable = TRUE;
+  dma_desc_build(&hcap->desc, &dma_init_struct);
+
+  input_struct.input_channel_select = hcap->channel;
+  input_struct.input_polarity_select = TMR_INPUT_BOTH_EDGE;
+  input_struct.input_mapped_select = TMR_CC_CHANNEL_MAPPED_DIRECT;
+  input_struct.input_filter_value = hcap->filter;
+  tmr_input_channel_init(hcap->tmrx, &input_struct, TMR_CHANNEL_INPUT_DIV_1);
+  tmr_channel_enable(hcap->tmrx, hcap->channel, FALSE);
+
+  return CAPTURE_OK;
+}
+
+/**
+  * @brief  stop the meter and give the dma channel back.
+  * @param  hcap: the handle points to the meter information.
+  * @retval none
+  */
+void capture_deinit(capture_handle_type* hcap)
+{
+  capture_stop(hcap);
+  dma_channel_free(&hcap->dma);
+}
+
+/**
+  * @brief  start capturing edges.
+  * @param  hcap: the handle points to the meter information.
+  * @retval none
+  */
+void capture_start(capture_handle_type* hcap)
+{
+  uint8_t index = hcap->channel / 2;
+
+  tmr_flag_clear(hcap->tmrx, (TMR_C1_FLAG | TMR_C1_RECAPTURE_FLAG) << index);
+  dma_chain_start(&hcap->dma, &hcap->desc);
+  tmr_dma_request_enable(hcap->tmrx, (tmr_dma_request_type)(TMR_C1_DMA_REQUEST << index), TRUE);
+  capture_channel_sync(hcap);
+}
+
+/**
+  * @brief  stop capturing edges, the timer keeps running.
+  * @param  hcap: the handle points to the meter information.
+  * @retval none
+  */
+void capture_stop(capture_handle_type* hcap)
+{
+  tmr_channel_enable(hcap->tmrx, hcap->channel, FALSE);
+  tmr_dma_request_enable(hcap->tmrx, (tmr_dma_request_type)(TMR_C1_DMA_REQUEST << (hcap->channel / 2)), FALSE);
+  dma_chain_stop(&hcap->dma);
+}
+
+/**
+  * @brief  copy the last published result, without locking. the copy is taken
+  *         again only when a block was published during it.
+  * @param  hcap: the handle points to the meter information.
+  * @param  result: destination.
+  * @retval none
+  */
+void capture_result_get(capture_handle_type* hcap, capture_result_type* result)
+{
+  uint32_t seq;
+
+  do
+  {
+    seq = hcap->seq;
+    __DMB();
+    *result = hcap->result;
+    __DMB();
+  } while((seq & 1) || (seq != hcap->seq));
+}
+
+/**
+  * @}
+  */
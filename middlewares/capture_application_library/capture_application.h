@@ -0,0 +1,135 @@
+/**
+  **************************************************************************
+  * @file     capture_application.h
+  * @brief    input capture frequency and duty meter application libray header file
+  **************************************************************************
+  *
+  * Copyright (c) 2025, Artery Technology, All rights reserved.
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+/*!< define to prevent recursive inclusion -------------------------------------*/
+#ifndef __CAPTURE_APPLICATION_H
+#define __CAPTURE_APPLICATION_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* includes ------------------------------------------------------------------*/
+#include "at32f422_426.h"
+#include "dma_application.h"
+
+/** @addtogroup AT32F422_426_middlewares_capture_application_library
+  * @{
+  */
+
+
+/** @defgroup CAPTURE_library_status_code
+  * @{
+  */
+
+typedef enum
+{
+  CAPTURE_OK = 0,         /*!< no error */
+  CAPTURE_ERR_PARAM,      /*!< invalid parameter */
+  CAPTURE_ERR_BUSY,       /*!< no dma channel left */
+} capture_status_type;
+
+/**
+  * @}
+  */
+
+/** @defgroup CAPTURE_library_result
+  * @{
+  */
+
+/**
+  * @brief  measurement of the periods that ended in one block of edges.
+  */
+typedef struct
+{
+  float                                  frequency;               /*!< mean frequency in hz, 0 without a period */
+  float                                  duty;                    /*!< high time over period, 0 ~ 1    */
+  float                                  jitter;                  /*!< standard deviation of the period in seconds */
+  uint16_t                               period_min;              /*!< shortest period in timer counts */
+  uint16_t                               period_max;              /*!< longest period in timer counts  */
+  uint16_t                               periods;                 /*!< number of periods               */
+  uint32_t                               update;                  /*!< blocks measured since the start */
+} capture_result_type;
+
+/**
+  * @}
+  */
+
+/** @defgroup CAPTURE_library_handle
+  * @{
+  */
+
+typedef struct
+{
+  dma_handle_type                        dma;                     /*!< capture dma, first member       */
+  dma_desc_type                          desc;                    /*!< loop mode register image        */
+  tmr_type                               *tmrx;                   /*!< free running timer, TMR1, TMR3 or TMR4 */
+  tmr_channel_select_type                channel;                 /*!< capture channel                 */
+  uint8_t                                filter;                  /*!< input filter value              */
+  uint32_t                               clock;                   /*!< timer counts per second         */
+  gpio_type                              *gpio;                   /*!< pin of the input, NULL if the level is not read */
+  uint16_t                               pin;                     /*!< pin of the input                */
+  uint16_t                               *buf;                    /*!< two blocks of edge timestamps   */
+  uint16_t                               block;                   /*!< edges in one block              */
+  uint16_t                               last;                    /*!< timestamp of the last edge      */
+  uint8_t                                level;                   /*!< input level after the last edge */
+  uint8_t                                first;                   /*!< no edge since the start         */
+  uint8_t                                have_high;               /*!< high time of this period known  */
+  uint16_t                               high;                    /*!< high time of this period        */
+  __IO uint32_t                          seq;                     /*!< result sequence, odd while written */
+  capture_result_type                    result;                  /*!< published result                */
+  __IO uint32_t                          lost_count;              /*!< restarts after a lost edge      */
+  __IO uint32_t                          overrun_count;           /*!< blocks overwritten before measured */
+} capture_handle_type;
+
+/**
+  * @}
+  */
+
+/** @defgroup CAPTURE_library_exported_functions
+  * @{
+  */
+
+void                capture_lowlevel_init (capture_handle_type* hcap);
+capture_status_type capture_init          (capture_handle_type* hcap, uint16_t* buf, uint16_t block);
+void                capture_deinit        (capture_handle_type* hcap);
+void                capture_start         (capture_handle_type* hcap);
+void                capture_stop          (capture_handle_type* hcap);
+void                capture_result_get    (capture_handle_type* hcap, capture_result_type* result);
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,457 @@
+/**
+  **************************************************************************
+  * @file     crc_application.c
+  * @brief    crc calculation application libray source file
+  **************************************************************************
+  *
+  * Copyright (c) 2025, Artery Technology, All rights reserved.
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+#include "crc_application.h"
+
+/** @addtogroup AT32F422_426_middlewares_crc_application_library
+  * @{
+  */
+
+
+/**
+  * @brief word and byte access to the crc data register, a host test may
+  *        define them to see the data written.
+  */
+#ifndef CRC_DT32
+#define CRC_DT32                         (CRC->dt)
+#endif
+#ifndef CRC_DT8
+#define CRC_DT8                          (*(__IO uint8_t *)&CRC->dt)
+#endif
+
+/**
+  * @brief preset models, same order as crc_preset_type
+  */
+const crc_model_type crc_model_table[CRC_PRESET_NUM] =
+{
+  {0x04C11DB7, 0xFFFFFFFF, 0xFFFFFFFF, 32, TRUE},
+  {0x00001021, 0x0000FFFF, 0x00000000, 16, FALSE},
+  {0x00000007, 0x00000000, 0x00000000,  8, FALSE},
+  {0x00008005, 0x0000FFFF, 0x00000000, 16, TRUE},
+};
+
+/**
+  * @brief  reverse the low bits of a value.
+  * @param  value: value to reverse.
+  * @param  width: number of bits.
+  * @retval reversed value.
+  */
+static uint32_t crc_bits_reverse(uint32_t value, uint8_t width)
+{
+  uint32_t result = 0;
+
+  while(width--)
+  {
+    result = (result << 1) | (value & 1);
+    value >>= 1;
+  }
+  return result;
+}
+
+/**
+  * @brief  mask of the crc width.
+  * @param  model: crc model.
+  * @retval mask.
+  */
+static uint32_t crc_width_mask(const crc_model_type* model)
+{
+  return (model->width == 32) ? 0xFFFFFFFF : ((1UL << model->width) - 1);
+}
+
+/**
+  * @brief  feed bytes to the crc unit. a reflected model switches the input
+  *         reversal to bytes for the 8-bit writes.
+  * @param  hcrc: the handle points to the crc information.
+  * @param  pbuffer: data.
+  * @param  length: number of bytes.
+  * @retval none.
+  */
+static void crc_bytes_feed(crc_handle_type* hcrc, const uint8_t* pbuffer, uint32_t length)
+{
+  if(length == 0)
+  {
+    return;
+  }
+
+  if(hcrc->model->reflect)
+  {
+    crc_reverse_input_data_set(CRC_REVERSE_INPUT_BY_BYTE);
+  }
+  while(length--)
+  {
+    CRC_DT8 = *pbuffer++;
+  }
+  if(hcrc->model->reflect)
+  {
+    crc_reverse_input_data_set(CRC_REVERSE_INPUT_BY_WORD);
+  }
+}
+
+static void crc_dma_chunk_start(crc_handle_type* hcrc);
+
+/**
+  * @brief  dma transfer complete, start the next descriptor or feed the tail.
+  * @param  hdma: the dma handle, first member of the crc handle.
+  * @param  desc: the finished descriptor.
+  * @retval none.
+  */
+static void crc_dma_full_callback(dma_handle_type* hdma, dma_desc_type* desc)
+{
+  crc_handle_type *hcrc = (crc_handle_type *)hdma;
+
+  if(hcrc->remain != 0)
+  {
+    desc->maddr += desc->dtcnt * (hcrc->model->reflect ? 4 : 1);
+    crc_dma_chunk_start(hcrc);
+    return;
+  }
+
+  crc_bytes_feed(hcrc, hcrc->tail, hcrc->tail_len);
+  hcrc->status = CRC_APP_OK;
+  hcrc->busy = 0;
+  if(hcrc->callback != 0)
+  {
+    hcrc->callback(hcrc);
+  }
+}
+
+/**
+  * @brief  dma transfer error, the calculation is lost.
+  * @param  hdma: the dma handle, first member of the crc handle.
+  * @param  desc: the failed descriptor.
+  * @retval none.
+  */
+static void crc_dma_error_callback(dma_handle_type* hdma, dma_desc_type* desc)
+{
+  crc_handle_type *hcrc = (crc_handle_type *)hdma;
+
+  hcrc->status = CRC_APP_ERR_DMA;
+  hcrc->busy = 0;
+  if(hcrc->callback != 0)
+  {
+    hcrc->callback(hcrc);
+  }
+}
+
+/**
+  * @brief  start the next dma descriptor, at most CRC_APP_DMA_MAX data.
+  * @param  hcrc: the handle points to the crc information.
+  * @retval none.
+  */
+static void crc_dma_chunk_start(crc_handle_type* hcrc)
+{
+  uint32_t number = (hcrc->remain > CRC_APP_DMA_MAX) ? CRC_APP_DMA_MAX : hcrc->remain;
+
+  hcrc->desc.dtcnt = number;
+  hcrc->remain -= number;
+  dma_chain_start(&hcrc->dma, &hcrc->desc);
+}
+
+/**
+  * @brief  select a preset model and build the software table, the hardware is
+  *         not touched. enough for crc_app_soft_calculate().
+  * @param  hcrc: the handle points to the crc information.
+  * @param  preset: crc model.
+  * @retval crc application status.
+  */
+crc_app_status_type crc_app_model_set(crc_handle_type* hcrc, crc_preset_type preset)
+{
+  const crc_model_type *model;
+  uint32_t poly, value, i, bit;
+
+  if((preset >= CRC_PRESET_NUM) || hcrc->busy)
+  {
+    return CRC_APP_ERR_PARAM;
+  }
+
+  model = &crc_model_table[preset];
+  hcrc->model = model;
+
+  /* nibble table, reflected models shift right, the others work on the top bits */
+  if(model->reflect)
+  {
+    poly = crc_bits_reverse(model->poly, model->width);
+    for(i = 0; i < 16; i++)
+    {
+      value = i;
+      for(bit = 0; bit < 4; bit++)
+      {
+        value = (value & 1) ? ((value >> 1) ^ poly) : (value >> 1);
+      }
+      hcrc->table[i] = value;
+    }
+  }
+  else
+  {
+    poly = model->poly << (32 - model->width);
+    for(i = 0; i < 16; i++)
+    {
+      value = i << 28;
+      for(bit = 0; bit < 4; bit++)
+      {
+        value = (value & 0x80000000) ? ((value << 1) ^ poly) : (value << 1);
+      }
+      hcrc->table[i] = value;
+    }
+  }
+
+  return CRC_APP_OK;
+}
+
+/**
+  * @brief  select a preset model, build the software table, enable the crc unit and
+  *         allocate a memory to memory dma channel. the handle is zeroed before the first call.
+  * @note   the interrupt of hcrc->dma.channel_index should call dma_irq_handler(&hcrc->dma).
+  *         without a free dma channel the calculations run on the cpu only.
+  * @param  hcrc: the handle points to the crc information.
+  * @param  preset: crc model.
+  * @retval crc application status.
+  */
+crc_app_status_type crc_app_init(crc_handle_type* hcrc, crc_preset_type preset)
+{
+  crc_app_status_type status;
+
+  status = crc_app_model_set(hcrc, preset);
+  if(status != CRC_APP_OK)
+  {
+    return status;
+  }
+
+  crm_periph_clock_enable(CRM_CRC_PERIPH_CLOCK, TRUE);
+  crm_periph_clock_enable(CRM_DMA1_PERIPH_CLOCK, TRUE);
+
+  if(hcrc->dma.channel == 0)
+  {
+    dma_channel_alloc(&hcrc->dma, DMA_REQ_MEM2MEM);
+  }
+  hcrc->dma.half_callback = 0;
+  hcrc->dma.full_callback = crc_dma_full_callback;
+  hcrc->dma.error_callback = crc_dma_error_callback;
+  hcrc->status = CRC_APP_OK;
+
+  return CRC_APP_OK;
+}
+
+/**
+  * @brief  program the crc unit with the model and load the initial value.
+  *         the unit may be shared, every calculation begins here.
+  * @param  hcrc: the handle points to the crc information.
+  * @retval none.
+  */
+void crc_app_start(crc_handle_type* hcrc)
+{
+  const crc_model_type *model = hcrc->model;
+
+  crc_poly_size_set((model->width == 32) ? CRC_POLY_SIZE_32B :
+                    (model->width == 16) ? CRC_POLY_SIZE_16B : CRC_POLY_SIZE_8B);
+  crc_poly_value_set(model->poly);
+  crc_reverse_input_data_set(model->reflect ? CRC_REVERSE_INPUT_BY_WORD : CRC_REVERSE_INPUT_NO_AFFECTE);
+  crc_reverse_output_data_set(model->reflect ? CRC_REVERSE_OUTPUT_DATA : CRC_REVERSE_OUTPUT_NO_AFFECTE);
+  crc_init_data_set(model->init);
+  crc_data_reset();
+}
+
+/**
+  * @brief  feed a buffer of any alignment and length by the cpu. the aligned
+  *         middle goes in words, byte swapped for the models that are not reflected.
+  * @param  hcrc: the handle points to the crc information.
+  * @param  pbuffer: data.
+  * @param  length: number of bytes.
+  * @retval none.
+  */
+void crc_app_update(crc_handle_type* hcrc, const void* pbuffer, uint32_t length)
+{
+  const uint8_t *pdata = (const uint8_t *)pbuffer;
+  const uint32_t *pword;
+  uint32_t head, words;
+
+  head = (4 - ((uint32_t)pdata & 3)) & 3;
+  if(head > length)
+  {
+    head = length;
+  }
+  crc_bytes_feed(hcrc, pdata, head);
+  pdata += head;
+  length -= head;
+
+  pword = (const uint32_t *)pdata;
+  words = length >> 2;
+  if(hcrc->model->reflect)
+  {
+    while(words--)
+    {
+      CRC_DT32 = *pword++;
+    }
+  }
+  else
+  {
+    while(words--)
+    {
+      CRC_DT32 = __REV(*pword++);
+    }
+  }
+
+  crc_bytes_feed(hcrc, (const uint8_t *)pword, length & 3);
+}
+
+/**
+  * @brief  feed a buffer by the dma, the cpu is free until the callback. a
+  *         reflected model moves words, the others move bytes since the dma
+  *         cannot swap them. blocks shorter than CRC_APP_DMA_MIN are fed by
+  *         the cpu and the callback is called at once.
+  * @param  hcrc: the handle points to the crc information.
+  * @param  pbuffer: data, untouched until the callback.
+  * @param  length: number of bytes.
+  * @param  callback: completion callback, may be NULL, then poll hcrc->busy.
+  * @retval crc application status.
+  */
+crc_app_status_type crc_app_update_dma(crc_handle_type* hcrc, const void* pbuffer, uint32_t length, crc_callback_type callback)
+{
+  const uint8_t *pdata = (const uint8_t *)pbuffer;
+  dma_init_type dma_init_struct;
+  uint32_t head = 0;
+
+  if(hcrc->busy)
+  {
+    return CRC_APP_ERR_BUSY;
+  }
+  if(hcrc->dma.channel == 0)
+  {
+    return CRC_APP_ERR_PARAM;
+  }
+
+  hcrc->callback = callback;
+  if(length < CRC_APP_DMA_MIN)
+  {
+    crc_app_update(hcrc, pbuffer, length);
+    hcrc->status = CRC_APP_OK;
+    if(callback != 0)
+    {
+      callback(hcrc);
+    }
+    return CRC_APP_OK;
+  }
+
+  dma_default_para_init(&dma_init_struct);
+  dma_init_struct.direction = DMA_DIR_MEMORY_TO_PERIPHERAL;
+  dma_init_struct.peripheral_base_addr = (uint32_t)&CRC->dt;
+  dma_init_struct.peripheral_inc_enable = FALSE;
+  dma_init_struct.memory_inc_enable = TRUE;
+  dma_init_struct.priority = DMA_PRIORITY_LOW;
+  dma_init_struct.loop_mode_enable = FALSE;
+  if(hcrc->model->reflect)
+  {
+    head = (4 - ((uint32_t)pdata & 3)) & 3;
+    crc_bytes_feed(hcrc, pdata, head);
+    hcrc->remain = (length - head) >> 2;
+    hcrc->tail = pdata + head + (hcrc->remain << 2);
+    hcrc->tail_len = (length - head) & 3;
+    dma_init_struct.peripheral_data_width = DMA_PERIPHERAL_DATA_WIDTH_WORD;
+    dma_init_struct.memory_data_width = DMA_MEMORY_DATA_WIDTH_WORD;
+  }
+  else
+  {
+    hcrc->remain = length;
+    hcrc->tail_len = 0;
+    dma_init_struct.peripheral_data_width = DMA_PERIPHERAL_DATA_WIDTH_BYTE;
+    dma_init_struct.memory_data_width = DMA_MEMORY_DATA_WIDTH_BYTE;
+  }
+  dma_init_struct.memory_base_addr = (uint32_t)(pdata + head);
+  dma_desc_build(&hcrc->desc, &dma_init_struct);
+
+  hcrc->busy = 1;
+  crc_dma_chunk_start(hcrc);
+
+  return CRC_APP_OK;
+}
+
+/**
+  * @brief  read the result of the data fed since crc_app_start().
+  * @param  hcrc: the handle points to the crc information.
+  * @retval crc value.
+  */
+uint32_t crc_app_result_get(crc_handle_type* hcrc)
+{
+  return (crc_data_get() ^ hcrc->model->xor_out) & crc_width_mask(hcrc->model);
+}
+
+/**
+  * @brief  calculate the crc of a buffer by the cpu.
+  * @param  hcrc: the handle points to the crc information.
+  * @param  pbuffer: data.
+  * @param  length: number of bytes.
+  * @retval crc value.
+  */
+uint32_t crc_app_calculate(crc_handle_type* hcrc, const void* pbuffer, uint32_t length)
+{
+  crc_app_start(hcrc);
+  crc_app_update(hcrc, pbuffer, length);
+  return crc_app_result_get(hcrc);
+}
+
+/**
+  * @brief  calculate the crc of a buffer in software with the nibble table,
+  *         bit exact with the crc unit. does not touch the hardware, the handle
+  *         needs crc_app_model_set() only.
+  * @param  hcrc: the handle points to the crc information.
+  * @param  pbuffer: data.
+  * @param  length: number of bytes.
+  * @retval crc value.
+  */
+uint32_t crc_app_soft_calculate(crc_handle_type* hcrc, const void* pbuffer, uint32_t length)
+{
+  const crc_model_type *model = hcrc->model;
+  const uint8_t *pdata = (const uint8_t *)pbuffer;
+  const uint32_t *table = hcrc->table;
+  uint32_t crc;
+
+  if(model->reflect)
+  {
+    crc = crc_bits_reverse(model->init, model->width);
+    while(length--)
+    {
+      crc ^= *pdata++;
+      crc = (crc >> 4) ^ table[crc & 0x0F];
+      crc = (crc >> 4) ^ table[crc & 0x0F];
+    }
+  }
+  else
+  {
+    crc = model->init << (32 - model->width);
+    while(length--)
+    {
+      crc ^= (uint32_t)*pdata++ << 24;
+      crc = (crc << 4) ^ table[crc >> 28];
+      crc = (crc << 4) ^ table[crc >> 28];
+    }
+    crc >>= (32 - model->width);
+  }
+
+  return (crc ^ model->xor_out) & crc_width_mask(model);
+}
+
+/**
+  * @}
+  */
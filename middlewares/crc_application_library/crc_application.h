@@ -0,0 +1,156 @@
+/**
+  **************************************************************************
+  * @file     crc_application.h
+  * @brief    crc calculation application libray header file
+  **************************************************************************
+  *
+  * Copyright (c) 2025, Artery Technology, All rights reserved.
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+/*!< define to prevent recursive inclusion -------------------------------------*/
+#ifndef __CRC_APPLICATION_H
+#define __CRC_APPLICATION_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* includes ------------------------------------------------------------------*/
+#include "at32f422_426.h"
+#include "dma_application.h"
+
+/** @addtogroup AT32F422_426_middlewares_crc_application_library
+  * @{
+  */
+
+
+/** @defgroup CRC_library_definition
+  * @{
+  */
+
+#define CRC_APP_DMA_MIN                  64                       /*!< shorter blocks are fed by the cpu */
+#define CRC_APP_DMA_MAX                  0xFFFF                   /*!< data of one dma descriptor      */
+
+/**
+  * @}
+  */
+
+/** @defgroup CRC_library_status_code
+  * @{
+  */
+
+typedef enum
+{
+  CRC_APP_OK = 0,      /*!< no error */
+  CRC_APP_ERR_PARAM,   /*!< invalid parameter */
+  CRC_APP_ERR_BUSY,    /*!< dma calculation ongoing */
+  CRC_APP_ERR_DMA,     /*!< dma transfer error */
+} crc_app_status_type;
+
+/**
+  * @}
+  */
+
+/** @defgroup CRC_library_model
+  * @{
+  */
+
+typedef enum
+{
+  CRC_PRESET_CRC32 = 0,  /*!< crc-32, iso-hdlc, zlib */
+  CRC_PRESET_CRC16_CCITT,/*!< crc-16/ccitt-false, poly 0x1021 init 0xffff */
+  CRC_PRESET_CRC8,       /*!< crc-8/smbus, poly 0x07 */
+  CRC_PRESET_MODBUS,     /*!< crc-16/modbus, poly 0x8005 reflected */
+  CRC_PRESET_NUM,
+} crc_preset_type;
+
+/**
+  * @brief  crc model in the rocksoft form, input and output reflection are the same.
+  */
+typedef struct
+{
+  uint32_t                               poly;                    /*!< polynomial, normal form          */
+  uint32_t                               init;                    /*!< register initial value          */
+  uint32_t                               xor_out;                 /*!< xor applied to the result       */
+  uint8_t                                width;                   /*!< 8, 16 or 32 bits                */
+  confirm_state                          reflect;                 /*!< reflected input and output      */
+} crc_model_type;
+
+/**
+  * @}
+  */
+
+/** @defgroup CRC_library_handle
+  * @{
+  */
+
+typedef struct crc_handle_struct crc_handle_type;
+
+/**
+  * @brief  dma calculation completion callback, called in the interrupt.
+  */
+typedef void (*crc_callback_type)(crc_handle_type* hcrc);
+
+struct crc_handle_struct
+{
+  dma_handle_type                        dma;                     /*!< memory to crc dma, first member */
+  dma_desc_type                          desc;                    /*!< dma register image              */
+  const crc_model_type                   *model;                  /*!< model of the calculation        */
+  uint32_t                               table[16];               /*!< nibble table of the software path */
+  const uint8_t                          *tail;                   /*!< bytes fed by the cpu after the dma */
+  uint32_t                               remain;                  /*!< dma data not yet started        */
+  uint8_t                                tail_len;                /*!< number of tail bytes            */
+  crc_callback_type                      callback;                /*!< dma completion callback         */
+  __IO crc_app_status_type               status;                  /*!< status of the dma calculation   */
+  __IO uint8_t                           busy;                    /*!< dma calculation ongoing         */
+};
+
+/**
+  * @}
+  */
+
+extern const crc_model_type crc_model_table[CRC_PRESET_NUM];
+
+/** @defgroup CRC_library_exported_functions
+  * @{
+  */
+
+crc_app_status_type crc_app_model_set     (crc_handle_type* hcrc, crc_preset_type preset);
+crc_app_status_type crc_app_init          (crc_handle_type* hcrc, crc_preset_type preset);
+void                crc_app_start         (crc_handle_type* hcrc);
+void                crc_app_update        (crc_handle_type* hcrc, const void* pbuffer, uint32_t length);
+crc_app_status_type crc_app_update_dma    (crc_handle_type* hcrc, const void* pbuffer, uint32_t length, crc_callback_type callback);
+uint32_t            crc_app_result_get    (crc_handle_type* hcrc);
+uint32_t            crc_app_calculate     (crc_handle_type* hcrc, const void* pbuffer, uint32_t length);
+uint32_t            crc_app_soft_calculate(crc_handle_type* hcrc, const void* pbuffer, uint32_t length);
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,413 @@
+/**
+  **************************************************************************
+  * @file     dma_application.c
+  * @brief    the driver library of the dma transfer service
+  **************************************************************************
+  *
+  * Copyright (c) 2025, Artery Technology, All rights reserved.
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+#include "dma_application.h"
+
+/** @addtogroup AT32F422_426_middlewares_dma_application_library
+  * @{
+  */
+
+
+/**
+  * @brief dma channel number and registers
+  */
+#define DMA_CHANNEL_NUM                  7
+#define DMA_CHANNEL_GET(index)           ((dma_channel_type *)(DMA1_CHANNEL1_BASE + 0x14 * ((index) - 1)))
+
+/**
+  * @brief get the flags of a channel, index 1~7
+  */
+#define DMA_GET_GL_FLAG(index)           (DMA1_GL1_FLAG << (((index) - 1) * 4))
+#define DMA_GET_TC_FLAG(index)           (DMA1_FDT1_FLAG << (((index) - 1) * 4))
+#define DMA_GET_HT_FLAG(index)           (DMA1_HDT1_FLAG << (((index) - 1) * 4))
+#define DMA_GET_TERR_FLAG(index)         (DMA1_DTERR1_FLAG << (((index) - 1) * 4))
+
+/**
+  * @brief ctrl register fields of a descriptor image
+  */
+#define DMA_CTRL_CHEN                    ((uint32_t)0x00000001)
+#define DMA_CTRL_INT_MASK                (DMA_FDT_INT | DMA_HDT_INT | DMA_DTERR_INT)
+#define DMA_CTRL_LM                      ((uint32_t)0x00000020)
+#define DMA_CTRL_M2M                     ((uint32_t)0x00004000)
+
+/**
+  * @brief one way to route a request: the channel and the scfg remap bits it needs
+  */
+typedef struct
+{
+  dma_request_type                       request;
+  uint8_t                                channel_index;
+  uint32_t                               rmp_mask;
+  uint32_t                               rmp_value;
+} dma_route_type;
+
+/**
+  * @brief request routes, the default mapping of a request is listed first
+  */
+static const dma_route_type dma_route_table[] =
+{
+  {DMA_REQ_ADC,           1, SCFG_ADC_DMA_RMP,       0},
+  {DMA_REQ_ADC,           2, SCFG_ADC_DMA_RMP,       SCFG_ADC_DMA_RMP},
+  {DMA_REQ_SPI1_RX,       2, 0,                      0},
+  {DMA_REQ_SPI1_TX,       3, 0,                      0},
+  {DMA_REQ_SPI2_RX,       4, SCFG_SPI2_DMA_RMP,      0},
+  {DMA_REQ_SPI2_RX,       6, SCFG_SPI2_DMA_RMP,      SCFG_SPI2_DMA_RMP},
+  {DMA_REQ_SPI2_TX,       5, SCFG_SPI2_DMA_RMP,      0},
+  {DMA_REQ_SPI2_TX,       7, SCFG_SPI2_DMA_RMP,      SCFG_SPI2_DMA_RMP},
+  {DMA_REQ_USART1_TX,     2, SCFG_USART1_TX_DMA_RMP, 0},
+  {DMA_REQ_USART1_TX,     4, SCFG_USART1_TX_DMA_RMP, SCFG_USART1_TX_DMA_RMP},
+  {DMA_REQ_USART1_RX,     3, SCFG_USART1_RX_DMA_RMP, 0},
+  {DMA_REQ_USART1_RX,     5, SCFG_USART1_RX_DMA_RMP, SCFG_USART1_RX_DMA_RMP},
+  {DMA_REQ_USART2_TX,     4, SCFG_USART2_DMA_RMP,    0},
+  {DMA_REQ_USART2_TX,     7, SCFG_USART2_DMA_RMP,    SCFG_USART2_DMA_RMP},
+  {DMA_REQ_USART2_RX,     5, SCFG_USART2_DMA_RMP,    0},
+  {DMA_REQ_USART2_RX,     6, SCFG_USART2_DMA_RMP,    SCFG_USART2_DMA_RMP},
+  {DMA_REQ_I2C1_TX,       2, SCFG_I2C1_DMA_RMP,      0},
+  {DMA_REQ_I2C1_TX,       6, SCFG_I2C1_DMA_RMP,      SCFG_I2C1_DMA_RMP},
+  {DMA_REQ_I2C1_RX,       3, SCFG_I2C1_DMA_RMP,      0},
+  {DMA_REQ_I2C1_RX,       7, SCFG_I2C1_DMA_RMP,      SCFG_I2C1_DMA_RMP},
+  {DMA_REQ_I2C2_TX,       4, 0,                      0},
+  {DMA_REQ_I2C2_RX,       5, 0,                      0},
+  {DMA_REQ_TMR1_CH1,      2, SCFG_TMR1_DMA_RMP,      0},
+  {DMA_REQ_TMR1_CH1,      6, SCFG_TMR1_DMA_RMP,      SCFG_TMR1_DMA_RMP},
+  {DMA_REQ_TMR1_CH2,      3, SCFG_TMR1_DMA_RMP,      0},
+  {DMA_REQ_TMR1_CH2,      6, SCFG_TMR1_DMA_RMP,      SCFG_TMR1_DMA_RMP},
+  {DMA_REQ_TMR1_CH3,      5, SCFG_TMR1_DMA_RMP,      0},
+  {DMA_REQ_TMR1_CH3,      6, SCFG_TMR1_DMA_RMP,      SCFG_TMR1_DMA_RMP},
+  {DMA_REQ_TMR1_CH4,      4, 0,                      0},
+  {DMA_REQ_TMR1_OVERFLOW, 5, 0,                      0},
+  {DMA_REQ_TMR3_CH1,      4, SCFG_TMR3_DMA_RMP,      0},
+  {DMA_REQ_TMR3_CH1,      6, SCFG_TMR3_DMA_RMP,      SCFG_TMR3_DMA_RMP},
+  {DMA_REQ_TMR3_CH3,      2, 0,                      0},
+  {DMA_REQ_TMR3_CH4,      3, 0,                      0},
+  {DMA_REQ_TMR4_CH1,      4, 0,                      0},
+  {DMA_REQ_TMR4_CH2,      3, 0,                      0},
+  {DMA_REQ_TMR4_CH3,      2, 0,                      0},
+  {DMA_REQ_TMR6_OVERFLOW, 3, 0,                      0},
+  {DMA_REQ_TMR15,         5, 0,                      0},
+  {DMA_REQ_TMR16,         3, SCFG_TMR16_DMA_RMP | SCFG_TMR16_DMA_RMP2, 0},
+  {DMA_REQ_TMR16,         4, SCFG_TMR16_DMA_RMP | SCFG_TMR16_DMA_RMP2, SCFG_TMR16_DMA_RMP},
+  {DMA_REQ_TMR16,         6, SCFG_TMR16_DMA_RMP | SCFG_TMR16_DMA_RMP2, SCFG_TMR16_DMA_RMP2},
+  {DMA_REQ_TMR17,         1, SCFG_TMR17_DMA_RMP | SCFG_TMR17_DMA_RMP2, 0},
+  {DMA_REQ_TMR17,         2, SCFG_TMR17_DMA_RMP | SCFG_TMR17_DMA_RMP2, SCFG_TMR17_DMA_RMP},
+  {DMA_REQ_TMR17,         7, SCFG_TMR17_DMA_RMP | SCFG_TMR17_DMA_RMP2, SCFG_TMR17_DMA_RMP2},
+};
+
+/**
+  * @brief channel ownership, index 0 is channel 1
+  */
+static dma_handle_type* dma_channel_owner[DMA_CHANNEL_NUM] = {0};
+static uint32_t dma_channel_rmp_mask[DMA_CHANNEL_NUM] = {0};
+static uint32_t dma_rmp_value = 0;
+
+/**
+  * @brief  get the scfg remap bits held by the allocated channels.
+  * @param  none
+  * @retval remap bits mask.
+  */
+static uint32_t dma_rmp_locked_get(void)
+{
+  uint32_t locked = 0;
+  uint8_t i;
+
+  for(i = 0; i < DMA_CHANNEL_NUM; i++)
+  {
+    if(dma_channel_owner[i] != 0)
+    {
+      locked |= dma_channel_rmp_mask[i];
+    }
+  }
+
+  return locked;
+}
+
+/**
+  * @brief  allocate a dma1 channel for a peripheral request and program the scfg remap
+  *         it needs. the default mapping is tried first, a remapped channel is taken
+  *         only when its remap bits do not move a request of an allocated channel.
+  * @note   the dma1 clock should be enabled before.
+  * @param  hdma: the handle points to the dma transfer information.
+  * @param  request: the peripheral request, DMA_REQ_MEM2MEM takes any free channel.
+  * @retval dma application status.
+  */
+dma_app_status_type dma_channel_alloc(dma_handle_type* hdma, dma_request_type request)
+{
+  uint32_t locked, i;
+  uint32_t bit;
+  const dma_route_type *route = 0;
+
+  if(request == DMA_REQ_MEM2MEM)
+  {
+    /* prefer the higher channels, the low ones carry most of the peripheral requests */
+    for(i = DMA_CHANNEL_NUM; i > 0; i--)
+    {
+      if(dma_channel_owner[i - 1] == 0)
+      {
+        dma_channel_owner[i - 1] = hdma;
+        dma_channel_rmp_mask[i - 1] = 0;
+        break;
+      }
+    }
+    if(i == 0)
+    {
+      return DMA_APP_ERR_BUSY;
+    }
+    hdma->channel_index = (uint8_t)i;
+  }
+  else
+  {
+    locked = dma_rmp_locked_get();
+    for(i = 0; i < sizeof(dma_route_table) / sizeof(dma_route_table[0]); i++)
+    {
+      if((dma_route_table[i].request == request) &&
+         (dma_channel_owner[dma_route_table[i].channel_index - 1] == 0) &&
+         (((dma_rmp_value ^ dma_route_table[i].rmp_value) & dma_route_table[i].rmp_mask & locked) == 0))
+      {
+        route = &dma_route_table[i];
+        break;
+      }
+    }
+    if(route == 0)
+    {
+      return DMA_APP_ERR_BUSY;
+    }
+
+    for(bit = 1; bit != 0; bit <<= 1)
+    {
+      if(route->rmp_mask & bit)
+      {
+        scfg_dma_channel_remap(bit, (route->rmp_value & bit) ? TRUE : FALSE);
+      }
+    }
+    dma_rmp_value = (dma_rmp_value & ~route->rmp_mask) | route->rmp_value;
+
+    dma_channel_owner[route->channel_index - 1] = hdma;
+    dma_channel_rmp_mask[route->channel_index - 1] = route->rmp_mask;
+    hdma->channel_index = route->channel_index;
+  }
+
+  hdma->request = request;
+  hdma->channel = DMA_CHANNEL_GET(hdma->channel_index);
+  hdma->desc = 0;
+  hdma->busy = 0;
+
+  hdma->channel->ctrl = 0;
+  DMA1->clr = DMA_GET_GL_FLAG(hdma->channel_index);
+
+  return DMA_APP_OK;
+}
+
+/**
+  * @brief  stop the transfer and give the channel back.
+  * @param  hdma: the handle points to the dma transfer information.
+  * @retval none.
+  */
+void dma_channel_free(dma_handle_type* hdma)
+{
+  if((hdma->channel_index == 0) || (hdma->channel_index > DMA_CHANNEL_NUM) ||
+     (dma_channel_owner[hdma->channel_index - 1] != hdma))
+  {
+    return;
+  }
+
+  dma_chain_stop(hdma);
+  dma_channel_owner[hdma->channel_index - 1] = 0;
+  dma_channel_rmp_mask[hdma->channel_index - 1] = 0;
+  hdma->channel = 0;
+  hdma->channel_index = 0;
+}
+
+/**
+  * @brief  build the register image of a descriptor, the same fields as dma_init().
+  *         the next link is cleared.
+  * @param  desc: the descriptor.
+  * @param  dma_init_struct: the transfer parameters.
+  * @retval none.
+  */
+void dma_desc_build(dma_desc_type* desc, dma_init_type* dma_init_struct)
+{
+  desc->ctrl = (uint32_t)dma_init_struct->direction |
+               ((uint32_t)(dma_init_struct->loop_mode_enable ? 1 : 0) << 5) |
+               ((uint32_t)(dma_init_struct->peripheral_inc_enable ? 1 : 0) << 6) |
+               ((uint32_t)(dma_init_struct->memory_inc_enable ? 1 : 0) << 7) |
+               ((uint32_t)dma_init_struct->peripheral_data_width << 8) |
+               ((uint32_t)dma_init_struct->memory_data_width << 10) |
+               ((uint32_t)dma_init_struct->priority << 12);
+  desc->dtcnt = dma_init_struct->buffer_size;
+  desc->paddr = dma_init_struct->peripheral_base_addr;
+  desc->maddr = dma_init_struct->memory_base_addr;
+  desc->next = 0;
+}
+
+/**
+  * @brief  load a descriptor into the channel and enable it. a handle without
+  *         callbacks and without a next descriptor runs with the interrupts off,
+  *         the owner ends it with dma_chain_stop().
+  * @param  hdma: the handle points to the dma transfer information.
+  * @param  desc: the descriptor.
+  * @retval none.
+  */
+void dma_desc_rearm(dma_handle_type* hdma, dma_desc_type* desc)
+{
+  dma_channel_type *channel = hdma->channel;
+  uint32_t ctrl = desc->ctrl;
+
+  if((hdma->full_callback != 0) || (desc->next != 0))
+  {
+    ctrl |= DMA_FDT_INT;
+  }
+  if(hdma->half_callback != 0)
+  {
+    ctrl |= DMA_HDT_INT;
+  }
+  if(ctrl & DMA_CTRL_INT_MASK)
+  {
+    ctrl |= DMA_DTERR_INT;
+  }
+  if(hdma->request == DMA_REQ_MEM2MEM)
+  {
+    ctrl |= DMA_CTRL_M2M;
+  }
+
+  hdma->desc = desc;
+  channel->ctrl = 0;
+  DMA1->clr = DMA_GET_GL_FLAG(hdma->channel_index);
+  channel->dtcnt = desc->dtcnt;
+  channel->paddr = desc->paddr;
+  channel->maddr = desc->maddr;
+  channel->ctrl = ctrl | DMA_CTRL_CHEN;
+}
+
+/**
+  * @brief  start a descriptor chain, the next descriptor is loaded from the
+  *         transfer complete interrupt. a descriptor with loop mode never ends.
+  * @param  hdma: the handle points to the dma transfer information.
+  * @param  desc: the first descriptor.
+  * @retval dma application status.
+  */
+dma_app_status_type dma_chain_start(dma_handle_type* hdma, dma_desc_type* desc)
+{
+  if((hdma->channel == 0) || (desc == 0))
+  {
+    return DMA_APP_ERR_PARAM;
+  }
+
+  if(hdma->busy)
+  {
+    return DMA_APP_ERR_BUSY;
+  }
+
+  hdma->busy = 1;
+  dma_desc_rearm(hdma, desc);
+
+  return DMA_APP_OK;
+}
+
+/**
+  * @brief  abort the running chain.
+  * @param  hdma: the handle points to the dma transfer information.
+  * @retval none.
+  */
+void dma_chain_stop(dma_handle_type* hdma)
+{
+  if(hdma->channel == 0)
+  {
+    return;
+  }
+
+  hdma->channel->ctrl &= ~(DMA_CTRL_CHEN | DMA_CTRL_INT_MASK);
+  DMA1->clr = DMA_GET_GL_FLAG(hdma->channel_index);
+  hdma->busy = 0;
+}
+
+/**
+  * @brief  dma interrupt handler, call it in the interrupt of the allocated channel.
+  *         on a transfer complete the full callback is called with the finished
+  *         descriptor, then the next descriptor of the chain is loaded.
+  * @param  hdma: the handle points to the dma transfer information.
+  * @retval none.
+  */
+void dma_irq_handler(dma_handle_type* hdma)
+{
+  dma_desc_type *desc = hdma->desc;
+  uint32_t sts;
+
+  if(hdma->channel == 0)
+  {
+    return;
+  }
+
+  sts = DMA1->sts & ((hdma->channel->ctrl & DMA_CTRL_INT_MASK) << ((hdma->channel_index - 1) * 4));
+
+  /* transfer error, the hardware has disabled the channel */
+  if(sts & DMA_GET_TERR_FLAG(hdma->channel_index))
+  {
+    DMA1->clr = DMA_GET_GL_FLAG(hdma->channel_index);
+    hdma->channel->ctrl &= ~(DMA_CTRL_CHEN | DMA_CTRL_INT_MASK);
+    hdma->busy = 0;
+    if(hdma->error_callback != 0)
+    {
+      hdma->error_callback(hdma, desc);
+    }
+    return;
+  }
+
+  if(sts & DMA_GET_HT_FLAG(hdma->channel_index))
+  {
+    DMA1->clr = DMA_GET_HT_FLAG(hdma->channel_index);
+    if(hdma->half_callback != 0)
+    {
+      hdma->half_callback(hdma, desc);
+    }
+  }
+
+  if(sts & DMA_GET_TC_FLAG(hdma->channel_index))
+  {
+    DMA1->clr = DMA_GET_TC_FLAG(hdma->channel_index);
+
+    /* a loop mode descriptor reloads by itself */
+    if((desc->ctrl & DMA_CTRL_LM) == 0)
+    {
+      if(desc->next != 0)
+      {
+        dma_desc_rearm(hdma, desc->next);
+      }
+      else
+      {
+        hdma->channel->ctrl &= ~(DMA_CTRL_CHEN | DMA_CTRL_INT_MASK);
+        hdma->busy = 0;
+      }
+    }
+
+    if(hdma->full_callback != 0)
+    {
+      hdma->full_callback(hdma, desc);
+    }
+  }
+}
+
+/**
+  * @}
+  */
@@ -0,0 +1,163 @@
+/**
+  **************************************************************************
+  * @file     dma_application.h
+  * @brief    dma application libray header file
+  **************************************************************************
+  *
+  * Copyright (c) 2025, Artery Technology, All rights reserved.
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+/*!< define to prevent recursive inclusion -------------------------------------*/
+#ifndef __DMA_APPLICATION_H
+#define __DMA_APPLICATION_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* includes ------------------------------------------------------------------*/
+#include "at32f422_426.h"
+
+/** @addtogroup AT32F422_426_middlewares_dma_application_library
+  * @{
+  */
+
+
+/** @defgroup DMA_library_request
+  * @{
+  */
+
+typedef enum
+{
+  DMA_REQ_MEM2MEM = 0,                   /*!< memory to memory, any channel */
+  DMA_REQ_ADC,                           /*!< adc, channel 1 or 2 */
+  DMA_REQ_SPI1_RX,                       /*!< spi1/i2s1 rx, channel 2 */
+  DMA_REQ_SPI1_TX,                       /*!< spi1/i2s1 tx, channel 3 */
+  DMA_REQ_SPI2_RX,                       /*!< spi2/i2s2 rx, channel 4 or 6 */
+  DMA_REQ_SPI2_TX,                       /*!< spi2/i2s2 tx, channel 5 or 7 */
+  DMA_REQ_USART1_TX,                     /*!< usart1 tx, channel 2 or 4 */
+  DMA_REQ_USART1_RX,                     /*!< usart1 rx, channel 3 or 5 */
+  DMA_REQ_USART2_TX,                     /*!< usart2 tx, channel 4 or 7 */
+  DMA_REQ_USART2_RX,                     /*!< usart2 rx, channel 5 or 6 */
+  DMA_REQ_I2C1_TX,                       /*!< i2c1 tx, channel 2 or 6 */
+  DMA_REQ_I2C1_RX,                       /*!< i2c1 rx, channel 3 or 7 */
+  DMA_REQ_I2C2_TX,                       /*!< i2c2 tx, channel 4 */
+  DMA_REQ_I2C2_RX,                       /*!< i2c2 rx, channel 5 */
+  DMA_REQ_TMR1_CH1,                      /*!< tmr1 ch1, channel 2 or 6 */
+  DMA_REQ_TMR1_CH2,                      /*!< tmr1 ch2, channel 3 or 6 */
+  DMA_REQ_TMR1_CH3,                      /*!< tmr1 ch3, channel 5 or 6 */
+  DMA_REQ_TMR1_CH4,                      /*!< tmr1 ch4/trig/hall, channel 4 */
+  DMA_REQ_TMR1_OVERFLOW,                 /*!< tmr1 overflow, channel 5 */
+  DMA_REQ_TMR3_CH1,                      /*!< tmr3 ch1/trig, channel 4 or 6 */
+  DMA_REQ_TMR3_CH3,                      /*!< tmr3 ch3, channel 2 */
+  DMA_REQ_TMR3_CH4,                      /*!< tmr3 ch4/overflow, channel 3 */
+  DMA_REQ_TMR4_CH1,                      /*!< tmr4 ch1/ch4/trig, channel 4 */
+  DMA_REQ_TMR4_CH2,                      /*!< tmr4 ch2/overflow, channel 3 */
+  DMA_REQ_TMR4_CH3,                      /*!< tmr4 ch3, channel 2 */
+  DMA_REQ_TMR6_OVERFLOW,                 /*!< tmr6 overflow, channel 3 */
+  DMA_REQ_TMR15,                         /*!< tmr15 ch1/ch2/overflow/trig/hall, channel 5 */
+  DMA_REQ_TMR16,                         /*!< tmr16 ch1/overflow, channel 3, 4 or 6 */
+  DMA_REQ_TMR17,                         /*!< tmr17 ch1/overflow, channel 1, 2 or 7 */
+} dma_request_type;
+
+/**
+  * @}
+  */
+
+/** @defgroup DMA_library_status_code
+  * @{
+  */
+
+typedef enum
+{
+  DMA_APP_OK = 0,      /*!< no error */
+  DMA_APP_ERR_PARAM,   /*!< invalid parameter */
+  DMA_APP_ERR_BUSY,    /*!< no channel left or transfer ongoing */
+} dma_app_status_type;
+
+/**
+  * @}
+  */
+
+/** @defgroup DMA_library_descriptor
+  * @{
+  */
+
+/**
+  * @brief  transfer descriptor, holds the register image written to the channel
+  *         and the link to the next descriptor of the chain.
+  */
+typedef struct dma_desc_struct
+{
+  uint32_t                               ctrl;                    /*!< ctrl register image, chen and interrupts cleared */
+  uint32_t                               dtcnt;                   /*!< number of data                  */
+  uint32_t                               paddr;                   /*!< peripheral address              */
+  uint32_t                               maddr;                   /*!< memory address                  */
+  struct dma_desc_struct                 *next;                   /*!< next descriptor, NULL ends the chain */
+} dma_desc_type;
+
+typedef struct dma_handle_struct dma_handle_type;
+
+/**
+  * @brief  transfer callback, called in the interrupt with the running descriptor.
+  */
+typedef void (*dma_callback_type)(dma_handle_type* hdma, dma_desc_type* desc);
+
+struct dma_handle_struct
+{
+  dma_request_type                       request;                 /*!< peripheral request              */
+  dma_channel_type                       *channel;                /*!< allocated channel               */
+  uint8_t                                channel_index;           /*!< allocated channel number, 1~7   */
+  dma_desc_type                          *desc;                   /*!< running descriptor              */
+  dma_callback_type                      half_callback;           /*!< half transfer callback          */
+  dma_callback_type                      full_callback;           /*!< full transfer callback of each descriptor */
+  dma_callback_type                      error_callback;          /*!< transfer error callback         */
+  __IO uint8_t                           busy;                    /*!< chain running                   */
+};
+
+/**
+  * @}
+  */
+
+/** @defgroup DMA_library_exported_functions
+  * @{
+  */
+
+dma_app_status_type dma_channel_alloc     (dma_handle_type* hdma, dma_request_type request);
+void                dma_channel_free      (dma_handle_type* hdma);
+void                dma_desc_build        (dma_desc_type* desc, dma_init_type* dma_init_struct);
+void                dma_desc_rearm        (dma_handle_type* hdma, dma_desc_type* desc);
+dma_app_status_type dma_chain_start       (dma_handle_type* hdma, dma_desc_type* desc);
+void                dma_chain_stop        (dma_handle_type* hdma);
+void                dma_irq_handler       (dma_handle_type* hdma);
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
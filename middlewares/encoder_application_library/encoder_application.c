@@ -0,0 +1,387 @@
+/**
+  **************************************************************************
+  * @file     encoder_application.c
+  * @brief    quadrature encoder service application libray source file
+  **************************************************************************
+  *
+  * Copyright (c) 2025, Artery Technology, All rights reserved.
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+#include "encoder_application.h"
+
+/** @addtogroup AT32F422_426_middlewares_encoder_application_library
+  * @{
+  */
+
+
+/**
+  * @brief  initializes peripherals used by the service: clocks, gpio, the
+  *         encoder timer in encoder mode with period 0xFFFF, the sample timer
+  *         overflowing sample_freq times a second, the encoder timer and dma
+  *         interrupts.
+  * @param  hen: the handle points to the encoder information.
+  * @retval none
+  */
+__WEAK void encoder_lowlevel_init(encoder_handle_type* hen)
+{
+
+}
+
+/**
+  * @brief  dma request of the sample timer overflow.
+  * @param  tmrx: the sample timer.
+  * @param  request: the dma request.
+  * @retval 1 if the timer has an overflow request, 0 if not.
+  */
+static uint8_t encoder_sample_request_get(tmr_type* tmrx, dma_request_type* request)
+{
+  if(tmrx == TMR1)
+  {
+    *request = DMA_REQ_TMR1_OVERFLOW;
+  }
+  else if(tmrx == TMR3)
+  {
+    *request = DMA_REQ_TMR3_CH4;
+  }
+  else if(tmrx == TMR4)
+  {
+    *request = DMA_REQ_TMR4_CH2;
+  }
+  else if(tmrx == TMR6)
+  {
+    *request = DMA_REQ_TMR6_OVERFLOW;
+  }
+  else if(tmrx == TMR15)
+  {
+    *request = DMA_REQ_TMR15;
+  }
+  else if(tmrx == TMR16)
+  {
+    *request = DMA_REQ_TMR16;
+  }
+  else if(tmrx == TMR17)
+  {
+    *request = DMA_REQ_TMR17;
+  }
+  else
+  {
+    return 0;
+  }
+
+  return 1;
+}
+
+/**
+  * @brief  process a block of samples and publish the snapshot. the m method
+  *         is used when the block holds at least m_threshold counts, else the
+  *         t method between the last edge and the reference edge. without a
+  *         new edge the velocity decays as if the next edge were due now.
+  * @param  hen: the handle points to the encoder information.
+  * @param  half: 0 for the first block, 1 for the second.
+  * @retval none
+  */
+static void encoder_block_done(encoder_handle_type* hen, uint8_t half)
+{
+  const uint16_t *sample = hen->buf + half * hen->block;
+  uint16_t pos = hen->block * 2 - (uint16_t)hen->dma.channel->dtcnt;
+  int32_t start = hen->position;
+  encoder_method_type method = ENCODER_METHOD_T;
+  uint32_t elapsed;
+  int32_t counts;
+  int16_t delta;
+  uint16_t index;
+
+  for(index = 0; index < hen->block; index++)
+  {
+    /* less than 32768 counts between two samples */
+    delta = (int16_t)(sample[index] - hen->last_raw);
+    hen->last_raw = sample[index];
+    hen->sample_count++;
+    if(delta != 0)
+    {
+      hen->position += delta;
+      hen->edge_sample = hen->sample_count;
+      hen->edge_position = hen->position;
+    }
+  }
+
+  if((pos >= hen->block) != (half == 0))
+  {
+    hen->overrun_count++;
+  }
+
+  counts = hen->position - start;
+  if((counts >= hen->m_threshold) || (-counts >= hen->m_threshold))
+  {
+    method = ENCODER_METHOD_M;
+    hen->velocity = (float)counts * hen->sample_freq / hen->block;
+    hen->ref_sample = hen->edge_sample;
+    hen->ref_position = hen->edge_position;
+    hen->ref_valid = 1;
+  }
+  else if(hen->ref_valid && (hen->edge_sample != hen->ref_sample))
+  {
+    hen->velocity = (float)(hen->edge_position - hen->ref_position) * hen->sample_freq / (hen->edge_sample - hen->ref_sample);
+    hen->ref_sample = hen->edge_sample;
+    hen->ref_position = hen->edge_position;
+  }
+  else if(hen->ref_valid)
+  {
+    elapsed = hen->sample_count - hen->ref_sample;
+    if(elapsed >= hen->stop_time)
+    {
+      hen->velocity = 0;
+    }
+    else if((hen->velocity * elapsed) > hen->sample_freq)
+    {
+      hen->velocity = (float)hen->sample_freq / elapsed;
+    }
+    else if((-hen->velocity * elapsed) > hen->sample_freq)
+    {
+      hen->velocity = -(float)hen->sample_freq / elapsed;
+    }
+  }
+  else if(hen->edge_sample != 0)
+  {
+    /* the first edge, the start is not an edge */
+    hen->ref_sample = hen->edge_sample;
+    hen->ref_position = hen->edge_position;
+    hen->ref_valid = 1;
+  }
+
+  hen->seq++;
+  __DMB();
+  hen->snapshot.position = hen->position;
+  hen->snapshot.velocity = hen->velocity;
+  hen->snapshot.sample = hen->sample_count;
+  hen->snapshot.method = method;
+  __DMB();
+  hen->seq++;
+}
+
+/**
+  * @brief  dma half transfer, the first block is complete.
+  * @param  hdma: the dma handle, first member of the encoder handle.
+  * @param  desc: the loop mode descriptor.
+  * @retval none
+  */
+static void encoder_half_callback(dma_handle_type* hdma, dma_desc_type* desc)
+{
+  encoder_block_done((encoder_handle_type *)hdma, 0);
+}
+
+/**
+  * @brief  dma full transfer, the second block is complete.
+  * @param  hdma: the dma handle, first member of the encoder handle.
+  * @param  desc: the loop mode descriptor.
+  * @retval none
+  */
+static void encoder_full_callback(dma_handle_type* hdma, dma_desc_type* desc)
+{
+  encoder_block_done((encoder_handle_type *)hdma, 1);
+}
+
+/**
+  * @brief  encoder service initialization, calls encoder_lowlevel_init() then
+  *         sets up the dma copying the encoder counter on every overflow of
+  *         the sample timer, in loop mode over two blocks.
+  * @note   the interrupt of hen->dma.channel_index should call
+  *         dma_irq_handler(&hen->dma), the encoder timer overflow interrupt
+  *         should call encoder_irq_handler(hen).
+  * @param  hen: the handle points to the encoder information, enc_tmrx,
+  *         sample_tmrx, sample_freq, m_threshold and stop_time set by the caller.
+  * @param  buf: two blocks, 2 * block samples.
+  * @param  block: samples in one block, the snapshot is published once a block.
+  * @retval encoder status.
+  */
+encoder_status_type encoder_init(encoder_handle_type* hen, uint16_t* buf, uint16_t block)
+{
+  dma_init_type dma_init_struct;
+  dma_request_type request;
+
+  if((buf == 0) || (block == 0) || (block > 0x7FFF) || (hen->sample_freq == 0) || \
+     ((hen->enc_tmrx != TMR1) && (hen->enc_tmrx != TMR3) && (hen->enc_tmrx != TMR4)) || \
+     (hen->sample_tmrx == hen->enc_tmrx) || (encoder_sample_request_get(hen->sample_tmrx, &request) == 0))
+  {
+    return ENCODER_ERR_PARAM;
+  }
+
+  hen->buf = buf;
+  hen->block = block;
+
+  encoder_lowlevel_init(hen);
+
+  if(dma_channel_alloc(&hen->dma, request) != DMA_APP_OK)
+  {
+    return ENCODER_ERR_BUSY;
+  }
+  hen->dma.half_callback = encoder_half_callback;
+  hen->dma.full_callback = encoder_full_callback;
+  hen->dma.error_callback = 0;
+
+  dma_default_para_init(&dma_init_struct);
+  dma_init_struct.buffer_size = block * 2;
+  dma_init_struct.direction = DMA_DIR_PERIPHERAL_TO_MEMORY;
+  dma_init_struct.memory_base_addr = (uint32_t)buf;
+  dma_init_struct.memory_data_width = DMA_MEMORY_DATA_WIDTH_HALFWORD;
+  dma_init_struct.memory_inc_enable = TRUE;
+  dma_init_struct.peripheral_base_addr = (uint32_t)&hen->enc_tmrx->cval;
+  dma_init_struct.peripheral_data_width = DMA_PERIPHERAL_DATA_WIDTH_HALFWORD;
+  dma_init_struct.peripheral_inc_enable = FALSE;
+  dma_init_struct.priority = DMA_PRIORITY_HIGH;
+  dma_init_struct.loop_mode_enable = TRUE;
+  dma_desc_build(&hen->desc, &dma_init_struct);
+
+  return ENCODER_OK;
+}
+
+/**
+  * @brief  stop the service and give the dma channel back.
+  * @param  hen: the handle points to the encoder information.
+  * @retval none
+  */
+void encoder_deinit(encoder_handle_type* hen)
+{
+  encoder_stop(hen);
+  dma_channel_free(&hen->dma);
+}
+
+/**
+  * @brief  start counting and sampling, the position starts at the counter
+  *         value and the velocity at 0.
+  * @param  hen: the handle points to the encoder information.
+  * @retval none
+  */
+void encoder_start(encoder_handle_type* hen)
+{
+  hen->last_raw = (uint16_t)hen->enc_tmrx->cval;
+  hen->position = hen->last_raw;
+  hen->high = 0;
+  hen->sample_count = 0;
+  hen->edge_sample = 0;
+  hen->edge_position = hen->position;
+  hen->ref_valid = 0;
+  hen->velocity = 0;
+  hen->overrun_count = 0;
+  hen->seq = 0;
+  hen->snapshot.position = hen->position;
+  hen->snapshot.velocity = 0;
+  hen->snapshot.sample = 0;
+  hen->snapshot.method = ENCODER_METHOD_T;
+
+  tmr_flag_clear(hen->enc_tmrx, TMR_OVF_FLAG);
+  tmr_interrupt_enable(hen->enc_tmrx, TMR_OVF_INT, TRUE);
+  tmr_counter_enable(hen->enc_tmrx, TRUE);
+
+  dma_chain_start(&hen->dma, &hen->desc);
+  tmr_dma_request_enable(hen->sample_tmrx, TMR_OVERFLOW_DMA_REQUEST, TRUE);
+  tmr_counter_enable(hen->sample_tmrx, TRUE);
+}
+
+/**
+  * @brief  stop sampling, the encoder timer keeps counting.
+  * @param  hen: the handle points to the encoder information.
+  * @retval none
+  */
+void encoder_stop(encoder_handle_type* hen)
+{
+  tmr_counter_enable(hen->sample_tmrx, FALSE);
+  tmr_dma_request_enable(hen->sample_tmrx, TMR_OVERFLOW_DMA_REQUEST, FALSE);
+  dma_chain_stop(&hen->dma);
+  tmr_interrupt_enable(hen->enc_tmrx, TMR_OVF_INT, FALSE);
+}
+
+/**
+  * @brief  position at the time of the call, the counter extended to 32 bits
+  *         by the overflow interrupt. a wrap whose interrupt is still pending,
+  *         the call being in a higher priority interrupt or the interrupts
+  *         disabled, is added here by the rule of encoder_irq_handler(). the
+  *         counter is read between two reads of the flag, the same on both
+  *         sides or the reads are taken again.
+  * @param  hen: the handle points to the encoder information.
+  * @retval position in counts.
+  */
+int32_t encoder_position_get(encoder_handle_type* hen)
+{
+  int32_t high;
+  uint16_t count;
+  flag_status pending;
+
+  do
+  {
+    high = hen->high;
+    pending = tmr_flag_get(hen->enc_tmrx, TMR_OVF_FLAG);
+    count = (uint16_t)hen->enc_tmrx->cval;
+  } while((high != hen->high) || (pending != tmr_flag_get(hen->enc_tmrx, TMR_OVF_FLAG)));
+
+  if(pending != RESET)
+  {
+    high += (count < 0x8000) ? 0x10000 : -0x10000;
+  }
+
+  return high + count;
+}
+
+/**
+  * @brief  copy the last published snapshot, without locking. the copy is
+  *         taken again only when a block was published during it.
+  * @param  hen: the handle points to the encoder information.
+  * @param  snapshot: destination.
+  * @retval none
+  */
+void encoder_snapshot_get(encoder_handle_type* hen, encoder_snapshot_type* snapshot)
+{
+  uint32_t seq;
+
+  do
+  {
+    seq = hen->seq;
+    __DMB();
+    *snapshot = hen->snapshot;
+    __DMB();
+  } while((seq & 1) || (seq != hen->seq));
+}
+
+/**
+  * @brief  encoder timer interrupt handler, extends the counter on an overflow.
+  *         the direction may have turned again since the wrap, so the side of
+  *         the wrap is taken from the counter: near 0 it went up past 0xffff,
+  *         near 0xffff it went down past 0.
+  * @param  hen: the handle points to the encoder information.
+  * @retval none
+  */
+void encoder_irq_handler(encoder_handle_type* hen)
+{
+  if(tmr_interrupt_flag_get(hen->enc_tmrx, TMR_OVF_FLAG) != RESET)
+  {
+    tmr_flag_clear(hen->enc_tmrx, TMR_OVF_FLAG);
+    if((uint16_t)hen->enc_tmrx->cval < 0x8000)
+    {
+      hen->high += 0x10000;
+    }
+    else
+    {
+      hen->high -= 0x10000;
+    }
+  }
+}
+
+/**
+  * @}
+  */
@@ -0,0 +1,143 @@
+/**
+  **************************************************************************
+  * @file     encoder_application.h
+  * @brief    quadrature encoder service application libray header file
+  **************************************************************************
+  *
+  * Copyright (c) 2025, Artery Technology, All rights reserved.
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+/*!< define to prevent recursive inclusion -------------------------------------*/
+#ifndef __ENCODER_APPLICATION_H
+#define __ENCODER_APPLICATION_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* includes ------------------------------------------------------------------*/
+#include "at32f422_426.h"
+#include "dma_application.h"
+
+/** @addtogroup AT32F422_426_middlewares_encoder_application_library
+  * @{
+  */
+
+
+/** @defgroup ENCODER_library_status_code
+  * @{
+  */
+
+typedef enum
+{
+  ENCODER_OK = 0,         /*!< no error */
+  ENCODER_ERR_PARAM,      /*!< invalid parameter */
+  ENCODER_ERR_BUSY,       /*!< no dma channel left */
+} encoder_status_type;
+
+/**
+  * @}
+  */
+
+/** @defgroup ENCODER_library_snapshot
+  * @{
+  */
+
+typedef enum
+{
+  ENCODER_METHOD_M = 0,   /*!< counts of the last block over its duration */
+  ENCODER_METHOD_T,       /*!< counts between edges over the time between them */
+} encoder_method_type;
+
+/**
+  * @brief  state published after every block of samples.
+  */
+typedef struct
+{
+  int32_t                                position;                /*!< counts at the last sample       */
+  float                                  velocity;                /*!< counts per second               */
+  uint32_t                               sample;                  /*!< samples taken since the start   */
+  encoder_method_type                    method;                  /*!< method of the velocity          */
+} encoder_snapshot_type;
+
+/**
+  * @}
+  */
+
+/** @defgroup ENCODER_library_handle
+  * @{
+  */
+
+typedef struct
+{
+  dma_handle_type                        dma;                     /*!< sample dma, first member        */
+  dma_desc_type                          desc;                    /*!< loop mode register image        */
+  tmr_type                               *enc_tmrx;               /*!< encoder timer, TMR1, TMR3 or TMR4 */
+  tmr_type                               *sample_tmrx;            /*!< timer of the sample rate        */
+  uint32_t                               sample_freq;             /*!< samples per second              */
+  uint16_t                               m_threshold;             /*!< counts of a block using the m method */
+  uint32_t                               stop_time;               /*!< samples without an edge giving 0 velocity */
+  uint16_t                               *buf;                    /*!< two blocks of counter samples   */
+  uint16_t                               block;                   /*!< samples in one block            */
+  uint16_t                               last_raw;                /*!< counter of the last sample      */
+  int32_t                                position;                /*!< extended counter of the last sample */
+  uint32_t                               sample_count;            /*!< samples taken                   */
+  uint32_t                               edge_sample;             /*!< sample of the last edge         */
+  int32_t                                edge_position;           /*!< position at the last edge       */
+  uint32_t                               ref_sample;              /*!< sample of the reference edge    */
+  int32_t                                ref_position;            /*!< position at the reference edge  */
+  uint8_t                                ref_valid;               /*!< reference edge seen             */
+  float                                  velocity;                /*!< last velocity                   */
+  __IO int32_t                           high;                    /*!< counter overflows, in counts    */
+  __IO uint32_t                          seq;                     /*!< snapshot sequence, odd while written */
+  encoder_snapshot_type                  snapshot;                /*!< published state                 */
+  __IO uint32_t                          overrun_count;           /*!< blocks overwritten before processed */
+} encoder_handle_type;
+
+/**
+  * @}
+  */
+
+/** @defgroup ENCODER_library_exported_functions
+  * @{
+  */
+
+void                encoder_lowlevel_init (encoder_handle_type* hen);
+encoder_status_type encoder_init          (encoder_handle_type* hen, uint16_t* buf, uint16_t block);
+void                encoder_deinit        (encoder_handle_type* hen);
+void                encoder_start         (encoder_handle_type* hen);
+void                encoder_stop          (encoder_handle_type* hen);
+int32_t             encoder_position_get  (encoder_handle_type* hen);
+void                encoder_snapshot_get  (encoder_handle_type* hen, encoder_snapshot_type* snapshot);
+void                encoder_irq_handler   (encoder_handle_type* hen);
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,310 @@
+/**
+  **************************************************************************
+  * @file     foc_application.c
+  * @brief    field oriented control application libray source file
+  **************************************************************************
+  *
+  * Copyright (c) 2025, Artery Technology, All rights reserved.
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+#include "foc_application.h"
+
+/** @addtogroup AT32F422_426_middlewares_foc_application_library
+  * @{
+  */
+
+
+/**
+  * @brief  initializes peripherals used by the loop: clocks, gpio, TMR1 in
+  *         center aligned pwm on channels 1 ~ 3 and their complementary outputs
+  *         with dead time, its trigger of the preempt conversion, the adc with
+  *         the phase a and b currents on preempt channels 1 and 2 triggered by
+  *         adc_preempt_conversion_trigger_set(), and the adc interrupt.
+  * @param  hfoc: the handle points to the control information.
+  * @retval none
+  */
+__WEAK void foc_lowlevel_init(foc_handle_type* hfoc)
+{
+
+}
+
+/**
+  * @brief  current controller with the output clamped, the clamped output
+  *         is kept as the last output so that the integral does not wind up.
+  * @param  pid: the controller.
+  * @param  error: reference minus measurement.
+  * @param  limit: output limit.
+  * @retval output.
+  */
+static q31_t foc_pid_run(arm_pid_instance_q31* pid, q31_t error, q31_t limit)
+{
+  q31_t out = arm_pid_q31(pid, error);
+
+  if(out > limit)
+  {
+    out = limit;
+  }
+  else if(out < -limit)
+  {
+    out = -limit;
+  }
+  pid->state[2] = out;
+
+  return out;
+}
+
+/**
+  * @brief  compare value of a phase, 0 is half the period.
+  * @param  hfoc: the handle points to the control information.
+  * @param  voltage: phase voltage, 1 is half the bus voltage.
+  * @retval compare value.
+  */
+static uint16_t foc_phase_compare(foc_handle_type* hfoc, int64_t voltage)
+{
+  int32_t compare;
+
+  if(voltage > 0x7FFFFFFF)
+  {
+    voltage = 0x7FFFFFFF;
+  }
+  else if(voltage < -0x7FFFFFFF)
+  {
+    voltage = -0x7FFFFFFF;
+  }
+
+  compare = (hfoc->period / 2) + (int32_t)((voltage * (hfoc->period / 2)) >> 31);
+
+  return (compare < 0) ? 0 : (uint16_t)compare;
+}
+
+/**
+  * @brief  loop initialization, calls foc_lowlevel_init() then initializes
+  *         the controllers and enables the preempt conversion end interrupt.
+  *         the outputs stay off until foc_start().
+  * @note   the adc interrupt should call foc_irq_handler(hfoc).
+  * @param  hfoc: the handle points to the control information, adcx,
+  *         pwm_tmrx, the controller gains, voltage_limit, current_invert and
+  *         angle set by the caller.
+  * @retval foc status.
+  */
+foc_status_type foc_init(foc_handle_type* hfoc)
+{
+  if((hfoc->adcx != ADC1) || (hfoc->pwm_tmrx != TMR1) || (hfoc->voltage_limit <= 0))
+  {
+    return FOC_ERR_PARAM;
+  }
+
+  foc_lowlevel_init(hfoc);
+
+  hfoc->period = (uint16_t)hfoc->pwm_tmrx->pr;
+  hfoc->offset[0] = 0x800;
+  hfoc->offset[1] = 0x800;
+  hfoc->offset_remain = 0;
+  hfoc->running = 0;
+  hfoc->theta = 0;
+  hfoc->id_ref = 0;
+  hfoc->iq_ref = 0;
+  hfoc->v_alpha = 0;
+  hfoc->v_beta = 0;
+  hfoc->cycles_max = 0;
+  hfoc->loop_count = 0;
+  arm_pid_init_q31(&hfoc->pid_d, 1);
+  arm_pid_init_q31(&hfoc->pid_q, 1);
+
+  /* start the dwt cycle counter of the loop measurement */
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+  adc_flag_clear(hfoc->adcx, ADC_PCCE_FLAG);
+  adc_interrupt_enable(hfoc->adcx, ADC_PCCE_INT, TRUE);
+
+  return FOC_OK;
+}
+
+/**
+  * @brief  measure the zero current offsets over count conversions, the
+  *         outputs must be off. offset_remain is 0 when done.
+  * @param  hfoc: the handle points to the control information.
+  * @param  count: conversions averaged, 1 ~ 65535.
+  * @retval foc status.
+  */
+foc_status_type foc_calibrate(foc_handle_type* hfoc, uint16_t count)
+{
+  if(count == 0)
+  {
+    return FOC_ERR_PARAM;
+  }
+
+  if(hfoc->running || hfoc->offset_remain)
+  {
+    return FOC_ERR_BUSY;
+  }
+
+  hfoc->offset_sum[0] = 0;
+  hfoc->offset_sum[1] = 0;
+  hfoc->offset_count = count;
+  hfoc->offset_remain = count;
+
+  return FOC_OK;
+}
+
+/**
+  * @brief  reset the controllers, set the outputs to half the bus voltage
+  *         and enable them.
+  * @param  hfoc: the handle points to the control information.
+  * @retval foc status.
+  */
+foc_status_type foc_start(foc_handle_type* hfoc)
+{
+  if(hfoc->offset_remain)
+  {
+    return FOC_ERR_BUSY;
+  }
+
+  arm_pid_reset_q31(&hfoc->pid_d);
+  arm_pid_reset_q31(&hfoc->pid_q);
+  hfoc->v_alpha = 0;
+  hfoc->v_beta = 0;
+
+  hfoc->pwm_tmrx->c1dt = hfoc->period / 2;
+  hfoc->pwm_tmrx->c2dt = hfoc->period / 2;
+  hfoc->pwm_tmrx->c3dt = hfoc->period / 2;
+  hfoc->running = 1;
+  tmr_output_enable(hfoc->pwm_tmrx, TRUE);
+
+  return FOC_OK;
+}
+
+/**
+  * @brief  disable the outputs, the conversions go on.
+  * @param  hfoc: the handle points to the control information.
+  * @retval none
+  */
+void foc_stop(foc_handle_type* hfoc)
+{
+  tmr_output_enable(hfoc->pwm_tmrx, FALSE);
+  hfoc->running = 0;
+}
+
+/**
+  * @brief  set the current references, taken by the next loop.
+  * @param  hfoc: the handle points to the control information.
+  * @param  id: d current reference.
+  * @param  iq: q current reference.
+  * @retval none
+  */
+void foc_current_set(foc_handle_type* hfoc, q31_t id, q31_t iq)
+{
+  hfoc->id_ref = id;
+  hfoc->iq_ref = iq;
+}
+
+/**
+  * @brief  adc interrupt handler, runs one control loop on every preempt
+  *         conversion end: clarke, angle, park, the d and q controllers,
+  *         inverse park and min max injection into the compare values, taken
+  *         by TMR1 on its next overflow. currents are 0.5 at the full adc
+  *         range so that clarke keeps headroom.
+  * @param  hfoc: the handle points to the control information.
+  * @retval none
+  */
+void foc_irq_handler(foc_handle_type* hfoc)
+{
+  uint32_t start = DWT->CYCCNT;
+  uint16_t raw_a, raw_b;
+  q31_t i_a, i_b, sin_val, cos_val, v_a, v_b;
+  int64_t v_c, max, min, middle;
+
+  if(adc_interrupt_flag_get(hfoc->adcx, ADC_PCCE_FLAG) == RESET)
+  {
+    return;
+  }
+  adc_flag_clear(hfoc->adcx, ADC_PCCE_FLAG);
+
+  raw_a = (uint16_t)hfoc->adcx->pdt1;
+  raw_b = (uint16_t)hfoc->adcx->pdt2;
+
+  if(hfoc->offset_remain)
+  {
+    hfoc->offset_sum[0] += raw_a;
+    hfoc->offset_sum[1] += raw_b;
+    if(--hfoc->offset_remain == 0)
+    {
+      hfoc->offset[0] = (uint16_t)((hfoc->offset_sum[0] + hfoc->offset_count / 2) / hfoc->offset_count);
+      hfoc->offset[1] = (uint16_t)((hfoc->offset_sum[1] + hfoc->offset_count / 2) / hfoc->offset_count);
+    }
+    return;
+  }
+
+  if(hfoc->running == 0)
+  {
+    return;
+  }
+
+  i_a = ((q31_t)raw_a - hfoc->offset[0]) << 19;
+  i_b = ((q31_t)raw_b - hfoc->offset[1]) << 19;
+  if(hfoc->current_invert)
+  {
+    i_a = -i_a;
+    i_b = -i_b;
+  }
+
+  arm_clarke_q31(i_a, i_b, &hfoc->i_alpha, &hfoc->i_beta);
+
+  if(hfoc->angle != 0)
+  {
+    hfoc->theta = hfoc->angle(hfoc, hfoc->i_alpha, hfoc->i_beta, hfoc->v_alpha, hfoc->v_beta);
+  }
+  else
+  {
+    hfoc->theta = (q31_t)((uint32_t)hfoc->theta + (uint32_t)hfoc->speed);
+  }
+  arm_sin_cos_q31(hfoc->theta, &sin_val, &cos_val);
+
+  arm_park_q31(hfoc->i_alpha, hfoc->i_beta, &hfoc->id, &hfoc->iq, sin_val, cos_val);
+
+  hfoc->vd = foc_pid_run(&hfoc->pid_d, __QSUB(hfoc->id_ref, hfoc->id), hfoc->voltage_limit);
+  hfoc->vq = foc_pid_run(&hfoc->pid_q, __QSUB(hfoc->iq_ref, hfoc->iq), hfoc->voltage_limit);
+
+  arm_inv_park_q31(hfoc->vd, hfoc->vq, &hfoc->v_alpha, &hfoc->v_beta, sin_val, cos_val);
+  arm_inv_clarke_q31(hfoc->v_alpha, hfoc->v_beta, &v_a, &v_b);
+  v_c = -(int64_t)v_a - v_b;
+
+  /* min max injection, the phases are centered between the rails */
+  max = (v_a > v_b) ? v_a : v_b;
+  max = (v_c > max) ? v_c : max;
+  min = (v_a < v_b) ? v_a : v_b;
+  min = (v_c < min) ? v_c : min;
+  middle = (max + min) / 2;
+
+  hfoc->pwm_tmrx->c1dt = foc_phase_compare(hfoc, v_a - middle);
+  hfoc->pwm_tmrx->c2dt = foc_phase_compare(hfoc, v_b - middle);
+  hfoc->pwm_tmrx->c3dt = foc_phase_compare(hfoc, v_c - middle);
+
+  hfoc->loop_count++;
+  hfoc->cycles = DWT->CYCCNT - start;
+  if(hfoc->cycles > hfoc->cycles_max)
+  {
+    hfoc->cycles_max = hfoc->cycles;
+  }
+}
+
+/**
+  * @}
+  */
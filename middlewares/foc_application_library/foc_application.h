@@ -0,0 +1,132 @@
+/**
+  **************************************************************************
+  * @file     foc_application.h
+  * @brief    field oriented control application libray header file
+  **************************************************************************
+  *
+  * Copyright (c) 2025, Artery Technology, All rights reserved.
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+/*!< define to prevent recursive inclusion -------------------------------------*/
+#ifndef __FOC_APPLICATION_H
+#define __FOC_APPLICATION_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* includes ------------------------------------------------------------------*/
+#include "at32f422_426.h"
+#include "arm_math.h"
+
+/** @addtogroup AT32F422_426_middlewares_foc_application_library
+  * @{
+  */
+
+
+/** @defgroup FOC_library_status_code
+  * @{
+  */
+
+typedef enum
+{
+  FOC_OK = 0,             /*!< no error */
+  FOC_ERR_PARAM,          /*!< invalid parameter */
+  FOC_ERR_BUSY,           /*!< offset calibration ongoing */
+} foc_status_type;
+
+/**
+  * @}
+  */
+
+/** @defgroup FOC_library_handle
+  * @{
+  */
+
+typedef struct foc_handle_struct foc_handle_type;
+
+/**
+  * @brief  rotor angle callback, called in the adc interrupt with the alpha
+  *         beta currents and the voltages of the previous period. returns the
+  *         electrical angle, -1 ~ 1 for -180 ~ 180 degrees.
+  */
+typedef q31_t (*foc_angle_type)(foc_handle_type* hfoc, q31_t i_alpha, q31_t i_beta, q31_t v_alpha, q31_t v_beta);
+
+struct foc_handle_struct
+{
+  adc_type                               *adcx;                   /*!< adc, phase a and b currents on preempt channels 1 and 2 */
+  tmr_type                               *pwm_tmrx;               /*!< TMR1, phase a ~ c on channels 1 ~ 3 */
+  arm_pid_instance_q31                   pid_d;                   /*!< d current controller, Kp Ki Kd set by the caller */
+  arm_pid_instance_q31                   pid_q;                   /*!< q current controller, Kp Ki Kd set by the caller */
+  q31_t                                  voltage_limit;           /*!< limit of vd and vq, 1 is half the bus voltage */
+  confirm_state                          current_invert;          /*!< current sensing inverted        */
+  foc_angle_type                         angle;                   /*!< angle callback, NULL turns at speed */
+  __IO q31_t                             speed;                   /*!< angle step of a period without callback */
+  __IO q31_t                             id_ref;                  /*!< d current reference             */
+  __IO q31_t                             iq_ref;                  /*!< q current reference             */
+  q31_t                                  theta;                   /*!< electrical angle                */
+  q31_t                                  i_alpha;                 /*!< alpha current                   */
+  q31_t                                  i_beta;                  /*!< beta current                    */
+  q31_t                                  id;                      /*!< d current                       */
+  q31_t                                  iq;                      /*!< q current                       */
+  q31_t                                  vd;                      /*!< d voltage                       */
+  q31_t                                  vq;                      /*!< q voltage                       */
+  q31_t                                  v_alpha;                 /*!< alpha voltage                   */
+  q31_t                                  v_beta;                  /*!< beta voltage                    */
+  uint16_t                               period;                  /*!< pwm timer period                */
+  uint16_t                               offset[2];               /*!< adc value of zero current       */
+  uint32_t                               offset_sum[2];           /*!< offset calibration sums         */
+  uint16_t                               offset_count;            /*!< samples of the calibration      */
+  __IO uint16_t                          offset_remain;           /*!< samples left to calibrate       */
+  __IO uint8_t                           running;                 /*!< control loop driving the outputs */
+  __IO uint32_t                          cycles;                  /*!< cpu cycles of the last loop     */
+  __IO uint32_t                          cycles_max;              /*!< longest loop                    */
+  __IO uint32_t                          loop_count;              /*!< loops run                       */
+};
+
+/**
+  * @}
+  */
+
+/** @defgroup FOC_library_exported_functions
+  * @{
+  */
+
+void            foc_lowlevel_init     (foc_handle_type* hfoc);
+foc_status_type foc_init              (foc_handle_type* hfoc);
+foc_status_type foc_calibrate         (foc_handle_type* hfoc, uint16_t count);
+foc_status_type foc_start             (foc_handle_type* hfoc);
+void            foc_stop              (foc_handle_type* hfoc);
+void            foc_current_set       (foc_handle_type* hfoc, q31_t id, q31_t iq);
+void            foc_irq_handler       (foc_handle_type* hfoc);
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
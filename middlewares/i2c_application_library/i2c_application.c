@@ -66,6 +66,19 @@
 #define I2C_START                        0
 #define I2C_END                          1
 
+/**
+  * @brief queued transaction steps
+  */
+#define I2C_QUEUE_START                  0
+#define I2C_QUEUE_ADDR_WRITE             1
+#define I2C_QUEUE_WRITE                  2
+#define I2C_QUEUE_WRITE_DMA              3
+#define I2C_QUEUE_WRITE_END              4
+#define I2C_QUEUE_RESTART                5
+#define I2C_QUEUE_ADDR_READ              6
+#define I2C_QUEUE_READ                   7
+#define I2C_QUEUE_READ_DMA               8
+
 /**
   * @brief  initializes peripherals used by the i2c.
   * @param  none
@@ -76,6 +89,59 @@ __WEAK void i2c_lowlevel_init(i2c_handle_type* hi2c)
 
 }
 
+/**
+  * @brief  free running tick of the timeouts, I2C_TICKS_PER_US ticks in a
+  *         microsecond. the default is the dwt cycle counter, started by
+  *         i2c_config(), it can be replaced by a timer counter.
+  * @param  none
+  * @retval tick value.
+  */
+__WEAK uint32_t i2c_tick_get(void)
+{
+  return DWT->CYCCNT;
+}
+
+/**
+  * @brief  check a timeout started at a tick.
+  * @param  start: i2c_tick_get() value at the start of the wait.
+  * @param  timeout: timeout in microseconds, clamped to I2C_TIMEOUT_LIMIT.
+  *         I2C_TIMEOUT_FOREVER never ends when I2C_TIMEOUT_FOREVER_ENABLE
+  *         is defined.
+  * @retval TRUE when the timeout has passed.
+  */
+confirm_state i2c_timeout_check(uint32_t start, uint32_t timeout)
+{
+#ifdef I2C_TIMEOUT_FOREVER_ENABLE
+  if(timeout == I2C_TIMEOUT_FOREVER)
+  {
+    return FALSE;
+  }
+#endif
+
+  if(timeout > I2C_TIMEOUT_LIMIT)
+  {
+    timeout = I2C_TIMEOUT_LIMIT;
+  }
+
+  /* compare in ticks, the tick difference is exact up to the wrap of the
+     32 bit counter, which the limit keeps clear of */
+  return ((i2c_tick_get() - start) >= timeout * I2C_TICKS_PER_US) ? TRUE : FALSE;
+}
+
+/**
+  * @brief  wait some microseconds.
+  * @param  us: time in microseconds.
+  * @retval none
+  */
+static void i2c_delay_us(uint32_t us)
+{
+  uint32_t start = i2c_tick_get();
+
+  while(i2c_timeout_check(start, us) == FALSE)
+  {
+  }
+}
+
 /**
   * @brief  i2c peripheral initialization.
   * @param  hi2c: the handle points to the operation information.
@@ -88,6 +154,10 @@ void i2c_config(i2c_handle_type* hi2c)
 
   /* i2c peripheral initialization */
   i2c_lowlevel_init(hi2c);
+
+  /* start the dwt cycle counter of the default i2c_tick_get() */
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
   
   /* i2c digital filtering time = dfilters/apb1clk */
   i2c_digital_filter_value_set(hi2c->i2cx, 0x02);
@@ -99,16 +169,20 @@ void i2c_config(i2c_handle_type* hi2c)
 /**
   * @brief  wait for the transfer to end.
   * @param  hi2c: the handle points to the operation information.
-  * @param  timeout: maximum waiting time.
+  * @param  timeout: maximum waiting time in microseconds.
   * @retval i2c status.
   */
 i2c_status_type i2c_wait_end(i2c_handle_type* hi2c, uint32_t timeout)
 {
+  uint32_t start = i2c_tick_get();
+
   while(hi2c->status != I2C_END)
   {
     /* check timeout */
-    if((timeout--) == 0)
+    if(i2c_timeout_check(start, timeout) == TRUE)
     {
+      hi2c->stats.timeout_count++;
+
       return I2C_ERR_TIMEOUT;
     }
   }
@@ -155,18 +229,31 @@ i2c_status_type i2c_wait_end(i2c_handle_type* hi2c, uint32_t timeout)
   *         - I2C_EVENT_CHECK_NONE
   *         - I2C_EVENT_CHECK_ACKFAIL
   *         - I2C_EVENT_CHECK_STOP
-  * @param  timeout: maximum waiting time.
+  * @param  timeout: maximum waiting time in microseconds. a bus still busy at
+  *         the timeout is recovered by i2c_bus_recover() once.
   * @retval i2c status.
   */
 i2c_status_type i2c_wait_flag(i2c_handle_type* hi2c, uint32_t flag, uint32_t event_check, uint32_t timeout)
 {
+  uint32_t start = i2c_tick_get();
+
   if(flag == I2C_BUSYF_FLAG)
   {
     while(i2c_flag_get(hi2c->i2cx, flag) != RESET)
     {
       /* check timeout */
-      if((timeout--) == 0)
+      if(i2c_timeout_check(start, timeout) == TRUE)
       {
+        hi2c->stats.timeout_count++;
+
+        /* a slave holding sda low, clock it free */
+        i2c_bus_recover(hi2c);
+
+        if(i2c_flag_get(hi2c->i2cx, flag) == RESET)
+        {
+          break;
+        }
+
         hi2c->error_code = I2C_ERR_TIMEOUT;
 
         return I2C_ERR_TIMEOUT;
@@ -188,6 +275,8 @@ i2c_status_type i2c_wait_flag(i2c_handle_type* hi2c, uint32_t flag, uint32_t eve
           /* clear ack fail flag */
           i2c_flag_clear(hi2c->i2cx, I2C_ACKFAIL_FLAG);
 
+          hi2c->stats.nack_count++;
+
           hi2c->error_code = I2C_ERR_ACKFAIL;
 
           return I2C_ERR_ACKFAIL;
@@ -209,8 +298,10 @@ i2c_status_type i2c_wait_flag(i2c_handle_type* hi2c, uint32_t flag, uint32_t eve
       }
 
       /* check timeout */
-      if((timeout--) == 0)
+      if(i2c_timeout_check(start, timeout) == TRUE)
       {
+        hi2c->stats.timeout_count++;
+
         hi2c->error_code = I2C_ERR_TIMEOUT;
 
         return I2C_ERR_TIMEOUT;
@@ -221,6 +312,74 @@ i2c_status_type i2c_wait_flag(i2c_handle_type* hi2c, uint32_t flag, uint32_t eve
   return I2C_OK;
 }
 
+/**
+  * @brief  free a bus held by a slave, for example after a reset in the middle
+  *         of a read. scl is clocked up to I2C_RECOVER_CLOCKS times until the
+  *         slave releases sda, then a stop is sent and the i2c is configured
+  *         again by i2c_config(). without hi2c->scl_gpio and hi2c->sda_gpio
+  *         only the i2c is reset.
+  * @param  hi2c: the handle points to the operation information.
+  * @retval none.
+  */
+void i2c_bus_recover(i2c_handle_type* hi2c)
+{
+  gpio_init_type gpio_init_struct;
+  uint32_t index;
+
+  hi2c->stats.recover_count++;
+
+  /* release the pins from the i2c */
+  i2c_enable(hi2c->i2cx, FALSE);
+
+  if((hi2c->scl_gpio != 0) && (hi2c->sda_gpio != 0))
+  {
+    gpio_bits_set(hi2c->scl_gpio, hi2c->scl_pin);
+    gpio_bits_set(hi2c->sda_gpio, hi2c->sda_pin);
+
+    gpio_default_para_init(&gpio_init_struct);
+    gpio_init_struct.gpio_out_type       = GPIO_OUTPUT_OPEN_DRAIN;
+    gpio_init_struct.gpio_pull           = GPIO_PULL_NONE;
+    gpio_init_struct.gpio_mode           = GPIO_MODE_OUTPUT;
+    gpio_init_struct.gpio_drive_strength = GPIO_DRIVE_STRENGTH_MODERATE;
+
+    gpio_init_struct.gpio_pins = hi2c->scl_pin;
+    gpio_init(hi2c->scl_gpio, &gpio_init_struct);
+
+    gpio_init_struct.gpio_pins = hi2c->sda_pin;
+    gpio_init(hi2c->sda_gpio, &gpio_init_struct);
+
+    i2c_delay_us(I2C_RECOVER_HALF_PERIOD_US);
+
+    /* clock the slave to the end of its byte */
+    for(index = 0; index < I2C_RECOVER_CLOCKS; index++)
+    {
+      if(gpio_input_data_bit_read(hi2c->sda_gpio, hi2c->sda_pin) != RESET)
+      {
+        break;
+      }
+
+      gpio_bits_reset(hi2c->scl_gpio, hi2c->scl_pin);
+      i2c_delay_us(I2C_RECOVER_HALF_PERIOD_US);
+
+      gpio_bits_set(hi2c->scl_gpio, hi2c->scl_pin);
+      i2c_delay_us(I2C_RECOVER_HALF_PERIOD_US);
+    }
+
+    /* stop condition, sda rises while scl is high */
+    gpio_bits_reset(hi2c->scl_gpio, hi2c->scl_pin);
+    i2c_delay_us(I2C_RECOVER_HALF_PERIOD_US);
+    gpio_bits_reset(hi2c->sda_gpio, hi2c->sda_pin);
+    i2c_delay_us(I2C_RECOVER_HALF_PERIOD_US);
+    gpio_bits_set(hi2c->scl_gpio, hi2c->scl_pin);
+    i2c_delay_us(I2C_RECOVER_HALF_PERIOD_US);
+    gpio_bits_set(hi2c->sda_gpio, hi2c->sda_pin);
+    i2c_delay_us(I2C_RECOVER_HALF_PERIOD_US);
+  }
+
+  /* reset the i2c, i2c_lowlevel_init() gives the pins back to it */
+  i2c_config(hi2c);
+}
+
 /**
   * @brief  dma transfer cofiguration.
   * @param  hi2c: the handle points to the operation information.
@@ -255,7 +414,7 @@ void i2c_dma_config(i2c_handle_type* hi2c, dma_channel_type* dma_channelx, uint8
   * @brief  send address in master transmits mode.
   * @param  hi2c: the handle points to the operation information.
   * @param  address: slave address.
-  * @param  timeout: maximum waiting time.
+  * @param  timeout: maximum waiting time in microseconds.
   * @retval i2c status.
   */
 i2c_status_type i2c_master_write_addr(i2c_handle_type *hi2c, uint16_t address, uint32_t timeout)
@@ -308,7 +467,7 @@ i2c_status_type i2c_master_write_addr(i2c_handle_type *hi2c, uint16_t address, u
   * @brief  send address in master receive mode.
   * @param  hi2c: the handle points to the operation information.
   * @param  address: slave address.
-  * @param  timeout: maximum waiting time.
+  * @param  timeout: maximum waiting time in microseconds.
   * @retval i2c status.
   */
 i2c_status_type i2c_master_read_addr(i2c_handle_type *hi2c, uint16_t address, uint32_t timeout)
@@ -391,7 +550,7 @@ i2c_status_type i2c_master_read_addr(i2c_handle_type *hi2c, uint16_t address, ui
   * @param  address: slave address.
   * @param  pdata: data buffer.
   * @param  size: data size.
-  * @param  timeout: maximum waiting time.
+  * @param  timeout: maximum waiting time in microseconds.
   * @retval i2c status.
   */
 i2c_status_type i2c_master_transmit(i2c_handle_type* hi2c, uint16_t address, uint8_t* pdata, uint16_t size, uint32_t timeout)
@@ -459,7 +618,7 @@ i2c_status_type i2c_master_transmit(i2c_handle_type* hi2c, uint16_t address, uin
   * @param  hi2c: the handle points to the operation information.
   * @param  pdata: data buffer.
   * @param  size: data size.
-  * @param  timeout: maximum waiting time.
+  * @param  timeout: maximum waiting time in microseconds.
   * @retval i2c status.
   */
 i2c_status_type i2c_slave_receive(i2c_handle_type* hi2c, uint8_t* pdata, uint16_t size, uint32_t timeout)
@@ -534,7 +693,7 @@ i2c_status_type i2c_slave_receive(i2c_handle_type* hi2c, uint8_t* pdata, uint16_
   * @param  address: slave address.
   * @param  pdata: data buffer.
   * @param  size: data size.
-  * @param  timeout: maximum waiting time.
+  * @param  timeout: maximum waiting time in microseconds.
   * @retval i2c status.
   */
 i2c_status_type i2c_master_receive(i2c_handle_type* hi2c, uint16_t address, uint8_t* pdata, uint16_t size, uint32_t timeout)
@@ -705,7 +864,7 @@ i2c_status_type i2c_master_receive(i2c_handle_type* hi2c, uint16_t address, uint
   * @param  hi2c: the handle points to the operation information.
   * @param  pdata: data buffer.
   * @param  size: data size.
-  * @param  timeout: maximum waiting time.
+  * @param  timeout: maximum waiting time in microseconds.
   * @retval i2c status.
   */
 i2c_status_type i2c_slave_transmit(i2c_handle_type* hi2c, uint8_t* pdata, uint16_t size, uint32_t timeout)
@@ -792,7 +951,7 @@ i2c_status_type i2c_slave_transmit(i2c_handle_type* hi2c, uint8_t* pdata, uint16
   * @param  address: slave address.
   * @param  pdata: data buffer.
   * @param  size: data size.
-  * @param  timeout: maximum waiting time.
+  * @param  timeout: maximum waiting time in microseconds.
   * @retval i2c status.
   */
 i2c_status_type i2c_master_transmit_int(i2c_handle_type* hi2c, uint16_t address, uint8_t* pdata, uint16_t size, uint32_t timeout)
@@ -839,7 +998,7 @@ i2c_status_type i2c_master_transmit_int(i2c_handle_type* hi2c, uint16_t address,
   * @param  hi2c: the handle points to the operation information.
   * @param  pdata: data buffer.
   * @param  size: data size.
-  * @param  timeout: maximum waiting time.
+  * @param  timeout: maximum waiting time in microseconds.
   * @retval i2c status.
   */
 i2c_status_type i2c_slave_receive_int(i2c_handle_type* hi2c, uint8_t* pdata, uint16_t size, uint32_t timeout)
@@ -878,7 +1037,7 @@ i2c_status_type i2c_slave_receive_int(i2c_handle_type* hi2c, uint8_t* pdata, uin
   * @param  address: slave address.
   * @param  pdata: data buffer.
   * @param  size: data size.
-  * @param  timeout: maximum waiting time.
+  * @param  timeout: maximum waiting time in microseconds.
   * @retval i2c status.
   */
 i2c_status_type i2c_master_receive_int(i2c_handle_type* hi2c, uint16_t address, uint8_t* pdata, uint16_t size, uint32_t timeout)
@@ -956,7 +1115,7 @@ i2c_status_type i2c_master_receive_int(i2c_handle_type* hi2c, uint16_t address,
   * @param  hi2c: the handle points to the operation information.
   * @param  pdata: data buffer.
   * @param  size: data size.
-  * @param  timeout: maximum waiting time.
+  * @param  timeout: maximum waiting time in microseconds.
   * @retval i2c status.
   */
 i2c_status_type i2c_slave_transmit_int(i2c_handle_type* hi2c, uint8_t* pdata, uint16_t size, uint32_t timeout)
@@ -995,7 +1154,7 @@ i2c_status_type i2c_slave_transmit_int(i2c_handle_type* hi2c, uint8_t* pdata, ui
   * @param  address: slave address.
   * @param  pdata: data buffer.
   * @param  size: data size.
-  * @param  timeout: maximum waiting time.
+  * @param  timeout: maximum waiting time in microseconds.
   * @retval i2c status.
   */
 i2c_status_type i2c_master_transmit_dma(i2c_handle_type* hi2c, uint16_t address, uint8_t* pdata, uint16_t size, uint32_t timeout)
@@ -1048,7 +1207,7 @@ i2c_status_type i2c_master_transmit_dma(i2c_handle_type* hi2c, uint16_t address,
   * @param  hi2c: the handle points to the operation information.
   * @param  pdata: data buffer.
   * @param  size: data size.
-  * @param  timeout: maximum waiting time.
+  * @param  timeout: maximum waiting time in microseconds.
   * @retval i2c status.
   */
 i2c_status_type i2c_slave_receive_dma(i2c_handle_type* hi2c, uint8_t* pdata, uint16_t size, uint32_t timeout)
@@ -1096,7 +1255,7 @@ i2c_status_type i2c_slave_receive_dma(i2c_handle_type* hi2c, uint8_t* pdata, uin
   * @param  address: slave address.
   * @param  pdata: data buffer.
   * @param  size: data size.
-  * @param  timeout: maximum waiting time.
+  * @param  timeout: maximum waiting time in microseconds.
   * @retval i2c status.
   */
 i2c_status_type i2c_master_receive_dma(i2c_handle_type* hi2c, uint16_t address, uint8_t* pdata, uint16_t size, uint32_t timeout)
@@ -1172,7 +1331,7 @@ i2c_status_type i2c_master_receive_dma(i2c_handle_type* hi2c, uint16_t address,
   * @param  hi2c: the handle points to the operation information.
   * @param  pdata: data buffer.
   * @param  size: data size.
-  * @param  timeout: maximum waiting time.
+  * @param  timeout: maximum waiting time in microseconds.
   * @retval i2c status.
   */
 i2c_status_type i2c_slave_transmit_dma(i2c_handle_type* hi2c, uint8_t* pdata, uint16_t size, uint32_t timeout)
@@ -1220,7 +1379,7 @@ i2c_status_type i2c_slave_transmit_dma(i2c_handle_type* hi2c, uint8_t* pdata, ui
   * @param  address: slave address.
   * @param  pdata: data buffer.
   * @param  size: data size.
-  * @param  timeout: maximum waiting time.
+  * @param  timeout: maximum waiting time in microseconds.
   * @retval i2c status.
   */
 i2c_status_type i2c_smbus_master_transmit(i2c_handle_type* hi2c, uint16_t address, uint8_t *pdata, uint16_t size, uint32_t timeout)
@@ -1296,7 +1455,7 @@ i2c_status_type i2c_smbus_master_transmit(i2c_handle_type* hi2c, uint16_t addres
   * @param  hi2c: the handle points to the operation information.
   * @param  pdata: data buffer.
   * @param  size: data size.
-  * @param  timeout: maximum waiting time.
+  * @param  timeout: maximum waiting time in microseconds.
   * @retval i2c status.
   */
 i2c_status_type i2c_smbus_slave_receive(i2c_handle_type* hi2c, uint8_t *pdata, uint16_t size, uint32_t timeout)
@@ -1395,7 +1554,7 @@ i2c_status_type i2c_smbus_slave_receive(i2c_handle_type* hi2c, uint8_t *pdata, u
   * @param  address: slave address.
   * @param  pdata: data buffer.
   * @param  size: data size.
-  * @param  timeout: maximum waiting time.
+  * @param  timeout: maximum waiting time in microseconds.
   * @retval i2c status.
   */
 i2c_status_type i2c_smbus_master_receive(i2c_handle_type* hi2c, uint16_t address, uint8_t *pdata, uint16_t size, uint32_t timeout)
@@ -1560,7 +1719,7 @@ i2c_status_type i2c_smbus_master_receive(i2c_handle_type* hi2c, uint16_t address
   * @param  hi2c: the handle points to the operation information.
   * @param  pdata: data buffer.
   * @param  size: data size.
-  * @param  timeout: maximum waiting time.
+  * @param  timeout: maximum waiting time in microseconds.
   * @retval i2c status.
   */
 i2c_status_type i2c_smbus_slave_transmit(i2c_handle_type* hi2c, uint8_t *pdata, uint16_t size, uint32_t timeout)
@@ -1667,7 +1826,7 @@ i2c_status_type i2c_smbus_slave_transmit(i2c_handle_type* hi2c, uint8_t *pdata,
   *         - I2C_MEM_ADDR_WIDIH_16:  memory address is 16 bit
   * @param  address: memory device address.
   * @param  mem_address: memory address.
-  * @param  timeout: maximum waiting time.
+  * @param  timeout: maximum waiting time in microseconds.
   * @retval i2c status.
   */
 i2c_status_type i2c_memory_address_send(i2c_handle_type* hi2c, i2c_mem_address_width_type mem_address_width, uint16_t mem_address, int32_t timeout)
@@ -1713,7 +1872,7 @@ i2c_status_type i2c_memory_address_send(i2c_handle_type* hi2c, i2c_mem_address_w
   * @param  mem_address: memory address.
   * @param  pdata: data buffer.
   * @param  size: data size.
-  * @param  timeout: maximum waiting time.
+  * @param  timeout: maximum waiting time in microseconds.
   * @retval i2c status.
   */
 i2c_status_type i2c_memory_write(i2c_handle_type* hi2c, i2c_mem_address_width_type mem_address_width, uint16_t address, uint16_t mem_address, uint8_t* pdata, uint16_t size, uint32_t timeout)
@@ -1802,7 +1961,7 @@ i2c_status_type i2c_memory_write(i2c_handle_type* hi2c, i2c_mem_address_width_ty
   * @param  mem_address: memory address.
   * @param  pdata: data buffer.
   * @param  size: data size.
-  * @param  timeout: maximum waiting time.
+  * @param  timeout: maximum waiting time in microseconds.
   * @retval i2c status.
   */
 i2c_status_type i2c_memory_read(i2c_handle_type* hi2c, i2c_mem_address_width_type mem_address_width, uint16_t address, uint16_t mem_address, uint8_t* pdata, uint16_t size, uint32_t timeout)
@@ -2015,7 +2174,7 @@ i2c_status_type i2c_memory_read(i2c_handle_type* hi2c, i2c_mem_address_width_typ
   * @param  mem_address: memory address.
   * @param  pdata: data buffer.
   * @param  size: data size.
-  * @param  timeout: maximum waiting time.
+  * @param  timeout: maximum waiting time in microseconds.
   * @retval i2c status.
   */
 i2c_status_type i2c_memory_write_int(i2c_handle_type* hi2c, i2c_mem_address_width_type mem_address_width, uint16_t address, uint16_t mem_address, uint8_t* pdata, uint16_t size, uint32_t timeout)
@@ -2092,7 +2251,7 @@ i2c_status_type i2c_memory_write_int(i2c_handle_type* hi2c, i2c_mem_address_widt
   * @param  mem_address: memory address.
   * @param  pdata: data buffer.
   * @param  size: data size.
-  * @param  timeout: maximum waiting time.
+  * @param  timeout: maximum waiting time in microseconds.
   * @retval i2c status.
   */
 i2c_status_type i2c_memory_read_int(i2c_handle_type* hi2c, i2c_mem_address_width_type mem_address_width, uint16_t address, uint16_t mem_address, uint8_t* pdata, uint16_t size, uint32_t timeout)
@@ -2209,7 +2368,7 @@ i2c_status_type i2c_memory_read_int(i2c_handle_type* hi2c, i2c_mem_address_width
   * @param  mem_address: memory address.
   * @param  pdata: data buffer.
   * @param  size: data size.
-  * @param  timeout: maximum waiting time.
+  * @param  timeout: maximum waiting time in microseconds.
   * @retval i2c status.
   */
 i2c_status_type i2c_memory_write_dma(i2c_handle_type* hi2c, i2c_mem_address_width_type mem_address_width, uint16_t address, uint16_t mem_address, uint8_t* pdata, uint16_t size, uint32_t timeout)
@@ -2292,7 +2451,7 @@ i2c_status_type i2c_memory_write_dma(i2c_handle_type* hi2c, i2c_mem_address_widt
   * @param  mem_address: memory address.
   * @param  pdata: data buffer.
   * @param  size: data size.
-  * @param  timeout: maximum waiting time.
+  * @param  timeout: maximum waiting time in microseconds.
   * @retval i2c status.
   */
 i2c_status_type i2c_memory_read_dma(i2c_handle_type* hi2c, i2c_mem_address_width_type mem_address_width, uint16_t address, uint16_t mem_address, uint8_t* pdata, uint16_t size, uint32_t timeout)
@@ -2635,6 +2794,557 @@ void i2c_slave_tx_rx_isr_dma(i2c_handle_type* hi2c)
   }
 }
 
+/**
+  * @brief  scl period of the i2c configured by i2c_init().
+  * @param  i2cx: i2c registers base address.
+  * @retval period in microseconds, rounded up.
+  */
+static uint32_t i2c_scl_period_get(i2c_type* i2cx)
+{
+  uint32_t clocks = i2cx->clkctrl_bit.speed;
+  uint32_t freq = i2cx->ctrl2_bit.clkfreq;
+
+  if(i2cx->clkctrl_bit.speedmode == 0)
+  {
+    /* standard mode, low and high of speed clocks each */
+    clocks *= 2;
+  }
+  else
+  {
+    /* fast mode, duty 2:1 or 16:9 */
+    clocks *= (i2cx->clkctrl_bit.dutymode == 0) ? 3 : 25;
+  }
+
+  if(freq == 0)
+  {
+    freq = 1;
+  }
+
+  return (clocks + freq - 1) / freq;
+}
+
+/**
+  * @brief  end a list of transactions taken off the queue with status, one
+  *         after the other in queue order.
+  * @param  hi2c: the handle points to the operation information.
+  * @param  xfer: first transaction of the list.
+  * @param  status: status given to the transactions.
+  * @retval none.
+  */
+static void i2c_queue_fail(i2c_handle_type* hi2c, i2c_xfer_type* xfer, i2c_status_type status)
+{
+  while(xfer != 0)
+  {
+    i2c_xfer_type *next = xfer->next;
+
+    xfer->next = 0;
+    xfer->status = status;
+
+    if(xfer->callback != 0)
+    {
+      xfer->callback(hi2c, xfer);
+    }
+
+    xfer = next;
+  }
+}
+
+/**
+  * @brief  start the transaction at the head of the queue, or leave the
+  *         interrupts disabled when the queue is empty. when the start finds
+  *         the previous stop still pending after hi2c->queue_stop_wait, the
+  *         bus is recovered and the whole queue is taken off it for the
+  *         caller to end with I2C_ERR_TIMEOUT by i2c_queue_fail().
+  * @param  hi2c: the handle points to the operation information.
+  * @retval the transactions taken off the queue, 0 when none.
+  */
+static i2c_xfer_type* i2c_queue_start(i2c_handle_type* hi2c)
+{
+  uint32_t start = i2c_tick_get();
+  i2c_xfer_type *xfer;
+
+  if(hi2c->queue_head == 0)
+  {
+    /* disable interrupt */
+    i2c_interrupt_enable(hi2c->i2cx, I2C_EVT_INT | I2C_DATA_INT | I2C_ERR_INT, FALSE);
+
+    hi2c->status = I2C_END;
+    return 0;
+  }
+
+  hi2c->mode = I2C_QUEUE_MA;
+  hi2c->status = I2C_START;
+  hi2c->error_code = I2C_OK;
+  hi2c->queue_step = I2C_QUEUE_START;
+
+  /* the stop of the previous transaction may still be on the bus */
+  while((hi2c->i2cx->ctrl1_bit.genstop) && (i2c_timeout_check(start, hi2c->queue_stop_wait) == FALSE))
+  {
+  }
+
+  if(hi2c->i2cx->ctrl1_bit.genstop)
+  {
+    /* the bus is held, fail the queue rather than start on it or wait for
+       the stop again for every transaction. the recovery resets the i2c so
+       the next submit starts clean */
+    hi2c->stats.timeout_count++;
+
+    i2c_bus_recover(hi2c);
+
+    /* disable interrupt */
+    i2c_interrupt_enable(hi2c->i2cx, I2C_EVT_INT | I2C_DATA_INT | I2C_ERR_INT, FALSE);
+
+    xfer = hi2c->queue_head;
+    hi2c->queue_head = 0;
+    hi2c->queue_tail = 0;
+    hi2c->status = I2C_END;
+
+    return xfer;
+  }
+
+  hi2c->queue_tick = i2c_tick_get();
+
+  /* ack acts on the current byte */
+  i2c_master_receive_ack_set(hi2c->i2cx, I2C_MASTER_ACK_CURRENT);
+
+  /* enable ack */
+  i2c_ack_enable(hi2c->i2cx, TRUE);
+
+  /* disable dma end transfer */
+  i2c_dma_end_transfer_set(hi2c->i2cx, FALSE);
+
+  /* generate start condtion */
+  i2c_start_generate(hi2c->i2cx);
+
+  /* enable interrupt */
+  i2c_interrupt_enable(hi2c->i2cx, I2C_EVT_INT | I2C_DATA_INT | I2C_ERR_INT, TRUE);
+
+  return 0;
+}
+
+/**
+  * @brief  stop the bus activity of the running queued transaction.
+  * @param  hi2c: the handle points to the operation information.
+  * @retval none.
+  */
+static void i2c_queue_stop(i2c_handle_type* hi2c)
+{
+  /* disable dma request */
+  i2c_dma_enable(hi2c->i2cx, FALSE);
+
+  if(hi2c->dma_tx_channel != 0)
+  {
+    dma_channel_enable(hi2c->dma_tx_channel, FALSE);
+    dma_interrupt_enable(hi2c->dma_tx_channel, DMA_FDT_INT, FALSE);
+  }
+  if(hi2c->dma_rx_channel != 0)
+  {
+    dma_channel_enable(hi2c->dma_rx_channel, FALSE);
+    dma_interrupt_enable(hi2c->dma_rx_channel, DMA_FDT_INT, FALSE);
+  }
+
+  /* generate stop condtion */
+  i2c_stop_generate(hi2c->i2cx);
+}
+
+/**
+  * @brief  finish the running queued transaction, start the next one and call
+  *         the callback of the finished one.
+  * @param  hi2c: the handle points to the operation information.
+  * @param  status: result of the transaction.
+  * @retval none.
+  */
+static void i2c_queue_done(i2c_handle_type* hi2c, i2c_status_type status)
+{
+  i2c_xfer_type *xfer = hi2c->queue_head;
+  i2c_xfer_type *failed;
+
+  hi2c->queue_head = xfer->next;
+  if(hi2c->queue_head == 0)
+  {
+    hi2c->queue_tail = 0;
+  }
+
+  xfer->next = 0;
+  xfer->status = status;
+
+  /* back to back, the callback may queue more */
+  failed = i2c_queue_start(hi2c);
+
+  if(xfer->callback != 0)
+  {
+    xfer->callback(hi2c, xfer);
+  }
+
+  i2c_queue_fail(hi2c, failed, I2C_ERR_TIMEOUT);
+}
+
+/**
+  * @brief  read part of the running queued transaction after the address is
+  *         acknowledged, by dma for two bytes or more when hi2c->dma_rx_channel
+  *         is set, else by interrupts.
+  * @param  hi2c: the handle points to the operation information.
+  * @param  xfer: running transaction.
+  * @retval none.
+  */
+static void i2c_queue_read_start(i2c_handle_type* hi2c, i2c_xfer_type* xfer)
+{
+  hi2c->pbuff  = xfer->rdata;
+  hi2c->pcount = xfer->rsize;
+
+  if((hi2c->dma_rx_channel != 0) && (xfer->rsize > 1))
+  {
+    hi2c->queue_step = I2C_QUEUE_READ_DMA;
+
+    /* only the dma ends the read */
+    i2c_interrupt_enable(hi2c->i2cx, I2C_EVT_INT | I2C_DATA_INT, FALSE);
+
+    /* configure the dma channel */
+    i2c_dma_config(hi2c, hi2c->dma_rx_channel, xfer->rdata, xfer->rsize);
+
+    /* enable dma end transfer */
+    i2c_dma_end_transfer_set(hi2c->i2cx, TRUE);
+
+    /* enable dma request */
+    i2c_dma_enable(hi2c->i2cx, TRUE);
+
+    /* clear addr flag */
+    i2c_flag_clear(hi2c->i2cx, I2C_ADDR7F_FLAG);
+    return;
+  }
+
+  hi2c->queue_step = I2C_QUEUE_READ;
+
+  if(xfer->rsize == 1)
+  {
+    /* disable ack */
+    i2c_ack_enable(hi2c->i2cx, FALSE);
+
+    /* clear addr flag */
+    i2c_flag_clear(hi2c->i2cx, I2C_ADDR7F_FLAG);
+
+    /* generate stop condtion */
+    i2c_stop_generate(hi2c->i2cx);
+  }
+  else if(xfer->rsize == 2)
+  {
+    /* ack acts on the next byte */
+    i2c_master_receive_ack_set(hi2c->i2cx, I2C_MASTER_ACK_NEXT);
+
+    /* clear addr flag */
+    i2c_flag_clear(hi2c->i2cx, I2C_ADDR7F_FLAG);
+
+    /* disable ack */
+    i2c_ack_enable(hi2c->i2cx, FALSE);
+  }
+  else
+  {
+    /* clear addr flag */
+    i2c_flag_clear(hi2c->i2cx, I2C_ADDR7F_FLAG);
+  }
+
+  /* enable rdbf interrupt */
+  i2c_interrupt_enable(hi2c->i2cx, I2C_DATA_INT, TRUE);
+}
+
+/**
+  * @brief  end of the write part when the last byte is out, restart for the
+  *         read part or stop.
+  * @param  hi2c: the handle points to the operation information.
+  * @param  xfer: running transaction.
+  * @retval none.
+  */
+static void i2c_queue_write_end(i2c_handle_type* hi2c, i2c_xfer_type* xfer)
+{
+  if(xfer->rsize != 0)
+  {
+    hi2c->queue_step = I2C_QUEUE_RESTART;
+
+    /* tdbe stays set until the restart, wait for the start flag only */
+    i2c_interrupt_enable(hi2c->i2cx, I2C_DATA_INT, FALSE);
+    i2c_interrupt_enable(hi2c->i2cx, I2C_EVT_INT, TRUE);
+
+    /* generate restart condtion */
+    i2c_start_generate(hi2c->i2cx);
+  }
+  else
+  {
+    /* generate stop condtion */
+    i2c_stop_generate(hi2c->i2cx);
+
+    i2c_queue_done(hi2c, I2C_OK);
+  }
+}
+
+/**
+  * @brief  queued transaction interrupt procession function.
+  * @param  hi2c: the handle points to the operation information.
+  * @retval none.
+  */
+static void i2c_queue_isr(i2c_handle_type* hi2c)
+{
+  i2c_xfer_type *xfer = hi2c->queue_head;
+
+  if(xfer == 0)
+  {
+    /* disable interrupt */
+    i2c_interrupt_enable(hi2c->i2cx, I2C_EVT_INT | I2C_DATA_INT | I2C_ERR_INT, FALSE);
+    return;
+  }
+
+  switch(hi2c->queue_step)
+  {
+    case I2C_QUEUE_START:
+    case I2C_QUEUE_RESTART:
+      if(i2c_flag_get(hi2c->i2cx, I2C_STARTF_FLAG) != RESET)
+      {
+        if((hi2c->queue_step == I2C_QUEUE_START) && (xfer->wsize != 0))
+        {
+          /* send slave address */
+          i2c_7bit_address_send(hi2c->i2cx, (uint8_t)xfer->address, I2C_DIRECTION_TRANSMIT);
+          hi2c->queue_step = I2C_QUEUE_ADDR_WRITE;
+        }
+        else
+        {
+          /* send slave address */
+          i2c_7bit_address_send(hi2c->i2cx, (uint8_t)xfer->address, I2C_DIRECTION_RECEIVE);
+          hi2c->queue_step = I2C_QUEUE_ADDR_READ;
+        }
+      }
+      break;
+
+    case I2C_QUEUE_ADDR_WRITE:
+      if(i2c_flag_get(hi2c->i2cx, I2C_ADDR7F_FLAG) != RESET)
+      {
+        hi2c->pbuff  = xfer->wdata;
+        hi2c->pcount = xfer->wsize;
+
+        if((hi2c->dma_tx_channel != 0) && (xfer->wsize > 2))
+        {
+          hi2c->queue_step = I2C_QUEUE_WRITE_DMA;
+
+          /* the dma transmit interrupt enables the tdc interrupt */
+          i2c_interrupt_enable(hi2c->i2cx, I2C_EVT_INT | I2C_DATA_INT, FALSE);
+
+          /* configure the dma channel */
+          i2c_dma_config(hi2c, hi2c->dma_tx_channel, xfer->wdata, xfer->wsize);
+
+          /* enable dma request */
+          i2c_dma_enable(hi2c->i2cx, TRUE);
+        }
+        else
+        {
+          hi2c->queue_step = I2C_QUEUE_WRITE;
+        }
+
+        /* clear addr flag */
+        i2c_flag_clear(hi2c->i2cx, I2C_ADDR7F_FLAG);
+      }
+      break;
+
+    case I2C_QUEUE_WRITE:
+      if(i2c_flag_get(hi2c->i2cx, I2C_TDBE_FLAG) != RESET)
+      {
+        if(hi2c->pcount == 0)
+        {
+          hi2c->queue_step = I2C_QUEUE_WRITE_END;
+
+          /* stop or restart once the last byte is out */
+          i2c_interrupt_enable(hi2c->i2cx, I2C_DATA_INT, FALSE);
+        }
+        else
+        {
+          /* write data */
+          i2c_data_send(hi2c->i2cx, *hi2c->pbuff++);
+          hi2c->pcount--;
+        }
+      }
+      break;
+
+    case I2C_QUEUE_WRITE_END:
+      if(i2c_flag_get(hi2c->i2cx, I2C_TDC_FLAG) != RESET)
+      {
+        i2c_queue_write_end(hi2c, xfer);
+      }
+      break;
+
+    case I2C_QUEUE_ADDR_READ:
+      if(i2c_flag_get(hi2c->i2cx, I2C_ADDR7F_FLAG) != RESET)
+      {
+        i2c_queue_read_start(hi2c, xfer);
+      }
+      break;
+
+    case I2C_QUEUE_READ:
+      i2c_master_rx_isr_int(hi2c);
+
+      if(hi2c->pcount == 0)
+      {
+        i2c_queue_done(hi2c, I2C_OK);
+      }
+      break;
+
+    default:
+      break;
+  }
+}
+
+/**
+  * @brief  queued transaction error procession function, the transaction ends
+  *         with the error and the next one starts.
+  * @param  hi2c: the handle points to the operation information.
+  * @retval none.
+  */
+static void i2c_queue_err_isr(i2c_handle_type* hi2c)
+{
+  i2c_status_type status = I2C_ERR_INTERRUPT;
+
+  if(i2c_flag_get(hi2c->i2cx, I2C_ACKFAIL_FLAG) != RESET)
+  {
+    status = I2C_ERR_ACKFAIL;
+
+    hi2c->stats.nack_count++;
+  }
+  else
+  {
+    hi2c->stats.error_count++;
+  }
+
+  /* clear buserr, arlost, ackfail, ouf, pecerr, tmout and alertf flags */
+  i2c_flag_clear(hi2c->i2cx, I2C_BUSERR_FLAG | I2C_ARLOST_FLAG | I2C_ACKFAIL_FLAG | I2C_OUF_FLAG |
+                             I2C_PECERR_FLAG | I2C_TMOUT_FLAG | I2C_ALERTF_FLAG);
+
+  hi2c->error_code = status;
+
+  if(hi2c->queue_head == 0)
+  {
+    /* disable interrupt */
+    i2c_interrupt_enable(hi2c->i2cx, I2C_EVT_INT | I2C_DATA_INT | I2C_ERR_INT, FALSE);
+    return;
+  }
+
+  i2c_queue_stop(hi2c);
+
+  i2c_queue_done(hi2c, status);
+}
+
+/**
+  * @brief  queue a master transaction, it runs from the interrupts after the
+  *         ones queued before and xfer->callback is called at its end. the
+  *         transactions of several slaves can be queued on one bus.
+  * @note   the i2c event and error interrupts, and the dma interrupts when
+  *         hi2c->dma_tx_channel or hi2c->dma_rx_channel is set, should call the
+  *         irq handlers of this library with the same priority. with dma the
+  *         hi2c->dma_init_struct is set as for i2c_master_transmit_dma().
+  *         the polling, int and dma functions must not be used while the queue
+  *         is running. hi2c->timeout is the longest transaction in microseconds,
+  *         see i2c_queue_timeout_check(). the wait of a transaction for the
+  *         stop of the one before is I2C_QUEUE_STOP_SCL_PERIODS scl periods.
+  * @param  hi2c: the handle points to the operation information.
+  * @param  xfer: transaction, xfer->status is I2C_PENDING until the end.
+  * @retval i2c status.
+  */
+i2c_status_type i2c_queue_submit(i2c_handle_type* hi2c, i2c_xfer_type* xfer)
+{
+  uint32_t primask;
+  i2c_xfer_type *failed = 0;
+
+  /* the queue sends 7-bit addresses only */
+  if(((xfer->wsize == 0) && (xfer->rsize == 0)) || (xfer->address > 0xFF))
+  {
+    return I2C_ERR_STEP_1;
+  }
+
+  xfer->status = I2C_PENDING;
+  xfer->next = 0;
+
+  primask = __get_PRIMASK();
+  __disable_irq();
+
+  if(hi2c->queue_head == 0)
+  {
+    hi2c->queue_head = xfer;
+    hi2c->queue_tail = xfer;
+
+    /* a stop takes about one scl period, the bus is held past a few */
+    hi2c->queue_stop_wait = I2C_QUEUE_STOP_SCL_PERIODS * i2c_scl_period_get(hi2c->i2cx);
+
+    failed = i2c_queue_start(hi2c);
+  }
+  else
+  {
+    hi2c->queue_tail->next = xfer;
+    hi2c->queue_tail = xfer;
+  }
+
+  __set_PRIMASK(primask);
+
+  i2c_queue_fail(hi2c, failed, I2C_ERR_TIMEOUT);
+
+  return I2C_OK;
+}
+
+/**
+  * @brief  end the running and all queued transactions with status, for example
+  *         when the application finds a transaction has been running too long.
+  * @param  hi2c: the handle points to the operation information.
+  * @param  status: status given to the transactions.
+  * @retval none.
+  */
+void i2c_queue_abort(i2c_handle_type* hi2c, i2c_status_type status)
+{
+  uint32_t primask;
+  i2c_xfer_type *xfer;
+
+  primask = __get_PRIMASK();
+  __disable_irq();
+
+  xfer = hi2c->queue_head;
+  hi2c->queue_head = 0;
+  hi2c->queue_tail = 0;
+
+  if(xfer != 0)
+  {
+    /* disable interrupt */
+    i2c_interrupt_enable(hi2c->i2cx, I2C_EVT_INT | I2C_DATA_INT | I2C_ERR_INT, FALSE);
+
+    i2c_queue_stop(hi2c);
+
+    hi2c->status = I2C_END;
+  }
+
+  __set_PRIMASK(primask);
+
+  i2c_queue_fail(hi2c, xfer, status);
+}
+
+/**
+  * @brief  end the running queued transaction with I2C_ERR_TIMEOUT when it has
+  *         run longer than hi2c->timeout, recover the bus and start the next
+  *         one. it is called periodically, for example by a timer interrupt
+  *         with the priority of the i2c interrupts.
+  * @param  hi2c: the handle points to the operation information.
+  * @retval none.
+  */
+void i2c_queue_timeout_check(i2c_handle_type* hi2c)
+{
+  if((hi2c->queue_head == 0) || (i2c_timeout_check(hi2c->queue_tick, hi2c->timeout) == FALSE))
+  {
+    return;
+  }
+
+  hi2c->stats.timeout_count++;
+
+  /* disable interrupt */
+  i2c_interrupt_enable(hi2c->i2cx, I2C_EVT_INT | I2C_DATA_INT | I2C_ERR_INT, FALSE);
+
+  i2c_queue_stop(hi2c);
+
+  i2c_bus_recover(hi2c);
+
+  i2c_queue_done(hi2c, I2C_ERR_TIMEOUT);
+}
+
 /**
   * @brief  interrupt procession function.
   * @param  hi2c: the handle points to the operation information.
@@ -2663,6 +3373,9 @@ void i2c_evt_irq_handler(i2c_handle_type* hi2c)
     case I2C_DMA_SLA_RX:
       i2c_slave_tx_rx_isr_dma(hi2c);
       break;
+    case I2C_QUEUE_MA:
+      i2c_queue_isr(hi2c);
+      break;
     default:
       break;
   }
@@ -2699,6 +3412,11 @@ void i2c_dma_tx_irq_handler(i2c_handle_type* hi2c)
         /* enable ackfail interrupt, generate stop condition in ackfail interrupt */
         i2c_interrupt_enable(hi2c->i2cx, I2C_ERR_INT, TRUE);
         break;
+      case I2C_QUEUE_MA:
+        /* enable tdc interrupt, stop or restart in tdc interrupt */
+        hi2c->queue_step = I2C_QUEUE_WRITE_END;
+        i2c_interrupt_enable(hi2c->i2cx, I2C_EVT_INT, TRUE);
+        break;
       default:
         break;
     }
@@ -2745,6 +3463,13 @@ void i2c_dma_rx_irq_handler(i2c_handle_type* hi2c)
         /* enable stop interrupt, wait for the stop flag to be set  */
         i2c_interrupt_enable(hi2c->i2cx, I2C_EVT_INT, TRUE);
         break;
+      case I2C_QUEUE_MA:
+        /* generate stop condtion */
+        i2c_stop_generate(hi2c->i2cx);
+
+        /* transfer complete, start the next transaction */
+        i2c_queue_done(hi2c, I2C_OK);
+        break;
       default:
         break;
     }
@@ -2758,11 +3483,20 @@ void i2c_dma_rx_irq_handler(i2c_handle_type* hi2c)
   */
 void i2c_err_irq_handler(i2c_handle_type* hi2c)
 {
+  if(hi2c->mode == I2C_QUEUE_MA)
+  {
+    i2c_queue_err_isr(hi2c);
+
+    return;
+  }
+
   /* buserr */
   if(i2c_flag_get(hi2c->i2cx, I2C_BUSERR_FLAG) != RESET)
   {
     i2c_flag_clear(hi2c->i2cx, I2C_BUSERR_FLAG);
 
+    hi2c->stats.error_count++;
+
     hi2c->error_code = I2C_ERR_INTERRUPT;
   }
 
@@ -2771,6 +3505,8 @@ void i2c_err_irq_handler(i2c_handle_type* hi2c)
   {
     i2c_flag_clear(hi2c->i2cx, I2C_ARLOST_FLAG);
 
+    hi2c->stats.error_count++;
+
     hi2c->error_code = I2C_ERR_INTERRUPT;
   }
 
@@ -2792,6 +3528,8 @@ void i2c_err_irq_handler(i2c_handle_type* hi2c)
         hi2c->status = I2C_END;
         break;
       default:
+        hi2c->stats.nack_count++;
+
         hi2c->error_code = I2C_ERR_INTERRUPT;
         break;
     }
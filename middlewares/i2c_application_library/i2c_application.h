@@ -48,6 +48,29 @@ extern "C" {
 #define I2C_EVENT_CHECK_ACKFAIL          ((uint32_t)0x00000001)    /*!< check flag ackfail */
 #define I2C_EVENT_CHECK_STOP             ((uint32_t)0x00000002)    /*!< check flag stop */
 
+/**
+  * @}
+  */
+
+/** @defgroup I2C_library_timeout
+  * @{
+  */
+
+/* ticks of i2c_tick_get() in one microsecond, the default tick is the core clock */
+#ifndef I2C_TICKS_PER_US
+#define I2C_TICKS_PER_US                 (system_core_clock / 1000000)
+#endif
+
+/* longer timeouts are clamped to I2C_TIMEOUT_LIMIT, half the range of the tick,
+   about 17.9 s at 120 mhz. I2C_TIMEOUT_FOREVER only waits without end when the
+   application defines I2C_TIMEOUT_FOREVER_ENABLE, it is clamped else */
+#define I2C_TIMEOUT_LIMIT                (0x7FFFFFFF / I2C_TICKS_PER_US) /*!< longest timeout in microseconds */
+#define I2C_TIMEOUT_FOREVER              ((uint32_t)0xFFFFFFFF)    /*!< wait without timeout */
+
+#define I2C_RECOVER_CLOCKS               9                          /*!< scl pulses to free the bus */
+#define I2C_RECOVER_HALF_PERIOD_US       5                          /*!< scl half period of the recovery */
+#define I2C_QUEUE_STOP_SCL_PERIODS       4                          /*!< scl periods the queue waits for the previous stop */
+
 /**
   * @}
   */
@@ -80,6 +103,7 @@ typedef enum
   I2C_DMA_MA_RX,
   I2C_DMA_SLA_TX,
   I2C_DMA_SLA_RX,
+  I2C_QUEUE_MA,
 } i2c_mode_type;
 
 
@@ -113,6 +137,7 @@ typedef enum
   I2C_ERR_ACKFAIL,     /*!< ackfail error */
   I2C_ERR_TIMEOUT,     /*!< timeout error */
   I2C_ERR_INTERRUPT,   /*!< interrupt error */
+  I2C_PENDING,         /*!< queued transaction not finished */
 
 } i2c_status_type;
 
@@ -124,20 +149,68 @@ typedef enum
   * @{
   */
 
+/**
+  * @brief  bus statistics, counted since the handle was cleared.
+  */
 typedef struct
+{
+  uint32_t                               nack_count;              /*!< transfers ended by an ackfail   */
+  uint32_t                               timeout_count;           /*!< waits or transactions timed out */
+  uint32_t                               recover_count;           /*!< bus recoveries                  */
+  uint32_t                               error_count;             /*!< bus error, arbitration lost and other error interrupts */
+} i2c_stats_type;
+
+typedef struct i2c_handle_struct i2c_handle_type;
+typedef struct i2c_xfer_struct i2c_xfer_type;
+
+/**
+  * @brief  queued transaction completion callback, called in the interrupt.
+  */
+typedef void (*i2c_xfer_callback_type)(i2c_handle_type* hi2c, i2c_xfer_type* xfer);
+
+/**
+  * @brief  queued master transaction, the write part then a restart and the read
+  *         part, for example a register address then the register data. either
+  *         part may be empty. the descriptor belongs to the queue until the
+  *         callback, it must not be changed or submitted again before.
+  */
+struct i2c_xfer_struct
+{
+  uint16_t                               address;                 /*!< 7-bit slave address, bit 0 ignored */
+  uint8_t                                *wdata;                  /*!< data written first              */
+  uint16_t                               wsize;                   /*!< number of bytes written         */
+  uint8_t                                *rdata;                  /*!< data read after the restart     */
+  uint16_t                               rsize;                   /*!< number of bytes read            */
+  i2c_xfer_callback_type                 callback;                /*!< completion callback, may be NULL */
+  void                                   *arg;                    /*!< caller data for the callback    */
+  __IO i2c_status_type                   status;                  /*!< I2C_PENDING until completion    */
+  i2c_xfer_type                          *next;                   /*!< queue link                      */
+};
+
+struct i2c_handle_struct
 {
   i2c_type                               *i2cx;                   /*!< i2c registers base address      */
   uint8_t                                *pbuff;                  /*!< pointer to i2c transfer buffer  */
   __IO uint16_t                          pcount;                  /*!< i2c transfer counter            */
   __IO uint32_t                          mode;                    /*!< i2c communication mode          */
-  __IO uint32_t                          timeout;                 /*!< i2c wait time                   */
+  __IO uint32_t                          timeout;                 /*!< i2c wait time in microseconds   */
   __IO uint32_t                          status;                  /*!< i2c communication status        */
   __IO i2c_status_type                   error_code;              /*!< i2c error code                  */
   dma_channel_type                       *dma_tx_channel;         /*!< dma transmit channel            */
   dma_channel_type                       *dma_rx_channel;         /*!< dma receive channel             */
   dma_init_type                          dma_init_struct;         /*!< dma init parameters             */
   uint8_t                                pec_val;                 /*!< i2c received pec value          */
-} i2c_handle_type;
+  i2c_xfer_type                          *queue_head;             /*!< running queued transaction      */
+  i2c_xfer_type                          *queue_tail;             /*!< last queued transaction         */
+  __IO uint8_t                           queue_step;              /*!< step of the running transaction */
+  uint32_t                               queue_tick;              /*!< start tick of the running transaction */
+  uint32_t                               queue_stop_wait;         /*!< wait for the previous stop in microseconds */
+  gpio_type                              *scl_gpio;               /*!< scl port for the bus recovery, may be NULL */
+  uint16_t                               scl_pin;                 /*!< scl pin for the bus recovery    */
+  gpio_type                              *sda_gpio;               /*!< sda port for the bus recovery   */
+  uint16_t                               sda_pin;                 /*!< sda pin for the bus recovery    */
+  i2c_stats_type                         stats;                   /*!< bus statistics                  */
+};
 
 /**
   * @}
@@ -149,6 +222,9 @@ typedef struct
 
 void            i2c_config                (i2c_handle_type* hi2c);
 void            i2c_lowlevel_init         (i2c_handle_type* hi2c);
+uint32_t        i2c_tick_get              (void);
+confirm_state   i2c_timeout_check         (uint32_t start, uint32_t timeout);
+void            i2c_bus_recover           (i2c_handle_type* hi2c);
 i2c_status_type i2c_wait_end              (i2c_handle_type* hi2c, uint32_t timeout);
 i2c_status_type i2c_wait_flag             (i2c_handle_type* hi2c, uint32_t flag, uint32_t event_check, uint32_t timeout);
 
@@ -179,6 +255,10 @@ i2c_status_type i2c_memory_read           (i2c_handle_type* hi2c, i2c_mem_addres
 i2c_status_type i2c_memory_read_int       (i2c_handle_type* hi2c, i2c_mem_address_width_type mem_address_width, uint16_t address, uint16_t mem_address, uint8_t* pdata, uint16_t size, uint32_t timeout);
 i2c_status_type i2c_memory_read_dma       (i2c_handle_type* hi2c, i2c_mem_address_width_type mem_address_width, uint16_t address, uint16_t mem_address, uint8_t* pdata, uint16_t size, uint32_t timeout);
 
+i2c_status_type i2c_queue_submit          (i2c_handle_type* hi2c, i2c_xfer_type* xfer);
+void            i2c_queue_abort           (i2c_handle_type* hi2c, i2c_status_type status);
+void            i2c_queue_timeout_check   (i2c_handle_type* hi2c);
+
 void            i2c_evt_irq_handler       (i2c_handle_type* hi2c);
 void            i2c_err_irq_handler       (i2c_handle_type* hi2c);
 void            i2c_dma_tx_irq_handler    (i2c_handle_type* hi2c);
@@ -0,0 +1,671 @@
+/**
+  **************************************************************************
+  * @file     kv_application.c
+  * @brief    the driver library of the flash key/value store
+  **************************************************************************
+  *
+  * Copyright (c) 2025, Artery Technology, All rights reserved.
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+#include "kv_application.h"
+
+/** @addtogroup AT32F422_426_middlewares_kv_application_library
+  * @{
+  */
+
+
+/**
+  * @brief sector layout
+  *        sector: | magic | seq | record | record | ... | 0xFF ... |
+  *        record: | key | length | data, padded with 0xFF to a halfword | crc16 |
+  *        the magic is programmed after the sequence when a sector is opened and
+  *        cleared before the sector is erased, the crc of a record is programmed last.
+  *        a crc of 0xffff is stored as 0, so a record cut off before its crc never
+  *        checks whatever its data.
+  */
+#define KV_SECTOR_ADDR(hkv, sector)      ((hkv)->base_addr + (uint32_t)(sector) * (hkv)->sector_size)
+#define KV_HALFWORD(addr)                (*(__IO uint16_t *)(addr))
+#define KV_RECORD_SIZE(len)              (KV_RECORD_OVERHEAD + (((uint32_t)(len) + 1) & ~(uint32_t)1))
+#define KV_DATA_MAX(hkv)                 (((hkv)->sector_size - KV_SECTOR_HEADER_SIZE) / 4)
+
+/**
+  * @brief record scan result
+  */
+#define KV_RECORD_END                    0
+#define KV_RECORD_VALID                  1
+#define KV_RECORD_TORN                   2
+
+/**
+  * @brief  update a crc-16/ccitt-false with one byte.
+  * @param  crc: current crc.
+  * @param  data: the byte.
+  * @retval new crc.
+  */
+static uint16_t kv_crc16_update(uint16_t crc, uint8_t data)
+{
+  uint8_t i;
+
+  crc ^= (uint16_t)data << 8;
+  for(i = 0; i < 8; i++)
+  {
+    crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+  }
+
+  return crc;
+}
+
+/**
+  * @brief  the crc as stored, never the erased value.
+  * @param  crc: crc of the record.
+  * @retval stored crc.
+  */
+static uint16_t kv_crc16_stored(uint16_t crc)
+{
+  return (crc == 0xFFFF) ? 0x0000 : crc;
+}
+
+/**
+  * @brief  check the record at addr.
+  * @param  hkv: the handle points to the key/value store information.
+  * @param  addr: record address.
+  * @param  limit: end address of its sector.
+  * @param  size: size of the record when it is valid.
+  * @retval KV_RECORD_END, KV_RECORD_VALID or KV_RECORD_TORN.
+  */
+static uint8_t kv_record_check(kv_handle_type* hkv, uint32_t addr, uint32_t limit, uint32_t* size)
+{
+  uint16_t key, len, crc = 0xFFFF;
+  uint32_t i;
+
+  if(addr + KV_RECORD_OVERHEAD > limit)
+  {
+    return KV_RECORD_END;
+  }
+
+  key = KV_HALFWORD(addr);
+  len = KV_HALFWORD(addr + 2);
+  if((key == 0xFFFF) && (len == 0xFFFF))
+  {
+    return KV_RECORD_END;
+  }
+
+  *size = KV_RECORD_SIZE(len & ~KV_RECORD_TOMBSTONE);
+  if((key == 0xFFFF) || (addr + *size > limit))
+  {
+    return KV_RECORD_TORN;
+  }
+
+  for(i = 0; i < *size - 2; i++)
+  {
+    crc = kv_crc16_update(crc, *(__IO uint8_t *)(addr + i));
+  }
+
+  return (KV_HALFWORD(addr + *size - 2) == kv_crc16_stored(crc)) ? KV_RECORD_VALID : KV_RECORD_TORN;
+}
+
+/**
+  * @brief  program one halfword.
+  * @param  addr: the address.
+  * @param  data: the halfword.
+  * @retval key/value store status.
+  */
+static kv_status_type kv_program(uint32_t addr, uint16_t data)
+{
+  return (flash_halfword_program(addr, data) == FLASH_OPERATE_DONE) ? KV_OK : KV_ERR_FLASH;
+}
+
+/**
+  * @brief  retire then erase a sector, a sector cut off in the middle of its
+  *         erase is never taken for a sector in use.
+  * @param  hkv: the handle points to the key/value store information.
+  * @param  sector: the sector.
+  * @retval key/value store status.
+  */
+static kv_status_type kv_sector_erase(kv_handle_type* hkv, uint8_t sector)
+{
+  uint32_t addr = KV_SECTOR_ADDR(hkv, sector);
+
+  if(KV_HALFWORD(addr) != KV_SECTOR_RETIRED)
+  {
+    /* when this program fails the header may still read as the magic. a sector
+       cut off in its erase then either breaks the run of consecutive seq which
+       kv_init walks back from the newest sector, so it is erased again at mount,
+       or it is the oldest sector of that run, whose live records were all copied
+       ahead before its collection and are overridden by those copies. */
+    kv_program(addr, KV_SECTOR_RETIRED);
+  }
+
+  hkv->erase_count++;
+  return (flash_sector_erase(addr) == FLASH_OPERATE_DONE) ? KV_OK : KV_ERR_FLASH;
+}
+
+/**
+  * @brief  check whether a sector is blank.
+  * @param  hkv: the handle points to the key/value store information.
+  * @param  sector: the sector.
+  * @retval TRUE or FALSE.
+  */
+static confirm_state kv_sector_blank(kv_handle_type* hkv, uint8_t sector)
+{
+  uint32_t addr = KV_SECTOR_ADDR(hkv, sector);
+  uint32_t i;
+
+  for(i = 0; i < hkv->sector_size; i += 4)
+  {
+    if(*(__IO uint32_t *)(addr + i) != 0xFFFFFFFF)
+    {
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
+/**
+  * @brief  open the erased sector after the head.
+  * @param  hkv: the handle points to the key/value store information.
+  * @retval key/value store status.
+  */
+static kv_status_type kv_sector_open(kv_handle_type* hkv)
+{
+  uint8_t next = (uint8_t)((hkv->head_sector + 1) % hkv->sector_num);
+  uint32_t addr = KV_SECTOR_ADDR(hkv, next);
+
+  if((kv_program(addr + 2, (uint16_t)(hkv->head_seq + 1)) != KV_OK) ||
+     (kv_program(addr, KV_SECTOR_MAGIC) != KV_OK))
+  {
+    return KV_ERR_FLASH;
+  }
+
+  hkv->head_sector = next;
+  hkv->head_seq++;
+  hkv->head_offset = KV_SECTOR_HEADER_SIZE;
+  hkv->erased_num--;
+
+  return KV_OK;
+}
+
+/**
+  * @brief  make a record the current one of its key in the ram index.
+  * @param  hkv: the handle points to the key/value store information.
+  * @param  key: the key.
+  * @param  len: the length halfword of the record.
+  * @param  addr: the record address.
+  * @retval none
+  */
+static void kv_index_update(kv_handle_type* hkv, uint16_t key, uint16_t len, uint32_t addr)
+{
+  uint32_t old = hkv->index[key];
+
+  if(old != 0)
+  {
+    hkv->live_bytes -= KV_RECORD_SIZE(KV_HALFWORD(old + 2));
+  }
+
+  if(len & KV_RECORD_TOMBSTONE)
+  {
+    hkv->index[key] = 0;
+  }
+  else
+  {
+    hkv->index[key] = addr;
+    hkv->live_bytes += KV_RECORD_SIZE(len);
+  }
+}
+
+/**
+  * @brief  append a record to the head, opening the next sector when it does not fit.
+  * @param  hkv: the handle points to the key/value store information.
+  * @param  key: the key.
+  * @param  len: the length halfword, with KV_RECORD_TOMBSTONE for a delete.
+  * @param  data: the data.
+  * @param  reserve: erased sectors which must be left when a sector is opened.
+  * @retval key/value store status.
+  */
+static kv_status_type kv_append(kv_handle_type* hkv, uint16_t key, uint16_t len, const uint8_t* data, uint8_t reserve)
+{
+  uint16_t data_len = len & ~KV_RECORD_TOMBSTONE;
+  uint32_t size = KV_RECORD_SIZE(data_len);
+  uint32_t addr, i;
+  uint16_t crc = 0xFFFF, hw;
+
+  if(hkv->head_offset + size > hkv->sector_size)
+  {
+    if(hkv->erased_num <= reserve)
+    {
+      return KV_ERR_FULL;
+    }
+    if(kv_sector_open(hkv) != KV_OK)
+    {
+      return KV_ERR_FLASH;
+    }
+  }
+
+  addr = KV_SECTOR_ADDR(hkv, hkv->head_sector) + hkv->head_offset;
+  /* the space is used even if the programming fails */
+  hkv->head_offset += (uint16_t)size;
+
+  crc = kv_crc16_update(crc, (uint8_t)key);
+  crc = kv_crc16_update(crc, (uint8_t)(key >> 8));
+  crc = kv_crc16_update(crc, (uint8_t)len);
+  crc = kv_crc16_update(crc, (uint8_t)(len >> 8));
+  if((kv_program(addr, key) != KV_OK) || (kv_program(addr + 2, len) != KV_OK))
+  {
+    return KV_ERR_FLASH;
+  }
+
+  for(i = 0; i < data_len; i += 2)
+  {
+    hw = (i + 1 < data_len) ? (uint16_t)(data[i] | (data[i + 1] << 8)) : (uint16_t)(data[i] | 0xFF00);
+    crc = kv_crc16_update(crc, (uint8_t)hw);
+    crc = kv_crc16_update(crc, (uint8_t)(hw >> 8));
+    if(kv_program(addr + 4 + i, hw) != KV_OK)
+    {
+      return KV_ERR_FLASH;
+    }
+  }
+
+  if(kv_program(addr + size - 2, kv_crc16_stored(crc)) != KV_OK)
+  {
+    return KV_ERR_FLASH;
+  }
+
+  kv_index_update(hkv, key, len, addr);
+
+  return KV_OK;
+}
+
+/**
+  * @brief  collect the oldest sector: copy its live records to the head, then
+  *         erase it. when the head cannot hold all of them the next erased sector
+  *         is opened first, so a collection which takes the last erased sector
+  *         writes only copies into it.
+  * @param  hkv: the handle points to the key/value store information.
+  * @retval key/value store status.
+  */
+static kv_status_type kv_gc_run(kv_handle_type* hkv)
+{
+  uint32_t base = KV_SECTOR_ADDR(hkv, hkv->oldest_sector);
+  uint32_t addr, size = 0, need = 0;
+  uint16_t key;
+  kv_status_type status;
+
+  if(hkv->oldest_sector == hkv->head_sector)
+  {
+    return KV_ERR_FULL;
+  }
+
+  for(addr = base + KV_SECTOR_HEADER_SIZE;
+      kv_record_check(hkv, addr, base + hkv->sector_size, &size) == KV_RECORD_VALID; addr += size)
+  {
+    key = KV_HALFWORD(addr);
+    if((key < hkv->key_num) && (hkv->index[key] == addr))
+    {
+      need += size;
+    }
+  }
+
+  if(hkv->head_offset + need > hkv->sector_size)
+  {
+    if(hkv->erased_num == 0)
+    {
+      return KV_ERR_FULL;
+    }
+    if(kv_sector_open(hkv) != KV_OK)
+    {
+      return KV_ERR_FLASH;
+    }
+  }
+
+  for(addr = base + KV_SECTOR_HEADER_SIZE;
+      kv_record_check(hkv, addr, base + hkv->sector_size, &size) == KV_RECORD_VALID; addr += size)
+  {
+    key = KV_HALFWORD(addr);
+    if((key < hkv->key_num) && (hkv->index[key] == addr))
+    {
+      status = kv_append(hkv, key, KV_HALFWORD(addr + 2), (const uint8_t *)(addr + 4), 0);
+      if(status != KV_OK)
+      {
+        return status;
+      }
+    }
+  }
+
+  status = kv_sector_erase(hkv, hkv->oldest_sector);
+  if(status != KV_OK)
+  {
+    return status;
+  }
+  hkv->oldest_sector = (uint8_t)((hkv->oldest_sector + 1) % hkv->sector_num);
+  hkv->erased_num++;
+
+  return KV_OK;
+}
+
+/**
+  * @brief  append a record, collecting garbage first when the next sector would
+  *         take the erased sector kept for the collection.
+  * @param  hkv: the handle points to the key/value store information.
+  * @param  key: the key.
+  * @param  len: the length halfword.
+  * @param  data: the data.
+  * @retval key/value store status.
+  */
+static kv_status_type kv_put(kv_handle_type* hkv, uint16_t key, uint16_t len, const uint8_t* data)
+{
+  uint32_t size = KV_RECORD_SIZE(len & ~KV_RECORD_TOMBSTONE);
+  uint8_t step = hkv->sector_num;
+  kv_status_type status = KV_OK;
+
+  flash_unlock();
+
+  while((status == KV_OK) && (hkv->head_offset + size > hkv->sector_size) && (hkv->erased_num < 2))
+  {
+    status = (step-- != 0) ? kv_gc_run(hkv) : KV_ERR_FULL;
+  }
+
+  if(status == KV_OK)
+  {
+    status = kv_append(hkv, key, len, data, 1);
+  }
+
+  flash_lock();
+
+  return status;
+}
+
+/**
+  * @brief  mount the store: erase the sectors which are not in use, replay the
+  *         records from the oldest sector to build the ram index. a torn record
+  *         left by a power loss closes the head sector.
+  * @param  hkv: the handle points to the key/value store information.
+  * @retval key/value store status.
+  */
+kv_status_type kv_init(kv_handle_type* hkv)
+{
+  uint32_t base, addr, size = 0;
+  uint16_t seq, off;
+  uint8_t s, cur, prev, active, newest = 0, found = 0, rec;
+  kv_status_type status = KV_OK;
+
+  if((hkv->sector_num < 3) || (hkv->gc_free_min < 2) || (hkv->gc_free_min >= hkv->sector_num) ||
+     (hkv->index == 0) || (hkv->key_num == 0) || (hkv->key_num == 0xFFFF) || ((hkv->sector_size & 0x3) != 0))
+  {
+    return KV_ERR_PARAM;
+  }
+
+  for(off = 0; off < hkv->key_num; off++)
+  {
+    hkv->index[off] = 0;
+  }
+  hkv->live_bytes = 0;
+  hkv->erase_count = 0;
+  hkv->live_limit = (uint32_t)(hkv->sector_num - 2) *
+                    (hkv->sector_size - KV_SECTOR_HEADER_SIZE - KV_RECORD_SIZE(KV_DATA_MAX(hkv)));
+
+  /* the newest sector in use is the one no other sector is ahead of */
+  for(s = 0; s < hkv->sector_num; s++)
+  {
+    if(KV_HALFWORD(KV_SECTOR_ADDR(hkv, s)) == KV_SECTOR_MAGIC)
+    {
+      seq = KV_HALFWORD(KV_SECTOR_ADDR(hkv, s) + 2);
+      if((found == 0) || ((int16_t)(seq - hkv->head_seq) > 0))
+      {
+        newest = s;
+        hkv->head_seq = seq;
+      }
+      found = 1;
+    }
+  }
+
+  flash_unlock();
+
+  /* walk back along consecutive sequences to the oldest sector */
+  active = 0;
+  if(found)
+  {
+    cur = newest;
+    active = 1;
+    while(active < hkv->sector_num)
+    {
+      prev = (uint8_t)((cur + hkv->sector_num - 1) % hkv->sector_num);
+      base = KV_SECTOR_ADDR(hkv, prev);
+      if((KV_HALFWORD(base) != KV_SECTOR_MAGIC) ||
+         (KV_HALFWORD(base + 2) != (uint16_t)(KV_HALFWORD(KV_SECTOR_ADDR(hkv, cur) + 2) - 1)))
+      {
+        break;
+      }
+      cur = prev;
+      active++;
+    }
+    hkv->oldest_sector = cur;
+    hkv->head_sector = newest;
+  }
+
+  /* every other sector is erased */
+  for(s = 0; (s < hkv->sector_num) && (status == KV_OK); s++)
+  {
+    if((active != 0) && ((uint8_t)((s + hkv->sector_num - hkv->oldest_sector) % hkv->sector_num) < active))
+    {
+      continue;
+    }
+    if(kv_sector_blank(hkv, s) == FALSE)
+    {
+      status = kv_sector_erase(hkv, s);
+    }
+  }
+  hkv->erased_num = hkv->sector_num - active;
+
+  if((status == KV_OK) && (hkv->erased_num == 0))
+  {
+    /* only a collection takes the last erased sector, it was cut off: drop its
+       copies, the records are still in the oldest sector */
+    status = kv_sector_erase(hkv, hkv->head_sector);
+    hkv->head_sector = (uint8_t)((hkv->head_sector + hkv->sector_num - 1) % hkv->sector_num);
+    hkv->head_seq--;
+    hkv->erased_num = 1;
+    active--;
+  }
+
+  if((status == KV_OK) && (active == 0))
+  {
+    /* empty store, the first sector opened is sector 0 */
+    hkv->head_sector = hkv->sector_num - 1;
+    hkv->oldest_sector = 0;
+    hkv->head_seq = 0xFFFF;
+    status = kv_sector_open(hkv);
+  }
+
+  flash_lock();
+
+  if(status != KV_OK)
+  {
+    return status;
+  }
+
+  /* replay the records, the later one of a key wins */
+  for(s = 0; s < active; s++)
+  {
+    cur = (uint8_t)((hkv->oldest_sector + s) % hkv->sector_num);
+    base = KV_SECTOR_ADDR(hkv, cur);
+    off = KV_SECTOR_HEADER_SIZE;
+    while((rec = kv_record_check(hkv, base + off, base + hkv->sector_size, &size)) == KV_RECORD_VALID)
+    {
+      addr = base + off;
+      if(KV_HALFWORD(addr) < hkv->key_num)
+      {
+        kv_index_update(hkv, KV_HALFWORD(addr), KV_HALFWORD(addr + 2), addr);
+      }
+      off += (uint16_t)size;
+    }
+
+    if(cur == hkv->head_sector)
+    {
+      /* a torn record stays the last one of its sector */
+      hkv->head_offset = (rec == KV_RECORD_TORN) ? hkv->sector_size : off;
+    }
+  }
+
+  return KV_OK;
+}
+
+/**
+  * @brief  erase every sector of the store and mount it empty.
+  * @param  hkv: the handle points to the key/value store information.
+  * @retval key/value store status.
+  */
+kv_status_type kv_format(kv_handle_type* hkv)
+{
+  kv_status_type status = KV_OK;
+  uint8_t s;
+
+  if(hkv->sector_num == 0)
+  {
+    return KV_ERR_PARAM;
+  }
+
+  flash_unlock();
+  for(s = 0; (s < hkv->sector_num) && (status == KV_OK); s++)
+  {
+    status = kv_sector_erase(hkv, s);
+  }
+  flash_lock();
+
+  if(status != KV_OK)
+  {
+    return status;
+  }
+
+  return kv_init(hkv);
+}
+
+/**
+  * @brief  store the value of a key.
+  * @param  hkv: the handle points to the key/value store information.
+  * @param  key: the key, 0 ~ key_num - 1.
+  * @param  data: the value.
+  * @param  len: length of the value, up to a quarter of a sector.
+  * @retval key/value store status.
+  */
+kv_status_type kv_write(kv_handle_type* hkv, uint16_t key, const void* data, uint16_t len)
+{
+  uint32_t live = hkv->live_bytes + KV_RECORD_SIZE(len);
+
+  if((key >= hkv->key_num) || (len > KV_DATA_MAX(hkv)) || ((data == 0) && (len != 0)))
+  {
+    return KV_ERR_PARAM;
+  }
+
+  if(hkv->index[key] != 0)
+  {
+    live -= KV_RECORD_SIZE(KV_HALFWORD(hkv->index[key] + 2));
+  }
+  if(live > hkv->live_limit)
+  {
+    return KV_ERR_FULL;
+  }
+
+  return kv_put(hkv, key, len, (const uint8_t *)data);
+}
+
+/**
+  * @brief  read the value of a key, through the ram index.
+  * @param  hkv: the handle points to the key/value store information.
+  * @param  key: the key.
+  * @param  buf: the buffer, the value is cut to size bytes.
+  * @param  size: size of buf.
+  * @param  len: length of the stored value, may be NULL.
+  * @retval key/value store status.
+  */
+kv_status_type kv_read(kv_handle_type* hkv, uint16_t key, void* buf, uint16_t size, uint16_t* len)
+{
+  uint32_t addr;
+  uint16_t data_len, i;
+
+  if(key >= hkv->key_num)
+  {
+    return KV_ERR_PARAM;
+  }
+
+  addr = hkv->index[key];
+  if(addr == 0)
+  {
+    return KV_ERR_NOT_FOUND;
+  }
+
+  data_len = KV_HALFWORD(addr + 2);
+  if(len != 0)
+  {
+    *len = data_len;
+  }
+
+  for(i = 0; (i < data_len) && (i < size); i++)
+  {
+    ((uint8_t *)buf)[i] = *(__IO uint8_t *)(addr + 4 + i);
+  }
+
+  return KV_OK;
+}
+
+/**
+  * @brief  delete a key, a tombstone record is appended.
+  * @param  hkv: the handle points to the key/value store information.
+  * @param  key: the key.
+  * @retval key/value store status.
+  */
+kv_status_type kv_delete(kv_handle_type* hkv, uint16_t key)
+{
+  if(key >= hkv->key_num)
+  {
+    return KV_ERR_PARAM;
+  }
+
+  if(hkv->index[key] == 0)
+  {
+    return KV_ERR_NOT_FOUND;
+  }
+
+  return kv_put(hkv, key, KV_RECORD_TOMBSTONE, 0);
+}
+
+/**
+  * @brief  background garbage collection, call it from the idle loop. each call
+  *         collects one sector, until gc_free_min sectors are erased.
+  * @param  hkv: the handle points to the key/value store information.
+  * @retval TRUE when a step was done, FALSE when there is nothing to do.
+  */
+confirm_state kv_gc_step(kv_handle_type* hkv)
+{
+  kv_status_type status;
+
+  if((hkv->erased_num >= hkv->gc_free_min) || (hkv->oldest_sector == hkv->head_sector))
+  {
+    return FALSE;
+  }
+
+  flash_unlock();
+  status = kv_gc_run(hkv);
+  flash_lock();
+
+  return (status == KV_OK) ? TRUE : FALSE;
+}
+
+/**
+  * @}
+  */
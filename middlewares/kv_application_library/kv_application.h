@@ -0,0 +1,123 @@
+/**
+  **************************************************************************
+  * @file     kv_application.h
+  * @brief    flash key/value store application libray header file
+  **************************************************************************
+  *
+  * Copyright (c) 2025, Artery Technology, All rights reserved.
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+/*!< define to prevent recursive inclusion -------------------------------------*/
+#ifndef __KV_APPLICATION_H
+#define __KV_APPLICATION_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* includes ------------------------------------------------------------------*/
+#include "at32f422_426.h"
+
+/** @addtogroup AT32F422_426_middlewares_kv_application_library
+  * @{
+  */
+
+
+/** @defgroup KV_library_definition
+  * @{
+  */
+
+#define KV_SECTOR_MAGIC                  0x4B56                   /*!< header of a sector in use       */
+#define KV_SECTOR_RETIRED                0x0000                   /*!< header of a sector being erased */
+#define KV_SECTOR_HEADER_SIZE            4                        /*!< magic and sequence halfwords    */
+#define KV_RECORD_OVERHEAD               6                        /*!< key, length and crc halfwords   */
+#define KV_RECORD_TOMBSTONE              0x8000                   /*!< length flag of a deleted key    */
+
+/**
+  * @}
+  */
+
+/** @defgroup KV_library_status_code
+  * @{
+  */
+
+typedef enum
+{
+  KV_OK = 0,           /*!< no error */
+  KV_ERR_PARAM,        /*!< invalid parameter */
+  KV_ERR_NOT_FOUND,    /*!< key not stored */
+  KV_ERR_FULL,         /*!< no room left for the live data */
+  KV_ERR_FLASH,        /*!< flash erase or program failed */
+} kv_status_type;
+
+/**
+  * @}
+  */
+
+/** @defgroup KV_library_handle
+  * @{
+  */
+
+typedef struct
+{
+  uint32_t                               base_addr;               /*!< address of the first sector     */
+  uint16_t                               sector_size;             /*!< flash sector size in bytes      */
+  uint8_t                                sector_num;              /*!< sectors of the store, at least 3 */
+  uint8_t                                gc_free_min;             /*!< erased sectors kept by kv_gc_step(), at least 2 */
+  uint32_t                               *index;                  /*!< ram index, record address of each key */
+  uint16_t                               key_num;                 /*!< keys 0 ~ key_num - 1            */
+  uint8_t                                head_sector;             /*!< sector being appended           */
+  uint8_t                                oldest_sector;           /*!< first sector to collect         */
+  uint8_t                                erased_num;              /*!< sectors ready for use           */
+  uint16_t                               head_seq;                /*!< sequence number of the head     */
+  uint16_t                               head_offset;             /*!< append offset in the head       */
+  uint32_t                               live_bytes;              /*!< size of the live records        */
+  uint32_t                               live_limit;              /*!< largest live_bytes that can always be collected */
+  uint32_t                               erase_count;             /*!< sectors erased since kv_init()  */
+} kv_handle_type;
+
+/**
+  * @}
+  */
+
+/** @defgroup KV_library_exported_functions
+  * @{
+  */
+
+kv_status_type      kv_init               (kv_handle_type* hkv);
+kv_status_type      kv_format             (kv_handle_type* hkv);
+kv_status_type      kv_write              (kv_handle_type* hkv, uint16_t key, const void* data, uint16_t len);
+kv_status_type      kv_read               (kv_handle_type* hkv, uint16_t key, void* buf, uint16_t size, uint16_t* len);
+kv_status_type      kv_delete             (kv_handle_type* hkv, uint16_t key);
+confirm_state       kv_gc_step            (kv_handle_type* hkv);
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,332 @@
+/**
+  **************************************************************************
+  * @file     pwm_seq_application.c
+  * @brief    tmr burst dma pwm sequencer application libray source file
+  **************************************************************************
+  *
+  * Copyright (c) 2025, Artery Technology, All rights reserved.
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+#include "pwm_seq_application.h"
+
+/** @addtogroup AT32F422_426_middlewares_pwm_seq_application_library
+  * @{
+  */
+
+
+/**
+  * @brief  initializes peripherals used by the sequencer: clocks, gpio, the timer
+  *         base and output channels, and the dma interrupt. hseq->tmrx, base and
+  *         burst may be set here.
+  * @param  hseq: the handle points to the sequencer information.
+  * @retval none
+  */
+__WEAK void pwm_seq_lowlevel_init(pwm_seq_handle_type* hseq)
+{
+
+}
+
+/**
+  * @brief  write one block, from the fill callback or the table. a short block
+  *         is completed with its last period, the end block is repeated.
+  * @param  hseq: the handle points to the sequencer information.
+  * @param  half: 0 for the first block, 1 for the second.
+  * @retval number of periods written before the padding.
+  */
+static uint16_t pwm_seq_block_fill(pwm_seq_handle_type* hseq, uint8_t half)
+{
+  uint16_t *entries = hseq->buf + half * hseq->block * hseq->burst;
+  const uint16_t *last;
+  uint32_t count = 0;
+  uint32_t index;
+
+  if(hseq->end == 0)
+  {
+    if(hseq->fill != 0)
+    {
+      count = hseq->fill(hseq, entries, hseq->block);
+    }
+    else
+    {
+      count = hseq->table_size - hseq->table_pos;
+      if(count > hseq->block)
+      {
+        count = hseq->block;
+      }
+      for(index = 0; index < count * hseq->burst; index++)
+      {
+        entries[index] = hseq->table[hseq->table_pos * hseq->burst + index];
+      }
+      hseq->table_pos += count;
+    }
+
+    if(count < hseq->block)
+    {
+      hseq->end = 1;
+      hseq->end_half = half;
+    }
+  }
+
+  if(count < hseq->block)
+  {
+    /* hold the last period, from the other block if this one is empty */
+    if(count != 0)
+    {
+      last = entries + (count - 1) * hseq->burst;
+    }
+    else
+    {
+      last = hseq->buf + ((half ^ 1) * hseq->block + hseq->block - 1) * hseq->burst;
+    }
+    for(index = count * hseq->burst; index < (uint32_t)hseq->block * hseq->burst; index++)
+    {
+      entries[index] = last[index % hseq->burst];
+    }
+  }
+
+  return (uint16_t)count;
+}
+
+/**
+  * @brief  a block was loaded into the timer, write it again while the dma is
+  *         in the other block, or end the sequence after the last one.
+  * @param  hseq: the handle points to the sequencer information.
+  * @param  half: 0 for the first block, 1 for the second.
+  * @retval none
+  */
+static void pwm_seq_block_done(pwm_seq_handle_type* hseq, uint8_t half)
+{
+  uint32_t size = (uint32_t)hseq->block * hseq->burst;
+  uint32_t pos = size * 2 - hseq->dma.channel->dtcnt;
+
+  hseq->block_count++;
+
+  if(hseq->end && (hseq->end_half == half))
+  {
+    pwm_seq_stop(hseq);
+    if(hseq->done != 0)
+    {
+      hseq->done(hseq);
+    }
+    return;
+  }
+
+  if((pos >= size) != (half == 0))
+  {
+    hseq->underrun_count++;
+  }
+
+  pwm_seq_block_fill(hseq, half);
+}
+
+/**
+  * @brief  dma half transfer, the first block is loaded.
+  * @param  hdma: the dma handle, first member of the sequencer handle.
+  * @param  desc: the loop mode descriptor.
+  * @retval none
+  */
+static void pwm_seq_half_callback(dma_handle_type* hdma, dma_desc_type* desc)
+{
+  pwm_seq_block_done((pwm_seq_handle_type *)hdma, 0);
+}
+
+/**
+  * @brief  dma full transfer, the second block is loaded.
+  * @param  hdma: the dma handle, first member of the sequencer handle.
+  * @param  desc: the loop mode descriptor.
+  * @retval none
+  */
+static void pwm_seq_full_callback(dma_handle_type* hdma, dma_desc_type* desc)
+{
+  pwm_seq_block_done((pwm_seq_handle_type *)hdma, 1);
+}
+
+/**
+  * @brief  sequencer initialization, calls pwm_seq_lowlevel_init() then sets up
+  *         the overflow burst dma in loop mode over two blocks. the buffers of
+  *         the period and channel registers of a period are enabled, so that
+  *         a period loaded on an overflow rules the period after it.
+  * @note   the interrupt of hseq->dma.channel_index should call
+  *         dma_irq_handler(&hseq->dma).
+  * @param  hseq: the handle points to the sequencer information, tmrx, base,
+  *         burst, fill and done set by the caller.
+  * @param  buf: two blocks, 2 * block * burst halfwords.
+  * @param  block: periods in one block.
+  * @retval pwm sequencer status.
+  */
+pwm_seq_status_type pwm_seq_init(pwm_seq_handle_type* hseq, uint16_t* buf, uint16_t block)
+{
+  dma_init_type dma_init_struct;
+  dma_request_type request;
+  uint8_t reg;
+
+  pwm_seq_lowlevel_init(hseq);
+
+  if(hseq->tmrx == TMR1)
+  {
+    request = DMA_REQ_TMR1_OVERFLOW;
+  }
+  else if(hseq->tmrx == TMR3)
+  {
+    request = DMA_REQ_TMR3_CH4;
+  }
+  else if(hseq->tmrx == TMR16)
+  {
+    request = DMA_REQ_TMR16;
+  }
+  else
+  {
+    return PWM_SEQ_ERR_PARAM;
+  }
+
+  if((buf == 0) || (block == 0) || (hseq->burst == 0) || \
+     ((hseq->base + hseq->burst) > TMR_DMACTRL_ADDRESS) || \
+     (((uint32_t)block * hseq->burst * 2) > 0xFFFF))
+  {
+    return PWM_SEQ_ERR_PARAM;
+  }
+
+  hseq->buf = buf;
+  hseq->block = block;
+  hseq->busy = 0;
+
+  if(dma_channel_alloc(&hseq->dma, request) != DMA_APP_OK)
+  {
+    return PWM_SEQ_ERR_BUSY;
+  }
+  hseq->dma.half_callback = pwm_seq_half_callback;
+  hseq->dma.full_callback = pwm_seq_full_callback;
+  hseq->dma.error_callback = 0;
+
+  dma_default_para_init(&dma_init_struct);
+  dma_init_struct.buffer_size = (uint32_t)block * hseq->burst * 2;
+  dma_init_struct.direction = DMA_DIR_MEMORY_TO_PERIPHERAL;
+  dma_init_struct.memory_base_addr = (uint32_t)buf;
+  dma_init_struct.memory_data_width = DMA_MEMORY_DATA_WIDTH_HALFWORD;
+  dma_init_struct.memory_inc_enable = TRUE;
+  dma_init_struct.peripheral_base_addr = (uint32_t)&hseq->tmrx->dmadt;
+  dma_init_struct.peripheral_data_width = DMA_PERIPHERAL_DATA_WIDTH_HALFWORD;
+  dma_init_struct.peripheral_inc_enable = FALSE;
+  dma_init_struct.priority = DMA_PRIORITY_HIGH;
+  dma_init_struct.loop_mode_enable = TRUE;
+  dma_desc_build(&hseq->desc, &dma_init_struct);
+
+  /* a period written by the burst takes effect on the next overflow */
+  for(reg = hseq->base; reg < (hseq->base + hseq->burst); reg++)
+  {
+    if(reg == TMR_PR_ADDRESS)
+    {
+      tmr_period_buffer_enable(hseq->tmrx, TRUE);
+    }
+    else if((reg >= TMR_C1DT_ADDRESS) && (reg <= TMR_C4DT_ADDRESS))
+    {
+      tmr_output_channel_buffer_enable(hseq->tmrx, (tmr_channel_select_type)((reg - TMR_C1DT_ADDRESS) * 2), TRUE);
+    }
+  }
+  tmr_dma_control_config(hseq->tmrx, (tmr_dma_transfer_length_type)(hseq->burst - 1), hseq->base);
+
+  return PWM_SEQ_OK;
+}
+
+/**
+  * @brief  stop the sequencer and give the dma channel back.
+  * @param  hseq: the handle points to the sequencer information.
+  * @retval none
+  */
+void pwm_seq_deinit(pwm_seq_handle_type* hseq)
+{
+  pwm_seq_stop(hseq);
+  dma_channel_free(&hseq->dma);
+}
+
+/**
+  * @brief  write both blocks and start the sequence, the counter is enabled.
+  *         the period before the first one keeps the registers set before.
+  * @param  hseq: the handle points to the sequencer information.
+  * @retval pwm sequencer status.
+  */
+pwm_seq_status_type pwm_seq_start(pwm_seq_handle_type* hseq)
+{
+  if(hseq->busy)
+  {
+    return PWM_SEQ_ERR_BUSY;
+  }
+
+  hseq->end = 0;
+  hseq->block_count = 0;
+  hseq->underrun_count = 0;
+
+  if(pwm_seq_block_fill(hseq, 0) == 0)
+  {
+    return PWM_SEQ_ERR_PARAM;
+  }
+  pwm_seq_block_fill(hseq, 1);
+
+  hseq->busy = 1;
+  dma_chain_start(&hseq->dma, &hseq->desc);
+  tmr_dma_request_enable(hseq->tmrx, TMR_OVERFLOW_DMA_REQUEST, TRUE);
+  tmr_counter_enable(hseq->tmrx, TRUE);
+
+  return PWM_SEQ_OK;
+}
+
+/**
+  * @brief  play a table of periods, burst registers per period. the table is
+  *         copied one block at a time and may be longer than the dma buffer.
+  * @param  hseq: the handle points to the sequencer information, fill is
+  *         cleared.
+  * @param  table: periods, registers from base in order.
+  * @param  periods: number of periods in the table.
+  * @retval pwm sequencer status.
+  */
+pwm_seq_status_type pwm_seq_table_play(pwm_seq_handle_type* hseq, const uint16_t* table, uint32_t periods)
+{
+  if(hseq->busy)
+  {
+    return PWM_SEQ_ERR_BUSY;
+  }
+
+  if((table == 0) || (periods == 0))
+  {
+    return PWM_SEQ_ERR_PARAM;
+  }
+
+  hseq->fill = 0;
+  hseq->table = table;
+  hseq->table_size = periods;
+  hseq->table_pos = 0;
+
+  return pwm_seq_start(hseq);
+}
+
+/**
+  * @brief  stop loading periods, the timer keeps running with the last one.
+  * @param  hseq: the handle points to the sequencer information.
+  * @retval none
+  */
+void pwm_seq_stop(pwm_seq_handle_type* hseq)
+{
+  tmr_dma_request_enable(hseq->tmrx, TMR_OVERFLOW_DMA_REQUEST, FALSE);
+  dma_chain_stop(&hseq->dma);
+  hseq->busy = 0;
+}
+
+/**
+  * @}
+  */
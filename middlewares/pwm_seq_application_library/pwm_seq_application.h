@@ -0,0 +1,126 @@
+/**
+  **************************************************************************
+  * @file     pwm_seq_application.h
+  * @brief    tmr burst dma pwm sequencer application libray header file
+  **************************************************************************
+  *
+  * Copyright (c) 2025, Artery Technology, All rights reserved.
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+/*!< define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PWM_SEQ_APPLICATION_H
+#define __PWM_SEQ_APPLICATION_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* includes ------------------------------------------------------------------*/
+#include "at32f422_426.h"
+#include "dma_application.h"
+
+/** @addtogroup AT32F422_426_middlewares_pwm_seq_application_library
+  * @{
+  */
+
+
+/** @defgroup PWM_SEQ_library_status_code
+  * @{
+  */
+
+typedef enum
+{
+  PWM_SEQ_OK = 0,         /*!< no error */
+  PWM_SEQ_ERR_PARAM,      /*!< invalid parameter */
+  PWM_SEQ_ERR_BUSY,       /*!< no dma channel left or sequence running */
+} pwm_seq_status_type;
+
+/**
+  * @}
+  */
+
+/** @defgroup PWM_SEQ_library_handle
+  * @{
+  */
+
+typedef struct pwm_seq_handle_struct pwm_seq_handle_type;
+
+/**
+  * @brief  fill callback, called in the dma interrupt to write the next periods,
+  *         burst registers per period. returns the number of periods written,
+  *         less than periods ends the sequence.
+  */
+typedef uint16_t (*pwm_seq_fill_type)(pwm_seq_handle_type* hseq, uint16_t* entries, uint16_t periods);
+
+/**
+  * @brief  end callback, called in the dma interrupt when the last period was
+  *         loaded. the timer keeps running with it.
+  */
+typedef void (*pwm_seq_done_type)(pwm_seq_handle_type* hseq);
+
+struct pwm_seq_handle_struct
+{
+  dma_handle_type                        dma;                     /*!< burst dma, first member         */
+  dma_desc_type                          desc;                    /*!< loop mode register image        */
+  tmr_type                               *tmrx;                   /*!< TMR1, TMR3 or TMR16             */
+  tmr_dma_address_type                   base;                    /*!< first register of a period      */
+  uint8_t                                burst;                   /*!< registers of a period, 1 ~ 18   */
+  uint16_t                               *buf;                    /*!< two blocks of periods           */
+  uint16_t                               block;                   /*!< periods in one block            */
+  pwm_seq_fill_type                      fill;                    /*!< fill callback, NULL plays the table */
+  pwm_seq_done_type                      done;                    /*!< end callback, may be NULL       */
+  const uint16_t                         *table;                  /*!< table of pwm_seq_table_play()   */
+  uint32_t                               table_size;              /*!< periods in the table            */
+  uint32_t                               table_pos;               /*!< next period of the table        */
+  uint8_t                                end;                     /*!< last block written              */
+  uint8_t                                end_half;                /*!< block holding the last period   */
+  __IO uint8_t                           busy;                    /*!< sequence running                */
+  __IO uint32_t                          block_count;             /*!< blocks loaded                   */
+  __IO uint32_t                          underrun_count;          /*!< blocks written after the dma reached them */
+};
+
+/**
+  * @}
+  */
+
+/** @defgroup PWM_SEQ_library_exported_functions
+  * @{
+  */
+
+void                pwm_seq_lowlevel_init (pwm_seq_handle_type* hseq);
+pwm_seq_status_type pwm_seq_init          (pwm_seq_handle_type* hseq, uint16_t* buf, uint16_t block);
+void                pwm_seq_deinit        (pwm_seq_handle_type* hseq);
+pwm_seq_status_type pwm_seq_start         (pwm_seq_handle_type* hseq);
+pwm_seq_status_type pwm_seq_table_play    (pwm_seq_handle_type* hseq, const uint16_t* table, uint32_t periods);
+void                pwm_seq_stop          (pwm_seq_handle_type* hseq);
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,601 @@
+/**
+  **************************************************************************
+  * @file     spiflash_application.c
+  * @brief    the driver library of the spi nor flash
+  **************************************************************************
+  *
+  * Copyright (c) 2025, Artery Technology, All rights reserved.
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+#include "spiflash_application.h"
+
+/** @addtogroup AT32F422_426_middlewares_spiflash_application_library
+  * @{
+  */
+
+
+/**
+  * @brief largest dma transfer, a longer read goes on with cs kept low
+  */
+#define SPIFLASH_DMA_MAX                 0xFFFF
+
+#define SPIFLASH_CS_HIGH(hflash)         gpio_bits_set((hflash)->cs_gpio, (hflash)->cs_pin)
+#define SPIFLASH_CS_LOW(hflash)          gpio_bits_reset((hflash)->cs_gpio, (hflash)->cs_pin)
+
+/**
+  * @brief memory increment bit of the ctrl image
+  */
+#define SPIFLASH_DMA_MINCM               ((uint32_t)0x00000080)
+
+static void spiflash_run(spiflash_handle_type* hflash);
+
+/**
+  * @brief  initializes peripherals used by the spi flash: clocks, gpio, the spi in
+  *         8 bit full duplex master mode, the busy poll timer and the interrupts.
+  * @param  hflash: the handle points to the spi flash information.
+  * @retval none
+  */
+__WEAK void spiflash_lowlevel_init(spiflash_handle_type* hflash)
+{
+
+}
+
+/**
+  * @brief  exchange one byte by polling, used for the short command phases.
+  * @param  hflash: the handle points to the spi flash information.
+  * @param  data: byte to send.
+  * @retval byte received.
+  */
+static uint8_t spiflash_byte_xfer(spiflash_handle_type* hflash, uint8_t data)
+{
+  while(spi_i2s_flag_get(hflash->spix, SPI_I2S_TDBE_FLAG) == RESET);
+  spi_i2s_data_transmit(hflash->spix, data);
+  while(spi_i2s_flag_get(hflash->spix, SPI_I2S_RDBF_FLAG) == RESET);
+  hflash->bus_bytes++;
+
+  return (uint8_t)spi_i2s_data_receive(hflash->spix);
+}
+
+/**
+  * @brief  pull cs low and send an instruction with a 24 bit address.
+  * @param  hflash: the handle points to the spi flash information.
+  * @param  cmd: the instruction.
+  * @param  addr: the address.
+  * @retval none
+  */
+static void spiflash_cmd_addr(spiflash_handle_type* hflash, uint8_t cmd, uint32_t addr)
+{
+  SPIFLASH_CS_LOW(hflash);
+  spiflash_byte_xfer(hflash, cmd);
+  spiflash_byte_xfer(hflash, (uint8_t)(addr >> 16));
+  spiflash_byte_xfer(hflash, (uint8_t)(addr >> 8));
+  spiflash_byte_xfer(hflash, (uint8_t)addr);
+}
+
+/**
+  * @brief  send the write enable instruction.
+  * @param  hflash: the handle points to the spi flash information.
+  * @retval none
+  */
+static void spiflash_write_enable(spiflash_handle_type* hflash)
+{
+  SPIFLASH_CS_LOW(hflash);
+  spiflash_byte_xfer(hflash, SPIFLASH_CMD_WRITEENABLE);
+  SPIFLASH_CS_HIGH(hflash);
+}
+
+/**
+  * @brief  start a fast read at addr, cs stays low for the data phase.
+  * @param  hflash: the handle points to the spi flash information.
+  * @param  addr: the address.
+  * @retval none
+  */
+static void spiflash_fast_read_cmd(spiflash_handle_type* hflash, uint32_t addr)
+{
+  spiflash_cmd_addr(hflash, SPIFLASH_CMD_FASTREADDATA, addr);
+  spiflash_byte_xfer(hflash, SPIFLASH_DUMMY_BYTE);
+}
+
+/**
+  * @brief  start the data phase through dma, the end is signaled by the receive channel.
+  * @param  hflash: the handle points to the spi flash information.
+  * @param  rx: receive buffer, NULL discards the received bytes.
+  * @param  tx: transmit buffer, NULL sends dummy bytes.
+  * @param  len: number of bytes, 1~SPIFLASH_DMA_MAX.
+  * @retval none
+  */
+static void spiflash_dma_start(spiflash_handle_type* hflash, uint8_t* rx, uint8_t* tx, uint16_t len)
+{
+  hflash->dummy = SPIFLASH_DUMMY_BYTE;
+
+  hflash->rx_desc.dtcnt = len;
+  hflash->rx_desc.maddr = (rx != 0) ? (uint32_t)rx : (uint32_t)&hflash->dummy;
+  hflash->rx_desc.ctrl = (rx != 0) ? (hflash->rx_desc.ctrl | SPIFLASH_DMA_MINCM) : (hflash->rx_desc.ctrl & ~SPIFLASH_DMA_MINCM);
+
+  hflash->tx_desc.dtcnt = len;
+  hflash->tx_desc.maddr = (tx != 0) ? (uint32_t)tx : (uint32_t)&hflash->dummy;
+  hflash->tx_desc.ctrl = (tx != 0) ? (hflash->tx_desc.ctrl | SPIFLASH_DMA_MINCM) : (hflash->tx_desc.ctrl & ~SPIFLASH_DMA_MINCM);
+
+  hflash->bus_bytes += len;
+
+  dma_chain_start(&hflash->dma_rx, &hflash->rx_desc);
+  dma_chain_start(&hflash->dma_tx, &hflash->tx_desc);
+  spi_i2s_dma_receiver_enable(hflash->spix, TRUE);
+  spi_i2s_dma_transmitter_enable(hflash->spix, TRUE);
+}
+
+/**
+  * @brief  read the status register 1.
+  * @param  hflash: the handle points to the spi flash information.
+  * @retval status register 1.
+  */
+static uint8_t spiflash_sr1_read(spiflash_handle_type* hflash)
+{
+  uint8_t sr1;
+
+  SPIFLASH_CS_LOW(hflash);
+  spiflash_byte_xfer(hflash, SPIFLASH_CMD_READSTATUSREG1);
+  sr1 = spiflash_byte_xfer(hflash, SPIFLASH_DUMMY_BYTE);
+  SPIFLASH_CS_HIGH(hflash);
+
+  return sr1;
+}
+
+/**
+  * @brief  end the running request and start the next one.
+  * @param  hflash: the handle points to the spi flash information.
+  * @param  status: result of the request.
+  * @retval none
+  */
+static void spiflash_complete(spiflash_handle_type* hflash, spiflash_status_type status)
+{
+  spiflash_request_type *req = hflash->queue[hflash->tail & hflash->size_mask];
+
+  hflash->tail++;
+  hflash->state = SPIFLASH_ST_IDLE;
+  req->status = status;
+  if(req->callback != 0)
+  {
+    req->callback(req);
+  }
+
+  spiflash_run(hflash);
+}
+
+/**
+  * @brief  read the next part of a read request.
+  * @param  hflash: the handle points to the spi flash information.
+  * @param  req: the running request.
+  * @retval none
+  */
+static void spiflash_read_next(spiflash_handle_type* hflash, spiflash_request_type* req)
+{
+  uint16_t len = (hflash->remain > SPIFLASH_DMA_MAX) ? SPIFLASH_DMA_MAX : (uint16_t)hflash->remain;
+
+  spiflash_dma_start(hflash, &req->buf[hflash->pos], 0, len);
+  hflash->pos += len;
+  hflash->remain -= len;
+}
+
+/**
+  * @brief  start the write of the part of the request inside the next sector,
+  *         by reading back the target range.
+  * @param  hflash: the handle points to the spi flash information.
+  * @param  req: the running request.
+  * @retval none
+  */
+static void spiflash_write_sector_begin(spiflash_handle_type* hflash, spiflash_request_type* req)
+{
+  uint32_t addr = req->addr + hflash->pos;
+
+  hflash->sector = addr & ~(uint32_t)(SPIFLASH_SECTOR_SIZE - 1);
+  hflash->sec_off = (uint16_t)(addr - hflash->sector);
+  hflash->sec_len = SPIFLASH_SECTOR_SIZE - hflash->sec_off;
+  if(hflash->sec_len > req->len - hflash->pos)
+  {
+    hflash->sec_len = (uint16_t)(req->len - hflash->pos);
+  }
+
+  hflash->state = SPIFLASH_ST_W_CHECK;
+  spiflash_fast_read_cmd(hflash, addr);
+  spiflash_dma_start(hflash, &hflash->sector_buf[hflash->sec_off], 0, hflash->sec_len);
+}
+
+/**
+  * @brief  program the next dirty page of the sector buffer, or go on with the next sector.
+  * @param  hflash: the handle points to the spi flash information.
+  * @param  req: the running request.
+  * @retval none
+  */
+static void spiflash_program_next(spiflash_handle_type* hflash, spiflash_request_type* req)
+{
+  uint8_t page = hflash->page;
+  uint16_t start, end;
+
+  while((page < SPIFLASH_SECTOR_SIZE / SPIFLASH_PAGE_SIZE) && ((hflash->dirty & (1U << page)) == 0))
+  {
+    page++;
+  }
+
+  if(page >= SPIFLASH_SECTOR_SIZE / SPIFLASH_PAGE_SIZE)
+  {
+    hflash->pos += hflash->sec_len;
+    if(hflash->pos < req->len)
+    {
+      spiflash_write_sector_begin(hflash, req);
+    }
+    else
+    {
+      spiflash_complete(hflash, SPIFLASH_OK);
+    }
+    return;
+  }
+
+  /* only the part of the page which holds valid data in the sector buffer */
+  start = page * SPIFLASH_PAGE_SIZE;
+  end = start + SPIFLASH_PAGE_SIZE;
+  if(start < hflash->prog_start)
+  {
+    start = hflash->prog_start;
+  }
+  if(end > hflash->prog_end)
+  {
+    end = hflash->prog_end;
+  }
+
+  hflash->page = page + 1;
+  hflash->program_count++;
+  hflash->state = SPIFLASH_ST_W_PROG;
+  spiflash_write_enable(hflash);
+  spiflash_cmd_addr(hflash, SPIFLASH_CMD_PAGEPROGRAM, hflash->sector + start);
+  spiflash_dma_start(hflash, 0, &hflash->sector_buf[start], end - start);
+}
+
+/**
+  * @brief  compare the range read back with the new data. when every changed bit
+  *         goes from 1 to 0 only the changed pages are programmed, otherwise the
+  *         rest of the sector is read, the sector erased and every page which is
+  *         not blank after the merge programmed.
+  * @param  hflash: the handle points to the spi flash information.
+  * @param  req: the running request.
+  * @retval none
+  */
+static void spiflash_write_check(spiflash_handle_type* hflash, spiflash_request_type* req)
+{
+  uint8_t *old = &hflash->sector_buf[hflash->sec_off];
+  const uint8_t *new_data = &req->buf[hflash->pos];
+  confirm_state need_erase = FALSE;
+  uint16_t i;
+
+  hflash->dirty = 0;
+  for(i = 0; i < hflash->sec_len; i++)
+  {
+    if(old[i] != new_data[i])
+    {
+      hflash->dirty |= (uint16_t)(1U << ((hflash->sec_off + i) / SPIFLASH_PAGE_SIZE));
+      if((old[i] & new_data[i]) != new_data[i])
+      {
+        need_erase = TRUE;
+      }
+      old[i] = new_data[i];
+    }
+  }
+
+  if(need_erase == FALSE)
+  {
+    hflash->prog_start = hflash->sec_off;
+    hflash->prog_end = hflash->sec_off + hflash->sec_len;
+    hflash->page = 0;
+    spiflash_program_next(hflash, req);
+  }
+  else if(hflash->sec_off != 0)
+  {
+    hflash->state = SPIFLASH_ST_W_HEAD;
+    spiflash_fast_read_cmd(hflash, hflash->sector);
+    spiflash_dma_start(hflash, hflash->sector_buf, 0, hflash->sec_off);
+  }
+  else
+  {
+    hflash->state = SPIFLASH_ST_W_HEAD;
+    spiflash_run(hflash);
+  }
+}
+
+/**
+  * @brief  step the state machine of the running request.
+  * @param  hflash: the handle points to the spi flash information.
+  * @retval none
+  */
+static void spiflash_run(spiflash_handle_type* hflash)
+{
+  spiflash_request_type *req;
+  uint16_t end, i, page;
+
+  if(hflash->head == hflash->tail)
+  {
+    return;
+  }
+  req = hflash->queue[hflash->tail & hflash->size_mask];
+
+  switch(hflash->state)
+  {
+    case SPIFLASH_ST_IDLE:
+      hflash->pos = 0;
+      if(req->op == SPIFLASH_OP_READ)
+      {
+        hflash->state = SPIFLASH_ST_READ;
+        hflash->remain = req->len;
+        spiflash_fast_read_cmd(hflash, req->addr);
+        spiflash_read_next(hflash, req);
+      }
+      else if(req->op == SPIFLASH_OP_ERASE)
+      {
+        hflash->state = SPIFLASH_ST_ERASE_WAIT;
+        hflash->erase_count++;
+        spiflash_write_enable(hflash);
+        spiflash_cmd_addr(hflash, SPIFLASH_CMD_SECTORERASE, req->addr & ~(uint32_t)(SPIFLASH_SECTOR_SIZE - 1));
+        SPIFLASH_CS_HIGH(hflash);
+      }
+      else
+      {
+        spiflash_write_sector_begin(hflash, req);
+      }
+      break;
+
+    case SPIFLASH_ST_READ:
+      if(hflash->remain != 0)
+      {
+        spiflash_read_next(hflash, req);
+      }
+      else
+      {
+        SPIFLASH_CS_HIGH(hflash);
+        spiflash_complete(hflash, SPIFLASH_OK);
+      }
+      break;
+
+    case SPIFLASH_ST_ERASE_WAIT:
+      spiflash_complete(hflash, SPIFLASH_OK);
+      break;
+
+    case SPIFLASH_ST_W_CHECK:
+      SPIFLASH_CS_HIGH(hflash);
+      spiflash_write_check(hflash, req);
+      break;
+
+    case SPIFLASH_ST_W_HEAD:
+      SPIFLASH_CS_HIGH(hflash);
+      end = hflash->sec_off + hflash->sec_len;
+      if(end < SPIFLASH_SECTOR_SIZE)
+      {
+        hflash->state = SPIFLASH_ST_W_TAIL;
+        spiflash_fast_read_cmd(hflash, hflash->sector + end);
+        spiflash_dma_start(hflash, &hflash->sector_buf[end], 0, SPIFLASH_SECTOR_SIZE - end);
+        break;
+      }
+      /* the range ends the sector, go on with the erase */
+
+    case SPIFLASH_ST_W_TAIL:
+      SPIFLASH_CS_HIGH(hflash);
+      hflash->state = SPIFLASH_ST_W_ERASE;
+      hflash->erase_count++;
+      spiflash_write_enable(hflash);
+      spiflash_cmd_addr(hflash, SPIFLASH_CMD_SECTORERASE, hflash->sector);
+      SPIFLASH_CS_HIGH(hflash);
+      break;
+
+    case SPIFLASH_ST_W_ERASE:
+      hflash->dirty = 0;
+      for(page = 0; page < SPIFLASH_SECTOR_SIZE / SPIFLASH_PAGE_SIZE; page++)
+      {
+        for(i = 0; i < SPIFLASH_PAGE_SIZE; i++)
+        {
+          if(hflash->sector_buf[page * SPIFLASH_PAGE_SIZE + i] != 0xFF)
+          {
+            hflash->dirty |= (uint16_t)(1U << page);
+            break;
+          }
+        }
+      }
+      hflash->prog_start = 0;
+      hflash->prog_end = SPIFLASH_SECTOR_SIZE;
+      hflash->page = 0;
+      spiflash_program_next(hflash, req);
+      break;
+
+    case SPIFLASH_ST_W_PROG:
+      SPIFLASH_CS_HIGH(hflash);
+      hflash->state = SPIFLASH_ST_W_PROG_WAIT;
+      break;
+
+    case SPIFLASH_ST_W_PROG_WAIT:
+      spiflash_program_next(hflash, req);
+      break;
+
+    default:
+      break;
+  }
+}
+
+/**
+  * @brief  end of a dma data phase.
+  * @param  hdma: the receive dma handle, first member of the spi flash handle.
+  * @param  desc: the finished descriptor.
+  * @retval none
+  */
+static void spiflash_dma_full_callback(dma_handle_type* hdma, dma_desc_type* desc)
+{
+  spiflash_handle_type *hflash = (spiflash_handle_type *)hdma;
+
+  /* the receive channel ends last, the transmit one has already stopped */
+  spi_i2s_dma_transmitter_enable(hflash->spix, FALSE);
+  spi_i2s_dma_receiver_enable(hflash->spix, FALSE);
+  dma_chain_stop(&hflash->dma_tx);
+
+  spiflash_run(hflash);
+}
+
+/**
+  * @brief  dma transfer error, the running request is ended.
+  * @param  hdma: the receive dma handle, first member of the spi flash handle.
+  * @param  desc: the failed descriptor.
+  * @retval none
+  */
+static void spiflash_dma_error_callback(dma_handle_type* hdma, dma_desc_type* desc)
+{
+  spiflash_handle_type *hflash = (spiflash_handle_type *)hdma;
+
+  spi_i2s_dma_transmitter_enable(hflash->spix, FALSE);
+  spi_i2s_dma_receiver_enable(hflash->spix, FALSE);
+  dma_chain_stop(&hflash->dma_tx);
+  SPIFLASH_CS_HIGH(hflash);
+
+  spiflash_complete(hflash, SPIFLASH_ERR_DMA);
+}
+
+/**
+  * @brief  spi flash initialization, calls spiflash_lowlevel_init() then allocates
+  *         and prepares the dma channels of the spi.
+  * @note   the interrupt of hflash->dma_rx.channel_index should call
+  *         dma_irq_handler(&hflash->dma_rx), a periodic timer interrupt should call
+  *         spiflash_timer_handler(). both interrupts should have the same priority.
+  * @param  hflash: the handle points to the spi flash information.
+  * @param  queue_buf: request pointer ring.
+  * @param  queue_size: number of entries of queue_buf, a power of 2.
+  * @retval spi flash status.
+  */
+spiflash_status_type spiflash_init(spiflash_handle_type* hflash, spiflash_request_type** queue_buf, uint16_t queue_size)
+{
+  dma_init_type dma_init_struct;
+
+  if((hflash->sector_buf == 0) || (queue_buf == 0) || (queue_size == 0) || ((queue_size & (queue_size - 1)) != 0))
+  {
+    return SPIFLASH_ERR_PARAM;
+  }
+
+  hflash->queue = queue_buf;
+  hflash->size_mask = queue_size - 1;
+  hflash->head = 0;
+  hflash->tail = 0;
+  hflash->state = SPIFLASH_ST_IDLE;
+  hflash->bus_bytes = 0;
+  hflash->erase_count = 0;
+  hflash->program_count = 0;
+
+  spiflash_lowlevel_init(hflash);
+  SPIFLASH_CS_HIGH(hflash);
+
+  if((dma_channel_alloc(&hflash->dma_rx, (hflash->spix == SPI1) ? DMA_REQ_SPI1_RX : DMA_REQ_SPI2_RX) != DMA_APP_OK) ||
+     (dma_channel_alloc(&hflash->dma_tx, (hflash->spix == SPI1) ? DMA_REQ_SPI1_TX : DMA_REQ_SPI2_TX) != DMA_APP_OK))
+  {
+    dma_channel_free(&hflash->dma_rx);
+    return SPIFLASH_ERR_PARAM;
+  }
+
+  hflash->dma_rx.half_callback = 0;
+  hflash->dma_rx.full_callback = spiflash_dma_full_callback;
+  hflash->dma_rx.error_callback = spiflash_dma_error_callback;
+  hflash->dma_tx.half_callback = 0;
+  hflash->dma_tx.full_callback = 0;
+  hflash->dma_tx.error_callback = 0;
+
+  dma_default_para_init(&dma_init_struct);
+  dma_init_struct.peripheral_base_addr = (uint32_t)&hflash->spix->dt;
+  dma_init_struct.peripheral_data_width = DMA_PERIPHERAL_DATA_WIDTH_BYTE;
+  dma_init_struct.memory_data_width = DMA_MEMORY_DATA_WIDTH_BYTE;
+  dma_init_struct.peripheral_inc_enable = FALSE;
+  dma_init_struct.memory_inc_enable = TRUE;
+  dma_init_struct.loop_mode_enable = FALSE;
+  dma_init_struct.priority = DMA_PRIORITY_VERY_HIGH;
+  dma_init_struct.direction = DMA_DIR_PERIPHERAL_TO_MEMORY;
+  dma_desc_build(&hflash->rx_desc, &dma_init_struct);
+  dma_init_struct.priority = DMA_PRIORITY_HIGH;
+  dma_init_struct.direction = DMA_DIR_MEMORY_TO_PERIPHERAL;
+  dma_desc_build(&hflash->tx_desc, &dma_init_struct);
+
+  return SPIFLASH_OK;
+}
+
+/**
+  * @brief  queue a request, it is started by the next timer tick when the flash is idle.
+  * @param  hflash: the handle points to the spi flash information.
+  * @param  req: the request, the status is SPIFLASH_PENDING until it ends.
+  * @retval spi flash status.
+  */
+spiflash_status_type spiflash_submit(spiflash_handle_type* hflash, spiflash_request_type* req)
+{
+  if((req->len == 0) && (req->op != SPIFLASH_OP_ERASE))
+  {
+    return SPIFLASH_ERR_PARAM;
+  }
+
+  if((uint16_t)(hflash->head - hflash->tail) > hflash->size_mask)
+  {
+    return SPIFLASH_ERR_FULL;
+  }
+
+  req->status = SPIFLASH_PENDING;
+  hflash->queue[hflash->head & hflash->size_mask] = req;
+  __DMB();
+  hflash->head++;
+
+  return SPIFLASH_OK;
+}
+
+/**
+  * @brief  check whether every queued request has ended.
+  * @param  hflash: the handle points to the spi flash information.
+  * @retval TRUE or FALSE.
+  */
+confirm_state spiflash_idle_get(spiflash_handle_type* hflash)
+{
+  return ((hflash->head == hflash->tail) && (hflash->state == SPIFLASH_ST_IDLE)) ? TRUE : FALSE;
+}
+
+/**
+  * @brief  periodic timer handler, polls the busy bit while an erase or a program
+  *         runs and starts the queued requests.
+  * @param  hflash: the handle points to the spi flash information.
+  * @retval none
+  */
+void spiflash_timer_handler(spiflash_handle_type* hflash)
+{
+  switch(hflash->state)
+  {
+    case SPIFLASH_ST_IDLE:
+      spiflash_run(hflash);
+      break;
+
+    case SPIFLASH_ST_ERASE_WAIT:
+    case SPIFLASH_ST_W_ERASE:
+    case SPIFLASH_ST_W_PROG_WAIT:
+      if((spiflash_sr1_read(hflash) & SPIFLASH_SR1_BUSY) == 0)
+      {
+        spiflash_run(hflash);
+      }
+      break;
+
+    default:
+      break;
+  }
+}
+
+/**
+  * @}
+  */
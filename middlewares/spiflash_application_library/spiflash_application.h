@@ -0,0 +1,188 @@
+/**
+  **************************************************************************
+  * @file     spiflash_application.h
+  * @brief    spi nor flash application libray header file
+  **************************************************************************
+  *
+  * Copyright (c) 2025, Artery Technology, All rights reserved.
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+/*!< define to prevent recursive inclusion -------------------------------------*/
+#ifndef __SPIFLASH_APPLICATION_H
+#define __SPIFLASH_APPLICATION_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* includes ------------------------------------------------------------------*/
+#include "at32f422_426.h"
+#include "dma_application.h"
+
+/** @addtogroup AT32F422_426_middlewares_spiflash_application_library
+  * @{
+  */
+
+
+/** @defgroup SPIFLASH_library_definition
+  * @{
+  */
+
+#define SPIFLASH_SECTOR_SIZE             4096
+#define SPIFLASH_PAGE_SIZE               256
+
+#define SPIFLASH_CMD_WRITEENABLE         0x06
+#define SPIFLASH_CMD_READSTATUSREG1      0x05
+#define SPIFLASH_CMD_FASTREADDATA        0x0B
+#define SPIFLASH_CMD_PAGEPROGRAM         0x02
+#define SPIFLASH_CMD_SECTORERASE         0x20
+#define SPIFLASH_DUMMY_BYTE              0xFF
+#define SPIFLASH_SR1_BUSY                0x01
+
+/**
+  * @}
+  */
+
+/** @defgroup SPIFLASH_library_status_code
+  * @{
+  */
+
+typedef enum
+{
+  SPIFLASH_OK = 0,        /*!< no error */
+  SPIFLASH_ERR_PARAM,     /*!< invalid parameter */
+  SPIFLASH_ERR_FULL,      /*!< request queue is full */
+  SPIFLASH_ERR_DMA,       /*!< dma transfer error */
+  SPIFLASH_PENDING,       /*!< request queued or running */
+} spiflash_status_type;
+
+/**
+  * @}
+  */
+
+/** @defgroup SPIFLASH_library_request
+  * @{
+  */
+
+typedef enum
+{
+  SPIFLASH_OP_READ = 0,   /*!< fast read into buf */
+  SPIFLASH_OP_WRITE,      /*!< write buf, erases a sector only when a bit goes from 0 to 1 */
+  SPIFLASH_OP_ERASE,      /*!< erase the sector holding addr */
+} spiflash_op_type;
+
+typedef struct spiflash_request_struct spiflash_request_type;
+
+/**
+  * @brief  request completion callback, called in the interrupt.
+  */
+typedef void (*spiflash_callback_type)(spiflash_request_type* req);
+
+/**
+  * @brief  spi flash request, owned by the caller until status is no more SPIFLASH_PENDING.
+  */
+struct spiflash_request_struct
+{
+  spiflash_op_type                       op;                      /*!< operation                       */
+  uint32_t                               addr;                    /*!< flash byte address              */
+  uint8_t                                *buf;                    /*!< data buffer                     */
+  uint32_t                               len;                     /*!< data length in bytes            */
+  spiflash_callback_type                 callback;                /*!< completion callback, may be NULL */
+  __IO spiflash_status_type              status;                  /*!< request status                  */
+};
+
+/**
+  * @}
+  */
+
+/** @defgroup SPIFLASH_library_handle
+  * @{
+  */
+
+typedef enum
+{
+  SPIFLASH_ST_IDLE = 0,   /*!< no request running */
+  SPIFLASH_ST_READ,       /*!< fast read dma in flight */
+  SPIFLASH_ST_ERASE_WAIT, /*!< sector erase request, flash busy */
+  SPIFLASH_ST_W_CHECK,    /*!< write, reading the target range back */
+  SPIFLASH_ST_W_HEAD,     /*!< write, reading the sector before the range */
+  SPIFLASH_ST_W_TAIL,     /*!< write, reading the sector after the range */
+  SPIFLASH_ST_W_ERASE,    /*!< write, sector erase busy */
+  SPIFLASH_ST_W_PROG,     /*!< write, page program dma in flight */
+  SPIFLASH_ST_W_PROG_WAIT,/*!< write, page program busy */
+} spiflash_state_type;
+
+typedef struct
+{
+  dma_handle_type                        dma_rx;                  /*!< receive dma, signals the end of every transfer */
+  dma_handle_type                        dma_tx;                  /*!< transmit dma                    */
+  dma_desc_type                          rx_desc;                 /*!< receive register image          */
+  dma_desc_type                          tx_desc;                 /*!< transmit register image         */
+  spi_type                               *spix;                   /*!< spi registers base address      */
+  gpio_type                              *cs_gpio;                /*!< software cs port                */
+  uint16_t                               cs_pin;                  /*!< software cs pin                 */
+  uint8_t                                *sector_buf;             /*!< SPIFLASH_SECTOR_SIZE bytes work buffer */
+  spiflash_request_type                  **queue;                 /*!< request pointer ring            */
+  uint16_t                               size_mask;               /*!< ring size minus one             */
+  __IO uint16_t                          head;                    /*!< write index, caller side        */
+  __IO uint16_t                          tail;                    /*!< read index, interrupt side      */
+  __IO spiflash_state_type               state;                   /*!< state of the running request    */
+  uint32_t                               pos;                     /*!< bytes of the request done       */
+  uint32_t                               remain;                  /*!< bytes left in the current step  */
+  uint32_t                               sector;                  /*!< sector address being written    */
+  uint16_t                               sec_off;                 /*!< offset of the range in the sector */
+  uint16_t                               sec_len;                 /*!< length of the range in the sector */
+  uint16_t                               prog_start;              /*!< first byte of the sector buffer to program */
+  uint16_t                               prog_end;                /*!< end of the bytes to program     */
+  uint16_t                               dirty;                   /*!< pages of the sector to program  */
+  uint8_t                                page;                    /*!< next page to check              */
+  uint8_t                                dummy;                   /*!< dma byte for the unused direction */
+  __IO uint32_t                          bus_bytes;               /*!< bytes clocked on the bus        */
+  __IO uint32_t                          erase_count;             /*!< sector erases issued            */
+  __IO uint32_t                          program_count;           /*!< page programs issued            */
+} spiflash_handle_type;
+
+/**
+  * @}
+  */
+
+/** @defgroup SPIFLASH_library_exported_functions
+  * @{
+  */
+
+void                 spiflash_lowlevel_init   (spiflash_handle_type* hflash);
+spiflash_status_type spiflash_init            (spiflash_handle_type* hflash, spiflash_request_type** queue_buf, uint16_t queue_size);
+spiflash_status_type spiflash_submit          (spiflash_handle_type* hflash, spiflash_request_type* req);
+confirm_state        spiflash_idle_get        (spiflash_handle_type* hflash);
+void                 spiflash_timer_handler   (spiflash_handle_type* hflash);
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
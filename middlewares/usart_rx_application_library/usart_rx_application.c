@@ -0,0 +1,314 @@
+/**
+  **************************************************************************
+  * @file     usart_rx_application.c
+  * @brief    usart dma receive application libray source file
+  **************************************************************************
+  *
+  * Copyright (c) 2025, Artery Technology, All rights reserved.
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+#include "usart_rx_application.h"
+
+/** @addtogroup AT32F422_426_middlewares_usart_rx_application_library
+  * @{
+  */
+
+
+/**
+  * @brief  initializes peripherals used by the receiver: clocks, gpio, the usart
+  *         parameters with the receiver enabled, and the usart and dma interrupts.
+  * @param  hrx: the handle points to the receiver information.
+  * @retval none
+  */
+__WEAK void usart_rx_lowlevel_init(usart_rx_handle_type* hrx)
+{
+
+}
+
+/**
+  * @brief  ring index of the next byte the dma writes.
+  * @param  hrx: the handle points to the receiver information.
+  * @retval ring index.
+  */
+static uint16_t usart_rx_head_get(usart_rx_handle_type* hrx)
+{
+  uint16_t head = hrx->size - (uint16_t)hrx->dma.channel->dtcnt;
+
+  if(head >= hrx->size)
+  {
+    head = 0;
+  }
+  return head;
+}
+
+/**
+  * @brief  bytes written by the dma since the start, the published ones and
+  *         those after pos not published yet.
+  * @param  hrx: the handle points to the receiver information.
+  * @param  pos: set to the ring index of the next byte to publish.
+  * @retval number of bytes.
+  */
+static uint32_t usart_rx_written_get(usart_rx_handle_type* hrx, uint16_t* pos)
+{
+  uint32_t published;
+  uint16_t head;
+
+  /* pos and published of the same interrupt */
+  do
+  {
+    published = hrx->published;
+    *pos = hrx->pos;
+  } while(published != hrx->published);
+
+  head = usart_rx_head_get(hrx);
+  return published + ((head >= *pos) ? (head - *pos) : (head + hrx->size - *pos));
+}
+
+/**
+  * @brief  the reader fell a ring behind, drop every published byte.
+  * @param  hrx: the handle points to the receiver information.
+  * @retval none
+  */
+static void usart_rx_overrun(usart_rx_handle_type* hrx)
+{
+  uint32_t published;
+  uint16_t pos;
+
+  do
+  {
+    published = hrx->published;
+    pos = hrx->pos;
+  } while(published != hrx->published);
+
+  hrx->tail = pos;
+  hrx->consumed = published;
+  hrx->overrun_count++;
+}
+
+/**
+  * @brief  publish the bytes written by the dma since the last call, in one
+  *         piece or two when the ring wrapped.
+  * @param  hrx: the handle points to the receiver information.
+  * @retval none
+  */
+static void usart_rx_publish(usart_rx_handle_type* hrx)
+{
+  uint16_t head = usart_rx_head_get(hrx);
+  uint16_t length;
+
+  hrx->irq_count++;
+  while(head != hrx->pos)
+  {
+    length = (head > hrx->pos) ? (head - hrx->pos) : (hrx->size - hrx->pos);
+    if(hrx->callback != 0)
+    {
+      hrx->callback(hrx, hrx->buf + hrx->pos, length);
+    }
+    hrx->pos += length;
+    if(hrx->pos == hrx->size)
+    {
+      hrx->pos = 0;
+    }
+    hrx->published += length;
+  }
+}
+
+/**
+  * @brief  dma half and full transfer, publish so that a burst longer than the
+  *         ring does not overwrite unpublished bytes.
+  * @param  hdma: the dma handle, first member of the receiver handle.
+  * @param  desc: the loop mode descriptor.
+  * @retval none
+  */
+static void usart_rx_dma_callback(dma_handle_type* hdma, dma_desc_type* desc)
+{
+  usart_rx_publish((usart_rx_handle_type *)hdma);
+}
+
+/**
+  * @brief  receiver initialization, calls usart_rx_lowlevel_init() then starts
+  *         the dma in loop mode over the ring with the idle line interrupt, and
+  *         the receiver timeout interrupt when hrx->timeout is not 0.
+  * @note   the usart interrupt should call usart_rx_irq_handler(hrx), the interrupt
+  *         of hrx->dma.channel_index should call dma_irq_handler(&hrx->dma).
+  *         both interrupts should have the same priority.
+  * @param  hrx: the handle points to the receiver information, usartx, timeout
+  *         and callback set by the caller.
+  * @param  buf: receive ring.
+  * @param  size: ring size in bytes, at least 2.
+  * @retval usart receiver status.
+  */
+usart_rx_status_type usart_rx_init(usart_rx_handle_type* hrx, uint8_t* buf, uint16_t size)
+{
+  dma_init_type dma_init_struct;
+
+  if((buf == 0) || (size < 2) || ((hrx->usartx != USART1) && (hrx->usartx != USART2)))
+  {
+    return USART_RX_ERR_PARAM;
+  }
+
+  hrx->buf = buf;
+  hrx->size = size;
+  hrx->pos = 0;
+  hrx->tail = 0;
+  hrx->published = 0;
+  hrx->consumed = 0;
+  hrx->overrun_count = 0;
+  hrx->irq_count = 0;
+
+  usart_rx_lowlevel_init(hrx);
+
+  if(dma_channel_alloc(&hrx->dma, (hrx->usartx == USART1) ? DMA_REQ_USART1_RX : DMA_REQ_USART2_RX) != DMA_APP_OK)
+  {
+    return USART_RX_ERR_BUSY;
+  }
+  hrx->dma.half_callback = usart_rx_dma_callback;
+  hrx->dma.full_callback = usart_rx_dma_callback;
+  hrx->dma.error_callback = 0;
+
+  dma_default_para_init(&dma_init_struct);
+  dma_init_struct.buffer_size = size;
+  dma_init_struct.direction = DMA_DIR_PERIPHERAL_TO_MEMORY;
+  dma_init_struct.memory_base_addr = (uint32_t)buf;
+  dma_init_struct.memory_data_width = DMA_MEMORY_DATA_WIDTH_BYTE;
+  dma_init_struct.memory_inc_enable = TRUE;
+  dma_init_struct.peripheral_base_addr = (uint32_t)&hrx->usartx->dt;
+  dma_init_struct.peripheral_data_width = DMA_PERIPHERAL_DATA_WIDTH_BYTE;
+  dma_init_struct.peripheral_inc_enable = FALSE;
+  dma_init_struct.priority = DMA_PRIORITY_HIGH;
+  dma_init_struct.loop_mode_enable = TRUE;
+  dma_desc_build(&hrx->desc, &dma_init_struct);
+  dma_chain_start(&hrx->dma, &hrx->desc);
+
+  /* the dma takes the data, only the end of a burst interrupts */
+  usart_interrupt_enable(hrx->usartx, USART_RDBF_INT, FALSE);
+  usart_flag_clear(hrx->usartx, USART_IDLEF_FLAG);
+  usart_interrupt_enable(hrx->usartx, USART_IDLE_INT, TRUE);
+  if(hrx->timeout != 0)
+  {
+    usart_receiver_timeout_value_set(hrx->usartx, hrx->timeout);
+    usart_flag_clear(hrx->usartx, USART_RTODF_FLAG);
+    usart_receiver_timeout_detection_enable(hrx->usartx, TRUE);
+    usart_interrupt_enable(hrx->usartx, USART_RTOD_INT, TRUE);
+  }
+  usart_dma_receiver_enable(hrx->usartx, TRUE);
+
+  return USART_RX_OK;
+}
+
+/**
+  * @brief  stop the receiver and give the dma channel back.
+  * @param  hrx: the handle points to the receiver information.
+  * @retval none
+  */
+void usart_rx_deinit(usart_rx_handle_type* hrx)
+{
+  usart_dma_receiver_enable(hrx->usartx, FALSE);
+  usart_interrupt_enable(hrx->usartx, USART_IDLE_INT, FALSE);
+  usart_interrupt_enable(hrx->usartx, USART_RTOD_INT, FALSE);
+  usart_receiver_timeout_detection_enable(hrx->usartx, FALSE);
+  dma_channel_free(&hrx->dma);
+}
+
+/**
+  * @brief  number of published bytes not read yet. a reader that fell a whole
+  *         ring behind the dma, published bytes or not, may have lost the oldest
+  *         bytes, all the published ones are dropped and overrun_count is increased.
+  * @param  hrx: the handle points to the receiver information.
+  * @retval number of bytes.
+  */
+uint16_t usart_rx_available_get(usart_rx_handle_type* hrx)
+{
+  uint16_t pos;
+
+  if((usart_rx_written_get(hrx, &pos) - hrx->consumed) >= hrx->size)
+  {
+    usart_rx_overrun(hrx);
+  }
+
+  return (uint16_t)(hrx->published - hrx->consumed);
+}
+
+/**
+  * @brief  read published bytes from the ring. when the dma has overwritten the
+  *         oldest of them while they were copied, they are dropped as an overrun.
+  * @param  hrx: the handle points to the receiver information.
+  * @param  pdata: destination.
+  * @param  length: room in pdata.
+  * @retval number of bytes read.
+  */
+uint16_t usart_rx_read(usart_rx_handle_type* hrx, uint8_t* pdata, uint16_t length)
+{
+  uint16_t available = usart_rx_available_get(hrx);
+  uint16_t count, pos;
+
+  if(length > available)
+  {
+    length = available;
+  }
+
+  for(count = 0; count < length; count++)
+  {
+    pdata[count] = hrx->buf[hrx->tail];
+    if(++hrx->tail == hrx->size)
+    {
+      hrx->tail = 0;
+    }
+  }
+
+  if((usart_rx_written_get(hrx, &pos) - hrx->consumed) > hrx->size)
+  {
+    usart_rx_overrun(hrx);
+    return 0;
+  }
+  hrx->consumed += length;
+
+  return length;
+}
+
+/**
+  * @brief  usart interrupt handler, publishes the burst on an idle line or a
+  *         receiver timeout.
+  * @param  hrx: the handle points to the receiver information.
+  * @retval none
+  */
+void usart_rx_irq_handler(usart_rx_handle_type* hrx)
+{
+  confirm_state end = FALSE;
+
+  if(usart_interrupt_flag_get(hrx->usartx, USART_IDLEF_FLAG) != RESET)
+  {
+    usart_flag_clear(hrx->usartx, USART_IDLEF_FLAG);
+    end = TRUE;
+  }
+  if(usart_interrupt_flag_get(hrx->usartx, USART_RTODF_FLAG) != RESET)
+  {
+    usart_flag_clear(hrx->usartx, USART_RTODF_FLAG);
+    end = TRUE;
+  }
+
+  if(end)
+  {
+    usart_rx_publish(hrx);
+  }
+}
+
+/**
+  * @}
+  */
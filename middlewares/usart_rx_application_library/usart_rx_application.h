@@ -0,0 +1,115 @@
+/**
+  **************************************************************************
+  * @file     usart_rx_application.h
+  * @brief    usart dma receive application libray header file
+  **************************************************************************
+  *
+  * Copyright (c) 2025, Artery Technology, All rights reserved.
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+/*!< define to prevent recursive inclusion -------------------------------------*/
+#ifndef __USART_RX_APPLICATION_H
+#define __USART_RX_APPLICATION_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* includes ------------------------------------------------------------------*/
+#include "at32f422_426.h"
+#include "dma_application.h"
+
+/** @addtogroup AT32F422_426_middlewares_usart_rx_application_library
+  * @{
+  */
+
+
+/** @defgroup USART_RX_library_status_code
+  * @{
+  */
+
+typedef enum
+{
+  USART_RX_OK = 0,        /*!< no error */
+  USART_RX_ERR_PARAM,     /*!< invalid parameter */
+  USART_RX_ERR_BUSY,      /*!< no dma channel left */
+} usart_rx_status_type;
+
+/**
+  * @}
+  */
+
+/** @defgroup USART_RX_library_handle
+  * @{
+  */
+
+typedef struct usart_rx_handle_struct usart_rx_handle_type;
+
+/**
+  * @brief  chunk callback, called in the interrupt for every contiguous piece
+  *         of the ring that was received since the last one.
+  */
+typedef void (*usart_rx_callback_type)(usart_rx_handle_type* hrx, const uint8_t* pdata, uint16_t length);
+
+struct usart_rx_handle_struct
+{
+  dma_handle_type                        dma;                     /*!< receive dma, first member       */
+  dma_desc_type                          desc;                    /*!< loop mode register image        */
+  usart_type                             *usartx;                 /*!< usart registers base address    */
+  uint8_t                                *buf;                    /*!< receive ring                    */
+  uint16_t                               size;                    /*!< ring size in bytes              */
+  __IO uint16_t                          pos;                     /*!< ring index of the next byte to publish */
+  uint32_t                               timeout;                 /*!< receiver timeout in bit times, 0 uses the idle line only */
+  usart_rx_callback_type                 callback;                /*!< chunk callback, may be NULL     */
+  __IO uint32_t                          published;               /*!< bytes published, interrupt side */
+  __IO uint32_t                          consumed;                /*!< bytes read, caller side         */
+  uint16_t                               tail;                    /*!< ring index of the next byte to read */
+  __IO uint32_t                          overrun_count;           /*!< times the reader fell a ring behind */
+  __IO uint32_t                          irq_count;               /*!< publishing interrupts           */
+};
+
+/**
+  * @}
+  */
+
+/** @defgroup USART_RX_library_exported_functions
+  * @{
+  */
+
+void                 usart_rx_lowlevel_init   (usart_rx_handle_type* hrx);
+usart_rx_status_type usart_rx_init            (usart_rx_handle_type* hrx, uint8_t* buf, uint16_t size);
+void                 usart_rx_deinit          (usart_rx_handle_type* hrx);
+uint16_t             usart_rx_available_get   (usart_rx_handle_type* hrx);
+uint16_t             usart_rx_read            (usart_rx_handle_type* hrx, uint8_t* pdata, uint16_t length);
+void                 usart_rx_irq_handler     (usart_rx_handle_type* hrx);
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
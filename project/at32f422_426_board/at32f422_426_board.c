@@ -80,6 +80,309 @@ static __IO uint32_t fac_ms;
  #endif
 #endif
 
+#ifdef PRINT_UART_BUFFERED
+#include <stdarg.h>
+
+/* deferred print record, formatted by uart_print_defer_process() */
+typedef struct
+{
+  const char *fmt;
+  uint32_t arg[4];
+} print_defer_type;
+
+/* transmit ring, the dma sends print_tx_count bytes from print_tx_tail */
+static uint8_t print_tx_buf[PRINT_UART_TX_BUF_SIZE];
+static __IO uint16_t print_tx_head = 0;
+static __IO uint16_t print_tx_tail = 0;
+static __IO uint16_t print_tx_count = 0;
+static __IO uint32_t print_tx_dropped = 0;
+static print_uart_policy_type print_tx_policy = PRINT_UART_BLOCK;
+
+static print_defer_type print_defer_buf[PRINT_UART_DEFER_NUM];
+static __IO uint16_t print_defer_head = 0;
+static __IO uint16_t print_defer_tail = 0;
+
+#ifdef PRINT_UART_TRACE
+/* trace event ring, sent by the dma when no text is waiting */
+static print_trace_event_type print_trace_buf[PRINT_UART_TRACE_NUM];
+static __IO uint16_t print_trace_head = 0;
+static __IO uint16_t print_trace_tail = 0;
+static __IO uint32_t print_trace_dropped = 0;
+static uint8_t print_trace_seq = 0;
+static uint8_t print_tx_trace = 0;     /* the running dma sends trace events */
+#endif
+
+/**
+  * @brief  retire the finished dma transfer and start the next contiguous part
+  *         of the ring. called from the dma interrupt or with the interrupts
+  *         masked, it polls the dma flag so it also works in a fault handler.
+  * @param  none
+  * @retval none
+  */
+static void print_tx_service(void)
+{
+  uint16_t head = print_tx_head;
+  uint16_t tail = print_tx_tail;
+  uint32_t addr;
+  uint16_t count;
+
+  if(print_tx_count != 0)
+  {
+    if(dma_flag_get(PRINT_UART_TX_DMA_FDT_FLAG) == RESET)
+      return;
+    dma_flag_clear(PRINT_UART_TX_DMA_FDT_FLAG);
+#ifdef PRINT_UART_TRACE
+    if(print_tx_trace)
+    {
+      count = print_trace_tail + print_tx_count / sizeof(print_trace_event_type);
+      print_trace_tail = (count >= PRINT_UART_TRACE_NUM) ? (count - PRINT_UART_TRACE_NUM) : count;
+      print_tx_trace = 0;
+    }
+    else
+#endif
+    {
+      tail += print_tx_count;
+      if(tail >= PRINT_UART_TX_BUF_SIZE)
+        tail -= PRINT_UART_TX_BUF_SIZE;
+      print_tx_tail = tail;
+    }
+    print_tx_count = 0;
+  }
+
+  if(head != tail)
+  {
+    count = (head > tail) ? (head - tail) : (PRINT_UART_TX_BUF_SIZE - tail);
+    addr = (uint32_t)&print_tx_buf[tail];
+  }
+#ifdef PRINT_UART_TRACE
+  else if(print_trace_head != print_trace_tail)
+  {
+    head = print_trace_head;
+    tail = print_trace_tail;
+    count = ((head > tail) ? (head - tail) : (PRINT_UART_TRACE_NUM - tail)) * sizeof(print_trace_event_type);
+    addr = (uint32_t)&print_trace_buf[tail];
+    print_tx_trace = 1;
+  }
+#endif
+  else
+  {
+    return;
+  }
+
+  dma_channel_enable(PRINT_UART_TX_DMA_CHANNEL, FALSE);
+  PRINT_UART_TX_DMA_CHANNEL->maddr = addr;
+  dma_data_number_set(PRINT_UART_TX_DMA_CHANNEL, count);
+  print_tx_count = count;
+  usart_flag_clear(PRINT_UART, USART_TDC_FLAG);
+  dma_channel_enable(PRINT_UART_TX_DMA_CHANNEL, TRUE);
+}
+
+/**
+  * @brief  put a character in the transmit ring.
+  * @param  ch: character
+  * @retval none
+  */
+static void print_tx_put(uint8_t ch)
+{
+  uint32_t primask = __get_PRIMASK();
+  uint16_t next;
+
+  __disable_irq();
+  next = print_tx_head + 1;
+  if(next == PRINT_UART_TX_BUF_SIZE)
+    next = 0;
+  while(next == print_tx_tail)
+  {
+    if(print_tx_policy == PRINT_UART_DROP)
+    {
+      print_tx_dropped++;
+      __set_PRIMASK(primask);
+      return;
+    }
+    print_tx_service();
+    /* let the other interrupts run while waiting */
+    __set_PRIMASK(primask);
+    __disable_irq();
+  }
+  print_tx_buf[print_tx_head] = ch;
+  print_tx_head = next;
+  if(print_tx_count == 0)
+    print_tx_service();
+  __set_PRIMASK(primask);
+}
+
+/**
+  * @brief  print transmit dma interrupt handler.
+  * @param  none
+  * @retval none
+  */
+void PRINT_UART_TX_DMA_IRQHandler(void)
+{
+  if(dma_interrupt_flag_get(PRINT_UART_TX_DMA_FDT_FLAG) != RESET)
+  {
+    print_tx_service();
+  }
+}
+
+/**
+  * @brief  select what a print does when the ring is full.
+  * @param  policy: PRINT_UART_BLOCK or PRINT_UART_DROP
+  * @retval none
+  */
+void uart_print_policy_set(print_uart_policy_type policy)
+{
+  print_tx_policy = policy;
+}
+
+/**
+  * @brief  number of characters and deferred prints dropped on a full ring.
+  * @param  none
+  * @retval dropped count
+  */
+uint32_t uart_print_dropped_get(void)
+{
+  return print_tx_dropped;
+}
+
+/**
+  * @brief  send everything in the ring and wait for the last stop bit. works
+  *         by polling with the interrupts masked, so it may be called from a
+  *         fault handler.
+  * @param  none
+  * @retval none
+  */
+void uart_print_flush(void)
+{
+  uint32_t primask = __get_PRIMASK();
+
+  __disable_irq();
+#ifdef PRINT_UART_TRACE
+  while((print_tx_head != print_tx_tail) || (print_trace_head != print_trace_tail) || (print_tx_count != 0))
+#else
+  while((print_tx_head != print_tx_tail) || (print_tx_count != 0))
+#endif
+  {
+    print_tx_service();
+  }
+  while(usart_flag_get(PRINT_UART, USART_TDC_FLAG) == RESET);
+  __set_PRIMASK(primask);
+}
+
+/**
+  * @brief  log a format pointer and up to 4 integer or pointer arguments, the
+  *         formatting is done later by uart_print_defer_process(). fmt and the
+  *         strings of %s arguments must stay valid until then.
+  * @param  fmt: printf format
+  * @param  argc: number of arguments, 0 ~ 4
+  * @retval none
+  */
+void uart_print_defer(const char *fmt, uint8_t argc, ...)
+{
+  uint32_t primask = __get_PRIMASK();
+  print_defer_type *record;
+  va_list args;
+  uint16_t next;
+  uint8_t index;
+
+  __disable_irq();
+  next = print_defer_head + 1;
+  if(next == PRINT_UART_DEFER_NUM)
+    next = 0;
+  if(next == print_defer_tail)
+  {
+    print_tx_dropped++;
+    __set_PRIMASK(primask);
+    return;
+  }
+
+  record = &print_defer_buf[print_defer_head];
+  record->fmt = fmt;
+  va_start(args, argc);
+  for(index = 0; index < 4; index++)
+  {
+    record->arg[index] = (index < argc) ? va_arg(args, uint32_t) : 0;
+  }
+  va_end(args);
+  print_defer_head = next;
+  __set_PRIMASK(primask);
+}
+
+/**
+  * @brief  format the deferred prints, call it where the time is available.
+  * @param  none
+  * @retval none
+  */
+void uart_print_defer_process(void)
+{
+  print_defer_type *record;
+  uint16_t next;
+
+  while(print_defer_tail != print_defer_head)
+  {
+    record = &print_defer_buf[print_defer_tail];
+    printf(record->fmt, record->arg[0], record->arg[1], record->arg[2], record->arg[3]);
+    next = print_defer_tail + 1;
+    if(next == PRINT_UART_DEFER_NUM)
+      next = 0;
+    print_defer_tail = next;
+  }
+}
+
+#ifdef PRINT_UART_TRACE
+/**
+  * @brief  log a binary trace event, cheap enough for an interrupt. the event
+  *         is dropped when the ring is full, the sequence number shows the gap.
+  * @param  id: event id, mapped to a format string by the host decoder
+  * @param  argc: number of arguments, 0 ~ 3
+  * @param  arg0: first argument
+  * @param  arg1: second argument
+  * @param  arg2: third argument
+  * @retval none
+  */
+void uart_trace(uint16_t id, uint8_t argc, uint32_t arg0, uint32_t arg1, uint32_t arg2)
+{
+  uint32_t primask = __get_PRIMASK();
+  print_trace_event_type *event;
+  uint16_t next;
+
+  __disable_irq();
+  next = print_trace_head + 1;
+  if(next == PRINT_UART_TRACE_NUM)
+    next = 0;
+  if(next == print_trace_tail)
+  {
+    print_trace_dropped++;
+    print_trace_seq++;
+    __set_PRIMASK(primask);
+    return;
+  }
+
+  event = &print_trace_buf[print_trace_head];
+  event->sync = PRINT_UART_TRACE_SYNC;
+  event->info = (uint8_t)((argc << 6) | (print_trace_seq++ & 0x3F));
+  event->id = id;
+  event->timestamp = PRINT_UART_TRACE_TIMESTAMP();
+  event->arg[0] = arg0;
+  event->arg[1] = arg1;
+  event->arg[2] = arg2;
+  print_trace_head = next;
+  if(print_tx_count == 0)
+    print_tx_service();
+  __set_PRIMASK(primask);
+}
+
+/**
+  * @brief  number of trace events dropped on a full ring.
+  * @param  none
+  * @retval dropped count
+  */
+uint32_t uart_trace_dropped_get(void)
+{
+  return print_trace_dropped;
+}
+#endif
+#endif
+
 #if defined (__GNUC__) && !defined (__clang__)
   #define PUTCHAR_PROTOTYPE int __io_putchar(int ch)
 #else
@@ -96,9 +399,13 @@ PUTCHAR_PROTOTYPE
 #if !defined (__GNUC__) || defined (__clang__)
   UNUSED(f);
 #endif
+#ifdef PRINT_UART_BUFFERED
+  print_tx_put((uint8_t)ch);
+#else
   while(usart_flag_get(PRINT_UART, USART_TDBE_FLAG) == RESET);
   usart_data_transmit(PRINT_UART, (uint16_t)ch);
   while(usart_flag_get(PRINT_UART, USART_TDC_FLAG) == RESET);
+#endif
   return ch;
 }
 
@@ -113,9 +420,13 @@ int __write(int fd, char *pbuffer, int size)
   UNUSED(fd);
   for(int i = 0; i < size; i ++)
   {
+#ifdef PRINT_UART_BUFFERED
+    print_tx_put((uint8_t)(*pbuffer++));
+#else
     while(usart_flag_get(PRINT_UART, USART_TDBE_FLAG) == RESET);
     usart_data_transmit(PRINT_UART, (uint16_t)(*pbuffer++));
     while(usart_flag_get(PRINT_UART, USART_TDC_FLAG) == RESET);
+#endif
   }
 
   return size;
@@ -130,6 +441,9 @@ int __write(int fd, char *pbuffer, int size)
 void uart_print_init(uint32_t baudrate)
 {
   gpio_init_type gpio_init_struct;
+#ifdef PRINT_UART_BUFFERED
+  dma_init_type dma_init_struct;
+#endif
 
 #if defined (__GNUC__) && !defined (__clang__)
   setvbuf(stdout, NULL, _IONBF, 0);
@@ -155,6 +469,34 @@ void uart_print_init(uint32_t baudrate)
   usart_init(PRINT_UART, baudrate, USART_DATA_8BITS, USART_STOP_1_BIT);
   usart_transmitter_enable(PRINT_UART, TRUE);
   usart_enable(PRINT_UART, TRUE);
+
+#ifdef PRINT_UART_BUFFERED
+  /* configure the transmit dma, each transfer is started by print_tx_service() */
+  crm_periph_clock_enable(CRM_DMA1_PERIPH_CLOCK, TRUE);
+  dma_reset(PRINT_UART_TX_DMA_CHANNEL);
+  dma_default_para_init(&dma_init_struct);
+  dma_init_struct.buffer_size = 0;
+  dma_init_struct.direction = DMA_DIR_MEMORY_TO_PERIPHERAL;
+  dma_init_struct.memory_base_addr = (uint32_t)print_tx_buf;
+  dma_init_struct.memory_data_width = DMA_MEMORY_DATA_WIDTH_BYTE;
+  dma_init_struct.memory_inc_enable = TRUE;
+  dma_init_struct.peripheral_base_addr = (uint32_t)&PRINT_UART->dt;
+  dma_init_struct.peripheral_data_width = DMA_PERIPHERAL_DATA_WIDTH_BYTE;
+  dma_init_struct.peripheral_inc_enable = FALSE;
+  dma_init_struct.priority = DMA_PRIORITY_LOW;
+  dma_init_struct.loop_mode_enable = FALSE;
+  dma_init(PRINT_UART_TX_DMA_CHANNEL, &dma_init_struct);
+  dma_interrupt_enable(PRINT_UART_TX_DMA_CHANNEL, DMA_FDT_INT, TRUE);
+  nvic_irq_enable(PRINT_UART_TX_DMA_IRQn, PRINT_UART_TX_DMA_PRIORITY, PRINT_UART_TX_DMA_PRIORITY);
+  usart_dma_transmitter_enable(PRINT_UART, TRUE);
+#endif
+
+#ifdef PRINT_UART_TRACE
+  /* start the dwt cycle counter used for the default timestamp */
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
 }
 
 /**
@@ -91,6 +91,80 @@ typedef enum
 #define PRINT_UART_TX_PIN_SOURCE         GPIO_PINS_SOURCE9
 #define PRINT_UART_TX_PIN_MUX_NUM        GPIO_MUX_1
 
+/**
+  * define PRINT_UART_BUFFERED to send printf through a ring drained by dma1
+  * channel2 instead of waiting on every character. the board then owns
+  * DMA1_Channel3_2_IRQHandler, examples using dma1 channel2 or 3 should not
+  * define it.
+  */
+/* #define PRINT_UART_BUFFERED */
+
+#ifdef PRINT_UART_BUFFERED
+#ifndef PRINT_UART_TX_BUF_SIZE
+#define PRINT_UART_TX_BUF_SIZE           512
+#endif
+#ifndef PRINT_UART_DEFER_NUM
+#define PRINT_UART_DEFER_NUM             16
+#endif
+/* preemption and sub priority of the dma interrupt, the lowest by default so
+   that a print never delays the interrupts of the application */
+#ifndef PRINT_UART_TX_DMA_PRIORITY
+#define PRINT_UART_TX_DMA_PRIORITY       ((1 << __NVIC_PRIO_BITS) - 1)
+#endif
+#define PRINT_UART_TX_DMA_CHANNEL        DMA1_CHANNEL2
+#define PRINT_UART_TX_DMA_FDT_FLAG       DMA1_FDT2_FLAG
+#define PRINT_UART_TX_DMA_IRQn           DMA1_Channel3_2_IRQn
+#define PRINT_UART_TX_DMA_IRQHandler     DMA1_Channel3_2_IRQHandler
+
+/* what a print does when the ring is full */
+typedef enum
+{
+  PRINT_UART_BLOCK                       = 0, /*!< wait for the dma to make room */
+  PRINT_UART_DROP                        = 1  /*!< drop the character and count it */
+} print_uart_policy_type;
+#endif
+
+/**
+  * define PRINT_UART_TRACE, with PRINT_UART_BUFFERED, for binary trace events
+  * sent by the same dma between the printed text. an event is 20 bytes, little
+  * endian: 0xa5, argc in bits 7:6 and a sequence number in bits 5:0, the 16-bit
+  * id, the 32-bit timestamp and 3 argument words. a host decoder finds the
+  * events by the 0xa5 byte, which plain ascii text does not hold.
+  * log events with UART_TRACE(id, "format", argc, arg0, arg1, arg2): the id
+  * and argc are literals and the format string is dropped by the compiler.
+  * trace_tool/trace_extract.py collects the id to format table from the
+  * sources at build time and trace_tool/trace_decode.py prints the events.
+  */
+/* #define PRINT_UART_TRACE */
+
+#ifdef PRINT_UART_TRACE
+#ifndef PRINT_UART_BUFFERED
+#error "PRINT_UART_TRACE needs PRINT_UART_BUFFERED"
+#endif
+#ifndef PRINT_UART_TRACE_NUM
+#define PRINT_UART_TRACE_NUM             32
+#endif
+/* event timestamp, the dwt cycle counter unless defined to a free running
+   timer counter such as (TMR2->cval) */
+#ifndef PRINT_UART_TRACE_TIMESTAMP
+#define PRINT_UART_TRACE_TIMESTAMP()     (DWT->CYCCNT)
+#endif
+#define PRINT_UART_TRACE_SYNC            0xA5
+#define UART_TRACE(id, fmt, argc, arg0, arg1, arg2) \
+        uart_trace((id), (argc), (uint32_t)(arg0), (uint32_t)(arg1), (uint32_t)(arg2))
+
+typedef struct
+{
+  uint8_t sync;
+  uint8_t info;
+  uint16_t id;
+  uint32_t timestamp;
+  uint32_t arg[3];
+} print_trace_event_type;
+#else
+#define UART_TRACE(id, fmt, argc, arg0, arg1, arg2) ((void)0)
+#endif
+
 /******************* define button *******************/
 typedef enum
 {
@@ -133,6 +207,21 @@ void delay_sec(uint16_t sec);
 /* printf uart init function */
 void uart_print_init(uint32_t baudrate);
 
+#ifdef PRINT_UART_BUFFERED
+/* buffered printf functions */
+void uart_print_policy_set(print_uart_policy_type policy);
+uint32_t uart_print_dropped_get(void);
+void uart_print_flush(void);
+void uart_print_defer(const char *fmt, uint8_t argc, ...);
+void uart_print_defer_process(void);
+#endif
+
+#ifdef PRINT_UART_TRACE
+/* binary trace functions */
+void uart_trace(uint16_t id, uint8_t argc, uint32_t arg0, uint32_t arg1, uint32_t arg2);
+uint32_t uart_trace_dropped_get(void);
+#endif
+
 /**
   * @}
   */
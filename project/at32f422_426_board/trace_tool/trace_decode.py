@@ -0,0 +1,135 @@
+#!/usr/bin/env python3
+# trace_decode.py, print the text and the binary trace events of the print uart
+#
+# usage: trace_decode.py -t trace_table.json [-c clock_hz] [input]
+#
+# input is a capture file or a serial device set raw beforehand, e.g.
+# stty -F /dev/ttyUSB0 115200 raw, standard input by default. the text lines
+# are printed as they are. an event, 20 little endian bytes starting with 0xa5,
+# is printed with its timestamp and the format of its id from the table built
+# by trace_extract.py. the 6-bit sequence number of the events shows the ones
+# dropped on a full ring on the device, they are reported as a gap.
+
+import argparse
+import json
+import re
+import struct
+import sys
+
+EVENT_SYNC = 0xA5
+EVENT_SIZE = 20
+EVENT = struct.Struct("<BBHI3I")
+CONVERSION = re.compile(r"%(?:(%)|([-+ #0]*\d*(?:\.\d+)?)(?:hh|h|ll|l)?([a-zA-Z]))")
+
+
+def c_format(fmt, args):
+    # printf of 32-bit words: %d and %i signed, the others unsigned
+    values = iter(args)
+
+    def convert(match):
+        if match.group(1):
+            return "%"
+        flags, kind = match.group(2), match.group(3)
+        value = next(values, 0)
+        if kind in "di":
+            value -= (value & 0x80000000) << 1
+            kind = "d"
+        elif kind == "u":
+            kind = "d"
+        elif kind == "c":
+            value &= 0xFF
+        return ("%" + flags + kind) % value
+
+    return CONVERSION.sub(convert, fmt)
+
+
+class TraceDecoder:
+    def __init__(self, table, clock_hz=0.0):
+        self.table = {int(k, 0): v for k, v in table.items()}
+        self.clock_hz = clock_hz
+        self.buf = bytearray()
+        self.text = bytearray()
+        self.seq = None
+        self.last_stamp = None
+        self.time = 0
+        self.lost = 0
+
+    def feed(self, data):
+        # returns the decoded lines
+        out = []
+        self.buf += data
+        i = 0
+        while i < len(self.buf):
+            if self.buf[i] != EVENT_SYNC:
+                c = self.buf[i]
+                i += 1
+                if c == 0x0A:
+                    out.append(self.text.decode("latin-1").rstrip("\r"))
+                    self.text.clear()
+                else:
+                    self.text.append(c)
+                continue
+            if len(self.buf) - i < EVENT_SIZE:
+                break
+            out.append(self.event(self.buf[i:i + EVENT_SIZE], out))
+            i += EVENT_SIZE
+        del self.buf[:i]
+        return out
+
+    def event(self, raw, out):
+        _, info, ident, stamp, a0, a1, a2 = EVENT.unpack(bytes(raw))
+        argc, seq = info >> 6, info & 0x3F
+        if self.seq is not None:
+            gap = (seq - self.seq - 1) & 0x3F
+            if gap:
+                self.lost += gap
+                out.append("[%d trace event(s) lost]" % gap)
+        self.seq = seq
+
+        # extend the 32-bit timestamp over its wraps
+        if self.last_stamp is not None:
+            self.time += (stamp - self.last_stamp) & 0xFFFFFFFF
+        self.last_stamp = stamp
+        if self.clock_hz:
+            when = "%12.6f" % (self.time / self.clock_hz)
+        else:
+            when = "%12d" % self.time
+
+        entry = self.table.get(ident)
+        args = (a0, a1, a2)[:argc]
+        if entry is None:
+            body = "id 0x%04X %s" % (ident, " ".join("0x%08X" % a for a in args))
+        else:
+            body = c_format(entry["format"], args)
+        return "%s %s" % (when, body.rstrip())
+
+
+def main():
+    parser = argparse.ArgumentParser(description="decode the print uart trace events")
+    parser.add_argument("-t", "--table", required=True, help="table of trace_extract.py")
+    parser.add_argument("-c", "--clock", type=float, default=0.0,
+                        help="timestamp clock in hz, raw ticks when omitted")
+    parser.add_argument("input", nargs="?", help="capture file or serial device, stdin by default")
+    args = parser.parse_args()
+
+    with open(args.table) as f:
+        decoder = TraceDecoder(json.load(f), args.clock)
+    source = open(args.input, "rb", buffering=0) if args.input else sys.stdin.buffer
+    try:
+        while True:
+            data = source.read(256)
+            if not data:
+                break
+            for line in decoder.feed(data):
+                print(line, flush=True)
+    except KeyboardInterrupt:
+        pass
+    if decoder.text:
+        print(decoder.text.decode("latin-1"))
+    if decoder.lost:
+        print("%d trace event(s) lost" % decoder.lost, file=sys.stderr)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,167 @@
+#!/usr/bin/env python3
+# trace_extract.py, collect the UART_TRACE id to format table from the sources
+#
+# usage: trace_extract.py -o trace_table.json <source file or directory> ...
+#
+# every UART_TRACE(id, "format", argc, arg0, arg1, arg2) call site of the .c
+# and .h files is read. the id and argc must be integer literals, the format
+# one or more adjacent string literals. the exit code is 1, and no table is
+# written, when an id is used with two different formats or argc, when argc
+# is above 3 or does not match the conversions of the format, or when %s is
+# used, an argument is a 32-bit word. run it as a pre-build step so that a
+# wrong call site breaks the build.
+
+import argparse
+import json
+import os
+import re
+import sys
+
+ARGC_MAX = 3
+CONVERSION = re.compile(r"%(?:%|[-+ #0]*\d*(?:\.\d+)?(?:hh|h|ll|l)?([a-zA-Z]))")
+CONVERSION_OK = "diouxXc"
+
+
+def source_files(paths):
+    for path in paths:
+        if os.path.isdir(path):
+            for root, _, names in os.walk(path):
+                for name in sorted(names):
+                    if name.endswith((".c", ".h")):
+                        yield os.path.join(root, name)
+        else:
+            yield path
+
+
+def strip_comments(text):
+    # blank the comments but keep the line numbers and the string literals
+    out = []
+    i = 0
+    n = len(text)
+    while i < n:
+        c = text[i]
+        if c == '"' or c == "'":
+            j = i + 1
+            while j < n and text[j] != c:
+                j += 2 if text[j] == "\\" else 1
+            out.append(text[i:j + 1])
+            i = j + 1
+        elif text.startswith("//", i):
+            j = text.find("\n", i)
+            j = n if j < 0 else j
+            i = j
+        elif text.startswith("/*", i):
+            j = text.find("*/", i + 2)
+            j = n if j < 0 else j + 2
+            out.append("\n" * text.count("\n", i, j))
+            i = j
+        else:
+            out.append(c)
+            i += 1
+    return "".join(out)
+
+
+def split_args(text, start):
+    # split the arguments of the call whose "(" is at start
+    args = []
+    depth = 0
+    i = start + 1
+    arg_start = i
+    while i < len(text):
+        c = text[i]
+        if c == '"' or c == "'":
+            j = i + 1
+            while j < len(text) and text[j] != c:
+                j += 2 if text[j] == "\\" else 1
+            i = j
+        elif c == "(":
+            depth += 1
+        elif c == ")":
+            if depth == 0:
+                args.append(text[arg_start:i].strip())
+                return args
+            depth -= 1
+        elif c == "," and depth == 0:
+            args.append(text[arg_start:i].strip())
+            arg_start = i + 1
+        i += 1
+    return None
+
+
+def c_string(expr):
+    # value of adjacent string literals, None when expr is not only literals
+    parts = re.findall(r'"((?:[^"\\]|\\.)*)"', expr)
+    if not parts or re.sub(r'"(?:[^"\\]|\\.)*"', "", expr).strip():
+        return None
+    raw = "".join(parts)
+    return raw.encode("latin-1").decode("unicode_escape")
+
+
+def c_integer(expr):
+    match = re.fullmatch(r"\(?\s*(0[xX][0-9a-fA-F]+|\d+)[uUlL]*\s*\)?", expr)
+    return int(match.group(1), 0) if match else None
+
+
+def extract(paths):
+    table = {}
+    errors = []
+    for path in source_files(paths):
+        with open(path, encoding="latin-1") as f:
+            text = strip_comments(f.read())
+        for match in re.finditer(r"\bUART_TRACE\s*\(", text):
+            line_start = text.rfind("\n", 0, match.start()) + 1
+            if text[line_start:match.start()].lstrip().startswith("#"):
+                continue
+            line = text.count("\n", 0, match.start()) + 1
+            site = "%s:%d" % (path, line)
+            args = split_args(text, match.end() - 1)
+            if args is None or len(args) != 6:
+                errors.append("%s: UART_TRACE needs 6 arguments" % site)
+                continue
+            ident = c_integer(args[0])
+            fmt = c_string(args[1])
+            argc = c_integer(args[2])
+            if ident is None or ident > 0xFFFF:
+                errors.append("%s: the id is not a 16-bit literal: %s" % (site, args[0]))
+                continue
+            if fmt is None:
+                errors.append("%s: the format is not a string literal" % site)
+                continue
+            if argc is None or argc > ARGC_MAX:
+                errors.append("%s: argc is not a literal of 0 to %d: %s" % (site, ARGC_MAX, args[2]))
+                continue
+            kinds = [k for k in CONVERSION.findall(fmt) if k]
+            bad = [k for k in kinds if k not in CONVERSION_OK]
+            if bad:
+                errors.append("%s: unsupported conversion %%%s" % (site, bad[0]))
+            if len(kinds) != argc:
+                errors.append("%s: argc %d but %d conversions in \"%s\"" % (site, argc, len(kinds), fmt))
+            key = "0x%04X" % ident
+            entry = table.get(key)
+            if entry is None:
+                table[key] = {"format": fmt, "argc": argc, "site": site}
+            elif entry["format"] != fmt or entry["argc"] != argc:
+                errors.append("%s: id %s already used for \"%s\" at %s" % (site, key, entry["format"], entry["site"]))
+    return table, errors
+
+
+def main():
+    parser = argparse.ArgumentParser(description="collect the UART_TRACE id to format table")
+    parser.add_argument("-o", "--output", required=True, help="table to write, json")
+    parser.add_argument("paths", nargs="+", help="source files or directories")
+    args = parser.parse_args()
+
+    table, errors = extract(args.paths)
+    for error in errors:
+        print(error, file=sys.stderr)
+    if errors:
+        return 1
+    with open(args.output, "w") as f:
+        json.dump(dict(sorted(table.items())), f, indent=2)
+        f.write("\n")
+    print("%d trace ids" % len(table))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -35,7 +35,10 @@
   * @{
   */
 
-#define I2C_TIMEOUT                      0xFFFFFFFF
+/* timeouts in microseconds, a master transfer of 8 bytes at 100 khz takes
+   about 1 ms, the slave waits for the button of the master board */
+#define I2C_TIMEOUT                      10000
+#define I2C_SLAVE_TIMEOUT                10000000
 
 #define I2Cx_SPEED                       100000
 #define I2Cx_ADDRESS                     0xA0
@@ -211,12 +214,12 @@ int main(void)
     }
 
     /* start the transmission process */
-    if((i2c_status = i2c_smbus_slave_receive(&hi2cx, rx_buf, BUF_SIZE, I2C_TIMEOUT)) != I2C_OK)
+    if((i2c_status = i2c_smbus_slave_receive(&hi2cx, rx_buf, BUF_SIZE, I2C_SLAVE_TIMEOUT)) != I2C_OK)
     {
       error_handler(i2c_status);
     }
 
-    if((i2c_status = i2c_smbus_slave_transmit(&hi2cx, tx_buf, BUF_SIZE, I2C_TIMEOUT)) != I2C_OK)
+    if((i2c_status = i2c_smbus_slave_transmit(&hi2cx, tx_buf, BUF_SIZE, I2C_SLAVE_TIMEOUT)) != I2C_OK)
     {
       error_handler(i2c_status);
     }
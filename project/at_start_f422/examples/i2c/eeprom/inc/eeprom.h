@@ -32,6 +32,10 @@
 #define EEPROM_PAGE_SIZE                 8    /*!< eeprom page size */
 #define EEPROM_I2C_ADDRESS               0xA0 /*!< eeprom i2c address */
 
+#define EEPROM_CACHE_NUM                 4     /*!< pages held by the write back cache */
+#define EEPROM_POLL_PERIOD_US            500   /*!< period of eeprom_cache_poll(), the ack polling period */
+#define EEPROM_WRITE_TIME_US             10000 /*!< longest page write cycle */
+
 typedef enum
 {
   EE_MODE_POLL                           = 0x01, /*!< polling communication */
@@ -39,7 +43,63 @@ typedef enum
   EE_MODE_DMA                            = 0x03, /*!< dma communication */
 } eeprom_mode_type;
 
+typedef enum
+{
+  EE_CACHE_IDLE                          = 0x00, /*!< no write back running */
+  EE_CACHE_WRITE                         = 0x01, /*!< page write transaction */
+  EE_CACHE_POLL_WAIT                     = 0x02, /*!< write cycle, wait for the next poll */
+  EE_CACHE_POLL                          = 0x03, /*!< ack poll transaction */
+} eeprom_cache_state_type;
+
+/**
+  * @brief  cached page, bytes from dirty_start to dirty_end are not written yet.
+  */
+typedef struct
+{
+  uint16_t                               page;                    /*!< page number                     */
+  uint8_t                                valid;                   /*!< data holds the page             */
+  uint8_t                                dirty_start;             /*!< first dirty byte                */
+  uint8_t                                dirty_end;               /*!< end of the dirty bytes, equal to dirty_start when clean */
+  uint32_t                               used;                    /*!< last use, the oldest clean page is replaced */
+  uint8_t                                data[EEPROM_PAGE_SIZE];  /*!< page data                       */
+} eeprom_cache_line_type;
+
+/**
+  * @brief  write back cache of an eeprom on the i2c transaction queue.
+  */
+typedef struct
+{
+  i2c_handle_type                        *hi2c;                   /*!< i2c bus                         */
+  i2c_mem_address_width_type             mem_address_width;       /*!< memory address width            */
+  uint16_t                               address;                 /*!< eeprom i2c address              */
+  eeprom_cache_line_type                 line[EEPROM_CACHE_NUM];  /*!< cached pages                    */
+  i2c_xfer_type                          xfer;                    /*!< write back and ack poll transaction */
+  i2c_xfer_type                          rxfer;                   /*!< read transaction                */
+  uint8_t                                wbuf[2 + EEPROM_PAGE_SIZE]; /*!< memory address and page data written back */
+  uint8_t                                rbuf[2];                 /*!< memory address of the read      */
+  uint8_t                                poll_data;               /*!< byte read by the ack poll       */
+  __IO uint8_t                           state;                   /*!< eeprom_cache_state_type         */
+  uint8_t                                flush_line;              /*!< line being written back         */
+  uint16_t                               flush_page;              /*!< page being written back         */
+  uint32_t                               use_count;               /*!< line use counter                */
+  uint32_t                               write_tick;              /*!< start of the write cycle        */
+  uint32_t                               xfer_tick;               /*!< submit tick of xfer             */
+  uint32_t                               rxfer_tick;              /*!< submit tick of rxfer            */
+  __IO i2c_status_type                   error_code;              /*!< last write back error           */
+  uint32_t                               write_count;             /*!< page write cycles               */
+  uint32_t                               merge_count;             /*!< writes merged into a dirty page */
+  uint32_t                               poll_count;              /*!< ack polls                       */
+  uint32_t                               bus_time;                /*!< microseconds from submit to end of the transactions */
+} eeprom_cache_type;
+
 i2c_status_type eeprom_write_buffer(i2c_handle_type* hi2c, eeprom_mode_type mode, i2c_mem_address_width_type mem_address_width, uint16_t address, uint16_t mem_address, uint8_t* pdata, uint16_t size, uint32_t timeout);
 i2c_status_type eeprom_read_buffer (i2c_handle_type* hi2c, eeprom_mode_type mode, i2c_mem_address_width_type mem_address_width, uint16_t address, uint16_t mem_address, uint8_t* pdata, uint16_t size, uint32_t timeout);
 
+void            eeprom_cache_init       (eeprom_cache_type* hee, i2c_handle_type* hi2c, i2c_mem_address_width_type mem_address_width, uint16_t address);
+i2c_status_type eeprom_cache_write      (eeprom_cache_type* hee, uint16_t mem_address, uint8_t* pdata, uint16_t size, uint32_t timeout);
+i2c_status_type eeprom_cache_read       (eeprom_cache_type* hee, uint16_t mem_address, uint8_t* pdata, uint16_t size, uint32_t timeout);
+void            eeprom_cache_flush_start(eeprom_cache_type* hee);
+i2c_status_type eeprom_cache_flush      (eeprom_cache_type* hee, uint32_t timeout);
+void            eeprom_cache_poll       (eeprom_cache_type* hee);
+
 #endif
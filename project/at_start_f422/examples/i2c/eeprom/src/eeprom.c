@@ -329,3 +329,512 @@ i2c_status_type eeprom_write_buffer(i2c_handle_type* hi2c, eeprom_mode_type mode
   
   return I2C_OK;
 }
+
+/**
+  * @brief  put the memory address in front of a transaction.
+  * @param  hee: the eeprom cache.
+  * @param  pbuf: destination, 2 bytes.
+  * @param  mem_address: memory address.
+  * @retval number of address bytes.
+  */
+static uint16_t eeprom_cache_address_set(eeprom_cache_type* hee, uint8_t* pbuf, uint16_t mem_address)
+{
+  if(hee->mem_address_width == I2C_MEM_ADDR_WIDIH_8)
+  {
+    pbuf[0] = (uint8_t)(mem_address & 0xFF);
+
+    return 1;
+  }
+
+  pbuf[0] = (uint8_t)(mem_address >> 8);
+  pbuf[1] = (uint8_t)(mem_address & 0xFF);
+
+  return 2;
+}
+
+static void eeprom_cache_flush_next(eeprom_cache_type* hee);
+
+/**
+  * @brief  ack poll end, the write cycle is over when the eeprom answered.
+  * @param  hi2c: the handle points to the operation information.
+  * @param  xfer: the ack poll transaction.
+  * @retval none
+  */
+static void eeprom_cache_poll_done(i2c_handle_type* hi2c, i2c_xfer_type* xfer)
+{
+  eeprom_cache_type *hee = (eeprom_cache_type *)xfer->arg;
+
+  hee->bus_time += (i2c_tick_get() - hee->xfer_tick) / I2C_TICKS_PER_US;
+
+  if(xfer->status == I2C_OK)
+  {
+    eeprom_cache_flush_next(hee);
+  }
+  else
+  {
+    /* still busy, poll again at the next period */
+    hee->state = EE_CACHE_POLL_WAIT;
+  }
+}
+
+/**
+  * @brief  page write end, start the ack polling of the write cycle.
+  * @param  hi2c: the handle points to the operation information.
+  * @param  xfer: the page write transaction.
+  * @retval none
+  */
+static void eeprom_cache_write_done(i2c_handle_type* hi2c, i2c_xfer_type* xfer)
+{
+  eeprom_cache_type *hee = (eeprom_cache_type *)xfer->arg;
+  eeprom_cache_line_type *line = &hee->line[hee->flush_line];
+
+  hee->bus_time += (i2c_tick_get() - hee->xfer_tick) / I2C_TICKS_PER_US;
+
+  if(xfer->status == I2C_OK)
+  {
+    hee->write_count++;
+    hee->write_tick = i2c_tick_get();
+    hee->state = EE_CACHE_POLL_WAIT;
+  }
+  else
+  {
+    /* write the whole page again at the next flush */
+    if((line->valid) && (line->page == hee->flush_page))
+    {
+      line->dirty_start = 0;
+      line->dirty_end = EEPROM_PAGE_SIZE;
+    }
+
+    hee->error_code = xfer->status;
+    hee->state = EE_CACHE_IDLE;
+  }
+}
+
+/**
+  * @brief  write back the next dirty page, or go idle when all are clean.
+  *         called in the interrupt or with the interrupts disabled.
+  * @param  hee: the eeprom cache.
+  * @retval none
+  */
+static void eeprom_cache_flush_next(eeprom_cache_type* hee)
+{
+  eeprom_cache_line_type *line;
+  uint16_t length;
+  uint16_t index;
+
+  for(index = 0; index < EEPROM_CACHE_NUM; index++)
+  {
+    line = &hee->line[index];
+
+    if((line->valid) && (line->dirty_start != line->dirty_end))
+    {
+      break;
+    }
+  }
+
+  if(index == EEPROM_CACHE_NUM)
+  {
+    hee->state = EE_CACHE_IDLE;
+    return;
+  }
+
+  /* copy the dirty bytes, the page is clean until it is written again */
+  length = eeprom_cache_address_set(hee, hee->wbuf, line->page * EEPROM_PAGE_SIZE + line->dirty_start);
+  for(index = line->dirty_start; index < line->dirty_end; index++)
+  {
+    hee->wbuf[length++] = line->data[index];
+  }
+  line->dirty_start = 0;
+  line->dirty_end = 0;
+
+  hee->flush_line = line - hee->line;
+  hee->flush_page = line->page;
+
+  hee->xfer.address = hee->address;
+  hee->xfer.wdata = hee->wbuf;
+  hee->xfer.wsize = length;
+  hee->xfer.rdata = 0;
+  hee->xfer.rsize = 0;
+  hee->xfer.callback = eeprom_cache_write_done;
+  hee->xfer.arg = hee;
+
+  hee->state = EE_CACHE_WRITE;
+  hee->xfer_tick = i2c_tick_get();
+  i2c_queue_submit(hee->hi2c, &hee->xfer);
+}
+
+/**
+  * @brief  read from the eeprom through the transaction queue, retried while
+  *         the eeprom does not answer during a write cycle.
+  * @param  hee: the eeprom cache.
+  * @param  mem_address: memory address.
+  * @param  pdata: data buffer.
+  * @param  size: data size.
+  * @param  timeout: maximum waiting time in microseconds.
+  * @retval i2c status.
+  */
+static i2c_status_type eeprom_cache_device_read(eeprom_cache_type* hee, uint16_t mem_address, uint8_t* pdata, uint16_t size, uint32_t timeout)
+{
+  uint32_t start = i2c_tick_get();
+
+  do
+  {
+    hee->rxfer.address = hee->address;
+    hee->rxfer.wdata = hee->rbuf;
+    hee->rxfer.wsize = eeprom_cache_address_set(hee, hee->rbuf, mem_address);
+    hee->rxfer.rdata = pdata;
+    hee->rxfer.rsize = size;
+    hee->rxfer.callback = 0;
+    hee->rxfer.arg = hee;
+
+    hee->rxfer_tick = i2c_tick_get();
+    if(i2c_queue_submit(hee->hi2c, &hee->rxfer) != I2C_OK)
+    {
+      return I2C_ERR_STEP_1;
+    }
+
+    while(hee->rxfer.status == I2C_PENDING)
+    {
+      if(i2c_timeout_check(start, timeout) == TRUE)
+      {
+        /* rxfer is still queued and must leave the queue before it is
+           submitted again, the queue is ended, a write back in it is
+           written again by the next flush */
+        i2c_queue_abort(hee->hi2c, I2C_ERR_TIMEOUT);
+
+        return I2C_ERR_TIMEOUT;
+      }
+    }
+
+    hee->bus_time += (i2c_tick_get() - hee->rxfer_tick) / I2C_TICKS_PER_US;
+
+    if(hee->rxfer.status != I2C_ERR_ACKFAIL)
+    {
+      return hee->rxfer.status;
+    }
+  } while(i2c_timeout_check(start, timeout) == FALSE);
+
+  return I2C_ERR_TIMEOUT;
+}
+
+/**
+  * @brief  find the cached page, or load it in place of the oldest clean page.
+  *         a full page write does not read the page.
+  * @param  hee: the eeprom cache.
+  * @param  page: page number.
+  * @param  load: read the page from the eeprom on a miss.
+  * @param  timeout: maximum waiting time in microseconds.
+  * @param  status: i2c status when no line is returned.
+  * @retval cache line, NULL on error.
+  */
+static eeprom_cache_line_type* eeprom_cache_line_get(eeprom_cache_type* hee, uint16_t page, confirm_state load, uint32_t timeout, i2c_status_type* status)
+{
+  eeprom_cache_line_type *line = 0;
+  uint16_t index;
+
+  for(index = 0; index < EEPROM_CACHE_NUM; index++)
+  {
+    if((hee->line[index].valid) && (hee->line[index].page == page))
+    {
+      line = &hee->line[index];
+      line->used = ++hee->use_count;
+
+      return line;
+    }
+  }
+
+  /* a free page, else the oldest clean one */
+  while(line == 0)
+  {
+    for(index = 0; index < EEPROM_CACHE_NUM; index++)
+    {
+      if(hee->line[index].valid == 0)
+      {
+        line = &hee->line[index];
+        break;
+      }
+
+      if((hee->line[index].dirty_start == hee->line[index].dirty_end) &&
+         ((line == 0) || (hee->line[index].used < line->used)))
+      {
+        line = &hee->line[index];
+      }
+    }
+
+    /* all pages dirty, write them back */
+    if(line == 0)
+    {
+      if((*status = eeprom_cache_flush(hee, timeout)) != I2C_OK)
+      {
+        return 0;
+      }
+    }
+  }
+
+  line->valid = 0;
+  line->dirty_start = 0;
+  line->dirty_end = 0;
+
+  if(load == TRUE)
+  {
+    if((*status = eeprom_cache_device_read(hee, page * EEPROM_PAGE_SIZE, line->data, EEPROM_PAGE_SIZE, timeout)) != I2C_OK)
+    {
+      return 0;
+    }
+  }
+
+  line->page = page;
+  line->valid = 1;
+  line->used = ++hee->use_count;
+
+  return line;
+}
+
+/**
+  * @brief  initialize the write back cache of an eeprom, pages cached before
+  *         are dropped. the i2c queue of hi2c is used, and eeprom_cache_poll()
+  *         is called every EEPROM_POLL_PERIOD_US from a timer interrupt with the
+  *         priority of the i2c interrupts.
+  * @param  hee: the eeprom cache.
+  * @param  hi2c: the handle points to the operation information.
+  * @param  mem_address_width: memory address width.
+  *         this parameter can be one of the following values:
+  *         - I2C_MEM_ADDR_WIDIH_8: memory address is 8 bit
+  *         - I2C_MEM_ADDR_WIDIH_16: memory address is 16 bit
+  * @param  address: eeprom address.
+  * @retval none
+  */
+void eeprom_cache_init(eeprom_cache_type* hee, i2c_handle_type* hi2c, i2c_mem_address_width_type mem_address_width, uint16_t address)
+{
+  uint16_t index;
+
+  hee->hi2c = hi2c;
+  hee->mem_address_width = mem_address_width;
+  hee->address = address;
+
+  for(index = 0; index < EEPROM_CACHE_NUM; index++)
+  {
+    hee->line[index].valid = 0;
+    hee->line[index].dirty_start = 0;
+    hee->line[index].dirty_end = 0;
+  }
+
+  hee->state = EE_CACHE_IDLE;
+  hee->use_count = 0;
+  hee->error_code = I2C_OK;
+  hee->write_count = 0;
+  hee->merge_count = 0;
+  hee->poll_count = 0;
+  hee->bus_time = 0;
+}
+
+/**
+  * @brief  write data to the cache, the eeprom is written by a later flush.
+  *         writes to a page that is not written back yet are merged.
+  * @param  hee: the eeprom cache.
+  * @param  mem_address: memory address.
+  * @param  pdata: data buffer.
+  * @param  size: data size.
+  * @param  timeout: maximum waiting time in microseconds, to load a page or to
+  *         write back pages when no clean page is left.
+  * @retval i2c status.
+  */
+i2c_status_type eeprom_cache_write(eeprom_cache_type* hee, uint16_t mem_address, uint8_t* pdata, uint16_t size, uint32_t timeout)
+{
+  eeprom_cache_line_type *line;
+  i2c_status_type status = I2C_OK;
+  uint32_t primask;
+  uint16_t offset;
+  uint16_t count;
+  uint16_t index;
+
+  while(size > 0)
+  {
+    offset = mem_address % EEPROM_PAGE_SIZE;
+    count = EEPROM_PAGE_SIZE - offset;
+
+    if(count > size)
+    {
+      count = size;
+    }
+
+    line = eeprom_cache_line_get(hee, mem_address / EEPROM_PAGE_SIZE, (count == EEPROM_PAGE_SIZE) ? FALSE : TRUE, timeout, &status);
+    if(line == 0)
+    {
+      return status;
+    }
+
+    for(index = 0; index < count; index++)
+    {
+      line->data[offset + index] = pdata[index];
+    }
+
+    /* the write back may take the dirty bytes at any time */
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    if(line->dirty_start != line->dirty_end)
+    {
+      hee->merge_count++;
+
+      if(offset < line->dirty_start)
+      {
+        line->dirty_start = offset;
+      }
+      if((offset + count) > line->dirty_end)
+      {
+        line->dirty_end = offset + count;
+      }
+    }
+    else
+    {
+      line->dirty_start = offset;
+      line->dirty_end = offset + count;
+    }
+
+    __set_PRIMASK(primask);
+
+    mem_address += count;
+    pdata += count;
+    size -= count;
+  }
+
+  return I2C_OK;
+}
+
+/**
+  * @brief  read data, cached pages come from the cache.
+  * @param  hee: the eeprom cache.
+  * @param  mem_address: memory address.
+  * @param  pdata: data buffer.
+  * @param  size: data size.
+  * @param  timeout: maximum waiting time in microseconds.
+  * @retval i2c status.
+  */
+i2c_status_type eeprom_cache_read(eeprom_cache_type* hee, uint16_t mem_address, uint8_t* pdata, uint16_t size, uint32_t timeout)
+{
+  eeprom_cache_line_type *line;
+  i2c_status_type status;
+  uint16_t offset;
+  uint16_t count;
+  uint16_t index;
+
+  while(size > 0)
+  {
+    offset = mem_address % EEPROM_PAGE_SIZE;
+    count = EEPROM_PAGE_SIZE - offset;
+
+    if(count > size)
+    {
+      count = size;
+    }
+
+    line = 0;
+    for(index = 0; index < EEPROM_CACHE_NUM; index++)
+    {
+      if((hee->line[index].valid) && (hee->line[index].page == (mem_address / EEPROM_PAGE_SIZE)))
+      {
+        line = &hee->line[index];
+        break;
+      }
+    }
+
+    if(line != 0)
+    {
+      for(index = 0; index < count; index++)
+      {
+        pdata[index] = line->data[offset + index];
+      }
+    }
+    else if((status = eeprom_cache_device_read(hee, mem_address, pdata, count, timeout)) != I2C_OK)
+    {
+      return status;
+    }
+
+    mem_address += count;
+    pdata += count;
+    size -= count;
+  }
+
+  return I2C_OK;
+}
+
+/**
+  * @brief  start writing back the dirty pages, the page writes and the ack
+  *         polling run from the interrupts.
+  * @param  hee: the eeprom cache.
+  * @retval none
+  */
+void eeprom_cache_flush_start(eeprom_cache_type* hee)
+{
+  uint32_t primask = __get_PRIMASK();
+
+  __disable_irq();
+
+  if(hee->state == EE_CACHE_IDLE)
+  {
+    hee->error_code = I2C_OK;
+
+    eeprom_cache_flush_next(hee);
+  }
+
+  __set_PRIMASK(primask);
+}
+
+/**
+  * @brief  write back the dirty pages and wait for the end of the write cycles.
+  * @param  hee: the eeprom cache.
+  * @param  timeout: maximum waiting time in microseconds.
+  * @retval i2c status.
+  */
+i2c_status_type eeprom_cache_flush(eeprom_cache_type* hee, uint32_t timeout)
+{
+  uint32_t start = i2c_tick_get();
+
+  eeprom_cache_flush_start(hee);
+
+  while(hee->state != EE_CACHE_IDLE)
+  {
+    if(i2c_timeout_check(start, timeout) == TRUE)
+    {
+      return I2C_ERR_TIMEOUT;
+    }
+  }
+
+  return hee->error_code;
+}
+
+/**
+  * @brief  ack polling of the write cycle, called every EEPROM_POLL_PERIOD_US
+  *         from a timer interrupt with the priority of the i2c interrupts.
+  * @param  hee: the eeprom cache.
+  * @retval none
+  */
+void eeprom_cache_poll(eeprom_cache_type* hee)
+{
+  if(hee->state != EE_CACHE_POLL_WAIT)
+  {
+    return;
+  }
+
+  if(i2c_timeout_check(hee->write_tick, EEPROM_WRITE_TIME_US) == TRUE)
+  {
+    hee->error_code = I2C_ERR_TIMEOUT;
+    hee->state = EE_CACHE_IDLE;
+    return;
+  }
+
+  /* a one byte read is acknowledged once the write cycle is over */
+  hee->xfer.address = hee->address;
+  hee->xfer.wdata = 0;
+  hee->xfer.wsize = 0;
+  hee->xfer.rdata = &hee->poll_data;
+  hee->xfer.rsize = 1;
+  hee->xfer.callback = eeprom_cache_poll_done;
+  hee->xfer.arg = hee;
+
+  hee->poll_count++;
+  hee->state = EE_CACHE_POLL;
+  hee->xfer_tick = i2c_tick_get();
+  i2c_queue_submit(hee->hi2c, &hee->xfer);
+}
@@ -35,7 +35,7 @@
   * @{
   */
 
-#define I2C_TIMEOUT                      0xFFFFFFFF
+#define I2C_TIMEOUT                      10000
 
 #define I2Cx_SPEED                       100000
 #define I2Cx_ADDRESS                     0xA0
@@ -65,6 +65,10 @@
 #define I2Cx_EVT_IRQn                    I2C2_EVT_IRQn
 #define I2Cx_ERR_IRQn                    I2C2_ERR_IRQn
 
+#define EE_POLL_TMR                      TMR6
+#define EE_POLL_TMR_CLK                  CRM_TMR6_PERIPH_CLOCK
+#define EE_POLL_TMR_IRQn                 TMR6_GLOBAL_IRQn
+
 #define BUF_SIZE                         12
 
 uint8_t tx_buf1[BUF_SIZE] = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C};
@@ -74,11 +78,17 @@ uint8_t rx_buf1[BUF_SIZE] = {0};
 uint8_t rx_buf2[BUF_SIZE] = {0};
 uint8_t rx_buf3[BUF_SIZE] = {0};
 
+/* merged result of the cached writes of tx_buf1, tx_buf2[4..7] and tx_buf3[8..11] */
+uint8_t tx_buf4[BUF_SIZE] = {0x01, 0x02, 0x03, 0x04, 0x50, 0x60, 0x70, 0x80, 0x99, 0xAA, 0xBB, 0xCC};
+uint8_t rx_buf4[BUF_SIZE] = {0};
+
 i2c_handle_type hi2cx;
+eeprom_cache_type hee;
 
 void error_handler(uint32_t error_code);
 uint32_t buffer_compare(uint8_t* buffer1, uint8_t* buffer2, uint32_t len);
 void i2c_lowlevel_init(i2c_handle_type* hi2c);
+void ee_poll_timer_init(void);
 
 /**
   * @brief  error handler program
@@ -148,6 +158,12 @@ void i2c_lowlevel_init(i2c_handle_type* hi2c)
     gpio_init(I2Cx_SDA_GPIO_PORT, &gpio_initstructure);
     gpio_pin_mux_config(I2Cx_SDA_GPIO_PORT, I2Cx_SDA_PIN_SOURCE, I2Cx_SDA_PIN_MUX_NUM);
 
+    /* i2c pins for the bus recovery */
+    hi2c->scl_gpio = I2Cx_SCL_GPIO_PORT;
+    hi2c->scl_pin  = I2Cx_SCL_PIN;
+    hi2c->sda_gpio = I2Cx_SDA_GPIO_PORT;
+    hi2c->sda_pin  = I2Cx_SDA_PIN;
+
     /* configure and enable i2c dma channel interrupt */
     nvic_irq_enable(I2Cx_DMA_TX_IRQn, 0, 0);
     nvic_irq_enable(I2Cx_DMA_RX_IRQn, 0, 0);
@@ -185,6 +201,27 @@ void i2c_lowlevel_init(i2c_handle_type* hi2c)
   }
 }
 
+/**
+  * @brief  timer of the eeprom cache ack polling, one overflow every
+  *         EEPROM_POLL_PERIOD_US.
+  * @param  none
+  * @retval none
+  */
+void ee_poll_timer_init(void)
+{
+  crm_periph_clock_enable(EE_POLL_TMR_CLK, TRUE);
+
+  /* the timer clock is the system clock, count microseconds */
+  tmr_base_init(EE_POLL_TMR, EEPROM_POLL_PERIOD_US - 1, system_core_clock / 1000000 - 1);
+  tmr_cnt_dir_set(EE_POLL_TMR, TMR_COUNT_UP);
+  tmr_interrupt_enable(EE_POLL_TMR, TMR_OVF_INT, TRUE);
+
+  /* same priority as the i2c interrupts */
+  nvic_irq_enable(EE_POLL_TMR_IRQn, 0, 0);
+
+  tmr_counter_enable(EE_POLL_TMR, TRUE);
+}
+
 /**
   * @brief  main function.
   * @param  none
@@ -205,6 +242,8 @@ int main(void)
 
   i2c_config(&hi2cx);
 
+  ee_poll_timer_init();
+
   while(1)
   {
     /* wait for key USER_BUTTON press before starting the communication */
@@ -261,9 +300,44 @@ int main(void)
     }
 
     
+    delay_ms(5);
+
+
+    /* cached writes, merged in ram and written back by interrupts, the write
+       and poll counters of hee show the saved write cycles */
+    eeprom_cache_init(&hee, &hi2cx, I2C_MEM_ADDR_WIDIH_8, I2Cx_ADDRESS);
+
+    if((i2c_status = eeprom_cache_write(&hee, 0x00, tx_buf1, BUF_SIZE, I2C_TIMEOUT)) != I2C_OK)
+    {
+      error_handler(i2c_status);
+    }
+
+    if((i2c_status = eeprom_cache_write(&hee, 0x04, &tx_buf2[4], 4, I2C_TIMEOUT)) != I2C_OK)
+    {
+      error_handler(i2c_status);
+    }
+
+    if((i2c_status = eeprom_cache_write(&hee, 0x08, &tx_buf3[8], 4, I2C_TIMEOUT)) != I2C_OK)
+    {
+      error_handler(i2c_status);
+    }
+
+    /* write back the dirty pages */
+    if((i2c_status = eeprom_cache_flush(&hee, I2C_TIMEOUT * EEPROM_CACHE_NUM)) != I2C_OK)
+    {
+      error_handler(i2c_status);
+    }
+
+    /* read data from eeprom device */
+    if((i2c_status = eeprom_read_buffer(&hi2cx, EE_MODE_POLL, I2C_MEM_ADDR_WIDIH_8, I2Cx_ADDRESS, 0x00, rx_buf4, BUF_SIZE, I2C_TIMEOUT)) != I2C_OK)
+    {
+      error_handler(i2c_status);
+    }
+
     if((buffer_compare(tx_buf1, rx_buf1, BUF_SIZE) == 0) &&
        (buffer_compare(tx_buf2, rx_buf2, BUF_SIZE) == 0) &&
-       (buffer_compare(tx_buf3, rx_buf3, BUF_SIZE) == 0))
+       (buffer_compare(tx_buf3, rx_buf3, BUF_SIZE) == 0) &&
+       (buffer_compare(tx_buf4, rx_buf4, BUF_SIZE) == 0))
     {
       at32_led_on(LED3);
     }
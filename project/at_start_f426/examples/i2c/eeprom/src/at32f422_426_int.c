@@ -26,8 +26,10 @@
 /* includes ------------------------------------------------------------------*/
 #include "at32f422_426_int.h"
 #include "i2c_application.h"
+#include "eeprom.h"
 
 extern i2c_handle_type hi2cx;
+extern eeprom_cache_type hee;
 
 #define I2Cx_DMA_RX_TX_IRQHandler        DMA1_Channel7_4_IRQHandler
 #define I2Cx_EVT_IRQHandler              I2C2_EVT_IRQHandler
@@ -168,6 +170,21 @@ void I2Cx_ERR_IRQHandler(void)
   i2c_err_irq_handler(&hi2cx);
 }
 
+/**
+  * @brief  this function handles timer6 interrupt request.
+  * @param  none
+  * @retval none
+  */
+void TMR6_GLOBAL_IRQHandler(void)
+{
+  if(tmr_interrupt_flag_get(TMR6, TMR_OVF_FLAG) != RESET)
+  {
+    tmr_flag_clear(TMR6, TMR_OVF_FLAG);
+
+    eeprom_cache_poll(&hee);
+  }
+}
+
 /**
   * @}
   */
@@ -35,7 +35,8 @@
   * @{
   */
 
-#define I2C_TIMEOUT                      0xFFFFFFFF
+/* timeout of a transfer in microseconds, 8 bytes at 100 khz take about 1 ms */
+#define I2C_TIMEOUT                      10000
 
 #define I2Cx_SPEED                       100000
 #define I2Cx_ADDRESS                     0xA0
@@ -100,6 +100,11 @@
 #define configUSE_16_BIT_TICKS    0
 #define configIDLE_SHOULD_YIELD    1
 
+/* Tickless idle, vPortSuppressTicksAndSleep() in tickless_idle.c puts the mcu
+in deep sleep and wakes it up with the ertc alarm. */
+#define configUSE_TICKLESS_IDLE    2
+#define configEXPECTED_IDLE_TIME_BEFORE_SLEEP 5
+
 
 /* Co-routine definitions. */
 #define configUSE_CO_ROUTINES     0
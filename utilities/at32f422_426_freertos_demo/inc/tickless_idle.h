@@ -0,0 +1,76 @@
+/**
+  **************************************************************************
+  * @file     tickless_idle.h
+  * @brief    header file of the tickless idle
+  **************************************************************************
+  *
+  * Copyright (c) 2025, Artery Technology, All rights reserved.
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+/* define to prevent recursive inclusion -------------------------------------*/
+#ifndef __TICKLESS_IDLE_H
+#define __TICKLESS_IDLE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* includes ------------------------------------------------------------------*/
+#include "at32f422_426.h"
+
+/* exported types ------------------------------------------------------------*/
+
+typedef struct
+{
+  uint32_t                               sleep_count;             /*!< deep sleep entries              */
+  uint32_t                               abort_count;             /*!< idle periods spent awake        */
+  uint32_t                               slept_ticks;             /*!< ticks stepped after a wakeup    */
+  uint32_t                               late_count;              /*!< wakeups past the unblock time, the restart is longer than TICKLESS_WAKEUP_COUNTS */
+} tickless_stats_type;
+
+/* exported constants --------------------------------------------------------*/
+
+/* ck_a = lext / (div_a + 1) is the sub-second resolution, ck_spre = ck_a / (div_b + 1) = 1 hz */
+#define TICKLESS_ERTC_DIV_A              0
+#define TICKLESS_ERTC_DIV_B              32767
+#define TICKLESS_ERTC_FREQ               (LEXT_VALUE / (TICKLESS_ERTC_DIV_A + 1))
+
+/* the alarm compares sbs [14:0], one period of the sub-second counter */
+#define TICKLESS_ERTC_MASK               0x7FFF
+
+/* the alarm is set that many ck_a periods early to cover the hext and pll restart */
+#define TICKLESS_WAKEUP_COUNTS           64
+
+/* shortest and longest deep sleep in ck_a periods */
+#define TICKLESS_MIN_COUNTS              32
+#define TICKLESS_MAX_COUNTS              (TICKLESS_ERTC_FREQ - 512)
+
+/* exported macro ------------------------------------------------------------*/
+/* exported functions ------------------------------------------------------- */
+
+extern tickless_stats_type tickless_stats;
+
+void tickless_idle_init(void);
+void tickless_idle_alarm_irq_handler(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -25,6 +25,7 @@
 
 /* includes ------------------------------------------------------------------*/
 #include "at32f422_426_int.h"
+#include "tickless_idle.h"
 
 /** @addtogroup UTILITIES_examples
   * @{
@@ -131,6 +132,16 @@ void DebugMon_Handler(void)
 //{
 //}
 
+/**
+  * @brief  this function handles the ertc alarm that ends the tickless deep sleep.
+  * @param  none
+  * @retval none
+  */
+void ERTC_IRQHandler(void)
+{
+  tickless_idle_alarm_irq_handler();
+}
+
 /**
   * @}
   */
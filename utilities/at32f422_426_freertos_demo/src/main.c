@@ -25,6 +25,7 @@
 
 #include "at32f422_426_board.h"
 #include "at32f422_426_clock.h"
+#include "tickless_idle.h"
 #include "FreeRTOS.h"
 #include "task.h"
 
@@ -61,6 +62,9 @@ int main(void)
   /* init usart1 */
   uart_print_init(115200);
 
+  /* ertc alarm for the deep sleep of the idle task */
+  tickless_idle_init();
+
   /* enter critical */
   taskENTER_CRITICAL();
 
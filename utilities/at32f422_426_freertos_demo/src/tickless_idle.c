@@ -0,0 +1,317 @@
+/**
+  **************************************************************************
+  * @file     tickless_idle.c
+  * @brief    tickless idle program
+  **************************************************************************
+  *
+  * Copyright (c) 2025, Artery Technology, All rights reserved.
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+/* includes ------------------------------------------------------------------*/
+#include "tickless_idle.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+/** @addtogroup UTILITIES_examples
+  * @{
+  */
+
+/** @addtogroup FreeRTOS_demo
+  * @{
+  */
+
+/* systick cycles of one tick */
+#define TICKLESS_SYSTICK_PERIOD          (configCPU_CLOCK_HZ / configTICK_RATE_HZ)
+
+/* longest idle time handled in one sleep, in ticks */
+#define TICKLESS_MAX_TICKS               ((TICKLESS_MAX_COUNTS * configTICK_RATE_HZ) / TICKLESS_ERTC_FREQ)
+
+tickless_stats_type tickless_stats;
+
+/**
+  * @brief  configure the ertc as the deep sleep time base: lext clock, the
+  *         sub-second divider, the alarm a interrupt through exint line 17.
+  * @note   the ertc domain is reset, the calendar is not used by the demo.
+  *         call before vTaskStartScheduler().
+  * @param  none
+  * @retval none
+  */
+void tickless_idle_init(void)
+{
+  exint_init_type exint_init_struct;
+
+  /* enable the pwc clock interface */
+  crm_periph_clock_enable(CRM_PWC_PERIPH_CLOCK, TRUE);
+
+  /* allow access to bpr domain */
+  pwc_battery_powered_domain_access(TRUE);
+
+  /* reset ertc domain */
+  crm_battery_powered_domain_reset(TRUE);
+  crm_battery_powered_domain_reset(FALSE);
+
+  /* enable the lext osc */
+  crm_clock_source_enable(CRM_CLOCK_SOURCE_LEXT, TRUE);
+
+  /* wait till lext is ready */
+  while(crm_flag_get(CRM_LEXT_STABLE_FLAG) == RESET)
+  {
+  }
+
+  /* select the ertc clock source */
+  crm_ertc_clock_select(CRM_ERTC_CLOCK_LEXT);
+
+  /* enable the ertc clock */
+  crm_ertc_clock_enable(TRUE);
+
+  ertc_reset();
+  ertc_wait_update();
+  ertc_divider_set(TICKLESS_ERTC_DIV_A, TICKLESS_ERTC_DIV_B);
+
+  /* sbs is read right after the wakeup, before the shadow registers are updated */
+  ertc_direct_read_enable(TRUE);
+
+  /* the alarm only matches the sub-second */
+  ertc_alarm_enable(ERTC_ALA, FALSE);
+  ertc_alarm_mask_set(ERTC_ALA, ERTC_ALARM_MASK_ALL);
+
+  /* config the exint line of the ertc alarm */
+  exint_init_struct.line_select   = EXINT_LINE_17;
+  exint_init_struct.line_enable   = TRUE;
+  exint_init_struct.line_mode     = EXINT_LINE_INTERRUPT;
+  exint_init_struct.line_polarity = EXINT_TRIGGER_RISING_EDGE;
+  exint_init(&exint_init_struct);
+
+  nvic_irq_enable(ERTC_IRQn, configLIBRARY_LOWEST_INTERRUPT_PRIORITY, 0);
+  ertc_interrupt_enable(ERTC_ALA_INT, TRUE);
+
+  /* config the voltage regulator mode, only used in deep sleep */
+  pwc_voltage_regulate_set(PWC_REGULATOR_LOW_POWER);
+}
+
+/**
+  * @brief  ertc alarm interrupt, only wakes up the cpu.
+  * @param  none
+  * @retval none
+  */
+void tickless_idle_alarm_irq_handler(void)
+{
+  if(ertc_interrupt_flag_get(ERTC_ALAF_FLAG) != RESET)
+  {
+    ertc_flag_clear(ERTC_ALAF_FLAG);
+    exint_flag_clear(EXINT_LINE_17);
+  }
+}
+
+/**
+  * @brief  wait for the sub-second counter to change. a reading taken at an
+  *         edge has no fraction of ck_a period, where one taken at a fixed
+  *         time after the wakeup would bias every sleep by the same amount.
+  * @param  none
+  * @retval sbs, counting down from TICKLESS_ERTC_DIV_B.
+  */
+static uint32_t tickless_ertc_edge(void)
+{
+  uint32_t sbs = ERTC->sbs;
+
+  while(ERTC->sbs == sbs)
+  {
+  }
+
+  return ERTC->sbs;
+}
+
+/**
+  * @brief  the system clock is the hick after deep sleep, switch back to the
+  *         pll configured by system_clock_config().
+  * @param  none
+  * @retval none
+  */
+static void tickless_clock_recover(void)
+{
+  /* enable external high-speed crystal oscillator - hext */
+  crm_clock_source_enable(CRM_CLOCK_SOURCE_HEXT, TRUE);
+
+  /* wait till hext is ready */
+  while(crm_hext_stable_wait() == ERROR)
+  {
+  }
+
+  /* enable pll */
+  crm_clock_source_enable(CRM_CLOCK_SOURCE_PLL, TRUE);
+
+  /* wait till pll is ready */
+  while(crm_flag_get(CRM_PLL_STABLE_FLAG) != SET)
+  {
+  }
+
+  /* enable auto step mode */
+  crm_auto_step_mode_enable(TRUE);
+
+  /* select pll as system clock source */
+  crm_sysclk_switch(CRM_SCLK_PLL);
+
+  /* wait till pll is used as system clock source */
+  while(crm_sysclk_switch_status_get() != CRM_SCLK_PLL)
+  {
+  }
+
+  /* disable auto step mode */
+  crm_auto_step_mode_enable(FALSE);
+}
+
+/**
+  * @brief  restart the systick so that it expires after cycles, then runs
+  *         with the normal tick period.
+  * @param  cycles: systick cycles to the next tick interrupt, at least 2.
+  * @retval none
+  */
+static void tickless_systick_restart(uint32_t cycles)
+{
+  SysTick->LOAD = cycles - 1;
+  SysTick->VAL = 0;
+  SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+  SysTick->LOAD = TICKLESS_SYSTICK_PERIOD - 1;
+}
+
+/**
+  * @brief  ertc counts of a sleep of xExpectedIdleTime ticks, up to the tick
+  *         before the unblock one, from the systick value it was stopped at.
+  * @param  xExpectedIdleTime: ticks to the next task unblock time, 2 at least.
+  * @param  cycles: systick value, cycles left in the current tick.
+  * @param  partial: the elapsed part of the current tick in time units.
+  * @retval ertc counts.
+  */
+static uint32_t tickless_sleep_counts(TickType_t xExpectedIdleTime, uint32_t cycles, uint32_t *partial)
+{
+  uint32_t period = TICKLESS_SYSTICK_PERIOD;
+
+  /* rounded, a truncation would drop half a unit on every sleep */
+  *partial = ((period - 1 - cycles) * (uint64_t)TICKLESS_ERTC_FREQ + period / 2) / period;
+
+  return ((xExpectedIdleTime - 1) * TICKLESS_ERTC_FREQ - *partial) / configTICK_RATE_HZ;
+}
+
+/**
+  * @brief  ticks slept and the systick cycles to the next tick after a sleep
+  *         of counts ertc periods, the part of a tick left over is carried by
+  *         the systick.
+  * @param  xExpectedIdleTime: ticks to the next task unblock time.
+  * @param  partial: the elapsed part of the tick before the sleep in time units.
+  * @param  counts: ertc counts slept.
+  * @param  ticks: ticks to step.
+  * @retval systick cycles to the next tick, 2 at least.
+  */
+static uint32_t tickless_wakeup_cycles(TickType_t xExpectedIdleTime, uint32_t partial, uint32_t counts, uint32_t *ticks)
+{
+  uint32_t units, cycles;
+
+  units = partial + counts * configTICK_RATE_HZ;
+  *ticks = units / TICKLESS_ERTC_FREQ;
+  units %= TICKLESS_ERTC_FREQ;
+
+  if(*ticks >= xExpectedIdleTime)
+  {
+    /* the unblock tick is due, deliver it at once, the time past it is lost */
+    tickless_stats.late_count++;
+    *ticks = xExpectedIdleTime - 1;
+    units = TICKLESS_ERTC_FREQ - 1;
+  }
+
+  cycles = ((TICKLESS_ERTC_FREQ - units) * (uint64_t)TICKLESS_SYSTICK_PERIOD) / TICKLESS_ERTC_FREQ;
+
+  return (cycles > 1) ? cycles : 2;
+}
+
+/**
+  * @brief  freertos tickless idle, replaces the systick by the ertc alarm and
+  *         enters deep sleep, then steps the tick count by the time measured
+  *         on the ertc sub-second counter.
+  * @note   time is kept in units of 1 / (TICKLESS_ERTC_FREQ * configTICK_RATE_HZ)
+  *         seconds, a tick is TICKLESS_ERTC_FREQ units and a ck_a period is
+  *         configTICK_RATE_HZ units. the part of the tick elapsed before the
+  *         sleep and the part left after it are carried by the systick, so
+  *         no time is dropped between sleeps. both ertc readings wait for an
+  *         edge, up to one ck_a period each.
+  * @param  xExpectedIdleTime: ticks to the next task unblock time.
+  * @retval none
+  */
+void vPortSuppressTicksAndSleep(TickType_t xExpectedIdleTime)
+{
+  uint32_t partial, counts, start, ticks, cycles;
+
+  if(xExpectedIdleTime > TICKLESS_MAX_TICKS)
+  {
+    xExpectedIdleTime = TICKLESS_MAX_TICKS;
+  }
+
+  __disable_irq();
+  __DSB();
+  __ISB();
+
+  /* stop the systick on an ertc edge, keep the part of the tick already elapsed */
+  start = tickless_ertc_edge();
+  SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+  cycles = SysTick->VAL;
+
+  /* wake up a tick early, the systick delivers the last one */
+  counts = tickless_sleep_counts(xExpectedIdleTime, cycles, &partial);
+
+  if(((SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) != 0) ||
+     (counts < TICKLESS_MIN_COUNTS + TICKLESS_WAKEUP_COUNTS) ||
+     (eTaskConfirmSleepModeStatus() == eAbortSleep))
+  {
+    /* resume the current tick where it was stopped */
+    tickless_systick_restart((cycles > 1) ? cycles : TICKLESS_SYSTICK_PERIOD);
+    tickless_stats.abort_count++;
+    __enable_irq();
+    return;
+  }
+  counts -= TICKLESS_WAKEUP_COUNTS;
+
+  ertc_alarm_enable(ERTC_ALA, FALSE);
+  ertc_alarm_sub_second_set(ERTC_ALA, (start - counts) & TICKLESS_ERTC_MASK, ERTC_ALARM_SBS_MASK_NONE);
+  ertc_flag_clear(ERTC_ALAF_FLAG);
+  exint_flag_clear(EXINT_LINE_17);
+  ertc_alarm_enable(ERTC_ALA, TRUE);
+
+  /* the alarm or any other interrupt ends the sleep, the handlers run
+     after the tick count is corrected */
+  pwc_deep_sleep_mode_enter(PWC_DEEP_SLEEP_ENTER_WFI);
+
+  tickless_clock_recover();
+  counts = (start - tickless_ertc_edge()) & TICKLESS_ERTC_MASK;
+  ertc_alarm_enable(ERTC_ALA, FALSE);
+
+  tickless_systick_restart(tickless_wakeup_cycles(xExpectedIdleTime, partial, counts, &ticks));
+
+  vTaskStepTick(ticks);
+  tickless_stats.sleep_count++;
+  tickless_stats.slept_ticks += ticks;
+
+  __enable_irq();
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
@@ -47,6 +47,48 @@ extern "C" {
 #define FLASH_SIZE    (*((uint32_t*)0x1FFFF7E0))  /* read from at32 flash capacity register(unit:kbyte) */
 #define SRAM_SIZE     16                         /* sram size, unit:kbyte */
 
+/* the flash from the app starting address is split in IMAGE_SLOT_NUM slots of
+   2kb multiples, 0xe000 bytes each on a 128kb device. an app is linked for the
+   slot it is programmed in */
+#define IMAGE_SLOT_NUM           2
+
+/* the image header is at the start of the last sector of a slot, the image
+   takes the sectors before it. the crc is the flash crc calibration of the
+   sectors holding length bytes, the rest of the last one erased (0xff): the
+   crc-32/mpeg-2 over the flash words msb first. host_tool/image_header.c
+   builds such a slot image */
+#define IMAGE_HEADER_MAGIC       0x474D4941
+
+/**
+  * @}
+  */
+
+/** @defgroup bootloader_exported_types
+  * @{
+  */
+
+/**
+  * @brief  image header type, check is the complement of the xor of the other words
+  */
+typedef struct
+{
+  uint32_t magic;
+  uint32_t length;
+  uint32_t version;
+  uint32_t crc;
+  uint32_t check;
+} image_header_type;
+
+/**
+  * @brief  image status type
+  */
+typedef enum
+{
+  IMAGE_NONE,
+  IMAGE_VALID,
+  IMAGE_BAD,
+} image_status_type;
+
 /**
   * @}
   */
@@ -57,6 +99,11 @@ extern "C" {
 
 void flash_2kb_write(uint32_t write_addr, uint8_t *pbuffer);
 flag_status flash_upgrade_flag_read(void);
+uint32_t flash_sector_size_get(void);
+uint32_t image_slot_size_get(void);
+uint32_t image_crc_calculate(uint32_t start_addr, uint32_t length);
+image_status_type image_verify(uint32_t slot_addr, uint32_t *version);
+uint32_t image_boot_select(void);
 
 /**
   * @}
@@ -54,6 +54,27 @@ extern "C" {
 indicates that an app upgrade will follow, see iap application note for more details */
 #define IAP_UPGRADE_FLAG         0x41544B38
 
+/* streaming upgrade, entered with cmd 0x5a03 instead of 0x5a01. every frame is
+   head(1) + sequence(1) + address(4, msb first) + data(2048) + crc32(4, msb first),
+   the crc32 is the zlib one over head, sequence, address and data. the pc-tool
+   keeps up to IAP_STREAM_WINDOW frames unacknowledged, the bootloader answers
+   ack + sequence when a block is programmed, nak + expected sequence to restart
+   from there, or abort + expected sequence to leave the streaming upgrade */
+#define IAP_BLOCK_SIZE           0x800
+#define IAP_FRAME_HEAD_SIZE      6
+#define IAP_FRAME_SIZE           (IAP_FRAME_HEAD_SIZE + IAP_BLOCK_SIZE + 4)
+#define IAP_FRAME_DATA           0x32     /* program the block at address */
+#define IAP_FRAME_END            0x33     /* all blocks sent, run the app */
+#define IAP_STREAM_WINDOW        2        /* one frame per half of the receive buffer */
+#define IAP_STREAM_ACK           0xCC
+#define IAP_STREAM_NAK           0xEE
+#define IAP_STREAM_ABORT         0xFF
+
+/* timeouts of the streaming upgrade in tmr3 ticks of 0.1ms */
+#define IAP_STREAM_GAP_TICKS     500      /* a frame stalled halfway, resynchronize */
+#define IAP_STREAM_SILENT_TICKS  200      /* line silence before the nak of a resynchronization */
+#define IAP_STREAM_IDLE_TICKS    30000    /* no data at all, abort */
+
 /**
   * @}
   */
@@ -96,6 +117,7 @@ typedef enum
   CMD_CTR_DONE,
   CMD_CTR_ERR,
   CMD_CTR_APP,
+  CMD_CTR_STREAM,
 } cmd_ctr_step_type;
 
 /**
@@ -107,6 +129,7 @@ typedef enum
   UPDATE_CLEAR_FLAG,
   UPDATE_ING,
   UPDATE_DONE,
+  UPDATE_STREAM,
 } update_status_type;
 
 typedef void (*iapfun)(void);
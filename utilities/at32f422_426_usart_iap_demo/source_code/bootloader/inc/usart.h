@@ -76,6 +76,8 @@ extern usart_group_type usart_group_struct;
   */
 
 void uart_init(uint32_t baudrate);
+void uart_dma_receive_start(uint8_t *pbuffer, uint16_t len);
+void uart_dma_receive_stop(void);
 
 /**
   * @}
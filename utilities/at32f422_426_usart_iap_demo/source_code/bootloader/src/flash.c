@@ -70,6 +70,117 @@ flag_status flash_upgrade_flag_read(void)
     return RESET;
 }
 
+/**
+  * @brief  flash sector size.
+  * @param  none
+  * @retval sector size in bytes
+  */
+uint32_t flash_sector_size_get(void)
+{
+  if(FLASH_SIZE < 0x100)  /* less than 256kb, 1kb/sector */
+    return 0x400;
+  else
+    return 0x800;
+}
+
+/**
+  * @brief  size of an app slot.
+  * @param  none
+  * @retval slot size in bytes
+  */
+uint32_t image_slot_size_get(void)
+{
+  return ((FLASH_BASE + 1024 * FLASH_SIZE - APP_START_ADDR) / IMAGE_SLOT_NUM) & ~(uint32_t)0x7FF;
+}
+
+/**
+  * @brief  crc of the sectors holding an image, by the flash crc calibration:
+  *         crc-32/mpeg-2, poly 0x04C11DB7, init 0xFFFFFFFF, no reflection
+  *         and no final xor, over the flash words msb first.
+  * @param  start_addr: image starting address, sector aligned
+  * @param  length: image length in bytes
+  * @retval crc
+  */
+uint32_t image_crc_calculate(uint32_t start_addr, uint32_t length)
+{
+  uint32_t sector_size = flash_sector_size_get();
+  uint32_t sector_cnt = (length + sector_size - 1) / sector_size;
+  return flash_crc_calibrate(start_addr, sector_cnt);
+}
+
+/**
+  * @brief  check the header, the vectors and the crc of the image of a slot.
+  * @param  slot_addr: slot starting address
+  * @param  version: image version, set when the image is valid
+  * @retval IMAGE_NONE when the slot has no header, IMAGE_VALID or IMAGE_BAD
+  */
+image_status_type image_verify(uint32_t slot_addr, uint32_t *version)
+{
+  uint32_t sector_size = flash_sector_size_get();
+  uint32_t slot_size = image_slot_size_get();
+  image_header_type *header = (image_header_type *)(slot_addr + slot_size - sector_size);
+
+  if(header->magic == 0xFFFFFFFF)
+    return IMAGE_NONE;
+
+  if((header->magic != IMAGE_HEADER_MAGIC) || \
+     (header->check != ~(header->magic ^ header->length ^ header->version ^ header->crc)))
+    return IMAGE_BAD;
+
+  if((header->length < 8) || (header->length > slot_size - sector_size))
+    return IMAGE_BAD;
+
+  /* stack pointer in sram, reset handler in the image */
+  if((((*(uint32_t*)slot_addr) - 0x20000000) > (SRAM_SIZE * 1024)) || \
+     ((*(uint32_t*)(slot_addr + 4)) < slot_addr) || ((*(uint32_t*)(slot_addr + 4)) >= slot_addr + header->length))
+    return IMAGE_BAD;
+
+  if(image_crc_calculate(slot_addr, header->length) != header->crc)
+    return IMAGE_BAD;
+
+  *version = header->version;
+  return IMAGE_VALID;
+}
+
+/**
+  * @brief  select the image to run: the valid one of highest version, else
+  *         an app without header in the first slot, as before the image headers.
+  *         an image that fails its check is never run.
+  * @param  none
+  * @retval image starting address, 0 when there is nothing to run
+  */
+uint32_t image_boot_select(void)
+{
+  uint32_t slot_addr, version = 0, best_version = 0;
+  uint32_t best_addr = 0, legacy_addr = 0;
+  uint8_t slot;
+  image_status_type status;
+
+  for(slot = 0; slot < IMAGE_SLOT_NUM; slot++)
+  {
+    slot_addr = APP_START_ADDR + slot * image_slot_size_get();
+    status = image_verify(slot_addr, &version);
+    if(status == IMAGE_VALID)
+    {
+      if((best_addr == 0) || (version > best_version))
+      {
+        best_addr = slot_addr;
+        best_version = version;
+      }
+    }
+    else if((status == IMAGE_NONE) && (slot == 0))
+    {
+      /* check app starting address whether 0x08xxxxxx */
+      if(((*(uint32_t*)(slot_addr + 4)) & 0xFF000000) == 0x08000000)
+        legacy_addr = slot_addr;
+    }
+  }
+
+  if(best_addr != 0)
+    return best_addr;
+  return legacy_addr;
+}
+
 /**
   * @}
   */
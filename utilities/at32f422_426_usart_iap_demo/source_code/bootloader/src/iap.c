@@ -44,6 +44,22 @@ static uint8_t cmd_addr_cnt = 0;
 static uint32_t cmd_data_cnt = 0;
 iapfun jump_to_app;
 
+/* tmr3 counts 0 ~ 10000 at 10khz */
+#define STREAM_TMR_TICKS         10001
+
+static uint8_t stream_buf[IAP_STREAM_WINDOW * IAP_FRAME_SIZE];
+static uint8_t stream_slot = 0;
+static uint8_t stream_expect = 0;
+static uint16_t stream_last_cnt = 0;
+static uint16_t stream_last_tick = 0;
+static uint32_t stream_idle_ticks = 0;
+
+static const uint32_t crc32_nibble_table[16] =
+{
+  0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+  0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+};
+
 /* app_load don't optimize */
 #if defined (__ARMCC_VERSION)
  #if (__ARMCC_VERSION >= 6010050)
@@ -71,6 +87,7 @@ void app_load(uint32_t app_addr)
     /* disable periph clock */
     crm_periph_clock_enable(CRM_TMR3_PERIPH_CLOCK, FALSE);
     crm_periph_clock_enable(CRM_USART1_PERIPH_CLOCK, FALSE);
+    crm_periph_clock_enable(CRM_DMA1_PERIPH_CLOCK, FALSE);
     crm_periph_clock_enable(CRM_GPIOA_PERIPH_CLOCK, FALSE);
 
     /* disable nvic irq and clear pending */
@@ -136,6 +153,10 @@ void command_handle(void)
       {
         cmd_ctr_step = CMD_CTR_APP;
       }
+      else if(val == 0x03)
+      {
+        cmd_ctr_step = CMD_CTR_STREAM;
+      }
       else
       {
         cmd_ctr_step = CMD_CTR_ERR;
@@ -260,6 +281,246 @@ void back_err(void)
   get_data_from_usart_flag = 0;
 }
 
+/**
+  * @brief  crc32 update, reflected polynomial 0xEDB88320.
+  * @param  crc: crc so far, 0xFFFFFFFF to start, complement the result to finish
+  * @param  pbuffer: data
+  * @param  len: data length in bytes
+  * @retval updated crc
+  */
+static uint32_t crc32_update(uint32_t crc, const uint8_t *pbuffer, uint32_t len)
+{
+  while(len--)
+  {
+    crc ^= *pbuffer++;
+    crc = (crc >> 4) ^ crc32_nibble_table[crc & 0x0F];
+    crc = (crc >> 4) ^ crc32_nibble_table[crc & 0x0F];
+  }
+  return crc;
+}
+
+/**
+  * @brief  read a msb first word.
+  * @param  pbuffer: first byte
+  * @retval word
+  */
+static uint32_t stream_word_get(const uint8_t *pbuffer)
+{
+  return ((uint32_t)pbuffer[0] << 24) + ((uint32_t)pbuffer[1] << 16) + \
+         ((uint32_t)pbuffer[2] << 8) + pbuffer[3];
+}
+
+/**
+  * @brief  streaming upgrade response.
+  * @param  code: IAP_STREAM_ACK, IAP_STREAM_NAK or IAP_STREAM_ABORT
+  * @param  seq: sequence number
+  * @retval none
+  */
+static void stream_reply(uint8_t code, uint8_t seq)
+{
+  usart_data_transmit(USART1, code);
+  while(usart_flag_get(USART1, USART_TDC_FLAG) == RESET);
+  usart_data_transmit(USART1, seq);
+  while(usart_flag_get(USART1, USART_TDC_FLAG) == RESET);
+}
+
+/**
+  * @brief  tmr3 ticks since the last call.
+  * @param  last: tick of the last call, updated
+  * @retval elapsed ticks
+  */
+static uint16_t stream_tick_elapsed(uint16_t *last)
+{
+  uint16_t now = (uint16_t)tmr_counter_value_get(TMR3);
+  uint16_t elapsed = (uint16_t)((now + STREAM_TMR_TICKS - *last) % STREAM_TMR_TICKS);
+  *last = now;
+  return elapsed;
+}
+
+/**
+  * @brief  arm the receive dma, the next frame lands at the start of the buffer.
+  * @param  none
+  * @retval none
+  */
+static void stream_receive_start(void)
+{
+  uart_dma_receive_start(stream_buf, sizeof(stream_buf));
+  stream_slot = 0;
+  stream_last_cnt = sizeof(stream_buf);
+  stream_last_tick = (uint16_t)tmr_counter_value_get(TMR3);
+  stream_idle_ticks = 0;
+}
+
+/**
+  * @brief  enter the streaming upgrade, usart1 receive moves from the byte
+  *         interrupt to the dma.
+  * @param  none
+  * @retval none
+  */
+static void stream_enter(void)
+{
+  usart_interrupt_enable(USART1, USART_RDBF_INT, FALSE);
+  usart_group_struct.count = 0;
+  usart_group_struct.head = 0;
+  usart_group_struct.tail = 0;
+  stream_expect = 0;
+  stream_receive_start();
+  update_status = UPDATE_STREAM;
+  back_ok();
+}
+
+/**
+  * @brief  leave the streaming upgrade and go back to the command flow.
+  * @param  none
+  * @retval none
+  */
+static void stream_abort(void)
+{
+  uart_dma_receive_stop();
+  stream_reply(IAP_STREAM_ABORT, stream_expect);
+  usart_interrupt_enable(USART1, USART_RDBF_INT, TRUE);
+  update_status = UPDATE_PRE;
+}
+
+/**
+  * @brief  drop the frames in flight, wait for the line to go silent and ask
+  *         the pc-tool to send again from the expected sequence.
+  * @param  none
+  * @retval none
+  */
+static void stream_resync(void)
+{
+  uint16_t tick = (uint16_t)tmr_counter_value_get(TMR3);
+  uint32_t silent = 0;
+  uart_dma_receive_stop();
+  while(silent < IAP_STREAM_SILENT_TICKS)
+  {
+    silent += stream_tick_elapsed(&tick);
+    if(usart_flag_get(USART1, USART_RDBF_FLAG) != RESET)
+    {
+      usart_data_receive(USART1);
+      silent = 0;
+    }
+  }
+  stream_receive_start();
+  stream_reply(IAP_STREAM_NAK, stream_expect);
+}
+
+/**
+  * @brief  handle a received frame.
+  * @param  frame: IAP_FRAME_SIZE bytes
+  * @retval none
+  */
+static void stream_frame_handle(uint8_t *frame)
+{
+  uint8_t head[IAP_FRAME_HEAD_SIZE];
+  uint32_t write_addr, crc;
+  uint8_t index;
+
+  crc = stream_word_get(frame + IAP_FRAME_HEAD_SIZE + IAP_BLOCK_SIZE);
+  if((crc32_update(0xFFFFFFFF, frame, IAP_FRAME_HEAD_SIZE + IAP_BLOCK_SIZE) ^ 0xFFFFFFFF) != crc)
+  {
+    stream_resync();
+    return;
+  }
+
+  /* a frame sent again after a lost ack, acknowledge it without programming */
+  if(frame[1] != stream_expect)
+  {
+    if((uint8_t)(stream_expect - frame[1]) <= IAP_STREAM_WINDOW)
+    {
+      stream_slot ^= 1;
+      stream_reply(IAP_STREAM_ACK, frame[1]);
+    }
+    else
+    {
+      stream_resync();
+    }
+    return;
+  }
+
+  if(frame[0] == IAP_FRAME_END)
+  {
+    uart_dma_receive_stop();
+    stream_reply(IAP_STREAM_ACK, frame[1]);
+    stream_expect++;
+    /* run the verified image of highest version */
+    write_addr = image_boot_select();
+    if(write_addr != 0)
+    {
+      crm_reset();
+      /* jump and run in app */
+      app_load(write_addr);
+    }
+    stream_abort();
+    return;
+  }
+
+  write_addr = stream_word_get(frame + 2);
+  if((frame[0] != IAP_FRAME_DATA) || (write_addr < APP_START_ADDR) || (write_addr % IAP_BLOCK_SIZE) || \
+     (write_addr + IAP_BLOCK_SIZE > FLASH_BASE + 1024 * FLASH_SIZE))
+  {
+    stream_abort();
+    return;
+  }
+
+  /* the dma keeps filling the other half while this one is programmed. the
+     block is checked against the crc again once in flash, which also catches
+     a pc-tool that overran the window */
+  for(index = 0; index < IAP_FRAME_HEAD_SIZE; index++)
+  {
+    head[index] = frame[index];
+  }
+  flash_2kb_write(write_addr, frame + IAP_FRAME_HEAD_SIZE);
+  if((crc32_update(crc32_update(0xFFFFFFFF, head, IAP_FRAME_HEAD_SIZE), (uint8_t *)write_addr, IAP_BLOCK_SIZE) ^ 0xFFFFFFFF) != crc)
+  {
+    stream_resync();
+    return;
+  }
+  stream_slot ^= 1;
+  stream_expect++;
+  stream_reply(IAP_STREAM_ACK, head[1]);
+}
+
+/**
+  * @brief  streaming upgrade handle, programs a frame as soon as its half of
+  *         the receive buffer is full.
+  * @param  none
+  * @retval none
+  */
+static void stream_handle(void)
+{
+  uint32_t flag = (stream_slot == 0) ? DMA1_HDT3_FLAG : DMA1_FDT3_FLAG;
+  uint16_t cnt;
+
+  if(dma_flag_get(flag) != RESET)
+  {
+    dma_flag_clear(flag);
+    stream_frame_handle(stream_buf + stream_slot * IAP_FRAME_SIZE);
+    stream_last_tick = (uint16_t)tmr_counter_value_get(TMR3);
+    stream_idle_ticks = 0;
+    return;
+  }
+
+  cnt = dma_data_number_get(DMA1_CHANNEL3);
+  if(cnt != stream_last_cnt)
+  {
+    stream_last_cnt = cnt;
+    stream_last_tick = (uint16_t)tmr_counter_value_get(TMR3);
+    stream_idle_ticks = 0;
+    return;
+  }
+  stream_idle_ticks += stream_tick_elapsed(&stream_last_tick);
+  if((cnt % IAP_FRAME_SIZE) && (stream_idle_ticks > IAP_STREAM_GAP_TICKS))
+  {
+    stream_resync();
+  }
+  else if(stream_idle_ticks > IAP_STREAM_IDLE_TICKS)
+  {
+    stream_abort();
+  }
+}
+
 /**
   * @brief  app update flow handle.
   * @param  none
@@ -280,6 +541,11 @@ void app_update_handle(void)
       cmd_ctr_step = CMD_CTR_IDLE;
       back_ok();
     }
+    else if(cmd_ctr_step == CMD_CTR_STREAM)
+    {
+      cmd_ctr_step = CMD_CTR_IDLE;
+      stream_enter();
+    }
     else if(cmd_ctr_step == CMD_CTR_ERR)
     {
       cmd_ctr_step = CMD_CTR_IDLE;
@@ -322,12 +588,13 @@ void app_update_handle(void)
     {
       cmd_ctr_step = CMD_CTR_IDLE;
       back_ok();
-      /* check app starting address whether 0x08xxxxxx */
-      if(((*(uint32_t*)(APP_START_ADDR + 4)) & 0xFF000000) == 0x08000000)
+      /* run the verified image of highest version */
+      write_addr = image_boot_select();
+      if(write_addr != 0)
       {
         crm_reset();
         /* jump and run in app */
-        app_load(APP_START_ADDR);
+        app_load(write_addr);
       }
       else
       {
@@ -340,6 +607,10 @@ void app_update_handle(void)
       back_err();
     }
   }
+  else if(update_status == UPDATE_STREAM)
+  {
+    stream_handle();
+  }
 }
 
 /**
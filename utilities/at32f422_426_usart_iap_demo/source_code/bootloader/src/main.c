@@ -45,6 +45,8 @@
   */
 int main(void)
 {
+  uint32_t app_addr;
+
   system_clock_config();
   at32_board_init();
 
@@ -54,9 +56,10 @@ int main(void)
   /* check iap_upgrade_flag flag */
   if(flash_upgrade_flag_read() == RESET)
   {
-    /* check app starting address whether 0x08xxxxxx */
-    if(((*(uint32_t*)(APP_START_ADDR + 4)) & 0xFF000000) == 0x08000000)
-      app_load(APP_START_ADDR);
+    /* run the verified image of highest version */
+    app_addr = image_boot_select();
+    if(app_addr != 0)
+      app_load(app_addr);
   }
 
   /* init usart used for app update */
@@ -74,6 +74,49 @@ void uart_init(uint32_t baudrate)
   usart_enable(USART1, TRUE);
 }
 
+/**
+  * @brief  start usart1 receive by dma1 channel3 in loop mode.
+  * @note   the half and full transfer flags mark the two halves of pbuffer,
+  *         the rdbf interrupt must be disabled by the caller.
+  * @param  pbuffer: receive buffer
+  * @param  len: receive buffer length in bytes
+  * @retval none
+  */
+void uart_dma_receive_start(uint8_t *pbuffer, uint16_t len)
+{
+  dma_init_type dma_init_struct;
+  crm_periph_clock_enable(CRM_DMA1_PERIPH_CLOCK, TRUE);
+
+  dma_reset(DMA1_CHANNEL3);
+  dma_default_para_init(&dma_init_struct);
+  dma_init_struct.buffer_size = len;
+  dma_init_struct.direction = DMA_DIR_PERIPHERAL_TO_MEMORY;
+  dma_init_struct.memory_base_addr = (uint32_t)pbuffer;
+  dma_init_struct.memory_data_width = DMA_MEMORY_DATA_WIDTH_BYTE;
+  dma_init_struct.memory_inc_enable = TRUE;
+  dma_init_struct.peripheral_base_addr = (uint32_t)&USART1->dt;
+  dma_init_struct.peripheral_data_width = DMA_PERIPHERAL_DATA_WIDTH_BYTE;
+  dma_init_struct.peripheral_inc_enable = FALSE;
+  dma_init_struct.priority = DMA_PRIORITY_VERY_HIGH;
+  dma_init_struct.loop_mode_enable = TRUE;
+  dma_init(DMA1_CHANNEL3, &dma_init_struct);
+  dma_flag_clear(DMA1_GL3_FLAG | DMA1_FDT3_FLAG | DMA1_HDT3_FLAG | DMA1_DTERR3_FLAG);
+
+  usart_dma_receiver_enable(USART1, TRUE);
+  dma_channel_enable(DMA1_CHANNEL3, TRUE);
+}
+
+/**
+  * @brief  stop usart1 dma receive.
+  * @param  none
+  * @retval none
+  */
+void uart_dma_receive_stop(void)
+{
+  usart_dma_receiver_enable(USART1, FALSE);
+  dma_channel_enable(DMA1_CHANNEL3, FALSE);
+}
+
 /**
   * @brief  usart1 interrupt handler.
   * @param  none
@@ -0,0 +1,424 @@
+/**
+  **************************************************************************
+  * @file     iap_stream.c
+  * @brief    linux sender of the bootloader streaming upgrade
+  **************************************************************************
+  *
+  * Copyright (c) 2025, Artery Technology, All rights reserved.
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+/* usage: iap_stream <tty> <image.bin> [address] [baudrate]
+
+   sends a binary image to the bootloader with the streaming upgrade (0x5a03),
+   see iap.h of the bootloader for the frame layout. the image is cut in 2kb
+   blocks programmed from address (0x08004000 by default), the last block is
+   padded with 0xff. up to IAP_STREAM_WINDOW frames are left unacknowledged,
+   a nak rewinds to the sequence it carries, a silent line sends the oldest
+   unacknowledged frame again. */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+/* protocol values, kept equal to iap.h of the bootloader */
+#define IAP_BLOCK_SIZE           0x800
+#define IAP_FRAME_HEAD_SIZE      6
+#define IAP_FRAME_SIZE           (IAP_FRAME_HEAD_SIZE + IAP_BLOCK_SIZE + 4)
+#define IAP_FRAME_DATA           0x32
+#define IAP_FRAME_END            0x33
+#define IAP_STREAM_WINDOW        2
+#define IAP_STREAM_ACK           0xCC
+#define IAP_STREAM_NAK           0xEE
+#define IAP_STREAM_ABORT         0xFF
+
+#define APP_START_ADDR           0x08004000
+
+/* a nak comes after 50ms of gap and 20ms of silence, a block takes about
+   180ms at 115200 baud, give a frame and a programming time some margin */
+#define REPLY_TIMEOUT_MS         1000
+#define RETRY_MAX                5
+
+/**
+  * @brief  crc32 of zlib, reflected polynomial 0xedb88320.
+  * @param  crc: crc so far, 0xffffffff to start, complement the result to finish
+  * @param  pbuffer: data
+  * @param  len: data length in bytes
+  * @retval updated crc
+  */
+static uint32_t crc32_update(uint32_t crc, const uint8_t *pbuffer, uint32_t len)
+{
+  uint8_t bit;
+
+  while(len--)
+  {
+    crc ^= *pbuffer++;
+    for(bit = 0; bit < 8; bit++)
+    {
+      crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+    }
+  }
+  return crc;
+}
+
+/**
+  * @brief  store a msb first word.
+  * @param  pbuffer: first byte
+  * @param  value: word
+  * @retval none
+  */
+static void word_put(uint8_t *pbuffer, uint32_t value)
+{
+  pbuffer[0] = (uint8_t)(value >> 24);
+  pbuffer[1] = (uint8_t)(value >> 16);
+  pbuffer[2] = (uint8_t)(value >> 8);
+  pbuffer[3] = (uint8_t)value;
+}
+
+/**
+  * @brief  open the serial port raw, 8n1 without flow control.
+  * @param  name: device name
+  * @param  baudrate: baudrate, ignored by a pseudo terminal
+  * @retval file descriptor, -1 on error
+  */
+static int port_open(const char *name, uint32_t baudrate)
+{
+  struct termios tio;
+  speed_t speed;
+  int fd;
+
+  fd = open(name, O_RDWR | O_NOCTTY);
+  if(fd < 0)
+  {
+    return -1;
+  }
+
+  switch(baudrate)
+  {
+    case 9600:   speed = B9600;   break;
+    case 57600:  speed = B57600;  break;
+    case 230400: speed = B230400; break;
+    case 460800: speed = B460800; break;
+    case 921600: speed = B921600; break;
+    default:     speed = B115200; break;
+  }
+
+  if(tcgetattr(fd, &tio) == 0)
+  {
+    cfmakeraw(&tio);
+    tio.c_cflag |= CLOCAL | CREAD;
+    tio.c_cflag &= ~(CSTOPB | CRTSCTS);
+    tio.c_cc[VMIN] = 0;
+    tio.c_cc[VTIME] = 0;
+    cfsetispeed(&tio, speed);
+    cfsetospeed(&tio, speed);
+    tcsetattr(fd, TCSANOW, &tio);
+  }
+  tcflush(fd, TCIOFLUSH);
+  return fd;
+}
+
+/**
+  * @brief  write all bytes.
+  * @param  fd: port
+  * @param  pbuffer: data
+  * @param  len: data length
+  * @retval 0 or -1 on error
+  */
+static int port_write(int fd, const uint8_t *pbuffer, uint32_t len)
+{
+  ssize_t n;
+
+  while(len)
+  {
+    n = write(fd, pbuffer, len);
+    if(n < 0)
+    {
+      if(errno == EINTR || errno == EAGAIN)
+      {
+        continue;
+      }
+      return -1;
+    }
+    pbuffer += n;
+    len -= (uint32_t)n;
+  }
+  return 0;
+}
+
+/**
+  * @brief  read one byte.
+  * @param  fd: port
+  * @param  val: the byte
+  * @param  timeout_ms: timeout
+  * @retval 1 when a byte is read, 0 on timeout, -1 on error
+  */
+static int port_read_byte(int fd, uint8_t *val, int timeout_ms)
+{
+  struct pollfd pfd;
+  ssize_t n;
+  int ret;
+
+  pfd.fd = fd;
+  pfd.events = POLLIN;
+  for(;;)
+  {
+    ret = poll(&pfd, 1, timeout_ms);
+    if(ret <= 0)
+    {
+      return (ret < 0 && errno != EINTR) ? -1 : 0;
+    }
+    n = read(fd, val, 1);
+    if(n == 1)
+    {
+      return 1;
+    }
+    if(n < 0 && errno != EINTR && errno != EAGAIN)
+    {
+      return -1;
+    }
+  }
+}
+
+/**
+  * @brief  build and send the frame of a block, the one after the last
+  *         block is the end frame.
+  * @param  fd: port
+  * @param  image: image data
+  * @param  image_len: image length
+  * @param  index: block index
+  * @param  block_num: number of blocks
+  * @param  addr: address of the first block
+  * @retval 0 or -1 on error
+  */
+static int frame_send(int fd, const uint8_t *image, uint32_t image_len, uint32_t index,
+                      uint32_t block_num, uint32_t addr)
+{
+  uint8_t frame[IAP_FRAME_SIZE];
+  uint32_t offset = index * IAP_BLOCK_SIZE;
+  uint32_t len = 0;
+
+  memset(frame, 0xFF, sizeof(frame));
+  frame[1] = (uint8_t)index;
+  if(index < block_num)
+  {
+    frame[0] = IAP_FRAME_DATA;
+    word_put(frame + 2, addr + offset);
+    len = image_len - offset;
+    if(len > IAP_BLOCK_SIZE)
+    {
+      len = IAP_BLOCK_SIZE;
+    }
+    memcpy(frame + IAP_FRAME_HEAD_SIZE, image + offset, len);
+  }
+  else
+  {
+    frame[0] = IAP_FRAME_END;
+    word_put(frame + 2, 0);
+  }
+  word_put(frame + IAP_FRAME_HEAD_SIZE + IAP_BLOCK_SIZE,
+           crc32_update(0xFFFFFFFF, frame, IAP_FRAME_HEAD_SIZE + IAP_BLOCK_SIZE) ^ 0xFFFFFFFF);
+
+  return port_write(fd, frame, sizeof(frame));
+}
+
+/**
+  * @brief  ask the bootloader for the streaming upgrade.
+  * @param  fd: port
+  * @retval 0 or -1 when the bootloader does not answer
+  */
+static int stream_enter(int fd)
+{
+  static const uint8_t cmd[2] = {0x5A, 0x03};
+  uint8_t val, last = 0;
+  int retry;
+
+  for(retry = 0; retry < RETRY_MAX; retry++)
+  {
+    tcflush(fd, TCIFLUSH);
+    if(port_write(fd, cmd, sizeof(cmd)) != 0)
+    {
+      return -1;
+    }
+    while(port_read_byte(fd, &val, REPLY_TIMEOUT_MS) == 1)
+    {
+      if(last == 0xCC && val == 0xDD)
+      {
+        return 0;
+      }
+      last = val;
+    }
+  }
+  return -1;
+}
+
+/**
+  * @brief  stream the image.
+  * @param  fd: port
+  * @param  image: image data
+  * @param  image_len: image length
+  * @param  addr: address of the first block
+  * @retval 0 or -1 on error
+  */
+static int stream_send(int fd, const uint8_t *image, uint32_t image_len, uint32_t addr)
+{
+  uint32_t block_num = (image_len + IAP_BLOCK_SIZE - 1) / IAP_BLOCK_SIZE;
+  uint32_t base = 0, next = 0, retry = 0, nak_count = 0;
+  uint8_t code, seq;
+  int ret;
+
+  /* base: oldest frame not acknowledged, next: next frame to send. the frame
+     index block_num is the end frame */
+  while(base <= block_num)
+  {
+    while((next <= block_num) && (next - base < IAP_STREAM_WINDOW))
+    {
+      if(frame_send(fd, image, image_len, next, block_num, addr) != 0)
+      {
+        return -1;
+      }
+      next++;
+    }
+
+    ret = port_read_byte(fd, &code, REPLY_TIMEOUT_MS);
+    if(ret == 1 && code != IAP_STREAM_ACK && code != IAP_STREAM_NAK && code != IAP_STREAM_ABORT)
+    {
+      continue;
+    }
+    if(ret == 1)
+    {
+      ret = port_read_byte(fd, &seq, REPLY_TIMEOUT_MS);
+    }
+    if(ret < 0)
+    {
+      return -1;
+    }
+    if(ret == 0)
+    {
+      if(++retry > RETRY_MAX)
+      {
+        fprintf(stderr, "no answer at block %u\n", base);
+        return -1;
+      }
+      next = base;
+      continue;
+    }
+    retry = 0;
+
+    if(code == IAP_STREAM_ACK)
+    {
+      /* the ack of a frame sent again is the one of an earlier frame */
+      if(seq == (uint8_t)base)
+      {
+        base++;
+        printf("\r%u/%u", base, block_num + 1);
+        fflush(stdout);
+      }
+    }
+    else if(code == IAP_STREAM_NAK)
+    {
+      /* the bootloader restarts its receive buffer, send again from seq */
+      if((uint8_t)(seq - (uint8_t)base) <= (uint8_t)(next - base))
+      {
+        base += (uint8_t)(seq - (uint8_t)base);
+        next = base;
+        nak_count++;
+      }
+    }
+    else
+    {
+      fprintf(stderr, "\naborted by the bootloader at sequence %u\n", seq);
+      return -1;
+    }
+  }
+  printf("\ndone, %u blocks, %u nak\n", block_num, nak_count);
+  return 0;
+}
+
+int main(int argc, char *argv[])
+{
+  uint32_t addr = APP_START_ADDR, baudrate = 115200;
+  uint8_t *image;
+  long image_len;
+  FILE *file;
+  int fd, ret;
+
+  if(argc < 3)
+  {
+    fprintf(stderr, "usage: %s <tty> <image.bin> [address] [baudrate]\n", argv[0]);
+    return 2;
+  }
+  if(argc > 3)
+  {
+    addr = (uint32_t)strtoul(argv[3], 0, 0);
+  }
+  if(argc > 4)
+  {
+    baudrate = (uint32_t)strtoul(argv[4], 0, 0);
+  }
+  if(addr % IAP_BLOCK_SIZE)
+  {
+    fprintf(stderr, "address 0x%08x is not on a 2kb block\n", addr);
+    return 2;
+  }
+
+  file = fopen(argv[2], "rb");
+  if(file == 0)
+  {
+    perror(argv[2]);
+    return 2;
+  }
+  fseek(file, 0, SEEK_END);
+  image_len = ftell(file);
+  fseek(file, 0, SEEK_SET);
+  image = malloc(image_len > 0 ? (size_t)image_len : 1);
+  if(image_len <= 0 || image == 0 || fread(image, 1, (size_t)image_len, file) != (size_t)image_len)
+  {
+    fprintf(stderr, "%s: cannot read the image\n", argv[2]);
+    fclose(file);
+    return 2;
+  }
+  fclose(file);
+
+  fd = port_open(argv[1], baudrate);
+  if(fd < 0)
+  {
+    perror(argv[1]);
+    return 2;
+  }
+
+  ret = 1;
+  if(stream_enter(fd) != 0)
+  {
+    fprintf(stderr, "no answer to the streaming upgrade command\n");
+  }
+  else if(stream_send(fd, image, (uint32_t)image_len, addr) == 0)
+  {
+    ret = 0;
+  }
+
+  close(fd);
+  free(image);
+  return ret;
+}
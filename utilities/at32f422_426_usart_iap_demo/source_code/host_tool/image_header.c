@@ -0,0 +1,170 @@
+/**
+  **************************************************************************
+  * @file     image_header.c
+  * @brief    build a slot image with the image header of the bootloader
+  **************************************************************************
+  *
+  * Copyright (c) 2025, Artery Technology, All rights reserved.
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+/* usage: image_header <app.bin> <slot.bin> <version> [flash kbytes]
+
+   writes the slot image to program at the start of an app slot: the app
+   padded with 0xff to whole sectors, 0xff up to the last sector of the slot
+   and the image_header_type there, see flash.h of the bootloader. the crc is
+   the one flash_crc_calibrate() reads from the flash controller for the
+   padded sectors: the crc-32/mpeg-2 over the flash words, read little endian
+   and fed msb first. the slot image ends with the
+   header, the rest of the last sector is left to the erased flash. the app
+   must be linked for the slot it is programmed in. */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* kept equal to iap.h and flash.h of the bootloader */
+#define APP_START_OFFSET         0x4000
+#define IMAGE_SLOT_NUM           2
+#define IMAGE_HEADER_MAGIC       0x474D4941
+#define IMAGE_HEADER_SIZE        20
+
+/**
+  * @brief  flash crc calibration: crc-32/mpeg-2 over little endian words,
+  *         poly 0x04c11db7, init 0xffffffff, no reflection and no final xor.
+  * @param  pbuffer: data, a multiple of 4 bytes
+  * @param  len: data length in bytes
+  * @retval crc
+  */
+static uint32_t image_crc(const uint8_t *pbuffer, uint32_t len)
+{
+  uint32_t crc = 0xFFFFFFFF;
+  uint8_t bit;
+
+  for(; len >= 4; len -= 4, pbuffer += 4)
+  {
+    crc ^= (uint32_t)pbuffer[0] | ((uint32_t)pbuffer[1] << 8) |
+           ((uint32_t)pbuffer[2] << 16) | ((uint32_t)pbuffer[3] << 24);
+    for(bit = 0; bit < 32; bit++)
+    {
+      crc = (crc & 0x80000000) ? ((crc << 1) ^ 0x04C11DB7) : (crc << 1);
+    }
+  }
+  return crc;
+}
+
+/**
+  * @brief  store a little endian word.
+  * @param  pbuffer: first byte
+  * @param  value: word
+  * @retval none
+  */
+static void word_put(uint8_t *pbuffer, uint32_t value)
+{
+  pbuffer[0] = (uint8_t)value;
+  pbuffer[1] = (uint8_t)(value >> 8);
+  pbuffer[2] = (uint8_t)(value >> 16);
+  pbuffer[3] = (uint8_t)(value >> 24);
+}
+
+int main(int argc, char *argv[])
+{
+  uint32_t flash_kbytes = 128, sector_size, slot_size, header_addr;
+  uint32_t length, padded, version, crc;
+  uint8_t *slot;
+  FILE *file;
+  long size;
+
+  if(argc < 4)
+  {
+    fprintf(stderr, "usage: %s <app.bin> <slot.bin> <version> [flash kbytes]\n", argv[0]);
+    return 2;
+  }
+  version = (uint32_t)strtoul(argv[3], 0, 0);
+  if(argc > 4)
+  {
+    flash_kbytes = (uint32_t)strtoul(argv[4], 0, 0);
+  }
+
+  /* flash_sector_size_get and image_slot_size_get of the bootloader */
+  sector_size = (flash_kbytes < 0x100) ? 0x400 : 0x800;
+  if(flash_kbytes * 1024 <= APP_START_OFFSET + IMAGE_SLOT_NUM * 0x800)
+  {
+    fprintf(stderr, "no app slot in %u kbytes\n", flash_kbytes);
+    return 2;
+  }
+  slot_size = ((flash_kbytes * 1024 - APP_START_OFFSET) / IMAGE_SLOT_NUM) & ~(uint32_t)0x7FF;
+  header_addr = slot_size - sector_size;
+
+  file = fopen(argv[1], "rb");
+  if(file == 0)
+  {
+    perror(argv[1]);
+    return 2;
+  }
+  fseek(file, 0, SEEK_END);
+  size = ftell(file);
+  fseek(file, 0, SEEK_SET);
+  if((size < 8) || ((uint32_t)size > header_addr))
+  {
+    fprintf(stderr, "%s: %ld bytes, a slot holds 8 to %u bytes\n", argv[1], size, header_addr);
+    fclose(file);
+    return 2;
+  }
+  length = (uint32_t)size;
+
+  slot = malloc(slot_size);
+  if(slot == 0)
+  {
+    fclose(file);
+    return 2;
+  }
+  memset(slot, 0xFF, slot_size);
+  if(fread(slot, 1, length, file) != length)
+  {
+    fprintf(stderr, "%s: cannot read the app\n", argv[1]);
+    fclose(file);
+    free(slot);
+    return 2;
+  }
+  fclose(file);
+
+  padded = (length + sector_size - 1) / sector_size * sector_size;
+  crc = image_crc(slot, padded);
+
+  word_put(slot + header_addr, IMAGE_HEADER_MAGIC);
+  word_put(slot + header_addr + 4, length);
+  word_put(slot + header_addr + 8, version);
+  word_put(slot + header_addr + 12, crc);
+  word_put(slot + header_addr + 16, ~(IMAGE_HEADER_MAGIC ^ length ^ version ^ crc));
+
+  file = fopen(argv[2], "wb");
+  if((file == 0) || (fwrite(slot, 1, header_addr + IMAGE_HEADER_SIZE, file) != header_addr + IMAGE_HEADER_SIZE))
+  {
+    perror(argv[2]);
+    free(slot);
+    return 2;
+  }
+  fclose(file);
+  free(slot);
+
+  printf("length %u, version %u, crc 0x%08X, header at slot offset 0x%X of 0x%X\n",
+         length, version, crc, header_addr, slot_size);
+  return 0;
+}
@@ -0,0 +1,621 @@
+/**
+  **************************************************************************
+  * @file     test_adc_stream.c
+  * @brief    host test of the adc stream application library
+  **************************************************************************
+  *
+  * Copyright (c) 2025, Artery Technology, All rights reserved.
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+/* usage: test_adc_stream
+
+   synthetic ordinary sequences are written to the stream buffer the way the
+   loop mode dma does, one sample at a time with the channel dtcnt counting
+   down, and the half and full transfer callbacks of the dma handle are called
+   as the dma interrupt would. the blocks reach the consumer callback of
+   adc_stream_application.c unchanged. the adc and dma application functions
+   are fakes keeping their state in this file.
+
+   the oversample stage is run on random sequences, ratios, shifts and block
+   splits twice: on word aligned blocks, which take the simd paths for one
+   and two channels, and on the same blocks moved to an odd halfword, which
+   take the sample by sample path. both must match a plain c reference bit
+   for bit. the simd intrinsics are the c versions of common/cmsis_host.h.
+
+   the voltage monitor supervisor rides on the stream: a monitor interrupt
+   with the data register holding a sample of another channel, the level
+   then taken from the guarded channel in the next block. */
+
+#include <stdlib.h>
+#include <string.h>
+#include "adc_stream_application.h"
+#include "host_map.h"
+
+#define SEQUENCE_LENGTH          3
+#define DEPTH                    4
+#define BLOCK_SIZE               (SEQUENCE_LENGTH * DEPTH)
+
+#define OVERSAMPLE_RUNS          300
+#define OVERSAMPLE_SAMPLES_MAX   4096
+
+/* fake adc, flags of adc_interrupt_flag_get() and their interrupt enables */
+static uint32_t adc_flags = 0;
+static uint32_t adc_ints = 0;
+static confirm_state adc_on = TRUE;
+static confirm_state adc_dma_on = FALSE;
+static confirm_state tmr_on = FALSE;
+
+/* fake voltage monitor */
+static adc_voltage_monitoring_type vm_mode = ADC_VMONITOR_NONE;
+static adc_channel_select_type vm_channel = ADC_CHANNEL_0;
+static uint16_t vm_high = 0;
+static uint16_t vm_low = 0;
+
+/* fake dma application */
+static confirm_state dma_busy = FALSE;
+static uint32_t dma_start_count = 0;
+static uint32_t dma_stop_count = 0;
+static uint32_t dma_free_count = 0;
+
+/* tick of the block timestamps */
+static uint32_t tick_now = 0;
+
+/* consumer callback records */
+static const uint16_t *cb_block[16];
+static uint16_t cb_size[16];
+static uint32_t cb_timestamp[16];
+static uint32_t cb_count = 0;
+static uint32_t cb_bad_data = 0;
+static uint32_t cb_sequence = 0;
+
+static adc_stream_handle_type hstream;
+static uint16_t stream_buf[BLOCK_SIZE * 2];
+
+uint32_t adc_stream_tick_get(void)
+{
+  return tick_now;
+}
+
+void adc_interrupt_enable(adc_type *adc_x, uint32_t adc_int, confirm_state new_state)
+{
+  if(new_state == TRUE)
+  {
+    adc_ints |= adc_int;
+  }
+  else
+  {
+    adc_ints &= ~adc_int;
+  }
+}
+
+flag_status adc_interrupt_flag_get(adc_type *adc_x, uint16_t adc_flag)
+{
+  uint32_t adc_int = 0;
+
+  switch(adc_flag)
+  {
+    case ADC_VMOR_FLAG: adc_int = ADC_VMOR_INT; break;
+    case ADC_OCCO_FLAG: adc_int = ADC_OCCO_INT; break;
+    case ADC_TCF_FLAG:  adc_int = ADC_TCF_INT;  break;
+    default: break;
+  }
+
+  return ((adc_flags & adc_flag) && (adc_ints & adc_int)) ? SET : RESET;
+}
+
+void adc_flag_clear(adc_type *adc_x, uint16_t adc_flag)
+{
+  adc_flags &= ~(uint32_t)adc_flag;
+}
+
+void adc_enable(adc_type *adc_x, confirm_state new_state)
+{
+  adc_on = new_state;
+}
+
+void adc_dma_mode_enable(adc_type *adc_x, confirm_state new_state)
+{
+  adc_dma_on = new_state;
+}
+
+void adc_convert_fail_auto_abort_enable(adc_type *adc_x, confirm_state new_state)
+{
+  adc_interrupt_enable(adc_x, ADC_TCF_INT, new_state);
+}
+
+void adc_voltage_monitor_enable(adc_type *adc_x, adc_voltage_monitoring_type adc_voltage_monitoring)
+{
+  vm_mode = adc_voltage_monitoring;
+}
+
+void adc_voltage_monitor_single_channel_select(adc_type *adc_x, adc_channel_select_type adc_channel)
+{
+  vm_channel = adc_channel;
+}
+
+void adc_voltage_monitor_threshold_value_set(adc_type *adc_x, uint16_t adc_high_threshold, uint16_t adc_low_threshold)
+{
+  vm_high = adc_high_threshold;
+  vm_low = adc_low_threshold;
+}
+
+void tmr_counter_enable(tmr_type *tmr_x, confirm_state new_state)
+{
+  tmr_on = new_state;
+}
+
+dma_app_status_type dma_channel_alloc(dma_handle_type* hdma, dma_request_type request)
+{
+  if(dma_busy == TRUE)
+  {
+    return DMA_APP_ERR_BUSY;
+  }
+
+  hdma->request = request;
+  hdma->channel = DMA1_CHANNEL1;
+  hdma->channel_index = 1;
+  return DMA_APP_OK;
+}
+
+void dma_channel_free(dma_handle_type* hdma)
+{
+  dma_free_count++;
+}
+
+void dma_default_para_init(dma_init_type* dma_init_struct)
+{
+  memset(dma_init_struct, 0, sizeof(dma_init_type));
+}
+
+void dma_desc_build(dma_desc_type* desc, dma_init_type* dma_init_struct)
+{
+  desc->ctrl = (dma_init_struct->loop_mode_enable == TRUE) ? 0x20 : 0;
+  desc->dtcnt = dma_init_struct->buffer_size;
+  desc->paddr = dma_init_struct->peripheral_base_addr;
+  desc->maddr = dma_init_struct->memory_base_addr;
+  desc->next = 0;
+}
+
+dma_app_status_type dma_chain_start(dma_handle_type* hdma, dma_desc_type* desc)
+{
+  hdma->desc = desc;
+  hdma->channel->dtcnt = desc->dtcnt;
+  hdma->busy = 1;
+  dma_start_count++;
+  return DMA_APP_OK;
+}
+
+void dma_chain_stop(dma_handle_type* hdma)
+{
+  hdma->busy = 0;
+  dma_stop_count++;
+}
+
+/**
+  * @brief  synthetic sample of a channel in a sequence.
+  */
+static uint16_t sample_value(uint32_t sequence, uint8_t channel)
+{
+  return (uint16_t)((sequence * 37 + channel * 1000) & 0xFFF);
+}
+
+/**
+  * @brief  consumer callback, checks every block holds the next sequences.
+  */
+static void stream_callback(adc_stream_handle_type* hs, const uint16_t* block, uint16_t size, uint32_t timestamp)
+{
+  uint16_t index;
+
+  if(cb_count < 16)
+  {
+    cb_block[cb_count] = block;
+    cb_size[cb_count] = size;
+    cb_timestamp[cb_count] = timestamp;
+  }
+  cb_count++;
+
+  for(index = 0; index < size; index++)
+  {
+    if(block[index] != sample_value(cb_sequence + index / SEQUENCE_LENGTH, index % SEQUENCE_LENGTH))
+    {
+      cb_bad_data++;
+    }
+  }
+  cb_sequence += size / SEQUENCE_LENGTH;
+}
+
+/**
+  * @brief  one sample written by the loop mode dma, the transfer interrupts
+  *         are taken right away when irq is set.
+  */
+static void dma_sample_put(uint16_t value, confirm_state irq)
+{
+  dma_channel_type *channel = hstream.dma.channel;
+  uint16_t total = hstream.block_size * 2;
+  uint16_t pos = total - (uint16_t)channel->dtcnt;
+
+  stream_buf[pos] = value;
+  tick_now += 10;
+
+  if(--channel->dtcnt == 0)
+  {
+    channel->dtcnt = total;
+    if(irq == TRUE)
+    {
+      hstream.dma.full_callback(&hstream.dma, hstream.dma.desc);
+    }
+  }
+  else if((pos + 1 == hstream.block_size) && (irq == TRUE))
+  {
+    hstream.dma.half_callback(&hstream.dma, hstream.dma.desc);
+  }
+}
+
+/**
+  * @brief  sequences converted, the dma interrupts are taken on time when
+  *         irq is set.
+  */
+static void sequences_put(uint32_t first, uint32_t number, confirm_state irq)
+{
+  uint32_t sequence;
+  uint8_t channel;
+
+  for(sequence = first; sequence < first + number; sequence++)
+  {
+    for(channel = 0; channel < SEQUENCE_LENGTH; channel++)
+    {
+      dma_sample_put(sample_value(sequence, channel), irq);
+    }
+  }
+}
+
+/**
+  * @brief  the stream from init to deinit.
+  */
+static void stream_test(void)
+{
+  uint32_t index;
+
+  ADC1->osq1_bit.oclen = SEQUENCE_LENGTH - 1;
+
+  /* parameters */
+  memset(&hstream, 0, sizeof(hstream));
+  hstream.adcx = ADC1;
+  HOST_CHECK(adc_stream_init(&hstream, 0, DEPTH) == ADC_STREAM_ERR_PARAM);
+  HOST_CHECK(adc_stream_init(&hstream, stream_buf, 0) == ADC_STREAM_ERR_PARAM);
+  HOST_CHECK(adc_stream_init(&hstream, stream_buf, 20000) == ADC_STREAM_ERR_PARAM);
+  dma_busy = TRUE;
+  HOST_CHECK(adc_stream_init(&hstream, stream_buf, DEPTH) == ADC_STREAM_ERR_BUSY);
+  dma_busy = FALSE;
+
+  /* a stream of five blocks, the callback gets them in turn */
+  hstream.tmrx = TMR1;
+  hstream.callback = stream_callback;
+  HOST_CHECK(adc_stream_init(&hstream, stream_buf, DEPTH) == ADC_STREAM_OK);
+  HOST_CHECK(hstream.sequence_length == SEQUENCE_LENGTH);
+  HOST_CHECK(hstream.block_size == BLOCK_SIZE);
+  HOST_CHECK(hstream.desc.dtcnt == BLOCK_SIZE * 2);
+  HOST_CHECK(hstream.desc.maddr == (uint32_t)(uintptr_t)stream_buf);
+  HOST_CHECK(hstream.desc.paddr == (uint32_t)(uintptr_t)&ADC1->odt);
+
+  adc_stream_start(&hstream);
+  HOST_CHECK((tmr_on == TRUE) && (adc_dma_on == TRUE) && (dma_start_count == 1));
+
+  sequences_put(0, DEPTH * 5, TRUE);
+  HOST_CHECK(cb_count == 5);
+  HOST_CHECK(hstream.block_count == 5);
+  HOST_CHECK(hstream.overrun_count == 0);
+  HOST_CHECK(cb_bad_data == 0);
+  for(index = 0; index < 5; index++)
+  {
+    HOST_CHECK(cb_block[index] == stream_buf + (index & 1) * BLOCK_SIZE);
+    HOST_CHECK(cb_size[index] == BLOCK_SIZE);
+    HOST_CHECK(cb_timestamp[index] == (index + 1) * BLOCK_SIZE * 10);
+  }
+
+  /* the interrupt of the second block comes a sequence late, the dma is in
+     the other block and the data is whole */
+  sequences_put(DEPTH * 5, DEPTH + 1, FALSE);
+  hstream.dma.full_callback(&hstream.dma, hstream.dma.desc);
+  HOST_CHECK(cb_count == 6);
+  HOST_CHECK(cb_bad_data == 0);
+  HOST_CHECK(hstream.overrun_count == 0);
+
+  /* the interrupt of the first block comes after the dma wrapped into it
+     again, the block is given but counted overrun */
+  sequences_put(DEPTH * 6 + 1, DEPTH * 2, FALSE);
+  hstream.dma.half_callback(&hstream.dma, hstream.dma.desc);
+  HOST_CHECK(cb_count == 7);
+  HOST_CHECK(hstream.overrun_count == 1);
+
+  /* an overflow restarts the dma at the first block */
+  adc_flags |= ADC_OCCO_FLAG;
+  adc_stream_irq_handler(&hstream);
+  HOST_CHECK(hstream.fail_count == 1);
+  HOST_CHECK((dma_stop_count == 1) && (dma_start_count == 2));
+  HOST_CHECK(hstream.dma.channel->dtcnt == BLOCK_SIZE * 2);
+  HOST_CHECK(adc_on == TRUE);
+  HOST_CHECK(adc_flags == 0);
+
+  /* a flag without its interrupt enable is not a fail */
+  adc_flags |= ADC_VMOR_FLAG;
+  adc_stream_irq_handler(&hstream);
+  HOST_CHECK(hstream.fail_count == 1);
+  adc_flags = 0;
+
+  adc_stream_deinit(&hstream);
+  HOST_CHECK((tmr_on == FALSE) && (adc_dma_on == FALSE));
+  HOST_CHECK(dma_free_count == 1);
+  HOST_CHECK((adc_ints & (ADC_OCCO_INT | ADC_TCF_INT)) == 0);
+}
+
+/**
+  * @brief  plain c oversample of a whole sample stream.
+  * @retval number of outputs.
+  */
+static uint32_t oversample_reference(const uint16_t* samples, uint32_t size, uint8_t channels,
+                                     uint16_t ratio, uint8_t shift, uint16_t* out)
+{
+  uint32_t sum[ADC_STREAM_OVERSAMPLE_CHANNELS];
+  uint32_t number = 0;
+  uint32_t sequence;
+  uint8_t ch;
+
+  for(sequence = 0; (sequence + ratio) * channels <= size; sequence += ratio)
+  {
+    memset(sum, 0, sizeof(sum));
+    for(ch = 0; ch < channels; ch++)
+    {
+      uint32_t i;
+
+      for(i = 0; i < ratio; i++)
+      {
+        sum[ch] += samples[(sequence + i) * channels + ch];
+      }
+      out[number++] = (uint16_t)(sum[ch] >> shift);
+    }
+  }
+
+  return number;
+}
+
+/**
+  * @brief  feed a sample stream to an oversample stage in blocks.
+  * @param  offset: halfword offset of the blocks, 1 moves them off the word.
+  * @retval number of outputs.
+  */
+static uint32_t oversample_run(adc_stream_oversample_type* hos, const uint16_t* samples, uint32_t size,
+                               const uint16_t* split, uint32_t split_num, uint8_t offset, uint16_t* out)
+{
+  static uint32_t words[OVERSAMPLE_SAMPLES_MAX / 2 + 1];
+  uint16_t *block = (uint16_t *)words + offset;
+  uint32_t start = 0;
+  uint32_t number = 0;
+  uint32_t index;
+
+  for(index = 0; index <= split_num; index++)
+  {
+    uint32_t end = (index < split_num) ? split[index] : size;
+
+    memcpy(block, samples + start, (end - start) * 2);
+    number += adc_stream_oversample_process(hos, block, (uint16_t)(end - start), out + number);
+    start = end;
+  }
+
+  return number;
+}
+
+/**
+  * @brief  simd and sample by sample oversampling against the reference.
+  */
+static void oversample_test(void)
+{
+  static uint16_t samples[OVERSAMPLE_SAMPLES_MAX];
+  static uint16_t out_ref[OVERSAMPLE_SAMPLES_MAX + ADC_STREAM_OVERSAMPLE_CHANNELS];
+  static uint16_t out_simd[OVERSAMPLE_SAMPLES_MAX + ADC_STREAM_OVERSAMPLE_CHANNELS];
+  static uint16_t out_scalar[OVERSAMPLE_SAMPLES_MAX + ADC_STREAM_OVERSAMPLE_CHANNELS];
+  static const uint16_t ratios[] = {1, 2, 3, 4, 8, 15, 16, 17, 32, 64, 256, 1024, 4096};
+  adc_stream_oversample_type hos;
+  uint16_t split[8];
+  uint32_t split_num, size, index, run;
+  uint32_t number_ref, number_simd, number_scalar;
+  uint32_t mismatch = 0;
+  uint16_t ratio;
+  uint8_t channels, shift;
+
+  HOST_CHECK(adc_stream_oversample_init(&hos, 0, 16, 2) == ADC_STREAM_ERR_PARAM);
+  HOST_CHECK(adc_stream_oversample_init(&hos, ADC_STREAM_OVERSAMPLE_CHANNELS + 1, 16, 2) == ADC_STREAM_ERR_PARAM);
+  HOST_CHECK(adc_stream_oversample_init(&hos, 1, 0, 2) == ADC_STREAM_ERR_PARAM);
+  HOST_CHECK(adc_stream_oversample_init(&hos, 1, 4097, 2) == ADC_STREAM_ERR_PARAM);
+
+  srand(1);
+  for(run = 0; run < OVERSAMPLE_RUNS; run++)
+  {
+    /* one and two channels take the simd paths, three the reference only */
+    channels = (uint8_t)((run % 3) + 1);
+    ratio = ratios[rand() % (sizeof(ratios) / sizeof(ratios[0]))];
+    shift = (uint8_t)(rand() % 5);
+    size = (uint32_t)(rand() % OVERSAMPLE_SAMPLES_MAX) + 1;
+    size -= size % channels;
+    if(size == 0)
+    {
+      size = channels;
+    }
+
+    for(index = 0; index < size; index++)
+    {
+      /* full scale now and then, the largest sums of the halfword lanes */
+      samples[index] = (run % 7 == 0) ? 0xFFF : (uint16_t)(rand() & 0xFFF);
+    }
+
+    /* sorted split points, even and odd ones, some splitting a sequence */
+    split_num = (uint32_t)(rand() % 8);
+    for(index = 0; index < split_num; index++)
+    {
+      split[index] = (uint16_t)(rand() % (size + 1));
+      if(rand() & 1)
+      {
+        split[index] &= ~1;
+      }
+    }
+    for(index = 1; index < split_num; index++)
+    {
+      uint32_t j;
+
+      for(j = index; (j > 0) && (split[j - 1] > split[j]); j--)
+      {
+        uint16_t swap = split[j];
+        split[j] = split[j - 1];
+        split[j - 1] = swap;
+      }
+    }
+
+    number_ref = oversample_reference(samples, size, channels, ratio, shift, out_ref);
+
+    adc_stream_oversample_init(&hos, channels, ratio, shift);
+    number_simd = oversample_run(&hos, samples, size, split, split_num, 0, out_simd);
+
+    adc_stream_oversample_init(&hos, channels, ratio, shift);
+    number_scalar = oversample_run(&hos, samples, size, split, split_num, 1, out_scalar);
+
+    if((number_simd != number_ref) || (number_scalar != number_ref) ||
+       (memcmp(out_simd, out_ref, number_ref * 2) != 0) ||
+       (memcmp(out_scalar, out_ref, number_ref * 2) != 0))
+    {
+      if(mismatch++ == 0)
+      {
+        printf("oversample mismatch: %u channels, ratio %u, shift %u, %u samples, %u splits\n",
+               channels, ratio, shift, size, split_num);
+      }
+    }
+  }
+  HOST_CHECK(mismatch == 0);
+
+  /* one channel, the simd path sums two sequences per word */
+  adc_stream_oversample_init(&hos, 1, 4, 0);
+  for(index = 0; index < 8; index++)
+  {
+    samples[index] = (uint16_t)(index + 1);
+  }
+  number_simd = oversample_run(&hos, samples, 8, split, 0, 0, out_simd);
+  HOST_CHECK((number_simd == 2) && (out_simd[0] == 10) && (out_simd[1] == 26));
+}
+
+/**
+  * @brief  one block of sequences of the channels 5, 7 and 9 at the given
+  *         levels, a sequence of channel 7 replaced by spike when not 0.
+  */
+static void monitor_block_put(uint16_t level, uint16_t spike)
+{
+  uint8_t sequence;
+
+  for(sequence = 0; sequence < DEPTH; sequence++)
+  {
+    dma_sample_put(level, TRUE);
+    dma_sample_put(((sequence == 2) && (spike != 0)) ? spike : level, TRUE);
+    dma_sample_put(level, TRUE);
+  }
+}
+
+/**
+  * @brief  the voltage monitor supervisor on a stream.
+  */
+static void monitor_test(void)
+{
+  static adc_stream_monitor_type hmon;
+  adc_stream_guard_type guard[2] =
+  {
+    {ADC_CHANNEL_7, 3000, 1000, 100, ADC_STREAM_LEVEL_NORMAL},
+    {ADC_CHANNEL_9, 3500, 500, 50, ADC_STREAM_LEVEL_NORMAL},
+  };
+  adc_stream_excursion_type excursion;
+
+  /* ranks 1 ~ 3: channels 5, 7 and 9 */
+  ADC1->osq1_bit.oclen = SEQUENCE_LENGTH - 1;
+  ADC1->osq3 = ADC_CHANNEL_5 | (ADC_CHANNEL_7 << 5) | (ADC_CHANNEL_9 << 10);
+
+  HOST_CHECK(adc_stream_monitor_init(&hmon, ADC1, guard, 2) == ADC_STREAM_OK);
+  HOST_CHECK((vm_mode == ADC_VMONITOR_SINGLE_ORDINARY) && (vm_channel == ADC_CHANNEL_7));
+  HOST_CHECK((vm_high == 3000) && (vm_low == 1000));
+
+  memset(&hstream, 0, sizeof(hstream));
+  hstream.adcx = ADC1;
+  hstream.monitor = &hmon;
+  HOST_CHECK(adc_stream_init(&hstream, stream_buf, DEPTH) == ADC_STREAM_OK);
+  adc_stream_start(&hstream);
+
+  /* the monitor moves to the next channel on every block */
+  monitor_block_put(2000, 0);
+  HOST_CHECK(vm_channel == ADC_CHANNEL_9);
+  monitor_block_put(2000, 0);
+  HOST_CHECK(vm_channel == ADC_CHANNEL_7);
+
+  /* channel 7 goes high in the third sequence, its interrupt comes when the
+     data register already holds the normal sample of channel 9 */
+  tick_now = 5000;
+  ADC1->odt = 2000;
+  adc_flags |= ADC_VMOR_FLAG;
+  adc_stream_irq_handler(&hstream);
+  HOST_CHECK(hmon.pending == 1);
+  HOST_CHECK(vm_mode == ADC_VMONITOR_NONE);
+  HOST_CHECK(adc_stream_monitor_read(&hmon, &excursion) == 0);
+
+  monitor_block_put(2000, 3400);
+  HOST_CHECK(hmon.pending == 0);
+  HOST_CHECK(hmon.excursion_count == 2);
+  HOST_CHECK(adc_stream_monitor_read(&hmon, &excursion) == 1);
+  HOST_CHECK((excursion.channel == ADC_CHANNEL_7) && (excursion.level == ADC_STREAM_LEVEL_HIGH));
+  HOST_CHECK((excursion.value == 3400) && (excursion.timestamp == 5000));
+  HOST_CHECK(adc_stream_monitor_read(&hmon, &excursion) == 1);
+  HOST_CHECK((excursion.channel == ADC_CHANNEL_7) && (excursion.level == ADC_STREAM_LEVEL_NORMAL));
+  HOST_CHECK(excursion.value == 2000);
+  HOST_CHECK(adc_stream_monitor_read(&hmon, &excursion) == 0);
+
+  /* the checked channel stays normal, the monitor went on to channel 9 */
+  HOST_CHECK(guard[0].level == ADC_STREAM_LEVEL_NORMAL);
+  HOST_CHECK((vm_mode == ADC_VMONITOR_SINGLE_ORDINARY) && (vm_channel == ADC_CHANNEL_9));
+
+  /* channel 9 stays low, its window becomes the way back */
+  tick_now = 9000;
+  adc_flags |= ADC_VMOR_FLAG;
+  adc_stream_irq_handler(&hstream);
+  monitor_block_put(400, 0);
+  HOST_CHECK(guard[1].level == ADC_STREAM_LEVEL_LOW);
+  HOST_CHECK(adc_stream_monitor_read(&hmon, &excursion) == 1);
+  HOST_CHECK((excursion.channel == ADC_CHANNEL_9) && (excursion.level == ADC_STREAM_LEVEL_LOW));
+  HOST_CHECK((excursion.value == 400) && (excursion.timestamp == 9000));
+  monitor_block_put(400, 0);
+  HOST_CHECK(vm_channel == ADC_CHANNEL_9);
+  HOST_CHECK((vm_high == 550) && (vm_low == 0));
+
+  adc_stream_deinit(&hstream);
+  adc_stream_monitor_deinit(&hmon);
+  HOST_CHECK(vm_mode == ADC_VMONITOR_NONE);
+}
+
+int main(void)
+{
+  host_map_init();
+
+  stream_test();
+  oversample_test();
+  monitor_test();
+
+  return host_report("test_adc_stream");
+}
@@ -0,0 +1,459 @@
+/**
+  **************************************************************************
+  * @file     test_can_filter.c
+  * @brief    host test of the can acceptance filter compiler
+  **************************************************************************
+  *
+  * Copyright (c) 2025, Artery Technology, All rights reserved.
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+/* usage: test_can_filter
+
+   the acceptance filter compiler of the can application library
+   (can_filter_compile()) against a model of the acceptance logic: the
+   driver is included with can_filter_set() renamed, the test wraps it to
+   keep the fcid, fcfmt, fmid and fmfmt written for every filter, and a
+   frame passes when an enabled filter matches it on every bit its mask
+   cares for. every standard identifier is offered to the model: no
+   identifier of the list is dropped, the accepted set and false accept
+   rate are the ones the compiler reports, the second stage match keeps
+   exactly the list. extended lists are checked on their identifiers and
+   random ones. the merges are checked block for block against the former
+   search of every pair at every merge, the time of the whole compile and
+   of the former merge alone are printed. */
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define can_filter_set                   can_filter_set_hw
+#include "at32f422_426_can.c"
+#undef can_filter_set
+
+#include "can_application.h"
+#include "host_map.h"
+
+#define FILTER_NUM                       16
+#define BLOCK_SIZE                       1024
+#define HASH_SIZE                        4096
+#define RANGE_MAX                        250
+#define RANDOM_LISTS                     200
+#define EXT_SAMPLES                      1000000
+#define BENCH_LISTS                      6
+
+/* the filter bank as the acceptance logic sees it */
+typedef struct
+{
+  uint32_t fcid;
+  uint32_t fcfmt;
+  uint32_t fmid;
+  uint32_t fmfmt;
+} sim_filter_type;
+
+static sim_filter_type sim_filter[FILTER_NUM];
+
+static can_filter_compile_type hflt;
+static can_filter_block_type block[BLOCK_SIZE];
+static uint32_t hash[HASH_SIZE];
+static can_id_range_type range[RANGE_MAX];
+static can_filter_block_type split[BLOCK_SIZE];
+static can_filter_block_type ref_block[BLOCK_SIZE];
+static uint16_t ref_block_num;
+
+void can_filter_set(can_type* can_x, can_filter_type filter_number, can_filter_config_type* filter_config_struct)
+{
+  can_filter_set_hw(can_x, filter_number, filter_config_struct);
+  sim_filter[filter_number].fcid = can_x->fcid;
+  sim_filter[filter_number].fcfmt = can_x->fcfmt;
+  sim_filter[filter_number].fmid = can_x->fmid;
+  sim_filter[filter_number].fmfmt = can_x->fmfmt;
+}
+
+/**
+  * @brief  the acceptance logic for a data frame, on the filters the compiler owns.
+  * @param  id: identifier of the frame.
+  * @param  id_type: standard or extended.
+  * @retval TRUE when an enabled filter passes it.
+  */
+static confirm_state sim_accept(uint32_t id, can_identifier_type id_type)
+{
+  uint32_t fid = (id_type == CAN_ID_STANDARD) ? (id << 18) : id;
+  uint32_t ffmt = ((uint32_t)id_type << 16) | (uint32_t)(rand() & 0xF);
+  uint32_t i;
+
+  for(i = 0; i < hflt.filter_num; i++)
+  {
+    if(((CAN1->acfctrl_bit.ae_x >> i) & 0x1) &&
+       (((fid ^ sim_filter[i].fcid) & ~sim_filter[i].fmid) == 0) &&
+       (((ffmt ^ sim_filter[i].fcfmt) & ~sim_filter[i].fmfmt) == 0))
+    {
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+/**
+  * @brief  check whether an identifier is in the list.
+  */
+static confirm_state list_has(uint32_t id)
+{
+  uint16_t i;
+
+  for(i = 0; i < hflt.range_num; i++)
+  {
+    if((id >= range[i].id_low) && (id <= range[i].id_high))
+    {
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+/**
+  * @brief  identifiers of a block.
+  */
+static uint32_t ref_span(uint32_t mask, uint32_t id_mask)
+{
+  uint32_t span = 1;
+
+  mask &= id_mask;
+  while(mask != 0)
+  {
+    if(mask & 0x1)
+    {
+      span <<= 1;
+    }
+    mask >>= 1;
+  }
+
+  return span;
+}
+
+/**
+  * @brief  the former merge stage: every pair searched at every merge.
+  * @param  src: blocks split from the ranges.
+  * @param  num: number of blocks.
+  * @param  id_mask: valid identifier bits.
+  */
+static void ref_merge(const can_filter_block_type* src, uint16_t num, uint32_t id_mask)
+{
+  can_filter_block_type merge;
+  uint32_t cost, best_cost;
+  uint16_t i, j, best_i = 0, best_j = 0;
+
+  memcpy(ref_block, src, num * sizeof(can_filter_block_type));
+  ref_block_num = num;
+
+  while(ref_block_num > hflt.filter_num)
+  {
+    best_cost = 0xFFFFFFFF;
+    for(i = 0; i < ref_block_num; i++)
+    {
+      for(j = i + 1; j < ref_block_num; j++)
+      {
+        merge.mask = ref_block[i].mask | ref_block[j].mask | (ref_block[i].code ^ ref_block[j].code);
+        cost = ref_span(merge.mask, id_mask) - ref_span(ref_block[i].mask, id_mask) -
+               ref_span(ref_block[j].mask, id_mask);
+        if((int32_t)cost < 0)
+        {
+          cost = 0;
+        }
+        if(cost < best_cost)
+        {
+          best_cost = cost;
+          best_i = i;
+          best_j = j;
+        }
+      }
+    }
+
+    merge.mask = ref_block[best_i].mask | ref_block[best_j].mask | (ref_block[best_i].code ^ ref_block[best_j].code);
+    merge.code = ref_block[best_i].code & ~merge.mask;
+    ref_block[best_i] = merge;
+    ref_block[best_j] = ref_block[--ref_block_num];
+  }
+}
+
+/**
+  * @brief  random list of single identifiers and ranges.
+  * @param  count: entries.
+  * @param  id_mask: valid identifier bits.
+  */
+static void list_random(uint16_t count, uint32_t id_mask)
+{
+  uint32_t low, width;
+  uint16_t i;
+
+  for(i = 0; i < count; i++)
+  {
+    low = (uint32_t)(((uint32_t)rand() << 8) ^ (uint32_t)rand()) & id_mask;
+    width = ((rand() % 4) == 0) ? (uint32_t)(rand() % 24) : 0;
+    if(low > id_mask - width)
+    {
+      low = id_mask - width;
+    }
+    range[i].id_low = low;
+    range[i].id_high = low + width;
+  }
+  hflt.range_num = count;
+}
+
+/**
+  * @brief  split the ranges into aligned blocks as the compiler's first stage does.
+  * @param  dst: the blocks.
+  * @retval number of blocks.
+  */
+static uint16_t ref_split(can_filter_block_type* dst)
+{
+  uint32_t low, high, size;
+  uint16_t num = 0, i;
+
+  for(i = 0; i < hflt.range_num; i++)
+  {
+    low = range[i].id_low;
+    high = range[i].id_high;
+    while(low <= high)
+    {
+      size = (low == 0) ? 0x20000000 : (low & (~low + 1));
+      while((size - 1) > (high - low))
+      {
+        size >>= 1;
+      }
+      dst[num].code = low;
+      dst[num].mask = size - 1;
+      num++;
+      if((high - low) < size)
+      {
+        break;
+      }
+      low += size;
+    }
+  }
+
+  return num;
+}
+
+/**
+  * @brief  compare the compiler's blocks with the former merge.
+  * @retval TRUE when they are the same blocks in the same order.
+  */
+static confirm_state blocks_same(void)
+{
+  uint16_t i;
+
+  if(hflt.block_num != ref_block_num)
+  {
+    return FALSE;
+  }
+  for(i = 0; i < ref_block_num; i++)
+  {
+    if((block[i].code != ref_block[i].code) || (block[i].mask != ref_block[i].mask))
+    {
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
+/**
+  * @brief  compile the list and compare its blocks with the former merge on the same split.
+  * @param  id_mask: valid identifier bits.
+  * @retval TRUE when they are the same blocks in the same order.
+  */
+static confirm_state merge_same(uint32_t id_mask)
+{
+  ref_merge(split, ref_split(split), id_mask);
+  if(can_filter_compile(&hflt) != CAN_APP_OK)
+  {
+    return FALSE;
+  }
+
+  return blocks_same();
+}
+
+int main(void)
+{
+  uint32_t id, accepted, wanted, false_accept, missed, match_failed, ext_rejected, std_rejected;
+  uint32_t differ, model_ppm, sampled, sampled_false, sampled_uniform, id_mask;
+  uint16_t n, num;
+  clock_t start;
+  double lib_time = 0, ref_time = 0;
+
+  host_map_init();
+  srand(3);
+
+  hflt.canx = CAN1;
+  hflt.id_type = CAN_ID_STANDARD;
+  hflt.range = range;
+  hflt.filter_num = FILTER_NUM;
+  hflt.block = block;
+  hflt.block_size = BLOCK_SIZE;
+  hflt.hash = hash;
+  hflt.hash_size = HASH_SIZE;
+
+  /* parameters */
+  range[0].id_low = 0x100;
+  range[0].id_high = 0x0FF;
+  hflt.range_num = 1;
+  HOST_CHECK(can_filter_compile(&hflt) == CAN_APP_ERR_PARAM);
+  range[0].id_high = 0x800;
+  HOST_CHECK(can_filter_compile(&hflt) == CAN_APP_ERR_PARAM);
+  range[0].id_high = 0x7FF;
+  hflt.filter_num = 17;
+  HOST_CHECK(can_filter_compile(&hflt) == CAN_APP_ERR_PARAM);
+  hflt.filter_num = FILTER_NUM;
+  hflt.hash_size = 3000;
+  HOST_CHECK(can_filter_compile(&hflt) == CAN_APP_ERR_PARAM);
+  hflt.hash_size = HASH_SIZE;
+  hflt.block_size = 2;
+  range[0].id_low = 0x101;
+  range[0].id_high = 0x1FE;
+  HOST_CHECK(can_filter_compile(&hflt) == CAN_APP_ERR_NOMEM);
+  hflt.block_size = BLOCK_SIZE;
+
+  /* a list which fits the filters is passed exactly */
+  range[0].id_low = 0x100;
+  range[0].id_high = 0x13F;
+  range[1].id_low = 0x7E0;
+  range[1].id_high = 0x7E7;
+  range[2].id_low = 0x555;
+  range[2].id_high = 0x555;
+  hflt.range_num = 3;
+  HOST_CHECK(can_filter_compile(&hflt) == CAN_APP_OK);
+  HOST_CHECK((hflt.block_num == 3) && (hflt.accept_count == 73) && (can_filter_false_accept_ppm_get(&hflt) == 0));
+  HOST_CHECK(CAN1->acfctrl_bit.ae_x == 0x0007);
+  missed = 0;
+  false_accept = 0;
+  for(id = 0; id <= 0x7FF; id++)
+  {
+    missed += (list_has(id) == TRUE) && (sim_accept(id, CAN_ID_STANDARD) == FALSE);
+    false_accept += (list_has(id) == FALSE) && (sim_accept(id, CAN_ID_STANDARD) == TRUE);
+  }
+  HOST_CHECK((missed == 0) && (false_accept == 0));
+
+  /* random standard lists, every identifier offered to the model */
+  missed = 0;
+  match_failed = 0;
+  ext_rejected = 0;
+  differ = 0;
+  std_rejected = 0;
+  for(n = 0; n < RANDOM_LISTS; n++)
+  {
+    hflt.id_type = CAN_ID_STANDARD;
+    hflt.filter_num = (uint8_t)(1 + rand() % FILTER_NUM);
+    list_random((uint16_t)(1 + rand() % 120), 0x7FF);
+    differ += (merge_same(0x7FF) == FALSE);
+
+    accepted = 0;
+    wanted = 0;
+    for(id = 0; id <= 0x7FF; id++)
+    {
+      if(sim_accept(id, CAN_ID_STANDARD) == TRUE)
+      {
+        accepted++;
+        wanted += list_has(id);
+        match_failed += (can_filter_match(&hflt, id) == SET) != (list_has(id) == TRUE);
+      }
+      else
+      {
+        missed += list_has(id);
+      }
+      ext_rejected += (sim_accept(id << 18, CAN_ID_EXTENDED) == FALSE);
+    }
+    model_ppm = (uint32_t)(((uint64_t)(accepted - wanted) * 1000000) / accepted);
+    std_rejected += (accepted != hflt.accept_count) || (wanted != hflt.want_count) ||
+                    (model_ppm != can_filter_false_accept_ppm_get(&hflt));
+  }
+  HOST_CHECK(missed == 0);
+  HOST_CHECK(std_rejected == 0);
+  HOST_CHECK(match_failed == 0);
+  HOST_CHECK(ext_rejected == RANDOM_LISTS * 0x800);
+  HOST_CHECK(differ == 0);
+
+  /* an extended list: its identifiers all pass, random ones at the rate the filters span */
+  hflt.id_type = CAN_ID_EXTENDED;
+  hflt.filter_num = FILTER_NUM;
+  list_random(RANGE_MAX, 0xFFFF);
+  for(n = 0; n < hflt.range_num; n++)
+  {
+    /* diagnostic requests of one node, 0x18da0000 and up */
+    range[n].id_low |= 0x18DA0000;
+    range[n].id_high |= 0x18DA0000;
+  }
+  HOST_CHECK(merge_same(0x1FFFFFFF) == TRUE);
+  missed = 0;
+  for(n = 0; n < hflt.range_num; n++)
+  {
+    missed += (sim_accept(range[n].id_low, CAN_ID_EXTENDED) == FALSE) +
+              (sim_accept(range[n].id_high, CAN_ID_EXTENDED) == FALSE) +
+              (sim_accept(range[n].id_low, CAN_ID_STANDARD) == TRUE);
+  }
+  HOST_CHECK(missed == 0);
+  sampled = 0;
+  sampled_false = 0;
+  sampled_uniform = 0;
+  for(id = 0; id < EXT_SAMPLES; id++)
+  {
+    /* half of the traffic near the list, half anywhere */
+    uint32_t x = (uint32_t)(((uint32_t)rand() << 8) ^ (uint32_t)rand()) & ((id & 1) ? 0x1FFFFFFF : 0x0001FFFF);
+    x |= (id & 1) ? 0 : 0x18DA0000;
+    if(sim_accept(x, CAN_ID_EXTENDED) == TRUE)
+    {
+      sampled++;
+      sampled_uniform += (id & 1);
+      sampled_false += (list_has(x) == FALSE);
+      match_failed += (can_filter_match(&hflt, x) == SET) != (list_has(x) == TRUE);
+    }
+  }
+  /* the sum of the filters bounds the accepted share of uniform traffic */
+  HOST_CHECK(((double)sampled_uniform * 2 / EXT_SAMPLES) <= ((double)hflt.accept_count / 0x20000000) + 0.002);
+  HOST_CHECK(match_failed == 0);
+  printf("extended list of %u ranges in %u filters: %u of %u identifiers passed, "
+         "%u of them false, compiler bound %u ppm false accept\n",
+         RANGE_MAX, FILTER_NUM, sampled, EXT_SAMPLES, sampled_false, can_filter_false_accept_ppm_get(&hflt));
+
+  /* the compile time against the former merge alone, standard and extended lists */
+  hflt.filter_num = FILTER_NUM;
+  for(n = 0; n < BENCH_LISTS; n++)
+  {
+    hflt.id_type = (n & 1) ? CAN_ID_EXTENDED : CAN_ID_STANDARD;
+    id_mask = (n & 1) ? 0x1FFFFFFF : 0x7FF;
+    list_random(RANGE_MAX, id_mask);
+
+    start = clock();
+    can_filter_compile(&hflt);
+    lib_time += (double)(clock() - start);
+
+    num = ref_split(split);
+    start = clock();
+    ref_merge(split, num, id_mask);
+    ref_time += (double)(clock() - start);
+
+    differ += (blocks_same() == FALSE);
+  }
+  HOST_CHECK(differ == 0);
+  printf("filter compile of %u ranges into %u filters: %.2f ms, former merge stage alone %.2f ms\n",
+         RANGE_MAX, FILTER_NUM, lib_time * 1000 / CLOCKS_PER_SEC / BENCH_LISTS, ref_time * 1000 / CLOCKS_PER_SEC / BENCH_LISTS);
+
+  return host_report("test_can_filter");
+}
@@ -0,0 +1,391 @@
+/**
+  **************************************************************************
+  * @file     test_can_rxq.c
+  * @brief    host test and benchmark of the can receive queue
+  **************************************************************************
+  *
+  * Copyright (c) 2025, Artery Technology, All rights reserved.
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+/* usage: test_can_rxq
+
+   the receive queue of the can application library (can_application.c) on
+   a simulated can_type: the receive buffer of SIM_RB_SLOTS frames presents
+   its oldest frame in rbid, rbfmt, rbdat and llcsize, as the hardware does.
+   the driver is included with can_rxbuf_read() and can_rxbuf_release()
+   renamed, the test wraps them to move the receive buffer on once RREL is
+   written. it checks every frame format, the ring overflow and high water,
+   and a long random run of arrivals and drains across the index wrap. the
+   benchmark times the queue against can_rxbuf_read() frame by frame and the
+   word payload copy of the driver against the former byte copy. */
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define can_rxbuf_read                   can_rxbuf_read_hw
+#define can_rxbuf_release                can_rxbuf_release_hw
+#include "at32f422_426_can.c"
+#undef can_rxbuf_read
+#undef can_rxbuf_release
+
+#include "can_application.h"
+#include "host_map.h"
+
+#define SIM_RB_SLOTS                     6
+#define RXQ_SLOTS                        16
+#define BENCH_FRAMES                     300000
+
+/* the receive buffer: frames in arrival order, frames lost on a full buffer */
+static can_rxbuf_type sim_rb[SIM_RB_SLOTS];
+static uint8_t sim_rb_first;
+static uint8_t sim_rb_count;
+static uint32_t sim_rb_lost;
+
+static can_rxq_handle_type hrxq;
+static can_rxbuf_type rxq_slot[RXQ_SLOTS];
+
+/**
+  * @brief  present the oldest frame of the receive buffer in the registers.
+  */
+static void sim_rb_present(void)
+{
+  can_rxbuf_type *frame = &sim_rb[sim_rb_first];
+  uint32_t word, len, index;
+
+  if(sim_rb_count == 0)
+  {
+    CAN1->ctrlstat_bit.rstat = CAN_RXBUF_STATUS_EMPTY;
+    return;
+  }
+
+  CAN1->rbid = (frame->id_type == CAN_ID_STANDARD) ? (frame->id << 18) : frame->id;
+  CAN1->rbfmt = (uint32_t)frame->data_length | ((uint32_t)frame->id_type << 16) |
+                ((uint32_t)frame->fd_format << 17) | ((uint32_t)frame->fd_rate_switch << 18) |
+                ((uint32_t)frame->frame_type << 20) | ((uint32_t)frame->kind_error << 24) |
+                ((uint32_t)frame->fd_error_state << 27) | ((uint32_t)frame->recv_frame << 28);
+
+  len = (dlc_to_bytes[frame->data_length] + 3) / 4;
+  for(index = 0; index < len; index++)
+  {
+    memcpy(&word, &frame->data[index * 4], 4);
+    CAN1->rbdat[index] = word;
+  }
+
+  /* the timestamp follows the payload, the cycle time two words later */
+  CAN1->llcsize_bit.llcaot = (uint16_t)((len + 4) * 4);
+  CAN1->rbdat[len] = frame->rx_timestamp;
+  CAN1->rbdat[len + 2] = frame->cycle_time;
+
+  CAN1->ctrlstat_bit.rstat = (sim_rb_count == SIM_RB_SLOTS) ? CAN_RXBUF_STATUS_FULL : CAN_RXBUF_STATUS_LESS;
+}
+
+/**
+  * @brief  a frame received from the bus, lost when the buffer is full.
+  */
+static void sim_rb_arrive(const can_rxbuf_type* frame)
+{
+  if(sim_rb_count == SIM_RB_SLOTS)
+  {
+    sim_rb_lost++;
+    CAN1->ctrlstat_bit.rov = 1;
+    return;
+  }
+
+  sim_rb[(sim_rb_first + sim_rb_count) % SIM_RB_SLOTS] = *frame;
+  sim_rb_count++;
+  sim_rb_present();
+}
+
+/**
+  * @brief  RREL written: the oldest frame leaves the buffer.
+  */
+static void sim_rb_release(void)
+{
+  if(CAN1->ctrlstat_bit.rrel == 0)
+  {
+    return;
+  }
+
+  CAN1->ctrlstat_bit.rrel = 0;
+  CAN1->ctrlstat_bit.rov = 0;
+  sim_rb_first = (sim_rb_first + 1) % SIM_RB_SLOTS;
+  sim_rb_count--;
+  sim_rb_present();
+}
+
+error_status can_rxbuf_read(can_type* can_x, can_rxbuf_type* can_rxbuf_struct)
+{
+  error_status status = can_rxbuf_read_hw(can_x, can_rxbuf_struct);
+
+  sim_rb_release();
+  return status;
+}
+
+error_status can_rxbuf_release(can_type* can_x)
+{
+  error_status status = can_rxbuf_release_hw(can_x);
+
+  sim_rb_release();
+  return status;
+}
+
+/**
+  * @brief  a frame numbered by seq: identifier, format and payload follow it.
+  */
+static void frame_make(can_rxbuf_type* frame, uint32_t seq)
+{
+  uint32_t index;
+
+  memset(frame, 0, sizeof(*frame));
+  frame->id_type = (seq & 1) ? CAN_ID_EXTENDED : CAN_ID_STANDARD;
+  frame->id = (frame->id_type == CAN_ID_STANDARD) ? ((seq * 7) & 0x7FF) : ((seq * 0x9E3779B1U) & 0x1FFFFFFF);
+  frame->data_length = (can_data_length_type)(seq % 16);
+  frame->fd_format = (seq % 16 > 8) ? CAN_FORMAT_FD : (can_format_type)((seq >> 4) & 1);
+  frame->fd_rate_switch = (can_rate_switch_type)((seq >> 5) & frame->fd_format);
+  frame->fd_error_state = (can_error_state_type)((seq >> 6) & 1);
+  frame->frame_type = ((frame->fd_format == CAN_FORMAT_CLASSIC) && ((seq % 23) == 0)) ? CAN_FRAME_REMOTE : CAN_FRAME_DATA;
+  frame->kind_error = (can_error_type)((seq >> 7) & 0x7);
+  frame->recv_frame = (can_recv_frame_type)((seq >> 10) & 1);
+  for(index = 0; index < dlc_to_bytes[frame->data_length]; index++)
+  {
+    frame->data[index] = (uint8_t)(seq + index * 13);
+  }
+  frame->rx_timestamp = seq * 1000 + 7;
+  frame->cycle_time = (uint16_t)(seq * 3);
+}
+
+static confirm_state frame_same(const can_rxbuf_type* a, const can_rxbuf_type* b)
+{
+  return ((a->id == b->id) && (a->id_type == b->id_type) && (a->frame_type == b->frame_type) &&
+          (a->data_length == b->data_length) && (a->fd_format == b->fd_format) &&
+          (a->fd_rate_switch == b->fd_rate_switch) && (a->fd_error_state == b->fd_error_state) &&
+          (a->kind_error == b->kind_error) && (a->recv_frame == b->recv_frame) &&
+          (a->rx_timestamp == b->rx_timestamp) && (a->cycle_time == b->cycle_time) &&
+          (memcmp(a->data, b->data, dlc_to_bytes[a->data_length]) == 0)) ? TRUE : FALSE;
+}
+
+static double time_now(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/**
+  * @brief  the payload copy of can_rxbuf_read() before the word copy.
+  */
+static void copy_bytes(uint8_t* wp, uint8_t len)
+{
+  uint32_t* rp = (uint32_t*)CAN1->rbdat;
+  uint8_t byte_cnt;
+
+  for(byte_cnt = 0; byte_cnt < len; byte_cnt += 4U)
+  {
+    wp[byte_cnt] = *rp & 0xFF;
+    wp[byte_cnt+1U] = (*rp >> 8U) & 0xFF;
+    wp[byte_cnt+2U] = (*rp >> 16U) & 0xFF;
+    wp[byte_cnt+3U] = (*rp >> 24U) & 0xFF;
+    rp++;
+  }
+}
+
+static void copy_words(uint8_t* wp, uint8_t len)
+{
+  __IO uint32_t* rp = CAN1->rbdat;
+  uint8_t byte_cnt;
+
+  for(byte_cnt = 0; byte_cnt < len; byte_cnt += 4U)
+  {
+    __UNALIGNED_UINT32_WRITE(&wp[byte_cnt], *rp++);
+  }
+}
+
+/**
+  * @brief  frames of one dlc through the queue in bursts of the receive
+  *         buffer size, or frame by frame with can_rxbuf_read(), returns the
+  *         nanoseconds per frame.
+  */
+static double bench_queue(uint8_t dlc, confirm_state queue)
+{
+  can_rxbuf_type frame, out[SIM_RB_SLOTS];
+  uint32_t sent, index;
+  double start;
+
+  frame_make(&frame, dlc);
+  start = time_now();
+  for(sent = 0; sent < BENCH_FRAMES; sent += SIM_RB_SLOTS)
+  {
+    for(index = 0; index < SIM_RB_SLOTS; index++)
+    {
+      sim_rb_arrive(&frame);
+    }
+
+    if(queue == TRUE)
+    {
+      can_rxq_irq_handler(&hrxq);
+      can_rxq_drain(&hrxq, out, SIM_RB_SLOTS);
+    }
+    else
+    {
+      index = 0;
+      while(can_rxbuf_read(CAN1, &out[index]) == SUCCESS)
+      {
+        index++;
+      }
+    }
+  }
+
+  return (time_now() - start) * 1e9 / sent;
+}
+
+static double bench_copy(confirm_state words)
+{
+  static uint8_t data[4 + 64];
+  volatile uint8_t sink = 0;
+  uint32_t round;
+  double start;
+
+  start = time_now();
+  for(round = 0; round < BENCH_FRAMES; round++)
+  {
+    /* an odd destination, as the data field may be */
+    if(words == TRUE)
+    {
+      copy_words(&data[1 + (round & 2)], 64);
+    }
+    else
+    {
+      copy_bytes(&data[1 + (round & 2)], 64);
+    }
+    sink += data[5];
+  }
+
+  return (time_now() - start) * 1e9 / BENCH_FRAMES;
+}
+
+int main(void)
+{
+  can_rxbuf_type frame, out[RXQ_SLOTS * 2], expect;
+  uint32_t seq, next, received, failed, burst, index, count;
+  confirm_state wrapped;
+  double queue_ns[2], read_ns[2];
+
+  host_map_init();
+  srand(5);
+
+  hrxq.canx = CAN1;
+  HOST_CHECK(can_rxq_init(&hrxq, rxq_slot, 0) == CAN_APP_ERR_PARAM);
+  HOST_CHECK(can_rxq_init(&hrxq, rxq_slot, 12) == CAN_APP_ERR_PARAM);
+  HOST_CHECK(can_rxq_init(&hrxq, rxq_slot, RXQ_SLOTS) == CAN_APP_OK);
+
+  /* an empty receive buffer, nothing stored */
+  HOST_CHECK((can_rxq_irq_handler(&hrxq) == 0) && (can_rxq_drain(&hrxq, out, RXQ_SLOTS) == 0));
+
+  /* every dlc, identifier type, format and flag goes through unchanged */
+  failed = 0;
+  for(seq = 0; seq < 2048; seq++)
+  {
+    frame_make(&frame, seq);
+    sim_rb_arrive(&frame);
+    count = can_rxq_irq_handler(&hrxq);
+    failed += (count != 1) || (can_rxq_drain(&hrxq, out, RXQ_SLOTS) != 1) || (frame_same(&out[0], &frame) != TRUE);
+  }
+  HOST_CHECK(failed == 0);
+  HOST_CHECK((sim_rb_count == 0) && (CAN1->ctrlstat_bit.rstat == CAN_RXBUF_STATUS_EMPTY));
+
+  /* a full ring: the frames beyond it are released and counted, the buffer
+     is empty after the interrupt */
+  HOST_CHECK(can_rxq_init(&hrxq, rxq_slot, 8) == CAN_APP_OK);
+  for(seq = 0; seq < 6; seq++)
+  {
+    frame_make(&frame, seq);
+    sim_rb_arrive(&frame);
+  }
+  HOST_CHECK(can_rxq_irq_handler(&hrxq) == 6);
+  for(seq = 6; seq < 12; seq++)
+  {
+    frame_make(&frame, seq);
+    sim_rb_arrive(&frame);
+  }
+  HOST_CHECK(can_rxq_irq_handler(&hrxq) == 2);
+  HOST_CHECK((hrxq.overflow_count == 4) && (hrxq.high_water == 8) && (sim_rb_count == 0));
+  HOST_CHECK(can_rxq_drain(&hrxq, out, 3) == 3);
+  frame_make(&expect, 2);
+  HOST_CHECK(frame_same(&out[2], &expect) == TRUE);
+  HOST_CHECK(can_rxq_drain(&hrxq, out, RXQ_SLOTS) == 5);
+  frame_make(&expect, 7);
+  HOST_CHECK(frame_same(&out[4], &expect) == TRUE);
+
+  /* random bursts and drains past the wrap of the 16 bit indexes: frames
+     come out in order, each one received, dropped by the ring or lost by a
+     full receive buffer */
+  HOST_CHECK(can_rxq_init(&hrxq, rxq_slot, RXQ_SLOTS) == CAN_APP_OK);
+  sim_rb_lost = 0;
+  next = 0;
+  received = 0;
+  failed = 0;
+  wrapped = FALSE;
+  for(seq = 0; seq < 200000;)
+  {
+    burst = 1 + rand() % 8;
+    for(index = 0; index < burst; index++, seq++)
+    {
+      frame_make(&frame, seq);
+      sim_rb_arrive(&frame);
+    }
+    can_rxq_irq_handler(&hrxq);
+    wrapped = (hrxq.head < hrxq.tail) ? TRUE : wrapped;
+
+    if((rand() % 3) != 0)
+    {
+      count = can_rxq_drain(&hrxq, out, 1 + rand() % (RXQ_SLOTS * 2));
+      for(index = 0; index < count; index++)
+      {
+        /* the sequence number is in the timestamp */
+        failed += (out[index].rx_timestamp - 7) / 1000 < next;
+        next = (out[index].rx_timestamp - 7) / 1000 + 1;
+        frame_make(&expect, next - 1);
+        failed += (frame_same(&out[index], &expect) != TRUE);
+      }
+      received += count;
+    }
+  }
+  received += can_rxq_drain(&hrxq, out, RXQ_SLOTS * 2);
+  HOST_CHECK(failed == 0);
+  HOST_CHECK(received + hrxq.overflow_count + sim_rb_lost == seq);
+  HOST_CHECK((hrxq.overflow_count != 0) && (sim_rb_lost != 0) && (wrapped == TRUE));
+  HOST_CHECK(hrxq.high_water == RXQ_SLOTS);
+
+  /* benchmark, classic 8 bytes and can-fd 64 bytes */
+  HOST_CHECK(can_rxq_init(&hrxq, rxq_slot, RXQ_SLOTS) == CAN_APP_OK);
+  queue_ns[0] = bench_queue(8, TRUE);
+  queue_ns[1] = bench_queue(15, TRUE);
+  read_ns[0] = bench_queue(8, FALSE);
+  read_ns[1] = bench_queue(15, FALSE);
+  HOST_CHECK(hrxq.overflow_count == 0);
+
+  printf("can receive, host ns per frame, %u frames in bursts of %u\n", BENCH_FRAMES, SIM_RB_SLOTS);
+  printf("  8 bytes:  queue and drain %.1f, can_rxbuf_read %.1f\n", queue_ns[0], read_ns[0]);
+  printf("  64 bytes: queue and drain %.1f, can_rxbuf_read %.1f\n", queue_ns[1], read_ns[1]);
+  printf("  64 byte payload copy: words %.1f, bytes %.1f\n", bench_copy(TRUE), bench_copy(FALSE));
+
+  return host_report("test_can_rxq");
+}
@@ -0,0 +1,194 @@
+/**
+  **************************************************************************
+  * @file     test_can_tts.c
+  * @brief    host test of the ttcan schedule validator
+  **************************************************************************
+  *
+  * Copyright (c) 2025, Artery Technology, All rights reserved.
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+/* usage: test_can_tts
+
+   can_tts_validate() of the can application library on hand made
+   schedules: disjoint windows, windows overlapping in the cycle and past
+   its end into the next one, a slot reloaded while the window of an entry
+   before the previous trigger is still open, entries of different basic
+   cycles sharing a time or a slot, the order errors and the bus
+   utilization. */
+
+#include <string.h>
+#include "can_application.h"
+#include "host_map.h"
+
+#define CYCLE_TIME                       1000
+
+static can_tts_handle_type htts;
+static can_tts_entry_type entry[8];
+static can_tts_report_type report;
+static can_txbuf_type frame;
+
+/**
+  * @brief  a transmit entry of a reserved duration.
+  */
+static void entry_set(uint8_t index, uint16_t trigger_time, can_ttcan_txbuf_type slot, uint16_t duration)
+{
+  memset(&entry[index], 0, sizeof(entry[index]));
+  entry[index].trigger_time = trigger_time;
+  entry[index].trigger_type = CAN_TTCAN_TRIGGER_SINGLE_TRANSMIT;
+  entry[index].txbuf_number = slot;
+  entry[index].repeat_mask = CAN_TTS_REPEAT_1;
+  entry[index].duration = duration;
+  entry[index].frame = &frame;
+}
+
+/**
+  * @brief  a time trigger, no window and no slot.
+  */
+static void entry_time_set(uint8_t index, uint16_t trigger_time)
+{
+  memset(&entry[index], 0, sizeof(entry[index]));
+  entry[index].trigger_time = trigger_time;
+  entry[index].trigger_type = CAN_TTCAN_TRIGGER_TIME;
+  entry[index].repeat_mask = CAN_TTS_REPEAT_1;
+}
+
+static can_app_status_type validate(uint8_t entry_num)
+{
+  htts.entry_num = entry_num;
+  return can_tts_validate(&htts, &report);
+}
+
+int main(void)
+{
+  host_map_init();
+
+  memset(&frame, 0, sizeof(frame));
+  frame.id_type = CAN_ID_STANDARD;
+  frame.frame_type = CAN_FRAME_DATA;
+  frame.data_length = CAN_DLC_BYTES_8;
+
+  htts.cycle_time = CYCLE_TIME;
+  htts.watch_time = CYCLE_TIME * 2;
+  htts.timer_div = CAN_TTCAN_TIMER_DIV_1;
+  htts.entry = entry;
+
+  /* disjoint windows on their own slots, 200 of 1000 ticks reserved */
+  entry_set(0, 100, CAN_TTCAN_TXBUF_NUM_0, 100);
+  entry_set(1, 400, CAN_TTCAN_TXBUF_NUM_1, 100);
+  HOST_CHECK((validate(2) == CAN_APP_OK) && (report.conflict_num == 0));
+  HOST_CHECK((report.busy_ticks == 64 * 200) && (report.utilization == 200));
+
+  /* the duration of a frame is computed when not given */
+  entry[1].duration = 0;
+  HOST_CHECK((validate(2) == CAN_APP_OK) && (report.busy_ticks == 64 * (100 + can_tts_frame_ticks(&frame, CAN_TTCAN_TIMER_DIV_1))));
+
+  /* windows overlapping in the cycle, once in each of the 64 cycles. the
+     time trigger keeps the slot of entry 0 from being loaded in its window */
+  entry_set(1, 150, CAN_TTCAN_TXBUF_NUM_1, 100);
+  entry_time_set(2, 600);
+  HOST_CHECK((validate(3) == CAN_APP_ERR_PARAM) && (report.conflict_num == 64));
+  HOST_CHECK((report.conflict_first == 0) && (report.conflict_second == 1));
+
+  /* without it the next frame of entry 0 is loaded at the trigger of entry 1 */
+  HOST_CHECK((validate(2) == CAN_APP_ERR_PARAM) && (report.conflict_num == 128));
+
+  /* the transmit window counts with the frame */
+  entry_set(1, 205, CAN_TTCAN_TXBUF_NUM_1, 100);
+  entry[0].window_ticks = 4;
+  HOST_CHECK(validate(3) == CAN_APP_OK);
+  entry[0].window_ticks = 5;
+  HOST_CHECK(validate(3) == CAN_APP_OK);
+  entry[0].window_ticks = 6;
+  HOST_CHECK(validate(3) == CAN_APP_ERR_PARAM);
+
+  /* the last window runs past the cycle end into the first of the next
+     cycle, and of the last cycle into the first one */
+  entry_set(0, 10, CAN_TTCAN_TXBUF_NUM_0, 20);
+  entry_time_set(1, 600);
+  entry_set(2, 980, CAN_TTCAN_TXBUF_NUM_1, 50);
+  HOST_CHECK((validate(3) == CAN_APP_ERR_PARAM) && (report.conflict_num == 64));
+  HOST_CHECK((report.conflict_first == 2) && (report.conflict_second == 0));
+  entry[2].duration = 30;
+  HOST_CHECK(validate(3) == CAN_APP_OK);
+
+  /* slot 0 reloaded for entry 2 at the time trigger of entry 1, before the
+     window of entry 0 ends: not adjacent, still a conflict */
+  entry_set(0, 0, CAN_TTCAN_TXBUF_NUM_0, 150);
+  entry_time_set(1, 100);
+  entry_set(2, 200, CAN_TTCAN_TXBUF_NUM_0, 50);
+  entry_time_set(3, 300);
+  HOST_CHECK((validate(4) == CAN_APP_ERR_PARAM) && (report.conflict_num == 64));
+  HOST_CHECK((report.conflict_first == 0) && (report.conflict_second == 2));
+  entry[1].trigger_time = 160;
+  HOST_CHECK(validate(4) == CAN_APP_OK);
+
+  /* an entry without a frame sends what is in the slot, no reload */
+  entry[1].trigger_time = 100;
+  entry[2].frame = 0;
+  HOST_CHECK(validate(4) == CAN_APP_OK);
+
+  /* one entry reloading its own slot at its own trigger */
+  entry_set(0, 0, CAN_TTCAN_TXBUF_NUM_0, 150);
+  HOST_CHECK((validate(1) == CAN_APP_ERR_PARAM) && (report.conflict_first == 0) && (report.conflict_second == 0));
+
+  /* the same time in alternate cycles: the windows never meet, the slot of
+     the second is loaded at the time trigger between them */
+  entry_set(0, 100, CAN_TTCAN_TXBUF_NUM_0, 100);
+  entry[0].repeat_mask = CAN_TTS_REPEAT_2;
+  entry_set(1, 100, CAN_TTCAN_TXBUF_NUM_0, 100);
+  entry[1].repeat_mask = CAN_TTS_REPEAT_2;
+  entry[1].cycle_offset = 1;
+  entry_time_set(2, 500);
+  HOST_CHECK((validate(3) == CAN_APP_OK) && (report.utilization == 100));
+
+  /* one window in 8 cycles near the cycle end, running into an entry of
+     its next cycle only: 8 conflicts */
+  entry_set(0, 10, CAN_TTCAN_TXBUF_NUM_1, 20);
+  entry[0].repeat_mask = CAN_TTS_REPEAT_8;
+  entry[0].cycle_offset = 3;
+  entry_time_set(1, 500);
+  entry_set(2, 990, CAN_TTCAN_TXBUF_NUM_0, 30);
+  entry[2].repeat_mask = CAN_TTS_REPEAT_8;
+  entry[2].cycle_offset = 2;
+  HOST_CHECK((validate(3) == CAN_APP_ERR_PARAM) && (report.conflict_num == 8));
+  entry[2].cycle_offset = 3;
+  HOST_CHECK(validate(3) == CAN_APP_OK);
+
+  /* order errors */
+  entry_set(0, 400, CAN_TTCAN_TXBUF_NUM_0, 10);
+  entry_set(1, 100, CAN_TTCAN_TXBUF_NUM_1, 10);
+  HOST_CHECK((validate(2) == CAN_APP_ERR_PARAM) && (report.order_error == 1));
+  entry_set(0, 100, CAN_TTCAN_TXBUF_NUM_0, 10);
+  entry_set(1, CYCLE_TIME, CAN_TTCAN_TXBUF_NUM_1, 10);
+  HOST_CHECK((validate(2) == CAN_APP_ERR_PARAM) && (report.order_error == 1));
+  entry_set(1, 400, (can_ttcan_txbuf_type)CAN_TTS_TXBUF_SLOTS, 10);
+  HOST_CHECK((validate(2) == CAN_APP_ERR_PARAM) && (report.order_error == 1));
+  entry_set(1, 400, CAN_TTCAN_TXBUF_NUM_1, 10);
+  entry[1].repeat_mask = CAN_TTS_REPEAT_4;
+  entry[1].cycle_offset = 4;
+  HOST_CHECK((validate(2) == CAN_APP_ERR_PARAM) && (report.order_error == 1));
+  entry[1].cycle_offset = 3;
+  htts.watch_time = CYCLE_TIME;
+  HOST_CHECK((validate(2) == CAN_APP_ERR_PARAM) && (report.order_error == 1));
+  htts.watch_time = CYCLE_TIME * 2;
+  entry_time_set(2, 600);
+  HOST_CHECK((validate(3) == CAN_APP_OK) && (report.order_error == 0));
+
+  return host_report("test_can_tts");
+}
@@ -0,0 +1,318 @@
+/**
+  **************************************************************************
+  * @file     test_capture.c
+  * @brief    host test of the capture application library
+  **************************************************************************
+  *
+  * Copyright (c) 2025, Artery Technology, All rights reserved.
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+/* usage: test_capture
+
+   synthetic edge streams, the 16-bit timer counts of both edges of a pulse
+   train, are written to the capture ring the way the loop mode dma does and
+   the half and full transfer callbacks of the dma handle are called as the
+   dma interrupt would. capture_application.c measures them block by block.
+   the timer, gpio and dma application functions are fakes keeping their
+   state in this file. */
+
+#include <math.h>
+#include <string.h>
+#include "capture_application.h"
+#include "host_map.h"
+
+#define CLOCK                    72000000
+#define BLOCK                    16
+
+/* fake timer and input pin */
+static uint32_t tmr_flags = 0;
+static confirm_state channel_on = FALSE;
+static uint32_t dma_requests = 0;
+static flag_status pin_level = RESET;
+
+/* fake dma application */
+static confirm_state dma_busy = FALSE;
+static uint32_t dma_start_count = 0;
+
+/* signal generator, the time of the last edge and the level after it */
+static uint32_t sig_time = 0;
+static uint8_t sig_level = 0;
+static uint32_t sig_edges = 0;
+
+static capture_handle_type hcap;
+static uint16_t capture_buf[BLOCK * 2];
+
+flag_status tmr_flag_get(tmr_type *tmr_x, uint32_t tmr_flag)
+{
+  return (tmr_flags & tmr_flag) ? SET : RESET;
+}
+
+void tmr_flag_clear(tmr_type *tmr_x, uint32_t tmr_flag)
+{
+  tmr_flags &= ~tmr_flag;
+}
+
+void tmr_channel_enable(tmr_type *tmr_x, tmr_channel_select_type tmr_channel, confirm_state new_state)
+{
+  channel_on = new_state;
+}
+
+void tmr_input_channel_init(tmr_type *tmr_x, tmr_input_config_type *input_struct, tmr_channel_input_divider_type divider_factor)
+{
+}
+
+void tmr_dma_request_enable(tmr_type *tmr_x, tmr_dma_request_type dma_request, confirm_state new_state)
+{
+  if(new_state == TRUE)
+  {
+    dma_requests |= dma_request;
+  }
+  else
+  {
+    dma_requests &= ~(uint32_t)dma_request;
+  }
+}
+
+flag_status gpio_input_data_bit_read(gpio_type *gpio_x, uint16_t pins)
+{
+  return pin_level;
+}
+
+dma_app_status_type dma_channel_alloc(dma_handle_type* hdma, dma_request_type request)
+{
+  if(dma_busy == TRUE)
+  {
+    return DMA_APP_ERR_BUSY;
+  }
+
+  hdma->request = request;
+  hdma->channel = DMA1_CHANNEL2;
+  hdma->channel_index = 2;
+  return DMA_APP_OK;
+}
+
+void dma_channel_free(dma_handle_type* hdma)
+{
+}
+
+void dma_default_para_init(dma_init_type* dma_init_struct)
+{
+  memset(dma_init_struct, 0, sizeof(dma_init_type));
+}
+
+void dma_desc_build(dma_desc_type* desc, dma_init_type* dma_init_struct)
+{
+  desc->ctrl = (dma_init_struct->loop_mode_enable == TRUE) ? 0x20 : 0;
+  desc->dtcnt = dma_init_struct->buffer_size;
+  desc->paddr = dma_init_struct->peripheral_base_addr;
+  desc->maddr = dma_init_struct->memory_base_addr;
+  desc->next = 0;
+}
+
+dma_app_status_type dma_chain_start(dma_handle_type* hdma, dma_desc_type* desc)
+{
+  hdma->desc = desc;
+  hdma->channel->dtcnt = desc->dtcnt;
+  hdma->busy = 1;
+  dma_start_count++;
+  return DMA_APP_OK;
+}
+
+void dma_chain_stop(dma_handle_type* hdma)
+{
+  hdma->busy = 0;
+}
+
+/**
+  * @brief  one edge captured and copied to the ring by the dma, the transfer
+  *         interrupts are taken right away when irq is set.
+  */
+static void edge_put(uint16_t timestamp, confirm_state irq)
+{
+  dma_channel_type *channel = hcap.dma.channel;
+  uint16_t total = hcap.block * 2;
+  uint16_t pos = total - (uint16_t)channel->dtcnt;
+
+  if((channel_on == FALSE) || (hcap.dma.busy == 0))
+  {
+    return;
+  }
+
+  capture_buf[pos] = timestamp;
+
+  if(--channel->dtcnt == 0)
+  {
+    channel->dtcnt = total;
+    if(irq == TRUE)
+    {
+      hcap.dma.full_callback(&hcap.dma, hcap.dma.desc);
+    }
+  }
+  else if((pos + 1 == hcap.block) && (irq == TRUE))
+  {
+    hcap.dma.half_callback(&hcap.dma, hcap.dma.desc);
+  }
+}
+
+/**
+  * @brief  pulse train edges, the low time alternates between low_a and low_b
+  *         to make a period jitter. the input pin follows the signal.
+  */
+static void signal_run(uint32_t high, uint32_t low_a, uint32_t low_b, uint32_t edges, confirm_state irq)
+{
+  while(edges--)
+  {
+    if(sig_level)
+    {
+      sig_time += high;
+    }
+    else
+    {
+      sig_time += (sig_edges & 2) ? low_b : low_a;
+    }
+    sig_level ^= 1;
+    sig_edges++;
+    pin_level = sig_level ? SET : RESET;
+    edge_put((uint16_t)sig_time, irq);
+  }
+}
+
+/**
+  * @brief  meter on channel 1 of tmr3, the signal at the given level.
+  */
+static void meter_start(uint8_t level, gpio_type* gpio)
+{
+  memset(&hcap, 0, sizeof(hcap));
+  hcap.tmrx = TMR3;
+  hcap.channel = TMR_SELECT_CHANNEL_1;
+  hcap.clock = CLOCK;
+  hcap.gpio = gpio;
+  hcap.pin = GPIO_PINS_6;
+  HOST_CHECK(capture_init(&hcap, capture_buf, BLOCK) == CAPTURE_OK);
+  HOST_CHECK(hcap.desc.paddr == (uint32_t)(uintptr_t)&TMR3->c1dt);
+
+  /* the counter is far from 0, the timestamps wrap within the test */
+  sig_time = 0xFF00;
+  sig_level = level;
+  sig_edges = 0;
+  pin_level = level ? SET : RESET;
+  capture_start(&hcap);
+  HOST_CHECK((channel_on == TRUE) && (dma_requests & TMR_C1_DMA_REQUEST));
+}
+
+/**
+  * @brief  compare two floats to a relative precision.
+  */
+static int near(float value, float expect)
+{
+  return fabsf(value - expect) <= fabsf(expect) * 1e-5f;
+}
+
+int main(void)
+{
+  capture_result_type result;
+  uint32_t starts;
+
+  host_map_init();
+
+  /* parameters: a complementary channel, channel 2 of tmr3 without dma, a
+     short block, no clock */
+  memset(&hcap, 0, sizeof(hcap));
+  hcap.tmrx = TMR3;
+  hcap.clock = CLOCK;
+  hcap.channel = TMR_SELECT_CHANNEL_1C;
+  HOST_CHECK(capture_init(&hcap, capture_buf, BLOCK) == CAPTURE_ERR_PARAM);
+  hcap.channel = TMR_SELECT_CHANNEL_2;
+  HOST_CHECK(capture_init(&hcap, capture_buf, BLOCK) == CAPTURE_ERR_PARAM);
+  hcap.channel = TMR_SELECT_CHANNEL_1;
+  HOST_CHECK(capture_init(&hcap, capture_buf, 1) == CAPTURE_ERR_PARAM);
+  hcap.clock = 0;
+  HOST_CHECK(capture_init(&hcap, capture_buf, BLOCK) == CAPTURE_ERR_PARAM);
+  hcap.clock = CLOCK;
+  dma_busy = TRUE;
+  HOST_CHECK(capture_init(&hcap, capture_buf, BLOCK) == CAPTURE_ERR_BUSY);
+  dma_busy = FALSE;
+
+  /* 100 khz, 25 % duty, from a low input: the first block has 7 periods as
+     its first edge only starts, the next ones 8 */
+  meter_start(0, GPIOA);
+  signal_run(180, 540, 540, BLOCK, TRUE);
+  capture_result_get(&hcap, &result);
+  HOST_CHECK((result.update == 1) && (result.periods == 7));
+  signal_run(180, 540, 540, BLOCK * 10, TRUE);
+  capture_result_get(&hcap, &result);
+  HOST_CHECK((result.update == 11) && (result.periods == 8));
+  HOST_CHECK(near(result.frequency, 100000.0f));
+  HOST_CHECK(near(result.duty, 0.25f));
+  HOST_CHECK(result.jitter == 0);
+  HOST_CHECK((result.period_min == 720) && (result.period_max == 720));
+  HOST_CHECK((hcap.lost_count == 0) && (hcap.overrun_count == 0));
+  capture_deinit(&hcap);
+  HOST_CHECK((channel_on == FALSE) && (dma_requests == 0));
+
+  /* periods of 700 and 740 counts, a standard deviation of 20 counts */
+  meter_start(0, GPIOA);
+  signal_run(180, 520, 560, BLOCK * 4, TRUE);
+  capture_result_get(&hcap, &result);
+  HOST_CHECK(result.periods == 8);
+  HOST_CHECK(near(result.frequency, 100000.0f));
+  HOST_CHECK((result.period_min == 700) && (result.period_max == 740));
+  HOST_CHECK(near(result.jitter, 20.0f / CLOCK));
+  HOST_CHECK(near(result.duty, 0.25f));
+  capture_deinit(&hcap);
+
+  /* a high input at the start, its first edge is falling */
+  meter_start(1, GPIOA);
+  signal_run(180, 540, 540, BLOCK * 2, TRUE);
+  capture_result_get(&hcap, &result);
+  HOST_CHECK(near(result.duty, 0.25f));
+  capture_deinit(&hcap);
+
+  /* without the pin the first edge is taken as rising, the duty of a signal
+     starting high is the one of its low time */
+  meter_start(1, 0);
+  signal_run(180, 540, 540, BLOCK * 2, TRUE);
+  capture_result_get(&hcap, &result);
+  HOST_CHECK(near(result.duty, 0.75f));
+  HOST_CHECK(near(result.frequency, 100000.0f));
+  capture_deinit(&hcap);
+
+  /* an edge lost by the dma sets the recapture flag, the meter starts again
+     at the input level and measures right after */
+  meter_start(0, GPIOA);
+  signal_run(180, 540, 540, BLOCK - 1, TRUE);
+  tmr_flags |= TMR_C1_RECAPTURE_FLAG;
+  sig_time += 720;
+  starts = dma_start_count;
+  signal_run(180, 540, 540, 1, TRUE);
+  HOST_CHECK(hcap.lost_count == 1);
+  HOST_CHECK(dma_start_count == starts + 1);
+  HOST_CHECK((tmr_flags & TMR_C1_RECAPTURE_FLAG) == 0);
+  signal_run(180, 540, 540, BLOCK * 2, TRUE);
+  capture_result_get(&hcap, &result);
+  HOST_CHECK(near(result.duty, 0.25f) && near(result.frequency, 100000.0f));
+
+  /* the interrupt of a block taken after the dma wrapped into it again */
+  signal_run(180, 540, 540, BLOCK * 2 + 1, FALSE);
+  hcap.dma.half_callback(&hcap.dma, hcap.dma.desc);
+  HOST_CHECK(hcap.overrun_count == 1);
+  capture_deinit(&hcap);
+
+  return host_report("test_capture");
+}
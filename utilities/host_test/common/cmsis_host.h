@@ -0,0 +1,215 @@
+/**
+  **************************************************************************
+  * @file     cmsis_host.h
+  * @brief    cmsis compiler layer for host builds of the library code
+  **************************************************************************
+  *
+  * Copyright (c) 2025, Artery Technology, All rights reserved.
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+/* force included ahead of every source by the host test makefile. it takes
+   the include guard of cmsis_compiler.h, so core_cm4.h and the device header
+   build unchanged on the host with these definitions instead of the arm ones.
+   the intrinsics are plain c with the arm semantics, the cpu state ones only
+   keep a software primask. */
+
+#ifndef __CMSIS_HOST_H
+#define __CMSIS_HOST_H
+
+#define __CMSIS_COMPILER_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define __ASM                                  __asm
+#define __INLINE                               inline
+#define __STATIC_INLINE                        static inline
+#define __STATIC_FORCEINLINE                   __attribute__((always_inline)) static inline
+#define __NO_RETURN                            __attribute__((__noreturn__))
+#define __USED                                 __attribute__((used))
+#define __WEAK                                 __attribute__((weak))
+#define __PACKED                               __attribute__((packed, aligned(1)))
+#define __PACKED_STRUCT                        struct __attribute__((packed, aligned(1)))
+#define __PACKED_UNION                         union __attribute__((packed, aligned(1)))
+#define __ALIGNED(x)                           __attribute__((aligned(x)))
+#define __RESTRICT                             __restrict
+#define __COMPILER_BARRIER()                   __ASM volatile("":::"memory")
+
+#define __UNALIGNED_UINT16_READ(addr)          (*(const uint16_t __attribute__((aligned(1))) *)(const void *)(addr))
+#define __UNALIGNED_UINT16_WRITE(addr, val)    (void)(*(uint16_t __attribute__((aligned(1))) *)(void *)(addr) = (val))
+#define __UNALIGNED_UINT32_READ(addr)          (*(const uint32_t __attribute__((aligned(1))) *)(const void *)(addr))
+#define __UNALIGNED_UINT32_WRITE(addr, val)    (void)(*(uint32_t __attribute__((aligned(1))) *)(void *)(addr) = (val))
+#define __UNALIGNED_UINT32(x)                  (*(uint32_t __attribute__((aligned(1))) *)(void *)(x))
+
+/* software primask, 1 while interrupts are masked */
+extern uint32_t host_primask;
+
+__STATIC_FORCEINLINE void __enable_irq(void)                 { host_primask = 0; }
+__STATIC_FORCEINLINE void __disable_irq(void)                { host_primask = 1; }
+__STATIC_FORCEINLINE uint32_t __get_PRIMASK(void)            { return host_primask; }
+__STATIC_FORCEINLINE void __set_PRIMASK(uint32_t primask)    { host_primask = primask & 1; }
+__STATIC_FORCEINLINE uint32_t __get_BASEPRI(void)            { return 0; }
+__STATIC_FORCEINLINE void __set_BASEPRI(uint32_t basepri)    { (void)basepri; }
+__STATIC_FORCEINLINE void __set_MSP(uint32_t top)            { (void)top; }
+__STATIC_FORCEINLINE uint32_t __get_MSP(void)                { return 0; }
+__STATIC_FORCEINLINE uint32_t __get_FPSCR(void)              { return 0; }
+__STATIC_FORCEINLINE void __set_FPSCR(uint32_t fpscr)        { (void)fpscr; }
+
+#define __NOP()                                __COMPILER_BARRIER()
+#define __WFI()                                __COMPILER_BARRIER()
+#define __WFE()                                __COMPILER_BARRIER()
+#define __SEV()                                __COMPILER_BARRIER()
+#define __ISB()                                __sync_synchronize()
+#define __DSB()                                __sync_synchronize()
+#define __DMB()                                __sync_synchronize()
+
+__STATIC_FORCEINLINE uint32_t __REV(uint32_t value)
+{
+  return __builtin_bswap32(value);
+}
+
+__STATIC_FORCEINLINE uint32_t __REV16(uint32_t value)
+{
+  return ((value & 0xFF00FF00U) >> 8) | ((value & 0x00FF00FFU) << 8);
+}
+
+__STATIC_FORCEINLINE int16_t __REVSH(int16_t value)
+{
+  return (int16_t)__builtin_bswap16((uint16_t)value);
+}
+
+__STATIC_FORCEINLINE uint32_t __ROR(uint32_t op1, uint32_t op2)
+{
+  op2 %= 32U;
+  return (op2 == 0U) ? op1 : ((op1 >> op2) | (op1 << (32U - op2)));
+}
+
+__STATIC_FORCEINLINE uint32_t __RBIT(uint32_t value)
+{
+  uint32_t result = 0;
+  uint32_t i;
+
+  for(i = 0; i < 32; i++)
+  {
+    result = (result << 1) | ((value >> i) & 1U);
+  }
+  return result;
+}
+
+__STATIC_FORCEINLINE uint8_t __CLZ(uint32_t value)
+{
+  return (value == 0U) ? 32U : (uint8_t)__builtin_clz(value);
+}
+
+/* saturation, the q flag is not modelled */
+__STATIC_FORCEINLINE int32_t __SSAT(int32_t val, uint32_t sat)
+{
+  int32_t max = (int32_t)((1U << (sat - 1U)) - 1U);
+  int32_t min = -1 - max;
+
+  return (val > max) ? max : ((val < min) ? min : val);
+}
+
+__STATIC_FORCEINLINE uint32_t __USAT(int32_t val, uint32_t sat)
+{
+  uint32_t max = (1U << sat) - 1U;
+
+  return (val < 0) ? 0U : (((uint32_t)val > max) ? max : (uint32_t)val);
+}
+
+__STATIC_FORCEINLINE int32_t __host_sat32(int64_t val)
+{
+  return (val > INT32_MAX) ? INT32_MAX : ((val < INT32_MIN) ? INT32_MIN : (int32_t)val);
+}
+
+__STATIC_FORCEINLINE int32_t __QADD(int32_t op1, int32_t op2)
+{
+  return __host_sat32((int64_t)op1 + op2);
+}
+
+__STATIC_FORCEINLINE int32_t __QSUB(int32_t op1, int32_t op2)
+{
+  return __host_sat32((int64_t)op1 - op2);
+}
+
+/* dual 16 bit multiply accumulate, the halves are signed */
+__STATIC_FORCEINLINE uint32_t __SMLAD(uint32_t op1, uint32_t op2, uint32_t op3)
+{
+  int32_t lo = (int32_t)(int16_t)op1 * (int16_t)op2;
+  int32_t hi = (int32_t)(int16_t)(op1 >> 16) * (int16_t)(op2 >> 16);
+
+  return (uint32_t)lo + (uint32_t)hi + op3;
+}
+
+__STATIC_FORCEINLINE uint32_t __SMUAD(uint32_t op1, uint32_t op2)
+{
+  return __SMLAD(op1, op2, 0U);
+}
+
+__STATIC_FORCEINLINE uint64_t __SMLALD(uint32_t op1, uint32_t op2, uint64_t acc)
+{
+  int64_t lo = (int64_t)(int16_t)op1 * (int16_t)op2;
+  int64_t hi = (int64_t)(int16_t)(op1 >> 16) * (int16_t)(op2 >> 16);
+
+  return acc + (uint64_t)(lo + hi);
+}
+
+/* dual 16 bit add, the halves wrap separately */
+__STATIC_FORCEINLINE uint32_t __UADD16(uint32_t op1, uint32_t op2)
+{
+  uint32_t lo = (op1 + op2) & 0x0000FFFFU;
+  uint32_t hi = ((op1 >> 16) + (op2 >> 16)) << 16;
+
+  return hi | lo;
+}
+
+__STATIC_FORCEINLINE uint32_t __QADD16(uint32_t op1, uint32_t op2)
+{
+  int32_t lo = __SSAT((int32_t)(int16_t)op1 + (int16_t)op2, 16);
+  int32_t hi = __SSAT((int32_t)(int16_t)(op1 >> 16) + (int16_t)(op2 >> 16), 16);
+
+  return ((uint32_t)hi << 16) | ((uint32_t)lo & 0xFFFFU);
+}
+
+__STATIC_FORCEINLINE uint32_t __QSUB16(uint32_t op1, uint32_t op2)
+{
+  int32_t lo = __SSAT((int32_t)(int16_t)op1 - (int16_t)op2, 16);
+  int32_t hi = __SSAT((int32_t)(int16_t)(op1 >> 16) - (int16_t)(op2 >> 16), 16);
+
+  return ((uint32_t)hi << 16) | ((uint32_t)lo & 0xFFFFU);
+}
+
+__STATIC_FORCEINLINE uint32_t __PKHBT(uint32_t op1, uint32_t op2, uint32_t shift)
+{
+  return (op1 & 0x0000FFFFU) | ((op2 << shift) & 0xFFFF0000U);
+}
+
+__STATIC_FORCEINLINE uint32_t __PKHTB(uint32_t op1, uint32_t op2, uint32_t shift)
+{
+  return (op1 & 0xFFFF0000U) | (((uint32_t)((int32_t)op2 >> shift)) & 0x0000FFFFU);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
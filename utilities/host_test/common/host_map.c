@@ -0,0 +1,101 @@
+/**
+  **************************************************************************
+  * @file     host_map.c
+  * @brief    fixed address memory map of the host tests
+  **************************************************************************
+  *
+  * Copyright (c) 2025, Artery Technology, All rights reserved.
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+/* the library reaches flash, sram and registers through fixed addresses. the
+   host tests map plain ram at those addresses, so the code under test runs
+   unchanged and a register is just a word the test can set up and inspect.
+   the tests link with -no-pie, which keeps their own data below 4 gbytes and
+   lets the 32 bit address casts of the library hold. */
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "host_map.h"
+
+typedef struct
+{
+  uintptr_t base;
+  size_t size;
+} host_region_type;
+
+static const host_region_type host_region[] =
+{
+  {0x08000000, HOST_FLASH_KBYTES * 1024},  /* main flash */
+  {0x1FFFF000, 0x1000},                    /* otp, user system data and flash size register */
+  {0x20000000, 0x10000},                   /* sram */
+  {0x40000000, 0x30000},                   /* apb1, apb2 and ahb1 peripherals */
+  {0x48000000, 0x2000},                    /* gpio */
+  {0xE0000000, 0x100000},                  /* core private peripherals and debug */
+};
+
+uint32_t host_primask = 0;
+uint32_t host_check_count = 0;
+uint32_t host_fail_count = 0;
+
+/**
+  * @brief  map every region, registers read 0 and flash reads erased.
+  * @param  none
+  * @retval none
+  */
+void host_map_init(void)
+{
+  uint32_t i;
+  void *p;
+
+  for(i = 0; i < sizeof(host_region) / sizeof(host_region[0]); i++)
+  {
+    p = mmap((void *)host_region[i].base, host_region[i].size, PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+    if(p != (void *)host_region[i].base)
+    {
+      printf("host_map: cannot map 0x%08lx\n", (unsigned long)host_region[i].base);
+      exit(2);
+    }
+  }
+
+  host_flash_erase();
+  *(volatile uint16_t *)0x1FFFF7E0 = HOST_FLASH_KBYTES;
+}
+
+/**
+  * @brief  erase the whole main flash.
+  * @param  none
+  * @retval none
+  */
+void host_flash_erase(void)
+{
+  memset((void *)host_region[0].base, 0xFF, host_region[0].size);
+}
+
+/**
+  * @brief  print the result of a test program.
+  * @param  name: test name
+  * @retval exit code, 0 when every check passed
+  */
+int host_report(const char *name)
+{
+  printf("%s: %lu checks, %lu failed\n", name, (unsigned long)host_check_count, (unsigned long)host_fail_count);
+  return (host_fail_count == 0) ? 0 : 1;
+}
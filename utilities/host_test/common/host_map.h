@@ -0,0 +1,64 @@
+/**
+  **************************************************************************
+  * @file     host_map.h
+  * @brief    fixed address memory map of the host tests
+  **************************************************************************
+  *
+  * Copyright (c) 2025, Artery Technology, All rights reserved.
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+#ifndef __HOST_MAP_H
+#define __HOST_MAP_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* flash capacity written to the flash size register, in kbytes */
+#define HOST_FLASH_KBYTES                128
+
+/**
+  * @brief  check a condition, report the failed one and count it.
+  */
+#define HOST_CHECK(cond)                                                   \
+  do                                                                       \
+  {                                                                        \
+    host_check_count++;                                                    \
+    if(!(cond))                                                            \
+    {                                                                      \
+      host_fail_count++;                                                   \
+      printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);      \
+    }                                                                      \
+  } while(0)
+
+extern uint32_t host_check_count;
+extern uint32_t host_fail_count;
+
+void host_map_init(void);
+void host_flash_erase(void);
+int  host_report(const char *name);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
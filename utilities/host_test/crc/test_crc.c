@@ -0,0 +1,437 @@
+/**
+  **************************************************************************
+  * @file     test_crc.c
+  * @brief    host test of the crc application library
+  **************************************************************************
+  *
+  * Copyright (c) 2025, Artery Technology, All rights reserved.
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+/* usage: test_crc
+
+   the crc application library (crc_application.c), included by the test
+   with CRC_DT32 and CRC_DT8 defined to log the data register writes. a
+   model of the crc unit takes the log and the faked crc driver setters:
+   polynomial size and value, initial value, input reversal by byte or by
+   word, output reversal within the polynomial size. a byte written while
+   the input is reversed by word is a model error. the dma library is
+   faked, a started descriptor moves its data to the unit at once and
+   completes. every preset is checked bit exact against a bitwise crc:
+   the table path after crc_app_model_set() alone, which leaves the
+   clocks and dma untouched, the cpu path and the dma path on random
+   lengths and alignments, and updates mixing both. the host time of the
+   table and bitwise paths, and the data register writes and descriptors
+   of the cpu and dma paths per kilobyte, are printed. */
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "at32f422_426.h"
+
+typedef struct
+{
+  uint8_t width;
+  uint8_t byte;
+  uint32_t word;
+} sim_write_type;
+
+static sim_write_type *sim_dt_write(uint8_t width);
+
+#define CRC_DT32                         (sim_dt_write(32)->word)
+#define CRC_DT8                          (sim_dt_write(8)->byte)
+#include "crc_application.c"
+
+#include "host_map.h"
+
+#define BUF_SIZE                         300000
+#define RANDOM_RUNS                      2000
+#define BENCH_SIZE                       4096
+#define BENCH_LOOPS                      2000
+
+/* the crc unit: registers set by the driver, writes logged since the last flush */
+static uint32_t sim_reg;
+static uint32_t sim_init;
+static uint32_t sim_poly;
+static uint8_t sim_width = 32;
+static crc_reverse_input_type sim_rev_in;
+static crc_reverse_output_type sim_rev_out;
+static sim_write_type sim_log[16];
+static uint32_t sim_log_num;
+static uint32_t sim_model_error;
+static uint32_t sim_word_writes;
+static uint32_t sim_byte_writes;
+
+/* the driver and dma calls seen */
+static uint32_t clock_enables;
+static uint32_t dma_allocs;
+static uint32_t dma_descs;
+static uint32_t callback_count;
+
+static crc_handle_type hcrc;
+static uint8_t buf[BUF_SIZE + 8];
+
+/**
+  * @brief  reverse the low bits of a value.
+  */
+static uint32_t bits_reverse(uint32_t value, uint8_t width)
+{
+  uint32_t result = 0;
+
+  while(width--)
+  {
+    result = (result << 1) | (value & 1);
+    value >>= 1;
+  }
+  return result;
+}
+
+/**
+  * @brief  the crc unit takes one write.
+  * @param  data: data written.
+  * @param  width: 8 or 32 bits.
+  */
+static void sim_feed(uint32_t data, uint8_t width)
+{
+  uint32_t mask = (sim_width == 32) ? 0xFFFFFFFF : ((1UL << sim_width) - 1);
+  uint32_t i, bit;
+
+  if(width == 8)
+  {
+    sim_byte_writes++;
+    if(sim_rev_in == CRC_REVERSE_INPUT_BY_BYTE)
+    {
+      data = bits_reverse(data, 8);
+    }
+    else if(sim_rev_in != CRC_REVERSE_INPUT_NO_AFFECTE)
+    {
+      sim_model_error++;
+    }
+  }
+  else
+  {
+    sim_word_writes++;
+    if(sim_rev_in == CRC_REVERSE_INPUT_BY_WORD)
+    {
+      data = bits_reverse(data, 32);
+    }
+    else if(sim_rev_in == CRC_REVERSE_INPUT_BY_BYTE)
+    {
+      data = bits_reverse(__REV(data), 32);
+    }
+    else if(sim_rev_in != CRC_REVERSE_INPUT_NO_AFFECTE)
+    {
+      sim_model_error++;
+    }
+  }
+
+  for(i = width; i > 0; i--)
+  {
+    bit = ((sim_reg >> (sim_width - 1)) ^ (data >> (i - 1))) & 1;
+    sim_reg = (sim_reg << 1) & mask;
+    if(bit)
+    {
+      sim_reg ^= sim_poly & mask;
+    }
+  }
+}
+
+/**
+  * @brief  hand the logged writes to the unit.
+  */
+static void sim_flush(void)
+{
+  uint32_t i;
+
+  for(i = 0; i < sim_log_num; i++)
+  {
+    sim_feed((sim_log[i].width == 8) ? sim_log[i].byte : sim_log[i].word, sim_log[i].width);
+  }
+  sim_log_num = 0;
+}
+
+static sim_write_type *sim_dt_write(uint8_t width)
+{
+  if(sim_log_num == sizeof(sim_log) / sizeof(sim_log[0]))
+  {
+    sim_flush();
+  }
+  sim_log[sim_log_num].width = width;
+  return &sim_log[sim_log_num++];
+}
+
+void crc_data_reset(void)
+{
+  sim_flush();
+  sim_reg = sim_init;
+}
+
+uint32_t crc_data_get(void)
+{
+  sim_flush();
+  return (sim_rev_out == CRC_REVERSE_OUTPUT_DATA) ? bits_reverse(sim_reg, sim_width) : sim_reg;
+}
+
+void crc_init_data_set(uint32_t value)
+{
+  sim_flush();
+  sim_init = value;
+}
+
+void crc_reverse_input_data_set(crc_reverse_input_type value)
+{
+  sim_flush();
+  sim_rev_in = value;
+}
+
+void crc_reverse_output_data_set(crc_reverse_output_type value)
+{
+  sim_flush();
+  sim_rev_out = value;
+}
+
+void crc_poly_value_set(uint32_t value)
+{
+  sim_flush();
+  sim_poly = value;
+}
+
+void crc_poly_size_set(crc_poly_size_type size)
+{
+  sim_flush();
+  sim_width = (size == CRC_POLY_SIZE_32B) ? 32 : (size == CRC_POLY_SIZE_16B) ? 16 :
+              (size == CRC_POLY_SIZE_8B) ? 8 : 7;
+}
+
+void crm_periph_clock_enable(crm_periph_clock_type value, confirm_state new_state)
+{
+  clock_enables++;
+}
+
+void dma_default_para_init(dma_init_type* dma_init_struct)
+{
+  memset(dma_init_struct, 0, sizeof(*dma_init_struct));
+}
+
+dma_app_status_type dma_channel_alloc(dma_handle_type* hdma, dma_request_type request)
+{
+  dma_allocs++;
+  hdma->request = request;
+  hdma->channel = DMA1_CHANNEL1;
+  hdma->channel_index = 1;
+  return DMA_APP_OK;
+}
+
+void dma_desc_build(dma_desc_type* desc, dma_init_type* dma_init_struct)
+{
+  desc->ctrl = dma_init_struct->memory_data_width;
+  desc->dtcnt = dma_init_struct->buffer_size;
+  desc->paddr = dma_init_struct->peripheral_base_addr;
+  desc->maddr = dma_init_struct->memory_base_addr;
+  desc->next = 0;
+}
+
+dma_app_status_type dma_chain_start(dma_handle_type* hdma, dma_desc_type* desc)
+{
+  uint32_t i;
+
+  /* the transfer runs to its end at once, then its interrupt */
+  sim_flush();
+  dma_descs++;
+  if(desc->paddr != (uint32_t)&CRC->dt)
+  {
+    sim_model_error++;
+  }
+  for(i = 0; i < desc->dtcnt; i++)
+  {
+    if(desc->ctrl == DMA_MEMORY_DATA_WIDTH_WORD)
+    {
+      sim_feed(((const uint32_t *)desc->maddr)[i], 32);
+    }
+    else
+    {
+      sim_feed(((const uint8_t *)desc->maddr)[i], 8);
+    }
+  }
+  hdma->full_callback(hdma, desc);
+
+  return DMA_APP_OK;
+}
+
+/**
+  * @brief  bitwise crc of the model, the reference of every path.
+  */
+static uint32_t ref_crc(const crc_model_type* model, const uint8_t* pdata, uint32_t length)
+{
+  uint32_t mask = (model->width == 32) ? 0xFFFFFFFF : ((1UL << model->width) - 1);
+  uint32_t crc = model->init, byte, bit;
+
+  while(length--)
+  {
+    byte = *pdata++;
+    if(model->reflect)
+    {
+      byte = bits_reverse(byte, 8);
+    }
+    for(bit = 0; bit < 8; bit++)
+    {
+      if(((crc >> (model->width - 1)) ^ (byte >> (7 - bit))) & 1)
+      {
+        crc = ((crc << 1) ^ model->poly) & mask;
+      }
+      else
+      {
+        crc = (crc << 1) & mask;
+      }
+    }
+  }
+  if(model->reflect)
+  {
+    crc = bits_reverse(crc, model->width);
+  }
+
+  return (crc ^ model->xor_out) & mask;
+}
+
+static void crc_done(crc_handle_type* h)
+{
+  callback_count++;
+}
+
+int main(void)
+{
+  static const uint32_t check[CRC_PRESET_NUM] = {0xCBF43926, 0x29B1, 0xF4, 0x4B37};
+  uint32_t preset, run, offset, length, cut, failed, dma_failed, mixed_failed, i, expect;
+  double soft_time, ref_time;
+  clock_t start;
+  volatile uint32_t sink = 0;
+
+  host_map_init();
+  srand(9);
+  for(i = 0; i < sizeof(buf); i++)
+  {
+    buf[i] = (uint8_t)rand();
+  }
+
+  /* the table path needs the model only */
+  failed = 0;
+  HOST_CHECK(crc_app_model_set(&hcrc, CRC_PRESET_NUM) == CRC_APP_ERR_PARAM);
+  for(preset = 0; preset < CRC_PRESET_NUM; preset++)
+  {
+    HOST_CHECK(crc_app_model_set(&hcrc, (crc_preset_type)preset) == CRC_APP_OK);
+    failed += (crc_app_soft_calculate(&hcrc, "123456789", 9) != check[preset]);
+    failed += (ref_crc(hcrc.model, (const uint8_t *)"123456789", 9) != check[preset]);
+    for(run = 0; run < RANDOM_RUNS; run++)
+    {
+      offset = rand() % 8;
+      length = rand() % 600;
+      failed += (crc_app_soft_calculate(&hcrc, buf + offset, length) != ref_crc(hcrc.model, buf + offset, length));
+    }
+  }
+  HOST_CHECK(failed == 0);
+  HOST_CHECK((clock_enables == 0) && (dma_allocs == 0) && (hcrc.dma.channel == 0));
+
+  /* the cpu and dma paths through the unit */
+  failed = 0;
+  dma_failed = 0;
+  mixed_failed = 0;
+  for(preset = 0; preset < CRC_PRESET_NUM; preset++)
+  {
+    HOST_CHECK(crc_app_init(&hcrc, (crc_preset_type)preset) == CRC_APP_OK);
+    failed += (crc_app_calculate(&hcrc, "123456789", 9) != check[preset]);
+    for(run = 0; run < RANDOM_RUNS; run++)
+    {
+      offset = rand() % 8;
+      length = rand() % 600;
+      expect = ref_crc(hcrc.model, buf + offset, length);
+      failed += (crc_app_calculate(&hcrc, buf + offset, length) != expect);
+
+      callback_count = 0;
+      crc_app_start(&hcrc);
+      dma_failed += (crc_app_update_dma(&hcrc, buf + offset, length, crc_done) != CRC_APP_OK) ||
+                    (hcrc.busy != 0) || (hcrc.status != CRC_APP_OK) || (callback_count != 1) ||
+                    (crc_app_result_get(&hcrc) != expect);
+
+      /* the same data in two updates, the first by the dma, the second by the cpu */
+      cut = (length != 0) ? (rand() % length) : 0;
+      crc_app_start(&hcrc);
+      crc_app_update_dma(&hcrc, buf + offset, cut, 0);
+      crc_app_update(&hcrc, buf + offset + cut, length - cut);
+      mixed_failed += (crc_app_result_get(&hcrc) != expect);
+    }
+
+    /* a block over several descriptors */
+    offset = 1 + preset;
+    callback_count = 0;
+    i = dma_descs;
+    crc_app_start(&hcrc);
+    crc_app_update_dma(&hcrc, buf + offset, BUF_SIZE, crc_done);
+    dma_failed += (crc_app_result_get(&hcrc) != ref_crc(hcrc.model, buf + offset, BUF_SIZE)) ||
+                  (callback_count != 1) ||
+                  ((dma_descs - i) != ((hcrc.model->reflect == TRUE) ? 2 : 5));
+  }
+  HOST_CHECK(failed == 0);
+  HOST_CHECK(dma_failed == 0);
+  HOST_CHECK(mixed_failed == 0);
+  HOST_CHECK(sim_model_error == 0);
+  HOST_CHECK((clock_enables == 2 * CRC_PRESET_NUM) && (dma_allocs == 1));
+
+  /* a calculation ongoing */
+  hcrc.busy = 1;
+  HOST_CHECK(crc_app_update_dma(&hcrc, buf, 100, 0) == CRC_APP_ERR_BUSY);
+  HOST_CHECK(crc_app_model_set(&hcrc, CRC_PRESET_CRC32) == CRC_APP_ERR_PARAM);
+  hcrc.busy = 0;
+
+  /* throughput: host time of the table and bitwise paths, data register
+     writes and descriptors of the cpu and dma paths for 1 kilobyte */
+  for(preset = 0; preset < CRC_PRESET_NUM; preset++)
+  {
+    crc_app_init(&hcrc, (crc_preset_type)preset);
+
+    start = clock();
+    for(run = 0; run < BENCH_LOOPS; run++)
+    {
+      sink += crc_app_soft_calculate(&hcrc, buf + (run & 3), BENCH_SIZE);
+    }
+    soft_time = (double)(clock() - start) / CLOCKS_PER_SEC;
+    start = clock();
+    for(run = 0; run < BENCH_LOOPS / 10; run++)
+    {
+      sink += ref_crc(hcrc.model, buf + (run & 3), BENCH_SIZE);
+    }
+    ref_time = (double)(clock() - start) * 10 / CLOCKS_PER_SEC;
+
+    sim_word_writes = 0;
+    sim_byte_writes = 0;
+    crc_app_calculate(&hcrc, buf + 1, 1024);
+    printf("%-6s table %6.1f MB/s, bitwise %5.1f MB/s; 1 KB unaligned: cpu %u word and %u byte writes, ",
+           (preset == 0) ? "crc32" : (preset == 1) ? "ccitt" : (preset == 2) ? "crc8" : "modbus",
+           (double)BENCH_SIZE * BENCH_LOOPS / soft_time / 1e6, (double)BENCH_SIZE * BENCH_LOOPS / ref_time / 1e6,
+           sim_word_writes, sim_byte_writes);
+    sim_word_writes = 0;
+    sim_byte_writes = 0;
+    i = dma_descs;
+    crc_app_start(&hcrc);
+    crc_app_update_dma(&hcrc, buf + 1, 1024, 0);
+    printf("dma %u word and %u byte writes, %u descriptors\n", sim_word_writes, sim_byte_writes, dma_descs - i);
+  }
+  (void)sink;
+
+  return host_report("test_crc");
+}
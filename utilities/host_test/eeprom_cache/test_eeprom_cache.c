@@ -0,0 +1,472 @@
+/**
+  **************************************************************************
+  * @file     test_eeprom_cache.c
+  * @brief    host test and benchmark of the write back cache of the eeprom
+  *           example
+  **************************************************************************
+  *
+  * Copyright (c) 2025, Artery Technology, All rights reserved.
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+/* usage: test_eeprom_cache
+
+   the eeprom cache of the i2c eeprom example (eeprom.c) on a simulated bus:
+   i2c_queue_submit() and i2c_queue_abort() stand for the transaction queue,
+   the transactions take their 100 khz bit times, a 24c02 model with 8 byte
+   pages nacks its address during the 5 ms write cycle. i2c_tick_get() counts
+   microseconds, every call moves the time on by one, ends the transactions
+   due and calls eeprom_cache_poll() every EEPROM_POLL_PERIOD_US as the timer
+   interrupt does.
+
+   the same random small writes go once straight to the eeprom, page by page
+   with ack polling, and once through the cache with a flush every
+   BENCH_FLUSH_PERIOD writes. the page write cycles, ack polls, bus bytes and
+   bus time of both are printed. a stuck bus ends a read by its timeout, the
+   read transaction must have left the queue when the next one comes. */
+
+#include <stdlib.h>
+#include <string.h>
+#include "eeprom.h"
+#include "host_map.h"
+
+/* one tick of i2c_tick_get() per microsecond */
+unsigned int system_core_clock = 1000000;
+
+#define SIM_BIT_US                       10
+#define SIM_WRITE_CYCLE_US               5000
+#define SIM_MEM_SIZE                     256
+
+#define BENCH_WRITES                     2000
+#define BENCH_PAGES                      4
+#define BENCH_FLUSH_PERIOD               16
+#define BENCH_TIMEOUT                    100000
+
+static eeprom_cache_type hee;
+static i2c_handle_type hi2c;
+
+/* the bus: queue, end of the running transaction, its nack, a stuck bus */
+static i2c_xfer_type *sim_head;
+static i2c_xfer_type *sim_tail;
+static uint32_t sim_xfer_end;
+static confirm_state sim_xfer_nack;
+static confirm_state sim_stuck;
+
+/* the eeprom: memory, address counter, end of the write cycle */
+static uint8_t sim_mem[SIM_MEM_SIZE];
+static uint8_t sim_mem_address;
+static uint32_t sim_busy_end;
+
+/* time, next poll timer interrupt, interrupt in progress */
+static uint32_t sim_time;
+static uint32_t sim_poll_next;
+static uint8_t sim_in_irq;
+
+/* counters: page write cycles, bus bytes, ack polls of the direct writes,
+   transactions submitted while queued */
+static uint32_t sim_page_writes;
+static uint32_t sim_bus_bytes;
+static uint32_t sim_direct_polls;
+static uint32_t sim_requeue;
+
+static void sim_run(void);
+
+/**
+  * @brief  one microsecond, transactions due and the poll timer run first.
+  */
+uint32_t i2c_tick_get(void)
+{
+  if(sim_in_irq == 0)
+  {
+    sim_in_irq = 1;
+    sim_time++;
+    sim_run();
+    sim_in_irq = 0;
+  }
+
+  return sim_time;
+}
+
+confirm_state i2c_timeout_check(uint32_t start, uint32_t timeout)
+{
+  return ((i2c_tick_get() - start) >= timeout * I2C_TICKS_PER_US) ? TRUE : FALSE;
+}
+
+/**
+  * @brief  start the transaction at the head of the queue: the eeprom nacks
+  *         its address during a write cycle, the stop follows at once.
+  */
+static void sim_xfer_start(void)
+{
+  i2c_xfer_type *xfer = sim_head;
+  uint32_t bits;
+
+  sim_xfer_nack = (sim_time < sim_busy_end) ? TRUE : FALSE;
+  if(sim_xfer_nack == TRUE)
+  {
+    bits = 1 + 9 + 1;
+    sim_bus_bytes += 1;
+  }
+  else
+  {
+    bits = 2 + ((xfer->wsize != 0) ? 9 * (1 + xfer->wsize) : 0) + ((xfer->rsize != 0) ? 1 + 9 * (1 + xfer->rsize) : 0);
+    sim_bus_bytes += ((xfer->wsize != 0) ? 1 + xfer->wsize : 0) + ((xfer->rsize != 0) ? 1 + xfer->rsize : 0);
+  }
+  sim_xfer_end = sim_time + bits * SIM_BIT_US;
+}
+
+/**
+  * @brief  end the running transaction on the eeprom model, call it back and
+  *         start the next one.
+  */
+static void sim_xfer_end_run(void)
+{
+  i2c_xfer_type *xfer = sim_head;
+  uint8_t page;
+  uint16_t index;
+
+  sim_head = xfer->next;
+  if(sim_head == 0)
+  {
+    sim_tail = 0;
+  }
+  xfer->next = 0;
+
+  if(sim_xfer_nack == TRUE)
+  {
+    xfer->status = I2C_ERR_ACKFAIL;
+  }
+  else
+  {
+    if(xfer->wsize != 0)
+    {
+      sim_mem_address = xfer->wdata[0];
+    }
+
+    /* data after the address is a page write, rolling over in the page */
+    if((xfer->wsize > 1) && (xfer->rsize == 0))
+    {
+      page = sim_mem_address & ~(EEPROM_PAGE_SIZE - 1);
+      for(index = 1; index < xfer->wsize; index++)
+      {
+        sim_mem[sim_mem_address] = xfer->wdata[index];
+        sim_mem_address = page | ((sim_mem_address + 1) & (EEPROM_PAGE_SIZE - 1));
+      }
+      sim_busy_end = sim_time + SIM_WRITE_CYCLE_US;
+      sim_page_writes++;
+    }
+
+    for(index = 0; index < xfer->rsize; index++)
+    {
+      xfer->rdata[index] = sim_mem[sim_mem_address++];
+    }
+
+    xfer->status = I2C_OK;
+  }
+
+  if(xfer->callback != 0)
+  {
+    xfer->callback(&hi2c, xfer);
+  }
+
+  if(sim_head != 0)
+  {
+    sim_xfer_start();
+  }
+}
+
+static void sim_run(void)
+{
+  while((sim_head != 0) && (sim_stuck == FALSE) && (sim_time >= sim_xfer_end))
+  {
+    sim_xfer_end_run();
+  }
+
+  if(sim_time >= sim_poll_next)
+  {
+    sim_poll_next += EEPROM_POLL_PERIOD_US;
+    eeprom_cache_poll(&hee);
+  }
+}
+
+i2c_status_type i2c_queue_submit(i2c_handle_type* hi2c, i2c_xfer_type* xfer)
+{
+  i2c_xfer_type *queued;
+
+  /* a queued descriptor submitted again links to itself */
+  for(queued = sim_head; queued != 0; queued = queued->next)
+  {
+    if(queued == xfer)
+    {
+      sim_requeue++;
+      return I2C_ERR_STEP_1;
+    }
+  }
+
+  xfer->status = I2C_PENDING;
+  xfer->next = 0;
+
+  if(sim_head == 0)
+  {
+    sim_head = xfer;
+    sim_tail = xfer;
+    sim_xfer_start();
+  }
+  else
+  {
+    sim_tail->next = xfer;
+    sim_tail = xfer;
+  }
+
+  return I2C_OK;
+}
+
+void i2c_queue_abort(i2c_handle_type* hi2c, i2c_status_type status)
+{
+  i2c_xfer_type *xfer = sim_head;
+  i2c_xfer_type *next;
+
+  sim_head = 0;
+  sim_tail = 0;
+
+  while(xfer != 0)
+  {
+    next = xfer->next;
+    xfer->next = 0;
+    xfer->status = status;
+
+    if(xfer->callback != 0)
+    {
+      xfer->callback(hi2c, xfer);
+    }
+
+    xfer = next;
+  }
+}
+
+/* the polling, int and dma functions of eeprom.c are not used here */
+i2c_status_type i2c_wait_end(i2c_handle_type* hi2c, uint32_t timeout)
+{
+  return I2C_ERR_STEP_1;
+}
+
+i2c_status_type i2c_wait_flag(i2c_handle_type* hi2c, uint32_t flag, uint32_t event_check, uint32_t timeout)
+{
+  return I2C_ERR_STEP_1;
+}
+
+i2c_status_type i2c_memory_write(i2c_handle_type* hi2c, i2c_mem_address_width_type mem_address_width, uint16_t address, uint16_t mem_address, uint8_t* pdata, uint16_t size, uint32_t timeout)
+{
+  return I2C_ERR_STEP_1;
+}
+
+i2c_status_type i2c_memory_write_int(i2c_handle_type* hi2c, i2c_mem_address_width_type mem_address_width, uint16_t address, uint16_t mem_address, uint8_t* pdata, uint16_t size, uint32_t timeout)
+{
+  return I2C_ERR_STEP_1;
+}
+
+i2c_status_type i2c_memory_write_dma(i2c_handle_type* hi2c, i2c_mem_address_width_type mem_address_width, uint16_t address, uint16_t mem_address, uint8_t* pdata, uint16_t size, uint32_t timeout)
+{
+  return I2C_ERR_STEP_1;
+}
+
+i2c_status_type i2c_memory_read(i2c_handle_type* hi2c, i2c_mem_address_width_type mem_address_width, uint16_t address, uint16_t mem_address, uint8_t* pdata, uint16_t size, uint32_t timeout)
+{
+  return I2C_ERR_STEP_1;
+}
+
+i2c_status_type i2c_memory_read_int(i2c_handle_type* hi2c, i2c_mem_address_width_type mem_address_width, uint16_t address, uint16_t mem_address, uint8_t* pdata, uint16_t size, uint32_t timeout)
+{
+  return I2C_ERR_STEP_1;
+}
+
+i2c_status_type i2c_memory_read_dma(i2c_handle_type* hi2c, i2c_mem_address_width_type mem_address_width, uint16_t address, uint16_t mem_address, uint8_t* pdata, uint16_t size, uint32_t timeout)
+{
+  return I2C_ERR_STEP_1;
+}
+
+/**
+  * @brief  wait for a queued transaction.
+  */
+static void xfer_wait(i2c_xfer_type* xfer)
+{
+  while(xfer->status == I2C_PENDING)
+  {
+    i2c_tick_get();
+  }
+}
+
+/**
+  * @brief  write to the eeprom without the cache: a page write per page
+  *         touched, each followed by ack polls every EEPROM_POLL_PERIOD_US
+  *         until the write cycle is over.
+  */
+static void direct_write(uint16_t mem_address, const uint8_t* pdata, uint16_t size)
+{
+  uint8_t wbuf[1 + EEPROM_PAGE_SIZE];
+  uint8_t poll_data;
+  i2c_xfer_type xfer;
+  uint16_t count;
+
+  memset(&xfer, 0, sizeof(xfer));
+  while(size > 0)
+  {
+    count = EEPROM_PAGE_SIZE - mem_address % EEPROM_PAGE_SIZE;
+    count = (count > size) ? size : count;
+
+    wbuf[0] = (uint8_t)mem_address;
+    memcpy(&wbuf[1], pdata, count);
+    xfer.wdata = wbuf;
+    xfer.wsize = 1 + count;
+    xfer.rdata = 0;
+    xfer.rsize = 0;
+    i2c_queue_submit(&hi2c, &xfer);
+    xfer_wait(&xfer);
+
+    xfer.wsize = 0;
+    xfer.rdata = &poll_data;
+    xfer.rsize = 1;
+    do
+    {
+      while(sim_time % EEPROM_POLL_PERIOD_US)
+      {
+        i2c_tick_get();
+      }
+      sim_direct_polls++;
+      i2c_queue_submit(&hi2c, &xfer);
+      xfer_wait(&xfer);
+    } while(xfer.status != I2C_OK);
+
+    mem_address += count;
+    pdata += count;
+    size -= count;
+  }
+}
+
+/**
+  * @brief  the same random writes to the eeprom, straight or through the
+  *         cache, returns the bus time in microseconds.
+  */
+static uint32_t bench_run(confirm_state cached, uint8_t* image)
+{
+  uint8_t data[4];
+  uint16_t mem_address, size, index;
+  uint32_t start, write, failed = 0;
+
+  srand(7);
+  memset(sim_mem, 0xFF, sizeof(sim_mem));
+  memset(image, 0xFF, SIM_MEM_SIZE);
+  sim_page_writes = 0;
+  sim_bus_bytes = 0;
+  eeprom_cache_init(&hee, &hi2c, I2C_MEM_ADDR_WIDIH_8, EEPROM_I2C_ADDRESS);
+  start = sim_time;
+
+  for(write = 0; write < BENCH_WRITES; write++)
+  {
+    size = 1 + rand() % 4;
+    mem_address = rand() % (BENCH_PAGES * EEPROM_PAGE_SIZE - size);
+    for(index = 0; index < size; index++)
+    {
+      data[index] = (uint8_t)rand();
+      image[mem_address + index] = data[index];
+    }
+
+    if(cached == TRUE)
+    {
+      failed += (eeprom_cache_write(&hee, mem_address, data, size, BENCH_TIMEOUT) != I2C_OK);
+      if((write % BENCH_FLUSH_PERIOD) == BENCH_FLUSH_PERIOD - 1)
+      {
+        failed += (eeprom_cache_flush(&hee, BENCH_TIMEOUT) != I2C_OK);
+      }
+    }
+    else
+    {
+      direct_write(mem_address, data, size);
+    }
+  }
+
+  if(cached == TRUE)
+  {
+    failed += (eeprom_cache_flush(&hee, BENCH_TIMEOUT) != I2C_OK);
+  }
+  HOST_CHECK(failed == 0);
+
+  return sim_time - start;
+}
+
+int main(void)
+{
+  uint8_t image[SIM_MEM_SIZE], data[EEPROM_PAGE_SIZE * 2];
+  uint32_t direct_time, direct_writes, direct_bytes, cache_time;
+  uint16_t index;
+
+  host_map_init();
+  hi2c.i2cx = I2C1;
+  sim_poll_next = EEPROM_POLL_PERIOD_US;
+
+  /* benchmark, both ways end with the same eeprom content */
+  direct_time = bench_run(FALSE, image);
+  direct_writes = sim_page_writes;
+  direct_bytes = sim_bus_bytes;
+  HOST_CHECK(memcmp(sim_mem, image, SIM_MEM_SIZE) == 0);
+
+  cache_time = bench_run(TRUE, image);
+  HOST_CHECK(memcmp(sim_mem, image, SIM_MEM_SIZE) == 0);
+  HOST_CHECK(hee.write_count == sim_page_writes);
+  HOST_CHECK((hee.write_count < direct_writes / 4) && (sim_bus_bytes < direct_bytes / 2));
+  HOST_CHECK(hee.bus_time <= cache_time);
+
+  printf("eeprom %u writes of 1~4 bytes on %u pages, flush every %u writes\n",
+         BENCH_WRITES, BENCH_PAGES, BENCH_FLUSH_PERIOD);
+  printf("  direct: %u page writes, %u ack polls, %u bus bytes, %u ms\n",
+         direct_writes, sim_direct_polls, direct_bytes, direct_time / 1000);
+  printf("  cache:  %u page writes, %u merged, %u ack polls, %u bus bytes, bus time %u ms of %u ms\n",
+         hee.write_count, hee.merge_count, hee.poll_count, sim_bus_bytes, hee.bus_time / 1000, cache_time / 1000);
+
+  /* reads: cached pages from ram, the others from the eeprom, retried while
+     the write cycle of a flush nacks them */
+  HOST_CHECK(eeprom_cache_write(&hee, 0x80, (uint8_t *)"cached!", 8, BENCH_TIMEOUT) == I2C_OK);
+  eeprom_cache_flush_start(&hee);
+  HOST_CHECK(eeprom_cache_read(&hee, 0x04, data, sizeof(data), BENCH_TIMEOUT) == I2C_OK);
+  HOST_CHECK(memcmp(data, &image[0x04], sizeof(data)) == 0);
+  HOST_CHECK(eeprom_cache_flush(&hee, BENCH_TIMEOUT) == I2C_OK);
+  HOST_CHECK(memcmp(&sim_mem[0x80], "cached!", 8) == 0);
+
+  /* a stuck bus during the write back and a read: the read ends by its
+     timeout and the queue with it, the page is written again later */
+  HOST_CHECK(eeprom_cache_write(&hee, 0x90, (uint8_t *)"stuck..", 8, BENCH_TIMEOUT) == I2C_OK);
+  sim_stuck = TRUE;
+  eeprom_cache_flush_start(&hee);
+  HOST_CHECK(eeprom_cache_read(&hee, 0xA0, data, 4, 2000) == I2C_ERR_TIMEOUT);
+  HOST_CHECK((sim_head == 0) && (hee.rxfer.status == I2C_ERR_TIMEOUT));
+  HOST_CHECK((hee.state == EE_CACHE_IDLE) && (hee.error_code == I2C_ERR_TIMEOUT));
+  HOST_CHECK(eeprom_cache_read(&hee, 0xA0, data, 4, 2000) == I2C_ERR_TIMEOUT);
+  sim_stuck = FALSE;
+
+  for(index = 0; index < 4; index++)
+  {
+    sim_mem[0xA0 + index] = (uint8_t)(0x5A + index);
+  }
+  HOST_CHECK(eeprom_cache_read(&hee, 0xA0, data, 4, BENCH_TIMEOUT) == I2C_OK);
+  HOST_CHECK((data[0] == 0x5A) && (data[3] == 0x5D));
+  HOST_CHECK(eeprom_cache_flush(&hee, BENCH_TIMEOUT) == I2C_OK);
+  HOST_CHECK(memcmp(&sim_mem[0x90], "stuck..", 8) == 0);
+  HOST_CHECK(sim_requeue == 0);
+
+  return host_report("test_eeprom_cache");
+}
@@ -0,0 +1,339 @@
+/**
+  **************************************************************************
+  * @file     test_foc.c
+  * @brief    host test of the field oriented control application library
+  **************************************************************************
+  *
+  * Copyright (c) 2025, Artery Technology, All rights reserved.
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+/* usage: test_foc
+
+   foc_application.c runs on the bundled cmsis-dsp q31 kernels. each preempt
+   conversion is a write of the two current results to ADC1 and a call of
+   foc_irq_handler(). single loops are checked against a double precision
+   reference of the transforms, the controllers and the min max injection,
+   then the loop drives a three phase resistor inductor load modelled from
+   the TMR1 compare values. the adc and timer output functions are fakes
+   keeping their state in this file. */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "foc_application.h"
+#include "host_map.h"
+
+#define PERIOD                   3000
+#define OFFSET_A                 2052
+#define OFFSET_B                 2040
+#define Q31(x)                   ((q31_t)((x) * 2147483648.0))
+
+/* the bundled cmsis-dsp has no arm_common_tables.c, the sine table of
+   arm_sin_cos_q31() is built here the way the cmsis one was generated */
+q31_t sinTable_q31[FAST_MATH_TABLE_SIZE + 1];
+
+/* fake adc and timer outputs */
+static confirm_state pcce_flag = FALSE;
+static confirm_state pcce_int = FALSE;
+static confirm_state outputs_on = FALSE;
+
+/* load model, phase currents with 1 at 4096 adc counts */
+static double load_i[3];
+
+static foc_handle_type hfoc;
+static q31_t test_theta;
+
+flag_status adc_interrupt_flag_get(adc_type *adc_x, uint16_t adc_flag)
+{
+  return (pcce_flag == TRUE) ? SET : RESET;
+}
+
+void adc_flag_clear(adc_type *adc_x, uint16_t adc_flag)
+{
+  pcce_flag = FALSE;
+}
+
+void adc_interrupt_enable(adc_type *adc_x, uint32_t adc_int, confirm_state new_state)
+{
+  pcce_int = new_state;
+}
+
+void tmr_output_enable(tmr_type *tmr_x, confirm_state new_state)
+{
+  outputs_on = new_state;
+}
+
+void foc_lowlevel_init(foc_handle_type* hfoc)
+{
+  TMR1->pr = PERIOD;
+}
+
+static q31_t angle_get(foc_handle_type* hfoc, q31_t i_alpha, q31_t i_beta, q31_t v_alpha, q31_t v_beta)
+{
+  return test_theta;
+}
+
+/**
+  * @brief  one preempt conversion end with the phase a and b results.
+  */
+static void conversion(uint16_t raw_a, uint16_t raw_b)
+{
+  ADC1->pdt1 = raw_a;
+  ADC1->pdt2 = raw_b;
+  pcce_flag = TRUE;
+  foc_irq_handler(&hfoc);
+}
+
+static double q31_value(q31_t value)
+{
+  return value / 2147483648.0;
+}
+
+static int near(double value, double expect, double tolerance)
+{
+  return fabs(value - expect) <= tolerance;
+}
+
+static double clamp(double value, double limit)
+{
+  return (value > limit) ? limit : ((value < -limit) ? -limit : value);
+}
+
+/**
+  * @brief  one period of the load: the pole voltages from the compare values,
+  *         the neutral point removed, a first order current response.
+  */
+static void load_period(double pole, double gain)
+{
+  double u[3], neutral;
+  int i;
+
+  u[0] = 2.0 * TMR1->c1dt / PERIOD - 1.0;
+  u[1] = 2.0 * TMR1->c2dt / PERIOD - 1.0;
+  u[2] = 2.0 * TMR1->c3dt / PERIOD - 1.0;
+  neutral = (u[0] + u[1] + u[2]) / 3.0;
+
+  for(i = 0; i < 3; i++)
+  {
+    load_i[i] = pole * load_i[i] + (1.0 - pole) * gain * (u[i] - neutral);
+  }
+}
+
+static uint16_t load_raw(double current, uint16_t offset)
+{
+  long raw = offset + lround(current * 4096.0);
+
+  return (uint16_t)((raw < 0) ? 0 : ((raw > 4095) ? 4095 : raw));
+}
+
+/**
+  * @brief  run the loop on the load, returns the peak phase a current of
+  *         the last half of the periods.
+  */
+static double load_run(uint32_t periods, double pole, double gain)
+{
+  double peak = 0;
+  uint32_t i;
+
+  for(i = 0; i < periods; i++)
+  {
+    conversion(load_raw(load_i[0], OFFSET_A), load_raw(load_i[1], OFFSET_B));
+    load_period(pole, gain);
+    if((i >= periods / 2) && (fabs(load_i[0]) > peak))
+    {
+      peak = fabs(load_i[0]);
+    }
+  }
+
+  return peak;
+}
+
+/**
+  * @brief  compare values within the period and centered by the injection.
+  */
+static int compare_centered(void)
+{
+  uint32_t c[3] = {TMR1->c1dt, TMR1->c2dt, TMR1->c3dt};
+  uint32_t max = c[0], min = c[0];
+  int i;
+
+  for(i = 1; i < 3; i++)
+  {
+    max = (c[i] > max) ? c[i] : max;
+    min = (c[i] < min) ? c[i] : min;
+  }
+
+  return (max <= PERIOD) && (abs((int)(max + min) - PERIOD) <= 2);
+}
+
+int main(void)
+{
+  double ia, ib, alpha, beta, th, sin_th, cos_th, id, iq, vd, vq, v_alpha, v_beta, v[3], middle, peak;
+  uint16_t raw_a, raw_b;
+  q31_t id_ref, iq_ref, sin_val, cos_val;
+  double error = 0;
+  uint32_t compare[3];
+  int i, k, ok;
+
+  host_map_init();
+
+  for(i = 0; i <= FAST_MATH_TABLE_SIZE; i++)
+  {
+    double value = round(sin(2.0 * M_PI * i / FAST_MATH_TABLE_SIZE) * 2147483648.0);
+    sinTable_q31[i] = (value > 2147483647.0) ? 0x7FFFFFFF : (q31_t)value;
+  }
+
+  /* the kernel within 0.004 of sin and cos. the error peaks next to -90
+     degrees, where the negation of sinTable_q31[384], -1, wraps to -1 again */
+  for(k = -32768; k < 32768; k++)
+  {
+    arm_sin_cos_q31((q31_t)(k * 65536 + 12345), &sin_val, &cos_val);
+    th = (k * 65536 + 12345) / 2147483648.0 * M_PI;
+    error = fmax(error, fmax(fabs(q31_value(sin_val) - sin(th)), fabs(q31_value(cos_val) - cos(th))));
+  }
+  HOST_CHECK(error < 0.004);
+
+  /* parameters */
+  memset(&hfoc, 0, sizeof(hfoc));
+  hfoc.adcx = ADC1;
+  hfoc.pwm_tmrx = TMR3;
+  hfoc.voltage_limit = Q31(0.9);
+  HOST_CHECK(foc_init(&hfoc) == FOC_ERR_PARAM);
+  hfoc.pwm_tmrx = TMR1;
+  hfoc.voltage_limit = 0;
+  HOST_CHECK(foc_init(&hfoc) == FOC_ERR_PARAM);
+  hfoc.voltage_limit = Q31(0.9);
+  hfoc.pid_d.Kp = Q31(0.5);
+  hfoc.pid_q.Kp = Q31(0.5);
+  hfoc.angle = angle_get;
+  HOST_CHECK(foc_init(&hfoc) == FOC_OK);
+  HOST_CHECK((hfoc.period == PERIOD) && (pcce_int == TRUE));
+  HOST_CHECK(CoreDebug->DEMCR & CoreDebug_DEMCR_TRCENA_Msk);
+
+  /* offset calibration, rounded averages, the loop is held off meanwhile */
+  HOST_CHECK(foc_calibrate(&hfoc, 0) == FOC_ERR_PARAM);
+  HOST_CHECK(foc_calibrate(&hfoc, 16) == FOC_OK);
+  HOST_CHECK(foc_calibrate(&hfoc, 16) == FOC_ERR_BUSY);
+  HOST_CHECK(foc_start(&hfoc) == FOC_ERR_BUSY);
+  for(i = 0; i < 16; i++)
+  {
+    conversion((i & 1) ? 2053 : 2050, OFFSET_B);
+  }
+  HOST_CHECK((hfoc.offset_remain == 0) && (hfoc.offset[0] == OFFSET_A) && (hfoc.offset[1] == OFFSET_B));
+  HOST_CHECK((outputs_on == FALSE) && (hfoc.loop_count == 0));
+
+  /* single loops from reset controllers, a proportional step each, against
+     a double precision reference on the sine and cosine of the kernel */
+  srand(1);
+  ok = 1;
+  for(k = 0; k < 500; k++)
+  {
+    raw_a = (uint16_t)(OFFSET_A - 1000 + rand() % 2000);
+    raw_b = (uint16_t)(OFFSET_B - 1000 + rand() % 2000);
+    test_theta = (q31_t)(((uint32_t)rand() << 16) ^ (uint32_t)rand());
+    id_ref = Q31((rand() % 2001 - 1000) / 4000.0);
+    iq_ref = Q31((rand() % 2001 - 1000) / 4000.0);
+
+    foc_start(&hfoc);
+    foc_current_set(&hfoc, id_ref, iq_ref);
+    conversion(raw_a, raw_b);
+
+    ia = (raw_a - OFFSET_A) / 4096.0;
+    ib = (raw_b - OFFSET_B) / 4096.0;
+    alpha = ia;
+    beta = (ia + 2.0 * ib) / sqrt(3.0);
+    arm_sin_cos_q31(test_theta, &sin_val, &cos_val);
+    sin_th = q31_value(sin_val);
+    cos_th = q31_value(cos_val);
+    id = alpha * cos_th + beta * sin_th;
+    iq = -alpha * sin_th + beta * cos_th;
+    vd = clamp(0.5 * (q31_value(id_ref) - id), 0.9);
+    vq = clamp(0.5 * (q31_value(iq_ref) - iq), 0.9);
+    v_alpha = vd * cos_th - vq * sin_th;
+    v_beta = vd * sin_th + vq * cos_th;
+    v[0] = v_alpha;
+    v[1] = -0.5 * v_alpha + sqrt(3.0) / 2.0 * v_beta;
+    v[2] = -v[0] - v[1];
+    middle = (fmax(v[0], fmax(v[1], v[2])) + fmin(v[0], fmin(v[1], v[2]))) / 2.0;
+    compare[0] = TMR1->c1dt;
+    compare[1] = TMR1->c2dt;
+    compare[2] = TMR1->c3dt;
+
+    ok &= near(q31_value(hfoc.id), id, 1e-6) && near(q31_value(hfoc.iq), iq, 1e-6);
+    ok &= near(q31_value(hfoc.vd), vd, 1e-6) && near(q31_value(hfoc.vq), vq, 1e-6);
+    for(i = 0; i < 3; i++)
+    {
+      ok &= near(compare[i], PERIOD / 2 + (v[i] - middle) * (PERIOD / 2), 1.0);
+    }
+  }
+  HOST_CHECK(ok);
+  HOST_CHECK((outputs_on == TRUE) && (hfoc.loop_count == 500));
+
+  /* current sensing inverted */
+  foc_start(&hfoc);
+  foc_current_set(&hfoc, 0, 0);
+  test_theta = 0;
+  hfoc.current_invert = TRUE;
+  conversion(OFFSET_A + 409, OFFSET_B);
+  HOST_CHECK(near(q31_value(hfoc.id), -409 / 4096.0, 1e-6));
+  hfoc.current_invert = FALSE;
+
+  /* closed loop on the load, the angle turning at 1/200 turn per period:
+     the d and q currents settle on their references, the phase currents
+     are sine waves of the q reference amplitude */
+  foc_stop(&hfoc);
+  HOST_CHECK((outputs_on == FALSE) && (hfoc.running == 0));
+  hfoc.angle = 0;
+  hfoc.speed = Q31(0.01);
+  hfoc.theta = 0;
+  hfoc.pid_d.Kp = Q31(0.9);
+  hfoc.pid_d.Ki = Q31(0.09);
+  hfoc.pid_q = hfoc.pid_d;
+  arm_pid_init_q31(&hfoc.pid_d, 1);
+  arm_pid_init_q31(&hfoc.pid_q, 1);
+  memset(load_i, 0, sizeof(load_i));
+  HOST_CHECK(foc_start(&hfoc) == FOC_OK);
+  foc_current_set(&hfoc, 0, Q31(0.2));
+  peak = load_run(800, 0.9, 2.0);
+  HOST_CHECK(near(q31_value(hfoc.id), 0, 0.002) && near(q31_value(hfoc.iq), 0.2, 0.002));
+  HOST_CHECK(near(peak, 0.2, 0.005));
+  HOST_CHECK(compare_centered());
+
+  /* a reference beyond the voltage limit: vq stays at the limit without the
+     integral winding up, a lower reference is followed at once */
+  hfoc.voltage_limit = Q31(0.05);
+  foc_current_set(&hfoc, 0, Q31(0.3));
+  load_run(400, 0.9, 2.0);
+  HOST_CHECK((hfoc.vq == hfoc.voltage_limit) && (hfoc.pid_q.state[2] == hfoc.voltage_limit));
+  HOST_CHECK(compare_centered());
+  foc_current_set(&hfoc, 0, Q31(0.05));
+  load_run(2, 0.9, 2.0);
+  HOST_CHECK(hfoc.vq < hfoc.voltage_limit);
+  load_run(400, 0.9, 2.0);
+  HOST_CHECK(near(q31_value(hfoc.iq), 0.05, 0.002));
+
+  /* stopped, the conversions no longer change the outputs */
+  foc_stop(&hfoc);
+  k = (int)hfoc.loop_count;
+  compare[0] = TMR1->c1dt;
+  conversion(OFFSET_A + 500, OFFSET_B);
+  HOST_CHECK((hfoc.loop_count == (uint32_t)k) && (TMR1->c1dt == compare[0]));
+
+  return host_report("test_foc");
+}
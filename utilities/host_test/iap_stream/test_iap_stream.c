@@ -0,0 +1,361 @@
+/**
+  **************************************************************************
+  * @file     test_iap_stream.c
+  * @brief    pseudo terminal loopback test of the bootloader streaming upgrade
+  **************************************************************************
+  *
+  * Copyright (c) 2025, Artery Technology, All rights reserved.
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+/* usage: test_iap_stream <iap_stream sender>
+
+   the bootloader iap.c runs unchanged against fakes of usart1, dma1 channel 3,
+   tmr3 and the flash write. usart1 is the master side of a pseudo terminal,
+   the linux sender runs on the slave side. every run streams a random image
+   and checks the flash against it, the second run corrupts one byte of the
+   third frame on its way to the dma buffer, which takes the crc mismatch, the
+   resynchronization and the nak rewind of the sender. */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "iap.h"
+#include "usart.h"
+#include "flash.h"
+#include "tmr.h"
+#include "host_map.h"
+
+#define RUN_SECONDS_MAX          60
+
+/* usart1 */
+usart_group_type usart_group_struct;
+uint8_t time_ira_cnt = 0;
+uint8_t get_data_from_usart_flag = 0;
+static int pty_fd = -1;
+static confirm_state rdbf_int = TRUE;
+static int rx_byte = -1;
+
+/* dma1 channel 3 in loop mode */
+static uint8_t *dma_buf = 0;
+static uint16_t dma_len = 0;
+static uint16_t dma_pos = 0;
+static confirm_state dma_on = FALSE;
+static uint32_t dma_flags = 0;
+static uint32_t dma_total = 0;
+static uint32_t corrupt_at = 0;
+
+/* observations */
+static uint32_t boot_select_count = 0;
+static uint32_t nak_count = 0;
+static uint8_t tx_last = 0;
+
+/**
+  * @brief  monotonic time in microseconds.
+  */
+static uint64_t now_us(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+}
+
+/**
+  * @brief  move the received bytes to where usart1 would put them: the dma
+  *         buffer, the interrupt ring or the receive data register.
+  */
+static void pty_pump(void)
+{
+  uint8_t val;
+
+  for(;;)
+  {
+    if(rx_byte < 0)
+    {
+      if(read(pty_fd, &val, 1) != 1)
+      {
+        return;
+      }
+      rx_byte = val;
+    }
+
+    if(dma_on == TRUE)
+    {
+      dma_total++;
+      if(dma_total == corrupt_at)
+      {
+        rx_byte ^= 0x5A;
+      }
+      dma_buf[dma_pos++] = (uint8_t)rx_byte;
+      if(dma_pos == dma_len / 2)
+      {
+        dma_flags |= DMA1_HDT3_FLAG;
+      }
+      if(dma_pos == dma_len)
+      {
+        dma_flags |= DMA1_FDT3_FLAG;
+        dma_pos = 0;
+      }
+    }
+    else if(rdbf_int == TRUE)
+    {
+      if(usart_group_struct.count < USART_REC_LEN)
+      {
+        usart_group_struct.buf[usart_group_struct.head] = (uint16_t)rx_byte;
+        usart_group_struct.head = (usart_group_struct.head + 1) % USART_REC_LEN;
+        usart_group_struct.count++;
+      }
+    }
+    else
+    {
+      /* stays in the receive data register until read */
+      return;
+    }
+    rx_byte = -1;
+  }
+}
+
+void usart_interrupt_enable(usart_type* usart_x, uint32_t usart_int, confirm_state new_state)
+{
+  if(usart_int == USART_RDBF_INT)
+  {
+    rdbf_int = new_state;
+  }
+}
+
+void usart_data_transmit(usart_type* usart_x, uint16_t data)
+{
+  uint8_t val = (uint8_t)data;
+
+  if(tx_last == IAP_STREAM_NAK && update_status == UPDATE_STREAM)
+  {
+    nak_count++;
+  }
+  tx_last = val;
+  while(write(pty_fd, &val, 1) < 0 && errno == EAGAIN);
+}
+
+uint16_t usart_data_receive(usart_type* usart_x)
+{
+  uint16_t val;
+
+  pty_pump();
+  val = (uint16_t)((rx_byte < 0) ? 0 : rx_byte);
+  rx_byte = -1;
+  return val;
+}
+
+flag_status usart_flag_get(usart_type* usart_x, uint32_t flag)
+{
+  if(flag == USART_RDBF_FLAG)
+  {
+    pty_pump();
+    return (rx_byte >= 0) ? SET : RESET;
+  }
+  return SET;
+}
+
+void uart_dma_receive_start(uint8_t *pbuffer, uint16_t len)
+{
+  dma_buf = pbuffer;
+  dma_len = len;
+  dma_pos = 0;
+  dma_flags = 0;
+  dma_on = TRUE;
+}
+
+void uart_dma_receive_stop(void)
+{
+  dma_on = FALSE;
+}
+
+flag_status dma_flag_get(uint32_t dmax_flag)
+{
+  pty_pump();
+  return (dma_flags & dmax_flag) ? SET : RESET;
+}
+
+void dma_flag_clear(uint32_t dmax_flag)
+{
+  dma_flags &= ~dmax_flag;
+}
+
+uint16_t dma_data_number_get(dma_channel_type* dmax_channely)
+{
+  return (uint16_t)(dma_len - dma_pos);
+}
+
+uint32_t tmr_counter_value_get(tmr_type *tmr_x)
+{
+  pty_pump();
+  return (uint32_t)((now_us() / 100) % 10001);
+}
+
+void crm_periph_clock_enable(crm_periph_clock_type value, confirm_state new_state)
+{
+}
+
+void nvic_irq_disable(IRQn_Type irqn)
+{
+}
+
+void crm_reset(void)
+{
+}
+
+void flash_2kb_write(uint32_t write_addr, uint8_t *pbuffer)
+{
+  memcpy((void *)(uintptr_t)write_addr, pbuffer, 0x800);
+}
+
+uint32_t image_boot_select(void)
+{
+  /* stay in the bootloader, the end frame is answered by an abort */
+  boot_select_count++;
+  return 0;
+}
+
+/**
+  * @brief  stream one image through the pseudo terminal.
+  * @param  sender: path of the sender
+  * @param  image_len: image length in bytes
+  * @param  corrupt: byte of the dma stream to corrupt, 0 for none
+  * @retval none
+  */
+static void stream_run(const char *sender, uint32_t image_len, uint32_t corrupt)
+{
+  char image_name[] = "/tmp/iap_stream_XXXXXX";
+  struct termios tio;
+  uint8_t *image;
+  uint64_t start;
+  uint32_t i;
+  int image_fd, slave_fd, status = -1;
+  pid_t pid, done = 0;
+
+  host_flash_erase();
+  memset(&usart_group_struct, 0, sizeof(usart_group_struct));
+  update_status = UPDATE_PRE;
+  cmd_ctr_step = CMD_CTR_IDLE;
+  rdbf_int = TRUE;
+  dma_on = FALSE;
+  dma_total = 0;
+  corrupt_at = corrupt;
+  boot_select_count = 0;
+  nak_count = 0;
+  rx_byte = -1;
+
+  image = malloc(image_len);
+  for(i = 0; i < image_len; i++)
+  {
+    image[i] = (uint8_t)rand();
+  }
+  image_fd = mkstemp(image_name);
+  HOST_CHECK(image_fd >= 0);
+  HOST_CHECK(write(image_fd, image, image_len) == (ssize_t)image_len);
+  close(image_fd);
+
+  pty_fd = posix_openpt(O_RDWR | O_NOCTTY);
+  HOST_CHECK(pty_fd >= 0);
+  grantpt(pty_fd);
+  unlockpt(pty_fd);
+
+  /* raw before the sender opens it, no echo of the bootloader answers */
+  slave_fd = open(ptsname(pty_fd), O_RDWR | O_NOCTTY);
+  tcgetattr(slave_fd, &tio);
+  cfmakeraw(&tio);
+  tcsetattr(slave_fd, TCSANOW, &tio);
+  fcntl(pty_fd, F_SETFL, O_NONBLOCK);
+
+  pid = fork();
+  if(pid == 0)
+  {
+    execl(sender, sender, ptsname(pty_fd), image_name, "0x08004000", (char *)0);
+    _exit(127);
+  }
+
+  start = now_us();
+  while(now_us() - start < (uint64_t)RUN_SECONDS_MAX * 1000000)
+  {
+    pty_pump();
+    iap_upgrade_app_handle();
+    if(done == 0)
+    {
+      done = waitpid(pid, &status, WNOHANG);
+    }
+    if(done == pid && boot_select_count != 0)
+    {
+      break;
+    }
+    if(done == pid && (!WIFEXITED(status) || WEXITSTATUS(status) != 0))
+    {
+      break;
+    }
+  }
+  if(done != pid)
+  {
+    kill(pid, SIGKILL);
+    waitpid(pid, &status, 0);
+  }
+
+  printf("image %u bytes, corrupt byte %u: sender exit %d, nak %u\n",
+         image_len, corrupt, WIFEXITED(status) ? WEXITSTATUS(status) : -1, nak_count);
+  HOST_CHECK(done == pid);
+  HOST_CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+  HOST_CHECK(boot_select_count == 1);
+  HOST_CHECK(memcmp((void *)APP_START_ADDR, image, image_len) == 0);
+  for(i = image_len; i < (image_len + 0x7FF) / 0x800 * 0x800; i++)
+  {
+    if(*(uint8_t *)(uintptr_t)(APP_START_ADDR + i) != 0xFF)
+    {
+      break;
+    }
+  }
+  HOST_CHECK(i == (image_len + 0x7FF) / 0x800 * 0x800);
+  if(corrupt != 0)
+  {
+    HOST_CHECK(nak_count != 0);
+  }
+
+  close(slave_fd);
+  close(pty_fd);
+  unlink(image_name);
+  free(image);
+}
+
+int main(int argc, char *argv[])
+{
+  if(argc < 2)
+  {
+    printf("usage: %s <iap_stream sender>\n", argv[0]);
+    return 2;
+  }
+
+  host_map_init();
+  srand(1);
+
+  stream_run(argv[1], 5 * 0x800 + 300, 0);
+  stream_run(argv[1], 6 * 0x800, 2 * IAP_FRAME_SIZE + 100);
+
+  return host_report("test_iap_stream");
+}
@@ -0,0 +1,183 @@
+/**
+  **************************************************************************
+  * @file     test_image_slot.c
+  * @brief    host test of the bootloader image header and slot selection
+  **************************************************************************
+  *
+  * Copyright (c) 2025, Artery Technology, All rights reserved.
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+/* usage: test_image_slot <image_header generator>
+
+   slot images built by host_tool/image_header.c are put in the flash and
+   checked by image_verify and image_boot_select of the bootloader flash.c.
+   flash_crc_calibrate() is the reference model of the flash crc calibration,
+   the crc-32/mpeg-2 over the flash words msb first. */
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "iap.h"
+#include "flash.h"
+#include "host_map.h"
+
+void flash_unlock(void)
+{
+}
+
+void flash_lock(void)
+{
+}
+
+flash_status_type flash_sector_erase(uint32_t sector_address)
+{
+  memset((void *)(uintptr_t)sector_address, 0xFF, flash_sector_size_get());
+  return FLASH_OPERATE_DONE;
+}
+
+flash_status_type flash_halfword_program(uint32_t address, uint16_t data)
+{
+  *(uint16_t *)(uintptr_t)address &= data;
+  return FLASH_OPERATE_DONE;
+}
+
+uint32_t flash_crc_calibrate(uint32_t start_addr, uint32_t sector_cnt)
+{
+  uint32_t word_cnt = sector_cnt * flash_sector_size_get() / sizeof(uint32_t);
+  uint32_t crc = 0xFFFFFFFF;
+  uint8_t bit;
+
+  while(word_cnt--)
+  {
+    crc ^= *(uint32_t *)(uintptr_t)start_addr;
+    start_addr += sizeof(uint32_t);
+    for(bit = 0; bit < 32; bit++)
+    {
+      crc = (crc & 0x80000000) ? ((crc << 1) ^ 0x04C11DB7) : (crc << 1);
+    }
+  }
+  return crc;
+}
+
+/**
+  * @brief  build a slot image of a random app with the generator and put it
+  *         in a slot.
+  * @param  generator: path of the generator
+  * @param  slot: slot number
+  * @param  length: app length
+  * @param  version: image version
+  * @retval none
+  */
+static void slot_load(const char *generator, uint8_t slot, uint32_t length, uint32_t version)
+{
+  char app_name[] = "/tmp/image_app_XXXXXX";
+  char slot_name[] = "/tmp/image_slot_XXXXXX";
+  char cmd[256];
+  uint32_t slot_addr = APP_START_ADDR + slot * image_slot_size_get();
+  uint8_t *app;
+  FILE *file;
+  long size;
+  uint32_t i;
+  int fd;
+
+  app = malloc(length);
+  for(i = 0; i < length; i++)
+  {
+    app[i] = (uint8_t)rand();
+  }
+  /* stack pointer in sram, reset handler in the app */
+  *(uint32_t *)app = 0x20001000;
+  *(uint32_t *)(app + 4) = slot_addr + 0x101;
+
+  fd = mkstemp(app_name);
+  HOST_CHECK(write(fd, app, length) == (ssize_t)length);
+  close(fd);
+  close(mkstemp(slot_name));
+
+  snprintf(cmd, sizeof(cmd), "%s %s %s %u %u > /dev/null", generator, app_name, slot_name, version, HOST_FLASH_KBYTES);
+  HOST_CHECK(system(cmd) == 0);
+
+  memset((void *)(uintptr_t)slot_addr, 0xFF, image_slot_size_get());
+  file = fopen(slot_name, "rb");
+  fseek(file, 0, SEEK_END);
+  size = ftell(file);
+  fseek(file, 0, SEEK_SET);
+  HOST_CHECK(size == (long)(image_slot_size_get() - flash_sector_size_get() + sizeof(image_header_type)));
+  HOST_CHECK(fread((void *)(uintptr_t)slot_addr, 1, (size_t)size, file) == (size_t)size);
+  fclose(file);
+
+  HOST_CHECK(memcmp((void *)(uintptr_t)slot_addr, app, length) == 0);
+
+  unlink(app_name);
+  unlink(slot_name);
+  free(app);
+}
+
+int main(int argc, char *argv[])
+{
+  uint32_t slot0, slot1, version = 0;
+  image_header_type *header;
+
+  if(argc < 2)
+  {
+    printf("usage: %s <image_header generator>\n", argv[0]);
+    return 2;
+  }
+
+  host_map_init();
+  srand(1);
+  slot0 = APP_START_ADDR;
+  slot1 = APP_START_ADDR + image_slot_size_get();
+  header = (image_header_type *)(uintptr_t)(slot1 + image_slot_size_get() - flash_sector_size_get());
+
+  /* erased flash, nothing to run */
+  HOST_CHECK(image_verify(slot0, &version) == IMAGE_NONE);
+  HOST_CHECK(image_boot_select() == 0);
+
+  /* one image, a length off the sector size */
+  slot_load(argv[1], 0, 0x2345, 3);
+  HOST_CHECK(image_verify(slot0, &version) == IMAGE_VALID);
+  HOST_CHECK(version == 3);
+  HOST_CHECK(image_boot_select() == slot0);
+
+  /* the highest version wins, a length of whole sectors */
+  slot_load(argv[1], 1, 0x3000, 5);
+  HOST_CHECK(image_verify(slot1, &version) == IMAGE_VALID);
+  HOST_CHECK(version == 5);
+  HOST_CHECK(image_boot_select() == slot1);
+
+  /* a bit flipped in the padding of the last sector */
+  slot_load(argv[1], 1, 0x2F00, 5);
+  *(uint8_t *)(uintptr_t)(slot1 + 0x2FF0) ^= 0x10;
+  HOST_CHECK(image_verify(slot1, &version) == IMAGE_BAD);
+  HOST_CHECK(image_boot_select() == slot0);
+
+  /* a bit flipped in the app */
+  slot_load(argv[1], 1, 0x2F00, 5);
+  *(uint8_t *)(uintptr_t)(slot1 + 0x1000) ^= 0x01;
+  HOST_CHECK(image_boot_select() == slot0);
+
+  /* a header which fails its check word */
+  slot_load(argv[1], 1, 0x2F00, 5);
+  header->version = 6;
+  HOST_CHECK(image_verify(slot1, &version) == IMAGE_BAD);
+  HOST_CHECK(image_boot_select() == slot0);
+
+  return host_report("test_image_slot");
+}
@@ -0,0 +1,310 @@
+/**
+  **************************************************************************
+  * @file     test_kv.c
+  * @brief    host test of the key/value store with power cuts
+  **************************************************************************
+  *
+  * Copyright (c) 2025, Artery Technology, All rights reserved.
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+/* usage: test_kv
+
+   the key/value store (kv_application.c) on the mapped main flash, with
+   flash_halfword_program() and flash_sector_erase() faked as a nor flash: a
+   program clears bits of an erased halfword, or writes 0, anything else is
+   a program error and leaves the flash as it was. a power cut is injected
+   at a random flash operation: the halfword being programmed keeps part of
+   its cleared bits, the sector being erased part of its set ones, and the
+   run is left by longjmp. every cut is followed by a mount, itself cut at
+   times, then every key is read: the acknowledged value, or for the key
+   written or deleted at the cut the old or the new one. writes, deletes
+   and background collections go on for thousands of cuts. a record cut off
+   before its crc, whose data happens to have the crc 0xffff, was taken as
+   written before the crc was stored as 0 for it. */
+
+#include <setjmp.h>
+#include <stdlib.h>
+#include <string.h>
+#include "kv_application.h"
+#include "host_map.h"
+
+#define KV_BASE                          0x08010000
+#define KV_SECTOR_SIZE                   1024
+#define KV_SECTOR_NUM                    6
+#define KV_KEYS                          32
+#define KV_VALUE_MAX                     48
+#define RUN_STEPS                        200000
+#define CUT_RATE                         300       /* one flash operation in CUT_RATE is cut */
+
+static kv_handle_type hkv;
+static uint32_t kv_index[KV_KEYS];
+
+/* the flash: operations, a cut armed, errors of the library */
+static jmp_buf cut_jmp;
+static confirm_state cut_armed;
+static uint32_t flash_ops;
+static uint32_t cut_count;
+static uint32_t cut_erase_count;
+static uint32_t program_error_count;
+
+/* the values acknowledged, the key of the operation running at a cut */
+static uint8_t model_value[KV_KEYS][KV_VALUE_MAX];
+static uint16_t model_len[KV_KEYS];
+static confirm_state model_present[KV_KEYS];
+static int32_t pending_key;
+static uint8_t pending_value[KV_VALUE_MAX];
+static uint16_t pending_len;
+static confirm_state pending_present;
+
+/* counters of the run, kept out of the registers across the longjmp */
+static uint32_t failed;
+static uint32_t mount_failed;
+static uint32_t status_failed;
+static uint32_t gc_steps;
+static uint32_t writes;
+static uint32_t deletes;
+
+/**
+  * @brief  check whether the next flash operation is cut, when cuts are armed.
+  */
+static confirm_state cut_now(void)
+{
+  flash_ops++;
+  return ((cut_armed == TRUE) && ((rand() % CUT_RATE) == 0)) ? TRUE : FALSE;
+}
+
+void flash_unlock(void)
+{
+}
+
+void flash_lock(void)
+{
+}
+
+flash_status_type flash_halfword_program(uint32_t address, uint16_t data)
+{
+  __IO uint16_t *hw = (__IO uint16_t *)address;
+
+  if(cut_now() == TRUE)
+  {
+    /* some of the bits to clear are cleared */
+    *hw &= (uint16_t)(data | rand());
+    cut_count++;
+    longjmp(cut_jmp, 1);
+  }
+
+  if((*hw != 0xFFFF) && (data != 0))
+  {
+    program_error_count++;
+    return FLASH_PROGRAM_ERROR;
+  }
+
+  *hw &= data;
+  return FLASH_OPERATE_DONE;
+}
+
+flash_status_type flash_sector_erase(uint32_t sector_address)
+{
+  __IO uint16_t *hw = (__IO uint16_t *)(sector_address & ~(uint32_t)(KV_SECTOR_SIZE - 1));
+  uint32_t i;
+
+  if(cut_now() == TRUE)
+  {
+    /* part of the cells erased, the others with some bits set */
+    for(i = 0; i < KV_SECTOR_SIZE / 2; i++)
+    {
+      hw[i] = (rand() & 1) ? 0xFFFF : (uint16_t)(hw[i] | (rand() & rand()));
+    }
+    cut_count++;
+    cut_erase_count++;
+    longjmp(cut_jmp, 1);
+  }
+
+  for(i = 0; i < KV_SECTOR_SIZE / 2; i++)
+  {
+    hw[i] = 0xFFFF;
+  }
+  return FLASH_OPERATE_DONE;
+}
+
+/**
+  * @brief  mount after a cut, the mount itself may be cut.
+  * @retval status of the mount which ran to its end.
+  */
+static kv_status_type mount(void)
+{
+  kv_status_type status;
+
+  while(setjmp(cut_jmp) != 0)
+  {
+  }
+  status = kv_init(&hkv);
+
+  return status;
+}
+
+/**
+  * @brief  check every key against the model after a mount, the pending one
+  *         may hold its old or its new value, the model takes what it holds.
+  * @retval keys which hold neither.
+  */
+static uint32_t keys_check(void)
+{
+  uint8_t buf[KV_VALUE_MAX];
+  uint16_t len = 0;
+  uint32_t failed = 0;
+  int32_t key;
+  kv_status_type status;
+  confirm_state old_ok, new_ok;
+
+  for(key = 0; key < KV_KEYS; key++)
+  {
+    memset(buf, 0, sizeof(buf));
+    status = kv_read(&hkv, (uint16_t)key, buf, sizeof(buf), &len);
+
+    old_ok = (model_present[key] == TRUE) ?
+             ((status == KV_OK) && (len == model_len[key]) && (memcmp(buf, model_value[key], len) == 0)) :
+             (status == KV_ERR_NOT_FOUND);
+    new_ok = FALSE;
+    if(key == pending_key)
+    {
+      new_ok = (pending_present == TRUE) ?
+               ((status == KV_OK) && (len == pending_len) && (memcmp(buf, pending_value, len) == 0)) :
+               (status == KV_ERR_NOT_FOUND);
+    }
+
+    if((old_ok == FALSE) && (new_ok == FALSE))
+    {
+      failed++;
+    }
+    else if(old_ok == FALSE)
+    {
+      model_present[key] = pending_present;
+      model_len[key] = pending_len;
+      memcpy(model_value[key], pending_value, pending_len);
+    }
+  }
+
+  pending_key = -1;
+  return failed;
+}
+
+int main(void)
+{
+  uint32_t step, kind, i;
+  kv_status_type status;
+
+  host_map_init();
+  srand(7);
+
+  hkv.base_addr = KV_BASE;
+  hkv.sector_size = KV_SECTOR_SIZE;
+  hkv.sector_num = KV_SECTOR_NUM;
+  hkv.gc_free_min = 2;
+  hkv.index = kv_index;
+  hkv.key_num = KV_KEYS;
+
+  /* parameters */
+  hkv.sector_num = 2;
+  HOST_CHECK(kv_init(&hkv) == KV_ERR_PARAM);
+  hkv.sector_num = KV_SECTOR_NUM;
+  hkv.gc_free_min = KV_SECTOR_NUM;
+  HOST_CHECK(kv_init(&hkv) == KV_ERR_PARAM);
+  hkv.gc_free_min = 2;
+
+  HOST_CHECK(kv_format(&hkv) == KV_OK);
+  HOST_CHECK(kv_write(&hkv, KV_KEYS, "x", 1) == KV_ERR_PARAM);
+  HOST_CHECK(kv_write(&hkv, 0, "x", KV_SECTOR_SIZE) == KV_ERR_PARAM);
+  HOST_CHECK(kv_delete(&hkv, 1) == KV_ERR_NOT_FOUND);
+
+  /* without cuts a mount finds what was written */
+  for(i = 0; i < KV_KEYS; i++)
+  {
+    model_len[i] = (uint16_t)(i % KV_VALUE_MAX);
+    memset(model_value[i], (int)i, model_len[i]);
+    model_present[i] = TRUE;
+    status_failed += (kv_write(&hkv, (uint16_t)i, model_value[i], model_len[i]) != KV_OK);
+  }
+  pending_key = -1;
+  HOST_CHECK(status_failed == 0);
+  HOST_CHECK((kv_init(&hkv) == KV_OK) && (keys_check() == 0));
+
+  /* random writes, deletes and collections with power cuts */
+  cut_armed = TRUE;
+  for(step = 0; step < RUN_STEPS; step++)
+  {
+    kind = rand() % 10;
+    pending_key = rand() % KV_KEYS;
+    pending_present = ((kind == 0) && (model_present[pending_key] == TRUE)) ? FALSE : TRUE;
+    pending_len = (pending_present == TRUE) ? (uint16_t)(rand() % (KV_VALUE_MAX + 1)) : 0;
+    for(i = 0; i < pending_len; i++)
+    {
+      pending_value[i] = (uint8_t)rand();
+    }
+    if(kind == 9)
+    {
+      pending_key = -1;
+    }
+
+    if(setjmp(cut_jmp) != 0)
+    {
+      /* power cut: mount and check */
+      mount_failed += (mount() != KV_OK);
+      failed += keys_check();
+      continue;
+    }
+
+    if(kind == 9)
+    {
+      gc_steps += (kv_gc_step(&hkv) == TRUE);
+      continue;
+    }
+
+    if(pending_present == TRUE)
+    {
+      status = kv_write(&hkv, (uint16_t)pending_key, pending_value, pending_len);
+      writes++;
+    }
+    else
+    {
+      status = kv_delete(&hkv, (uint16_t)pending_key);
+      deletes++;
+    }
+    status_failed += (status != KV_OK);
+
+    model_present[pending_key] = pending_present;
+    model_len[pending_key] = pending_len;
+    memcpy(model_value[pending_key], pending_value, pending_len);
+    pending_key = -1;
+  }
+  cut_armed = FALSE;
+
+  HOST_CHECK((cut_count > 1000) && (cut_erase_count > 10));
+  HOST_CHECK((failed == 0) && (mount_failed == 0) && (status_failed == 0));
+  HOST_CHECK(program_error_count == 0);
+
+  /* a last clean mount holds the model */
+  HOST_CHECK((kv_init(&hkv) == KV_OK) && (keys_check() == 0));
+
+  printf("kv store %u sectors of %u bytes, %u keys: %u writes, %u deletes, %u collections, "
+         "%u flash operations, %u power cuts, %u of them in an erase\n",
+         KV_SECTOR_NUM, KV_SECTOR_SIZE, KV_KEYS, writes, deletes, gc_steps, flash_ops, cut_count, cut_erase_count);
+
+  return host_report("test_kv");
+}
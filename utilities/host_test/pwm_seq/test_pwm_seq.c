@@ -0,0 +1,450 @@
+/**
+  **************************************************************************
+  * @file     test_pwm_seq.c
+  * @brief    host test of the pwm sequencer application library
+  **************************************************************************
+  *
+  * Copyright (c) 2025, Artery Technology, All rights reserved.
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+/* usage: test_pwm_seq
+
+   pwm_seq_application.c and the timer driver run against a model of the
+   overflow burst dma: on every overflow the buffered period and duty take
+   the values written before, they are recorded as the period that starts,
+   then the burst writes the registers from dmactrl addr and counts the loop
+   mode dtcnt down. the half and full transfer callbacks run when a block is
+   loaded, or some overflows later to make an underrun. the tables are a
+   stepper acceleration ramp and the bits of an led strip frame. */
+
+#include <string.h>
+#include "pwm_seq_application.h"
+#include "host_map.h"
+
+#define PERIODS_MAX              256
+
+/* fake dma application */
+static confirm_state dma_busy = FALSE;
+static uint32_t dma_free_count = 0;
+
+/* periods started by the timer, from the buffered registers */
+static uint16_t period_pr[PERIODS_MAX];
+static uint16_t period_duty[PERIODS_MAX];
+static uint32_t period_num = 0;
+static uint64_t period_time = 0;
+
+/* transfer interrupts not taken yet, 0 first block, 1 second. they wait
+   for irq_take() while irq_hold is set */
+static uint8_t irq_pending[4];
+static uint8_t irq_pending_num = 0;
+static confirm_state irq_hold = FALSE;
+
+/* end callbacks */
+static uint32_t done_count = 0;
+
+/* led strip frame of the fill callback */
+static const uint8_t led_frame[] = {0xA5, 0x3C, 0xFF};
+static uint32_t led_bit = 0;
+
+#define LED_PERIOD               89
+#define LED_DUTY_0               28
+#define LED_DUTY_1               57
+
+static pwm_seq_handle_type hseq;
+static uint16_t seq_buf[2 * 8 * 3];
+static uint16_t table[PERIODS_MAX * 3];
+
+void crm_periph_reset(crm_periph_reset_type value, confirm_state new_state)
+{
+}
+
+dma_app_status_type dma_channel_alloc(dma_handle_type* hdma, dma_request_type request)
+{
+  if(dma_busy == TRUE)
+  {
+    return DMA_APP_ERR_BUSY;
+  }
+
+  hdma->request = request;
+  hdma->channel = DMA1_CHANNEL5;
+  hdma->channel_index = 5;
+  return DMA_APP_OK;
+}
+
+void dma_channel_free(dma_handle_type* hdma)
+{
+  dma_free_count++;
+}
+
+void dma_default_para_init(dma_init_type* dma_init_struct)
+{
+  memset(dma_init_struct, 0, sizeof(dma_init_type));
+}
+
+void dma_desc_build(dma_desc_type* desc, dma_init_type* dma_init_struct)
+{
+  desc->ctrl = (dma_init_struct->loop_mode_enable == TRUE) ? 0x20 : 0;
+  desc->dtcnt = dma_init_struct->buffer_size;
+  desc->paddr = dma_init_struct->peripheral_base_addr;
+  desc->maddr = dma_init_struct->memory_base_addr;
+  desc->next = 0;
+}
+
+dma_app_status_type dma_chain_start(dma_handle_type* hdma, dma_desc_type* desc)
+{
+  hdma->desc = desc;
+  hdma->channel->dtcnt = desc->dtcnt;
+  hdma->busy = 1;
+  return DMA_APP_OK;
+}
+
+void dma_chain_stop(dma_handle_type* hdma)
+{
+  hdma->busy = 0;
+}
+
+/**
+  * @brief  take the transfer interrupts that are due.
+  */
+static void irq_take(void)
+{
+  uint8_t index;
+
+  for(index = 0; index < irq_pending_num; index++)
+  {
+    if(irq_pending[index] == 0)
+    {
+      hseq.dma.half_callback(&hseq.dma, hseq.dma.desc);
+    }
+    else
+    {
+      hseq.dma.full_callback(&hseq.dma, hseq.dma.desc);
+    }
+  }
+  irq_pending_num = 0;
+}
+
+/**
+  * @brief  one timer overflow: the buffered registers start a period, then
+  *         the burst dma writes the registers of the period after it.
+  */
+static void timer_overflow(void)
+{
+  tmr_type *tmrx = hseq.tmrx;
+  dma_channel_type *channel = hseq.dma.channel;
+  uint16_t total = (uint16_t)hseq.desc.dtcnt;
+  uint16_t pos;
+  uint8_t index;
+
+  if(period_num < PERIODS_MAX)
+  {
+    period_pr[period_num] = (uint16_t)tmrx->pr;
+    period_duty[period_num] = (uint16_t)tmrx->c1dt;
+  }
+  period_num++;
+  period_time += tmrx->pr + 1;
+
+  if(((tmrx->iden & TMR_OVERFLOW_DMA_REQUEST) == 0) || (hseq.dma.busy == 0))
+  {
+    return;
+  }
+
+  for(index = 0; index <= tmrx->dmactrl_bit.dtb; index++)
+  {
+    pos = total - (uint16_t)channel->dtcnt;
+    ((__IO uint32_t *)tmrx)[tmrx->dmactrl_bit.addr + index] = seq_buf[pos];
+
+    if(--channel->dtcnt == 0)
+    {
+      channel->dtcnt = total;
+      irq_pending[irq_pending_num++] = 1;
+    }
+    else if(pos + 1 == total / 2)
+    {
+      irq_pending[irq_pending_num++] = 0;
+    }
+  }
+
+  if(irq_hold == FALSE)
+  {
+    irq_take();
+  }
+}
+
+/**
+  * @brief  end callback.
+  */
+static void seq_done(pwm_seq_handle_type* hs)
+{
+  done_count++;
+}
+
+/**
+  * @brief  fill callback of the led strip frame, a bit a period with the
+  *         duty of its value, then a period low as the reset of the strip.
+  */
+static uint16_t led_fill(pwm_seq_handle_type* hs, uint16_t* entries, uint16_t periods)
+{
+  uint16_t count = 0;
+
+  while((count < periods) && (led_bit <= sizeof(led_frame) * 8))
+  {
+    if(led_bit == sizeof(led_frame) * 8)
+    {
+      entries[count] = 0;
+    }
+    else
+    {
+      entries[count] = (led_frame[led_bit / 8] & (0x80 >> (led_bit % 8))) ? LED_DUTY_1 : LED_DUTY_0;
+    }
+    led_bit++;
+    count++;
+  }
+
+  return count;
+}
+
+/**
+  * @brief  run overflows, up to the end callback and some more.
+  */
+static void timer_run(uint32_t overflows_after_done)
+{
+  uint32_t guard = 0;
+
+  while((done_count == 0) && (guard++ < PERIODS_MAX))
+  {
+    timer_overflow();
+  }
+  while(overflows_after_done--)
+  {
+    timer_overflow();
+  }
+}
+
+/**
+  * @brief  timer state before a sequence.
+  */
+static void timer_reset(tmr_type* tmrx, uint16_t pr, uint16_t duty)
+{
+  memset((void *)tmrx, 0, sizeof(tmr_type));
+  tmrx->pr = pr;
+  tmrx->c1dt = duty;
+  period_num = 0;
+  period_time = 0;
+  irq_pending_num = 0;
+  done_count = 0;
+}
+
+/**
+  * @brief  a stepper acceleration ramp of three registers a period, pr, rpr
+  *         and c1dt, played from a table longer than the dma buffer.
+  */
+static void ramp_test(void)
+{
+  uint32_t periods = 38;
+  uint32_t index;
+  uint32_t c = 20000;
+  uint64_t time = 0;
+  uint32_t bad = 0;
+
+  /* c(i) = c(i-1) - 2 c(i-1) / (4 i + 1), the period of a constant
+     acceleration, half duty */
+  for(index = 0; index < periods; index++)
+  {
+    if(index != 0)
+    {
+      c -= 2 * c / (4 * index + 1);
+    }
+    table[index * 3] = (uint16_t)(c - 1);
+    table[index * 3 + 1] = 0;
+    table[index * 3 + 2] = (uint16_t)(c / 2);
+    time += c;
+  }
+
+  timer_reset(TMR1, 999, 500);
+  memset(&hseq, 0, sizeof(hseq));
+  hseq.tmrx = TMR1;
+  hseq.base = TMR_PR_ADDRESS;
+  hseq.burst = 3;
+  hseq.done = seq_done;
+  HOST_CHECK(pwm_seq_init(&hseq, seq_buf, 4) == PWM_SEQ_OK);
+  HOST_CHECK(hseq.desc.dtcnt == 2 * 4 * 3);
+  HOST_CHECK(hseq.desc.paddr == (uint32_t)(uintptr_t)&TMR1->dmadt);
+  HOST_CHECK((TMR1->dmactrl_bit.addr == TMR_PR_ADDRESS) && (TMR1->dmactrl_bit.dtb == 2));
+  HOST_CHECK((TMR1->ctrl1_bit.prben == 1) && (TMR1->cm1_output_bit.c1oben == 1));
+
+  HOST_CHECK(pwm_seq_table_play(&hseq, table, periods) == PWM_SEQ_OK);
+  HOST_CHECK((hseq.busy == 1) && (TMR1->ctrl1_bit.tmren == 1));
+  HOST_CHECK(pwm_seq_table_play(&hseq, table, periods) == PWM_SEQ_ERR_BUSY);
+
+  timer_run(3);
+  HOST_CHECK(done_count == 1);
+  HOST_CHECK(hseq.busy == 0);
+  HOST_CHECK((TMR1->iden & TMR_OVERFLOW_DMA_REQUEST) == 0);
+  HOST_CHECK(hseq.underrun_count == 0);
+
+  /* the period before the table, the table in order, then its last one */
+  HOST_CHECK((period_pr[0] == 999) && (period_duty[0] == 500));
+  for(index = 0; index < periods; index++)
+  {
+    if((period_pr[index + 1] != table[index * 3]) || (period_duty[index + 1] != table[index * 3 + 2]))
+    {
+      bad++;
+    }
+  }
+  HOST_CHECK(bad == 0);
+  for(index = periods + 1; index < period_num; index++)
+  {
+    if(period_pr[index] != table[(periods - 1) * 3])
+    {
+      bad++;
+    }
+  }
+  HOST_CHECK(bad == 0);
+
+  /* the ramp lasts the sum of its periods */
+  time += 999 + 1 + (uint64_t)(period_num - periods - 1) * (table[(periods - 1) * 3] + 1);
+  HOST_CHECK(period_time == time);
+
+  pwm_seq_deinit(&hseq);
+  HOST_CHECK(dma_free_count == 1);
+}
+
+/**
+  * @brief  an led strip frame from the fill callback, c1dt only.
+  */
+static void led_test(void)
+{
+  uint32_t bits = sizeof(led_frame) * 8;
+  uint32_t index;
+  uint32_t bad = 0;
+
+  timer_reset(TMR16, LED_PERIOD, 0);
+  memset(&hseq, 0, sizeof(hseq));
+  hseq.tmrx = TMR16;
+  hseq.base = TMR_C1DT_ADDRESS;
+  hseq.burst = 1;
+  hseq.fill = led_fill;
+  hseq.done = seq_done;
+  led_bit = 0;
+  HOST_CHECK(pwm_seq_init(&hseq, seq_buf, 8) == PWM_SEQ_OK);
+  HOST_CHECK((TMR16->ctrl1_bit.prben == 0) && (TMR16->cm1_output_bit.c1oben == 1));
+  HOST_CHECK(pwm_seq_start(&hseq) == PWM_SEQ_OK);
+
+  timer_run(4);
+  HOST_CHECK(done_count == 1);
+  HOST_CHECK(hseq.underrun_count == 0);
+
+  for(index = 0; index < bits; index++)
+  {
+    uint16_t duty = (led_frame[index / 8] & (0x80 >> (index % 8))) ? LED_DUTY_1 : LED_DUTY_0;
+
+    if((period_duty[index + 1] != duty) || (period_pr[index + 1] != LED_PERIOD))
+    {
+      bad++;
+    }
+  }
+  HOST_CHECK(bad == 0);
+
+  /* the reset period holds the line low to the end */
+  for(index = bits + 1; index < period_num; index++)
+  {
+    if(period_duty[index] != 0)
+    {
+      bad++;
+    }
+  }
+  HOST_CHECK(bad == 0);
+  HOST_CHECK(period_num >= bits + 2);
+
+  pwm_seq_deinit(&hseq);
+}
+
+/**
+  * @brief  a block interrupt taken after the dma went back into the block.
+  */
+static void underrun_test(void)
+{
+  uint32_t index;
+
+  for(index = 0; index < 64; index++)
+  {
+    table[index] = (uint16_t)(100 + index);
+  }
+
+  timer_reset(TMR3, 999, 0);
+  memset(&hseq, 0, sizeof(hseq));
+  hseq.tmrx = TMR3;
+  hseq.base = TMR_C1DT_ADDRESS;
+  hseq.burst = 1;
+  hseq.done = seq_done;
+  HOST_CHECK(pwm_seq_init(&hseq, seq_buf, 4) == PWM_SEQ_OK);
+  HOST_CHECK(pwm_seq_table_play(&hseq, table, 64) == PWM_SEQ_OK);
+
+  /* on time for two blocks, then the interrupts wait until the dma is in
+     the first block again */
+  for(index = 0; index < 8; index++)
+  {
+    timer_overflow();
+  }
+  HOST_CHECK(hseq.underrun_count == 0);
+  irq_hold = TRUE;
+  for(index = 0; index < 9; index++)
+  {
+    timer_overflow();
+  }
+  irq_hold = FALSE;
+  irq_take();
+  HOST_CHECK(hseq.underrun_count != 0);
+
+  pwm_seq_stop(&hseq);
+  HOST_CHECK(hseq.busy == 0);
+  pwm_seq_deinit(&hseq);
+}
+
+int main(void)
+{
+  host_map_init();
+
+  /* parameters */
+  memset(&hseq, 0, sizeof(hseq));
+  hseq.tmrx = TMR6;
+  hseq.base = TMR_C1DT_ADDRESS;
+  hseq.burst = 1;
+  HOST_CHECK(pwm_seq_init(&hseq, seq_buf, 4) == PWM_SEQ_ERR_PARAM);
+  hseq.tmrx = TMR1;
+  HOST_CHECK(pwm_seq_init(&hseq, 0, 4) == PWM_SEQ_ERR_PARAM);
+  HOST_CHECK(pwm_seq_init(&hseq, seq_buf, 0) == PWM_SEQ_ERR_PARAM);
+  hseq.burst = 0;
+  HOST_CHECK(pwm_seq_init(&hseq, seq_buf, 4) == PWM_SEQ_ERR_PARAM);
+  hseq.base = TMR_C4DT_ADDRESS;
+  hseq.burst = 3;
+  HOST_CHECK(pwm_seq_init(&hseq, seq_buf, 4) == PWM_SEQ_ERR_PARAM);
+  hseq.base = TMR_C1DT_ADDRESS;
+  hseq.burst = 1;
+  dma_busy = TRUE;
+  HOST_CHECK(pwm_seq_init(&hseq, seq_buf, 4) == PWM_SEQ_ERR_BUSY);
+  dma_busy = FALSE;
+
+  ramp_test();
+  led_test();
+  underrun_test();
+
+  return host_report("test_pwm_seq");
+}
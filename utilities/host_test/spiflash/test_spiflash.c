@@ -0,0 +1,625 @@
+/**
+  **************************************************************************
+  * @file     test_spiflash.c
+  * @brief    host test of the spi flash library on a w25q command simulator
+  **************************************************************************
+  *
+  * Copyright (c) 2025, Artery Technology, All rights reserved.
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+/* usage: test_spiflash
+
+   the spi flash library (spiflash_application.c) on a w25q command
+   simulator. the spi data register, the cs pin and the dma of the library
+   are faked: every byte goes through the simulator, which decodes the
+   instructions between cs edges as the chip does: write enable, status
+   register 1, fast read, page program and sector erase, with the busy time
+   of the erase and the program counted in timer ticks. a program or erase
+   without write enable, an instruction while busy, a page program wrapping
+   in its page or setting a bit from 0 to 1, and a cs edge out of place are
+   counted as protocol errors. it checks single requests against the bytes
+   they should take on the bus, then random requests queued several at a
+   time against a reference image, and prints the bus bytes per operation. */
+
+#include <stdlib.h>
+#include <string.h>
+#include "spiflash_application.h"
+#include "host_map.h"
+
+#define SIM_SIZE                         0x20000
+#define SIM_ERASE_TICKS                  45
+#define SIM_PROG_TICKS                   1
+#define SIM_QUEUE_SIZE                   8
+#define RANDOM_ROUNDS                    1500
+
+/* the chip: array, instruction in progress, write enable latch, busy ticks */
+static uint8_t sim_mem[SIM_SIZE];
+static confirm_state sim_cs_low;
+static uint8_t sim_cmd;
+static uint32_t sim_pos;
+static uint32_t sim_addr;
+static uint8_t sim_wel;
+static uint32_t sim_busy;
+static uint8_t sim_rx;
+
+/* counters of the simulator */
+static uint32_t sim_errors;
+static uint32_t sim_bytes;
+static uint32_t sim_erases;
+static uint32_t sim_programs;
+static uint32_t sim_status_reads;
+
+static spiflash_handle_type hflash;
+static spiflash_request_type *queue_buf[SIM_QUEUE_SIZE];
+static uint8_t sector_buf[SPIFLASH_SECTOR_SIZE];
+static uint32_t dma_done;
+
+/* requests and their buffers, static as the dma images hold 32 bit addresses */
+static spiflash_request_type req[SIM_QUEUE_SIZE];
+static uint8_t req_buf[SIM_QUEUE_SIZE][3 * SPIFLASH_SECTOR_SIZE];
+static uint8_t big_buf[0x11200];
+static uint8_t model[SIM_SIZE];
+static uint32_t callback_count;
+
+/**
+  * @brief  one byte clocked on the bus, returns the byte of the chip.
+  */
+static uint8_t sim_exchange(uint8_t data)
+{
+  uint32_t pos, offset, addr;
+
+  sim_bytes++;
+  if(sim_cs_low == FALSE)
+  {
+    sim_errors++;
+    return 0xFF;
+  }
+
+  pos = sim_pos++;
+  if(pos == 0)
+  {
+    sim_cmd = data;
+    sim_addr = 0;
+    if((sim_busy != 0) && (data != SPIFLASH_CMD_READSTATUSREG1))
+    {
+      sim_errors++;
+    }
+    if(((data == SPIFLASH_CMD_PAGEPROGRAM) || (data == SPIFLASH_CMD_SECTORERASE)) && (sim_wel == 0))
+    {
+      sim_errors++;
+    }
+    if(data == SPIFLASH_CMD_READSTATUSREG1)
+    {
+      sim_status_reads++;
+    }
+    return 0xFF;
+  }
+
+  switch(sim_cmd)
+  {
+    case SPIFLASH_CMD_READSTATUSREG1:
+      return (uint8_t)(((sim_busy != 0) ? SPIFLASH_SR1_BUSY : 0) | (sim_wel << 1));
+
+    case SPIFLASH_CMD_WRITEENABLE:
+      sim_errors++;
+      return 0xFF;
+
+    case SPIFLASH_CMD_FASTREADDATA:
+    case SPIFLASH_CMD_PAGEPROGRAM:
+    case SPIFLASH_CMD_SECTORERASE:
+      if(pos <= 3)
+      {
+        sim_addr = (sim_addr << 8) | data;
+        return 0xFF;
+      }
+      if(sim_cmd == SPIFLASH_CMD_SECTORERASE)
+      {
+        sim_errors++;
+        return 0xFF;
+      }
+      if(sim_cmd == SPIFLASH_CMD_FASTREADDATA)
+      {
+        /* the dummy byte, then the array from the address on */
+        return (pos == 4) ? 0xFF : sim_mem[(sim_addr + pos - 5) % SIM_SIZE];
+      }
+
+      /* page program, the address wraps in the page */
+      offset = pos - 4;
+      if((sim_addr & (SPIFLASH_PAGE_SIZE - 1)) + offset >= SPIFLASH_PAGE_SIZE)
+      {
+        sim_errors++;
+      }
+      addr = ((sim_addr & ~(uint32_t)(SPIFLASH_PAGE_SIZE - 1)) | ((sim_addr + offset) & (SPIFLASH_PAGE_SIZE - 1))) % SIM_SIZE;
+      if((data & ~sim_mem[addr]) != 0)
+      {
+        sim_errors++;
+      }
+      if(sim_wel != 0)
+      {
+        sim_mem[addr] &= data;
+      }
+      return 0xFF;
+
+    default:
+      sim_errors++;
+      return 0xFF;
+  }
+}
+
+/**
+  * @brief  cs rising, the instruction takes effect.
+  */
+static void sim_cs_rise(void)
+{
+  if(sim_cs_low == FALSE)
+  {
+    return;
+  }
+  sim_cs_low = FALSE;
+
+  if(sim_pos == 0)
+  {
+    return;
+  }
+
+  switch(sim_cmd)
+  {
+    case SPIFLASH_CMD_WRITEENABLE:
+      sim_wel = 1;
+      break;
+
+    case SPIFLASH_CMD_PAGEPROGRAM:
+      if(sim_pos < 5)
+      {
+        sim_errors++;
+      }
+      else if(sim_wel != 0)
+      {
+        sim_programs++;
+        sim_busy = SIM_PROG_TICKS;
+      }
+      sim_wel = 0;
+      break;
+
+    case SPIFLASH_CMD_SECTORERASE:
+      if(sim_pos != 4)
+      {
+        sim_errors++;
+      }
+      else if(sim_wel != 0)
+      {
+        memset(&sim_mem[(sim_addr % SIM_SIZE) & ~(uint32_t)(SPIFLASH_SECTOR_SIZE - 1)], 0xFF, SPIFLASH_SECTOR_SIZE);
+        sim_erases++;
+        sim_busy = SIM_ERASE_TICKS;
+      }
+      sim_wel = 0;
+      break;
+
+    case SPIFLASH_CMD_FASTREADDATA:
+      if(sim_pos < 5)
+      {
+        sim_errors++;
+      }
+      break;
+
+    default:
+      break;
+  }
+}
+
+/* the drivers seen by the library */
+void gpio_bits_set(gpio_type *gpio_x, uint16_t pins)
+{
+  if((gpio_x == hflash.cs_gpio) && (pins == hflash.cs_pin))
+  {
+    sim_cs_rise();
+  }
+}
+
+void gpio_bits_reset(gpio_type *gpio_x, uint16_t pins)
+{
+  if((gpio_x == hflash.cs_gpio) && (pins == hflash.cs_pin))
+  {
+    if(sim_cs_low == TRUE)
+    {
+      sim_errors++;
+    }
+    sim_cs_low = TRUE;
+    sim_pos = 0;
+  }
+}
+
+flag_status spi_i2s_flag_get(spi_type* spi_x, uint32_t spi_i2s_flag)
+{
+  return SET;
+}
+
+void spi_i2s_data_transmit(spi_type* spi_x, uint16_t tx_data)
+{
+  sim_rx = sim_exchange((uint8_t)tx_data);
+}
+
+uint16_t spi_i2s_data_receive(spi_type* spi_x)
+{
+  return sim_rx;
+}
+
+void spi_i2s_dma_receiver_enable(spi_type* spi_x, confirm_state new_state)
+{
+}
+
+/**
+  * @brief  the transmit request starts the exchange of the two dma images,
+  *         the end is taken by the test loop as the receive channel interrupt.
+  */
+void spi_i2s_dma_transmitter_enable(spi_type* spi_x, confirm_state new_state)
+{
+  dma_desc_type *rx = hflash.dma_rx.desc, *tx = hflash.dma_tx.desc;
+  uint8_t *rp, *tp, data;
+  uint32_t index;
+
+  if((new_state == FALSE) || (hflash.dma_rx.busy == 0) || (hflash.dma_tx.busy == 0))
+  {
+    return;
+  }
+
+  if(rx->dtcnt != tx->dtcnt)
+  {
+    sim_errors++;
+  }
+
+  rp = (uint8_t *)(uintptr_t)rx->maddr;
+  tp = (uint8_t *)(uintptr_t)tx->maddr;
+  for(index = 0; index < tx->dtcnt; index++)
+  {
+    data = sim_exchange((tx->ctrl & 0x80) ? tp[index] : *tp);
+    if(rx->ctrl & 0x80)
+    {
+      rp[index] = data;
+    }
+    else
+    {
+      *rp = data;
+    }
+  }
+
+  dma_done++;
+}
+
+void dma_default_para_init(dma_init_type* dma_init_struct)
+{
+  memset(dma_init_struct, 0, sizeof(*dma_init_struct));
+}
+
+dma_app_status_type dma_channel_alloc(dma_handle_type* hdma, dma_request_type request)
+{
+  hdma->request = request;
+  hdma->channel = (hdma == &hflash.dma_rx) ? DMA1_CHANNEL2 : DMA1_CHANNEL3;
+  hdma->channel_index = (hdma == &hflash.dma_rx) ? 2 : 3;
+  return DMA_APP_OK;
+}
+
+void dma_channel_free(dma_handle_type* hdma)
+{
+  hdma->channel = 0;
+}
+
+void dma_desc_build(dma_desc_type* desc, dma_init_type* dma_init_struct)
+{
+  desc->ctrl = (dma_init_struct->memory_inc_enable == TRUE) ? 0x80 : 0;
+  desc->dtcnt = dma_init_struct->buffer_size;
+  desc->paddr = dma_init_struct->peripheral_base_addr;
+  desc->maddr = dma_init_struct->memory_base_addr;
+  desc->next = 0;
+}
+
+dma_app_status_type dma_chain_start(dma_handle_type* hdma, dma_desc_type* desc)
+{
+  hdma->desc = desc;
+  hdma->busy = 1;
+  return DMA_APP_OK;
+}
+
+void dma_chain_stop(dma_handle_type* hdma)
+{
+  hdma->busy = 0;
+}
+
+/**
+  * @brief  run the interrupts until every queued request has ended: the end
+  *         of a dma transfer, else a timer tick, the busy time of the chip
+  *         counted in ticks.
+  * @retval ticks taken.
+  */
+static uint32_t sim_run(void)
+{
+  uint32_t ticks = 0, guard = 10000000;
+
+  while((spiflash_idle_get(&hflash) == FALSE) && (--guard != 0))
+  {
+    if(dma_done != 0)
+    {
+      dma_done--;
+      hflash.dma_rx.busy = 0;
+      hflash.dma_rx.full_callback(&hflash.dma_rx, hflash.dma_rx.desc);
+    }
+    else
+    {
+      spiflash_timer_handler(&hflash);
+      if(sim_busy != 0)
+      {
+        sim_busy--;
+      }
+      ticks++;
+    }
+  }
+
+  if(guard == 0)
+  {
+    sim_errors++;
+  }
+
+  return ticks;
+}
+
+static void req_callback(spiflash_request_type* request)
+{
+  callback_count++;
+}
+
+static void req_set(spiflash_request_type* request, spiflash_op_type op, uint32_t addr, uint8_t* buf, uint32_t len)
+{
+  request->op = op;
+  request->addr = addr;
+  request->buf = buf;
+  request->len = len;
+  request->callback = req_callback;
+}
+
+/**
+  * @brief  run one request alone, returns the bus bytes it took.
+  */
+static uint32_t op_run(spiflash_op_type op, uint32_t addr, uint8_t* buf, uint32_t len)
+{
+  uint32_t bytes = sim_bytes;
+
+  req_set(&req[0], op, addr, buf, len);
+  if(spiflash_submit(&hflash, &req[0]) != SPIFLASH_OK)
+  {
+    sim_errors++;
+  }
+  sim_run();
+
+  return sim_bytes - bytes;
+}
+
+/**
+  * @brief  apply a finished request to the reference image, a read is checked
+  *         against it.
+  * @retval 1 when a read differs.
+  */
+static uint32_t model_apply(spiflash_request_type* request)
+{
+  uint32_t sector;
+
+  switch(request->op)
+  {
+    case SPIFLASH_OP_READ:
+      return (memcmp(request->buf, &model[request->addr], request->len) != 0) ? 1 : 0;
+
+    case SPIFLASH_OP_WRITE:
+      memcpy(&model[request->addr], request->buf, request->len);
+      return 0;
+
+    default:
+      sector = request->addr & ~(uint32_t)(SPIFLASH_SECTOR_SIZE - 1);
+      memset(&model[sector], 0xFF, SPIFLASH_SECTOR_SIZE);
+      return 0;
+  }
+}
+
+/**
+  * @brief  check whether a write or erase queued after a read in the round
+  *         changes the range of the read.
+  */
+static confirm_state round_touched(uint32_t read, uint32_t count)
+{
+  uint32_t later, first, last;
+
+  for(later = read + 1; later < count; later++)
+  {
+    if(req[later].op == SPIFLASH_OP_READ)
+    {
+      continue;
+    }
+
+    first = req[later].addr;
+    last = req[later].addr + req[later].len - 1;
+    if(req[later].op == SPIFLASH_OP_ERASE)
+    {
+      first = req[later].addr & ~(uint32_t)(SPIFLASH_SECTOR_SIZE - 1);
+      last = first + SPIFLASH_SECTOR_SIZE - 1;
+    }
+    if((first < req[read].addr + req[read].len) && (last >= req[read].addr))
+    {
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+/**
+  * @brief  a random request of the workload, writes mostly small, some over
+  *         sector boundaries, and a few with bits going from 0 to 1.
+  */
+static void random_request(spiflash_request_type* request, uint8_t* buf)
+{
+  uint32_t kind = rand() % 10, len, index, addr;
+
+  if(kind < 3)
+  {
+    len = 1 + rand() % (3 * SPIFLASH_SECTOR_SIZE);
+    req_set(request, SPIFLASH_OP_READ, rand() % (SIM_SIZE - len), buf, len);
+  }
+  else if(kind == 3)
+  {
+    req_set(request, SPIFLASH_OP_ERASE, rand() % SIM_SIZE, buf, 0);
+  }
+  else
+  {
+    len = (kind < 8) ? 1 + rand() % 64 : 1 + rand() % (2 * SPIFLASH_SECTOR_SIZE);
+    addr = rand() % (SIM_SIZE - len);
+    for(index = 0; index < len; index++)
+    {
+      /* clearing bits only, or any value */
+      buf[index] = (kind < 6) ? (uint8_t)(model[addr + index] & rand()) : (uint8_t)rand();
+    }
+    req_set(request, SPIFLASH_OP_WRITE, addr, buf, len);
+  }
+}
+
+int main(void)
+{
+  uint32_t bytes, reads, ticks, mismatch, index, round, count, before;
+  uint32_t prog_bytes, erase_bytes;
+
+  host_map_init();
+  srand(6);
+
+  hflash.spix = SPI1;
+  hflash.cs_gpio = GPIOA;
+  hflash.cs_pin = GPIO_PINS_4;
+
+  hflash.sector_buf = 0;
+  HOST_CHECK(spiflash_init(&hflash, queue_buf, SIM_QUEUE_SIZE) == SPIFLASH_ERR_PARAM);
+  hflash.sector_buf = sector_buf;
+  HOST_CHECK(spiflash_init(&hflash, queue_buf, 6) == SPIFLASH_ERR_PARAM);
+  HOST_CHECK(spiflash_init(&hflash, queue_buf, SIM_QUEUE_SIZE) == SPIFLASH_OK);
+
+  for(index = 0; index < SIM_SIZE; index++)
+  {
+    sim_mem[index] = (uint8_t)rand();
+  }
+  memcpy(model, sim_mem, SIM_SIZE);
+
+  /* a read is the instruction, 3 address bytes, the dummy byte and the data */
+  bytes = op_run(SPIFLASH_OP_READ, 0x1234, req_buf[0], 100);
+  HOST_CHECK((bytes == 5 + 100) && (memcmp(req_buf[0], &sim_mem[0x1234], 100) == 0));
+
+  /* longer than one dma transfer, cs stays low: one instruction */
+  bytes = op_run(SPIFLASH_OP_READ, 0x100, big_buf, sizeof(big_buf));
+  HOST_CHECK((bytes == 5 + sizeof(big_buf)) && (memcmp(big_buf, &sim_mem[0x100], sizeof(big_buf)) == 0));
+
+  /* an erase: write enable, the instruction, then status polls while busy */
+  before = sim_status_reads;
+  bytes = op_run(SPIFLASH_OP_ERASE, 0x3456, 0, 0);
+  memset(&model[0x3000], 0xFF, SPIFLASH_SECTOR_SIZE);
+  HOST_CHECK((sim_erases == 1) && (sim_status_reads - before == SIM_ERASE_TICKS));
+  HOST_CHECK((bytes == 1 + 4 + 2 * (sim_status_reads - before)) && (memcmp(&sim_mem[0x3000], &model[0x3000], SPIFLASH_SECTOR_SIZE) == 0));
+  erase_bytes = bytes;
+
+  /* 16 bytes into the blank sector: read back, one page program, no erase */
+  for(index = 0; index < 16; index++)
+  {
+    req_buf[0][index] = (uint8_t)(index * 11);
+  }
+  before = sim_status_reads;
+  bytes = op_run(SPIFLASH_OP_WRITE, 0x3010, req_buf[0], 16);
+  memcpy(&model[0x3010], req_buf[0], 16);
+  HOST_CHECK((sim_erases == 1) && (sim_programs == 1));
+  HOST_CHECK(bytes == (5 + 16) + (1 + 4 + 16) + 2 * (sim_status_reads - before));
+
+  /* the same data again: read back only */
+  bytes = op_run(SPIFLASH_OP_WRITE, 0x3010, req_buf[0], 16);
+  HOST_CHECK((bytes == 5 + 16) && (sim_programs == 1));
+
+  /* across a page boundary into blank flash, two programs */
+  bytes = op_run(SPIFLASH_OP_WRITE, 0x30F8, req_buf[0], 16);
+  memcpy(&model[0x30F8], req_buf[0], 16);
+  HOST_CHECK((sim_programs == 3) && (sim_erases == 1));
+  HOST_CHECK(memcmp(&sim_mem[0x3000], &model[0x3000], SPIFLASH_SECTOR_SIZE) == 0);
+
+  /* a bit from 0 to 1: the rest of the sector read, erased, the two pages
+     holding data programmed again */
+  req_buf[0][0] = 0xFF;
+  before = sim_status_reads;
+  bytes = op_run(SPIFLASH_OP_WRITE, 0x3010, req_buf[0], 1);
+  model[0x3010] = 0xFF;
+  HOST_CHECK((sim_erases == 2) && (sim_programs == 5));
+  HOST_CHECK(bytes == (5 + 1) + (5 + 0x10) + (5 + SPIFLASH_SECTOR_SIZE - 0x11) + (1 + 4) +
+                      2 * (1 + 4 + SPIFLASH_PAGE_SIZE) + 2 * (sim_status_reads - before));
+  HOST_CHECK(memcmp(&sim_mem[0x3000], &model[0x3000], SPIFLASH_SECTOR_SIZE) == 0);
+  prog_bytes = bytes;
+
+  HOST_CHECK((sim_errors == 0) && (callback_count == 7));
+
+  /* random requests, queued several at a time and ended in order */
+  reads = 0;
+  mismatch = 0;
+  ticks = 0;
+  callback_count = 0;
+  for(round = 0; round < RANDOM_ROUNDS; round++)
+  {
+    count = 1 + rand() % SIM_QUEUE_SIZE;
+    for(index = 0; index < count; index++)
+    {
+      random_request(&req[index], req_buf[index]);
+      mismatch += (spiflash_submit(&hflash, &req[index]) != SPIFLASH_OK);
+      reads += (req[index].op == SPIFLASH_OP_READ);
+
+      /* a write is applied to the model before the reads queued after it */
+      if(req[index].op != SPIFLASH_OP_READ)
+      {
+        model_apply(&req[index]);
+      }
+    }
+    if(count == SIM_QUEUE_SIZE)
+    {
+      mismatch += (spiflash_submit(&hflash, &req[0]) != SPIFLASH_ERR_FULL);
+    }
+
+    ticks += sim_run();
+    for(index = 0; index < count; index++)
+    {
+      mismatch += (req[index].status != SPIFLASH_OK);
+    }
+    /* reads see the image at the end of their round, check them when no
+       later write of the round touched them */
+    for(index = 0; index < count; index++)
+    {
+      if((req[index].op == SPIFLASH_OP_READ) && (round_touched(index, count) == FALSE))
+      {
+        mismatch += model_apply(&req[index]);
+      }
+    }
+  }
+  HOST_CHECK((mismatch == 0) && (callback_count > RANDOM_ROUNDS));
+  HOST_CHECK(memcmp(sim_mem, model, SIM_SIZE) == 0);
+  HOST_CHECK(sim_errors == 0);
+  HOST_CHECK((sim_bytes == hflash.bus_bytes) && (sim_erases == hflash.erase_count) && (sim_programs == hflash.program_count));
+
+  printf("spi flash bus bytes, w25q simulator, erase busy %u ticks, program busy %u tick\n", SIM_ERASE_TICKS, SIM_PROG_TICKS);
+  printf("  sector erase: %u bytes\n", erase_bytes);
+  printf("  1 byte with a bit from 0 to 1, 2 pages kept: %u bytes\n", prog_bytes);
+  printf("  random workload: %u requests, %u reads, %u bus bytes, %u erases, %u page programs, %u ticks\n",
+         callback_count, reads, sim_bytes, sim_erases, sim_programs, ticks);
+
+  return host_report("test_spiflash");
+}
@@ -0,0 +1,252 @@
+/**
+  **************************************************************************
+  * @file     test_tickless.c
+  * @brief    host test of the tick compensation of the freertos demo
+  **************************************************************************
+  *
+  * Copyright (c) 2025, Artery Technology, All rights reserved.
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+/* usage: test_tickless
+
+   tickless_idle.c is included to reach its static tick compensation steps,
+   tickless_sleep_counts() before a sleep and tickless_wakeup_cycles() after
+   it. a timeline in seconds stands for the hardware: the systick running at
+   system_core_clock, the ertc sub-second counter on the lext, sleeps ended
+   by the alarm or earlier by another interrupt and a hext and pll restart of
+   random length. it goes through the steps of vPortSuppressTicksAndSleep()
+   and compares the kernel time, the tick count and the systick phase, to
+   the real time at every wakeup and after hours of simulated time. */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "tickless_idle.c"
+#include "host_map.h"
+
+unsigned int system_core_clock = 120000000;
+
+/* timeline: the real time, the tick count, the start and the length of the
+   systick period in progress */
+static double sim_time;
+static uint32_t kernel_tick;
+static double tick_start;
+static uint32_t tick_cycles;
+
+/* kernel time error in ticks, its extremes at the wakeups, ticks stepped
+   up to the unblock one */
+static double error_min;
+static double error_max;
+static uint32_t step_over;
+
+eSleepModeStatus eTaskConfirmSleepModeStatus(void)
+{
+  return eStandardSleep;
+}
+
+void vTaskStepTick(const TickType_t xTicksToJump)
+{
+  kernel_tick += xTicksToJump;
+}
+
+static double random_unit(void)
+{
+  return rand() / ((double)RAND_MAX + 1.0);
+}
+
+/**
+  * @brief  ck_a periods since 0, the sub-second counter at a time and the
+  *         time of its next edge.
+  */
+static uint64_t ertc_count(double t)
+{
+  return (uint64_t)floor(t * TICKLESS_ERTC_FREQ);
+}
+
+static uint32_t ertc_sbs(uint64_t count)
+{
+  return (uint32_t)(TICKLESS_ERTC_DIV_B - count) & TICKLESS_ERTC_MASK;
+}
+
+static double ertc_edge(double t)
+{
+  return (ertc_count(t) + 1) / (double)TICKLESS_ERTC_FREQ;
+}
+
+/**
+  * @brief  run the systick to a time, returns the ticks it delivered.
+  */
+static uint32_t systick_run(double t)
+{
+  uint32_t ticks = 0;
+
+  while(tick_start + tick_cycles / (double)system_core_clock <= t)
+  {
+    tick_start += tick_cycles / (double)system_core_clock;
+    tick_cycles = TICKLESS_SYSTICK_PERIOD;
+    kernel_tick++;
+    ticks++;
+  }
+
+  return ticks;
+}
+
+/**
+  * @brief  kernel time minus real time in ticks, the kernel time is the tick
+  *         count plus the elapsed part of the systick period.
+  */
+static double kernel_error(void)
+{
+  double next = tick_start + tick_cycles / (double)system_core_clock;
+
+  return kernel_tick + 1 - (next - sim_time) * configTICK_RATE_HZ - sim_time * configTICK_RATE_HZ;
+}
+
+/**
+  * @brief  one idle period of vPortSuppressTicksAndSleep(): the systick
+  *         stopped on an ertc edge, the alarm, the wakeup by the alarm or an
+  *         early interrupt, the restart, the tick count stepped and the
+  *         systick restarted on the next ertc edge.
+  * @retval 1 when the cpu slept.
+  */
+static int idle_run(TickType_t idle, double early, double restart)
+{
+  uint32_t val, partial, counts, start, target, ticks;
+  uint64_t count;
+  double alarm, wake, error;
+
+  if(idle > TICKLESS_MAX_TICKS)
+  {
+    idle = TICKLESS_MAX_TICKS;
+  }
+
+  sim_time = ertc_edge(sim_time);
+  if(systick_run(sim_time) != 0)
+  {
+    /* a tick pending, aborted */
+    return 0;
+  }
+  start = ertc_sbs(ertc_count(sim_time));
+  val = tick_cycles - 1 - (uint32_t)floor((sim_time - tick_start) * system_core_clock);
+
+  counts = tickless_sleep_counts(idle, val, &partial);
+  if(counts < TICKLESS_MIN_COUNTS + TICKLESS_WAKEUP_COUNTS)
+  {
+    return 0;
+  }
+  counts -= TICKLESS_WAKEUP_COUNTS;
+  target = (start - counts) & TICKLESS_ERTC_MASK;
+
+  /* the alarm matches on the first counter edge to the target */
+  count = ertc_count(sim_time) + 1;
+  count += (ertc_sbs(count) - target) & TICKLESS_ERTC_MASK;
+  alarm = count / (double)TICKLESS_ERTC_FREQ;
+  wake = (early > 0) ? sim_time + early * (alarm - sim_time) : alarm;
+
+  sim_time = ertc_edge(wake + restart);
+  counts = (start - ertc_sbs(ertc_count(sim_time))) & TICKLESS_ERTC_MASK;
+
+  tick_cycles = tickless_wakeup_cycles(idle, partial, counts, &ticks);
+  tick_start = sim_time;
+  vTaskStepTick(ticks);
+  step_over += (ticks >= idle);
+
+  error = kernel_error();
+  error_min = (error < error_min) ? error : error_min;
+  error_max = (error > error_max) ? error : error_max;
+
+  return 1;
+}
+
+/**
+  * @brief  run sleeps of random idle times between awake times of up to
+  *         3 ms, 30 % of them ended early when early is set, the restart
+  *         between restart_min and restart_max seconds.
+  * @retval sleeps taken.
+  */
+static uint32_t timeline_run(uint32_t sleeps, confirm_state early, double restart_min, double restart_max)
+{
+  uint32_t slept = 0;
+  double stop;
+
+  sim_time = 0;
+  kernel_tick = 0;
+  tick_start = 0;
+  tick_cycles = TICKLESS_SYSTICK_PERIOD;
+  error_min = 0;
+  error_max = 0;
+  step_over = 0;
+  memset(&tickless_stats, 0, sizeof(tickless_stats));
+
+  while(sleeps--)
+  {
+    sim_time += random_unit() * 0.003;
+    systick_run(sim_time);
+
+    stop = ((early == TRUE) && (random_unit() < 0.3)) ? random_unit() : 0;
+    slept += idle_run(5 + rand() % 1996, stop, restart_min + random_unit() * (restart_max - restart_min));
+  }
+
+  return slept;
+}
+
+int main(void)
+{
+  uint32_t partial, ticks, slept;
+  double error;
+
+  host_map_init();
+  srand(1);
+
+  /* a sleep of 2 ticks from a tick start is the ck_a periods of one tick, the
+     alarm of the longest sleep stays within the sub-second period */
+  HOST_CHECK(tickless_sleep_counts(2, TICKLESS_SYSTICK_PERIOD - 1, &partial) == TICKLESS_ERTC_FREQ / configTICK_RATE_HZ);
+  HOST_CHECK(partial == 0);
+  HOST_CHECK(tickless_sleep_counts(TICKLESS_MAX_TICKS, TICKLESS_SYSTICK_PERIOD - 1, &partial) <= TICKLESS_MAX_COUNTS);
+  HOST_CHECK(tickless_sleep_counts(3, TICKLESS_SYSTICK_PERIOD / 2, &partial) ==
+             (2 * TICKLESS_ERTC_FREQ - TICKLESS_ERTC_FREQ / 2) / configTICK_RATE_HZ);
+
+  /* the rest of a tick carried by the systick */
+  HOST_CHECK(tickless_wakeup_cycles(10, 0, 0, &ticks) == TICKLESS_SYSTICK_PERIOD);
+  HOST_CHECK(ticks == 0);
+  HOST_CHECK(tickless_wakeup_cycles(10, 3 * TICKLESS_ERTC_FREQ + TICKLESS_ERTC_FREQ / 2 - 98 * configTICK_RATE_HZ, 98, &ticks) ==
+             TICKLESS_SYSTICK_PERIOD / 2);
+  HOST_CHECK((ticks == 3) && (tickless_stats.late_count == 0));
+
+  /* past the unblock time, the last tick is due at once */
+  HOST_CHECK(tickless_wakeup_cycles(10, 0, 11 * TICKLESS_ERTC_FREQ / configTICK_RATE_HZ, &ticks) == 3);
+  HOST_CHECK((ticks == 9) && (tickless_stats.late_count == 1));
+
+  /* restarts within TICKLESS_WAKEUP_COUNTS, alarm and early wakeups: the
+     kernel time stays within 1 us of the real time at every wakeup and after
+     about 17 hours, no drift */
+  slept = timeline_run(100000, TRUE, 0.0005, 0.0025);
+  error = kernel_error();
+  HOST_CHECK((slept > 98000) && (sim_time > 60000.0));
+  HOST_CHECK((tickless_stats.late_count == 0) && (step_over == 0));
+  HOST_CHECK((error_min > -0.001) && (error_max < 0.001) && (fabs(error) < 0.001));
+
+  /* restarts longer than the tick and TICKLESS_WAKEUP_COUNTS: every wakeup
+     by the alarm is late, the kernel time falls behind, never ahead */
+  slept = timeline_run(2000, FALSE, 0.0035, 0.0035);
+  HOST_CHECK((tickless_stats.late_count == slept) && (slept > 1900) && (step_over == 0));
+  HOST_CHECK((error_max < 0.001) && (kernel_error() < -1.0));
+
+  return host_report("test_tickless");
+}
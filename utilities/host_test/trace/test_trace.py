@@ -0,0 +1,105 @@
+#!/usr/bin/env python3
+# host test of the print uart trace tools: the id table extraction from call
+# sites and the decoding of a captured stream of text and 20-byte events laid
+# out as print_trace_event_type.
+#
+# usage: test_trace.py <trace_tool directory>
+
+import json
+import os
+import struct
+import subprocess
+import sys
+import tempfile
+
+tool_dir = sys.argv[1]
+sys.dont_write_bytecode = True
+sys.path.insert(0, tool_dir)
+from trace_decode import TraceDecoder  # noqa: E402
+
+checks = 0
+fails = 0
+
+
+def check(cond, what):
+    global checks, fails
+    checks += 1
+    if not cond:
+        fails += 1
+        print("check failed: %s" % what)
+
+
+def extract(source):
+    with tempfile.TemporaryDirectory() as tmp:
+        with open(os.path.join(tmp, "app.c"), "w") as f:
+            f.write(source)
+        table = os.path.join(tmp, "table.json")
+        result = subprocess.run([sys.executable, os.path.join(tool_dir, "trace_extract.py"),
+                                 "-o", table, tmp], capture_output=True, text=True)
+        data = None
+        if os.path.exists(table):
+            with open(table) as f:
+                data = json.load(f)
+        return result.returncode, result.stderr, data
+
+
+def event(seq, ident, stamp, argc, args):
+    args = list(args) + [0] * (3 - len(args))
+    return struct.pack("<BBHI3I", 0xA5, (argc << 6) | (seq & 0x3F), ident, stamp & 0xFFFFFFFF, *args)
+
+
+# extraction of well formed call sites, the macro definition is skipped
+code, err, table = extract(r'''
+#define UART_TRACE(id, fmt, argc, arg0, arg1, arg2) uart_trace((id), (argc), (arg0), (arg1), (arg2))
+void f(int a, int b)
+{
+  UART_TRACE(0x0101, "adc block %u, level %d", 2, a, b, 0);
+  /* UART_TRACE(0x0101, "in a comment", 0, 0, 0, 0); */
+  UART_TRACE(7, "state " "%c" " 100%%", 1,
+             'A', 0, 0);
+  UART_TRACE(0x0101, "adc block %u, level %d", 2, a + 1, (b), 0);
+  UART_TRACE(0x0200, "idle", 0, 0, 0, 0);
+}
+''')
+check(code == 0, "extract exit code %d: %s" % (code, err))
+check(table is not None and sorted(table) == ["0x0007", "0x0101", "0x0200"], "extracted ids %s" % table)
+if table:
+    check(table["0x0007"]["format"] == "state %c 100%%", "concatenated format %r" % table["0x0007"]["format"])
+    check(table["0x0101"]["argc"] == 2, "argc of 0x0101")
+
+# one id with two formats, argc off the conversions, %s, a non literal id
+for source, what in (
+        ('UART_TRACE(1, "a %u", 1, x, 0, 0);\nUART_TRACE(1, "b %u", 1, x, 0, 0);', "duplicate id"),
+        ('UART_TRACE(2, "a %u %u", 1, x, y, 0);', "argc mismatch"),
+        ('UART_TRACE(3, "%s", 1, p, 0, 0);', "string argument"),
+        ('UART_TRACE(ID_X, "x", 0, 0, 0, 0);', "symbolic id"),
+        ('UART_TRACE(4, "%u %u %u %u", 4, a, b, c);', "argc above 3")):
+    code, err, table = extract(source)
+    check(code == 1 and table is None and err, "%s not rejected" % what)
+
+# decoding: text around events, a dropped event, a timestamp wrap, an unknown id
+table = {"0x0101": {"format": "adc block %u, level %d", "argc": 2},
+         "0x0007": {"format": "state %c 100%%", "argc": 1}}
+stream = (b"boot\r\n" +
+          event(0, 0x0101, 0xFFFFFF00, 2, (5, 0xFFFFFFFE)) +
+          b"hello " + event(1, 0x0007, 0x00000100, 1, (ord("A"),)) + b"world\r\n" +
+          event(4, 0x0333, 0x00000200, 3, (1, 2, 3)))
+decoder = TraceDecoder(table, clock_hz=0)
+lines = []
+for i in range(0, len(stream), 7):
+    lines += decoder.feed(stream[i:i + 7])
+expect = ["boot",
+          "           0 adc block 5, level -2",
+          "         512 state A 100%",
+          "hello world",
+          "[2 trace event(s) lost]",
+          "         768 id 0x0333 0x00000001 0x00000002 0x00000003"]
+check(lines == expect, "decoded lines\n%s\nexpected\n%s" % ("\n".join(lines), "\n".join(expect)))
+check(decoder.lost == 2, "lost count %d" % decoder.lost)
+
+decoder = TraceDecoder(table, clock_hz=1000.0)
+lines = decoder.feed(event(10, 0x0101, 1000, 2, (1, 2)) + event(11, 0x0101, 3500, 2, (1, 2)))
+check(lines[1].split()[0] == "2.500000", "timestamp in seconds %s" % lines)
+
+print("test_trace: %d checks, %d failed" % (checks, fails))
+sys.exit(1 if fails else 0)
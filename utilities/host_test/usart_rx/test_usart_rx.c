@@ -0,0 +1,383 @@
+/**
+  **************************************************************************
+  * @file     test_usart_rx.c
+  * @brief    host test of the usart dma receiver
+  **************************************************************************
+  *
+  * Copyright (c) 2025, Artery Technology, All rights reserved.
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+/* usage: test_usart_rx
+
+   the usart dma receiver (usart_rx_application.c) replaying byte streams
+   with random gaps, in bit times: the loop mode dma writes every byte to
+   the ring and counts dtcnt down, with its half and full interrupts, the
+   usart raises the idle line a frame after the last byte and the receiver
+   timeout after hrx->timeout bit times. every interrupt is served after a
+   random latency, during which bytes go on arriving. every chunk given to
+   the callback is checked: its place in the ring, its bytes against the
+   stream, and its end at the dma position or the ring end. every burst
+   must be published by its idle interrupt. a reader polls
+   usart_rx_read() with random stalls, every byte it gets must be the byte
+   of the stream at its count, and a byte it misses must be counted in
+   overrun_count. */
+
+#include <stdlib.h>
+#include <string.h>
+#include "usart_rx_application.h"
+#include "host_map.h"
+
+#define STREAM_LEN                       200000
+#define FRAME_BITS                       10
+#define LATENCY_MAX                      25        /* interrupt latency, bit times */
+#define TIME_NONE                        0xFFFFFFFFFFFFFFFFULL
+
+static usart_rx_handle_type hrx;
+static uint8_t ring[256];
+static uint8_t stream[STREAM_LEN];
+
+/* the line and the interrupts, times in bit times */
+static uint64_t now;
+static uint32_t arrived;
+static uint64_t last_time;
+static confirm_state idle_armed;
+static confirm_state rto_armed;
+static uint64_t idle_time;
+static uint64_t rto_time;
+static uint64_t dma_irq_time;
+static uint64_t usart_irq_time;
+static flag_status idle_flag;
+static flag_status rto_flag;
+static confirm_state rto_enabled;
+
+/* what the callback and the reader saw */
+static uint32_t cb_count;
+static uint32_t cb_failed;
+static uint32_t publish_failed;
+static uint32_t burst_failed;
+static uint32_t read_failed;
+static uint32_t lost_silent;
+static uint32_t read_total;
+
+void dma_default_para_init(dma_init_type* dma_init_struct)
+{
+  memset(dma_init_struct, 0, sizeof(*dma_init_struct));
+}
+
+dma_app_status_type dma_channel_alloc(dma_handle_type* hdma, dma_request_type request)
+{
+  if(request != DMA_REQ_USART1_RX)
+  {
+    return DMA_APP_ERR_PARAM;
+  }
+  hdma->request = request;
+  hdma->channel = DMA1_CHANNEL3;
+  hdma->channel_index = 3;
+  return DMA_APP_OK;
+}
+
+void dma_channel_free(dma_handle_type* hdma)
+{
+  hdma->channel = 0;
+}
+
+void dma_desc_build(dma_desc_type* desc, dma_init_type* dma_init_struct)
+{
+  desc->ctrl = (dma_init_struct->loop_mode_enable == TRUE) ? 0x20 : 0;
+  desc->dtcnt = dma_init_struct->buffer_size;
+  desc->paddr = dma_init_struct->peripheral_base_addr;
+  desc->maddr = dma_init_struct->memory_base_addr;
+  desc->next = 0;
+}
+
+dma_app_status_type dma_chain_start(dma_handle_type* hdma, dma_desc_type* desc)
+{
+  hdma->desc = desc;
+  hdma->busy = 1;
+  hdma->channel->dtcnt = desc->dtcnt;
+  return DMA_APP_OK;
+}
+
+void usart_interrupt_enable(usart_type* usart_x, uint32_t usart_int, confirm_state new_state)
+{
+}
+
+void usart_dma_receiver_enable(usart_type* usart_x, confirm_state new_state)
+{
+}
+
+void usart_receiver_timeout_value_set(usart_type* usart_x, uint32_t value)
+{
+}
+
+void usart_receiver_timeout_detection_enable(usart_type* usart_x, confirm_state new_state)
+{
+  rto_enabled = new_state;
+}
+
+flag_status usart_interrupt_flag_get(usart_type* usart_x, uint32_t flag)
+{
+  return (flag == USART_IDLEF_FLAG) ? idle_flag : (flag == USART_RTODF_FLAG) ? rto_flag : RESET;
+}
+
+void usart_flag_clear(usart_type* usart_x, uint32_t flag)
+{
+  if(flag == USART_IDLEF_FLAG)
+  {
+    idle_flag = RESET;
+  }
+  if(flag == USART_RTODF_FLAG)
+  {
+    rto_flag = RESET;
+  }
+}
+
+/**
+  * @brief  the chunk callback: place, bytes and end of every chunk.
+  */
+static void chunk_check(usart_rx_handle_type* h, const uint8_t* pdata, uint16_t length)
+{
+  uint16_t head = h->size - (uint16_t)h->dma.channel->dtcnt;
+  uint32_t end = (uint32_t)(pdata - h->buf) + length;
+
+  cb_failed += (pdata != h->buf + h->pos) || (length == 0) || (end > h->size) ||
+               ((end != h->size) && (end != head)) ||
+               (memcmp(pdata, stream + cb_count, length) != 0);
+  cb_count += length;
+}
+
+/**
+  * @brief  a raised interrupt is served after a random latency, a pending one keeps its time.
+  */
+static void irq_raise(uint64_t* irq_time)
+{
+  if(*irq_time == TIME_NONE)
+  {
+    *irq_time = now + (uint64_t)(rand() % (LATENCY_MAX + 1));
+  }
+}
+
+/**
+  * @brief  a byte ends its stop bit: the dma writes it and counts down.
+  */
+static void byte_arrive(void)
+{
+  dma_channel_type *channel = hrx.dma.channel;
+
+  hrx.buf[hrx.size - channel->dtcnt] = stream[arrived++];
+  channel->dtcnt--;
+  if(channel->dtcnt == hrx.size / 2)
+  {
+    irq_raise(&dma_irq_time);
+  }
+  if(channel->dtcnt == 0)
+  {
+    channel->dtcnt = hrx.size;
+    irq_raise(&dma_irq_time);
+  }
+  last_time = now;
+  idle_armed = TRUE;
+  rto_armed = rto_enabled;
+}
+
+/**
+  * @brief  gap before the next byte, in idle bit times.
+  */
+static uint32_t gap_random(void)
+{
+  uint32_t r = rand() % 100;
+
+  if(r < 70)
+  {
+    return 0;
+  }
+  if(r < 85)
+  {
+    return rand() % FRAME_BITS;
+  }
+  if(r < 95)
+  {
+    return FRAME_BITS + rand() % 40;
+  }
+  return 50 + rand() % 2000;
+}
+
+/**
+  * @brief  replay a stream through the receiver.
+  * @param  size: ring size.
+  * @param  timeout: receiver timeout in bit times, 0 for the idle line only.
+  * @param  callback: TRUE to check the chunks.
+  * @retval overruns counted by the receiver.
+  */
+static uint32_t replay(uint16_t size, uint32_t timeout, confirm_state callback)
+{
+  uint64_t next_byte, next_read, t;
+  uint32_t gap, before, overruns, n, consumed;
+  uint8_t out[96];
+
+  memset(&hrx, 0, sizeof(hrx));
+  hrx.usartx = USART1;
+  hrx.timeout = timeout;
+  hrx.callback = (callback == TRUE) ? chunk_check : 0;
+  rto_enabled = FALSE;
+  if(usart_rx_init(&hrx, ring, size) != USART_RX_OK)
+  {
+    return 0xFFFFFFFF;
+  }
+
+  now = 0;
+  arrived = 0;
+  cb_count = 0;
+  cb_failed = 0;
+  publish_failed = 0;
+  burst_failed = 0;
+  read_failed = 0;
+  lost_silent = 0;
+  idle_armed = FALSE;
+  rto_armed = FALSE;
+  idle_flag = RESET;
+  rto_flag = RESET;
+  dma_irq_time = TIME_NONE;
+  usart_irq_time = TIME_NONE;
+  gap = gap_random();
+  next_byte = FRAME_BITS + gap;
+  next_read = 0;
+
+  while((arrived < STREAM_LEN) || (dma_irq_time != TIME_NONE) || (usart_irq_time != TIME_NONE) ||
+        (idle_armed == TRUE) || (rto_armed == TRUE))
+  {
+    /* the line events of the gap before the next byte */
+    idle_time = ((idle_armed == TRUE) && (gap >= FRAME_BITS)) ? last_time + FRAME_BITS : TIME_NONE;
+    rto_time = ((rto_armed == TRUE) && (gap >= timeout)) ? last_time + timeout : TIME_NONE;
+
+    t = (arrived < STREAM_LEN) ? next_byte : TIME_NONE;
+    t = (idle_time < t) ? idle_time : t;
+    t = (rto_time < t) ? rto_time : t;
+    t = (dma_irq_time < t) ? dma_irq_time : t;
+    t = (usart_irq_time < t) ? usart_irq_time : t;
+    t = ((next_read < t) && (arrived < STREAM_LEN)) ? next_read : t;
+    if(t == TIME_NONE)
+    {
+      /* the line went idle for good, nothing raised */
+      idle_armed = FALSE;
+      rto_armed = FALSE;
+      continue;
+    }
+    now = t;
+
+    if(t == dma_irq_time)
+    {
+      dma_irq_time = TIME_NONE;
+      hrx.dma.full_callback(&hrx.dma, hrx.dma.desc);
+      publish_failed += (hrx.published != arrived);
+    }
+    else if(t == usart_irq_time)
+    {
+      usart_irq_time = TIME_NONE;
+      usart_rx_irq_handler(&hrx);
+      publish_failed += (hrx.published != arrived);
+    }
+    else if(t == idle_time)
+    {
+      idle_armed = FALSE;
+      idle_flag = SET;
+      irq_raise(&usart_irq_time);
+    }
+    else if(t == rto_time)
+    {
+      rto_armed = FALSE;
+      rto_flag = SET;
+      irq_raise(&usart_irq_time);
+    }
+    else if(t == next_read)
+    {
+      /* the main loop reads, now and then it stalls */
+      before = hrx.overrun_count;
+      consumed = hrx.consumed;
+      n = usart_rx_read(&hrx, out, (uint16_t)(1 + rand() % sizeof(out)));
+      read_failed += (memcmp(out, stream + hrx.consumed - n, n) != 0);
+      lost_silent += ((hrx.consumed - n) != consumed) && (hrx.overrun_count == before);
+      read_total += n;
+      next_read = now + (((rand() % 50) == 0) ? (uint64_t)(rand() % (size * FRAME_BITS * 3)) : (uint64_t)(rand() % 200));
+    }
+    else
+    {
+      /* a burst ended by an idle line longer than the latency is published */
+      if((gap >= FRAME_BITS + LATENCY_MAX + 1) && (usart_irq_time == TIME_NONE))
+      {
+        burst_failed += (hrx.published != arrived);
+      }
+      byte_arrive();
+      gap = (arrived < STREAM_LEN) ? gap_random() : 0xFFFFFFFF;
+      next_byte = now + FRAME_BITS + gap;
+    }
+  }
+
+  cb_failed += (callback == TRUE) && (cb_count != STREAM_LEN);
+  publish_failed += (hrx.published != STREAM_LEN);
+  overruns = hrx.overrun_count;
+  usart_rx_deinit(&hrx);
+
+  return overruns;
+}
+
+int main(void)
+{
+  uint32_t i, overruns, irqs;
+
+  host_map_init();
+  srand(5);
+  for(i = 0; i < STREAM_LEN; i++)
+  {
+    stream[i] = (uint8_t)rand();
+  }
+
+  /* parameters */
+  hrx.usartx = USART1;
+  HOST_CHECK(usart_rx_init(&hrx, 0, 64) == USART_RX_ERR_PARAM);
+  HOST_CHECK(usart_rx_init(&hrx, ring, 1) == USART_RX_ERR_PARAM);
+  hrx.usartx = (usart_type *)(USART2_BASE + 0x400);
+  HOST_CHECK(usart_rx_init(&hrx, ring, 64) == USART_RX_ERR_PARAM);
+  hrx.usartx = USART2;
+  HOST_CHECK(usart_rx_init(&hrx, ring, 64) == USART_RX_ERR_BUSY);
+
+  /* idle line only, a ring of 64 */
+  overruns = replay(64, 0, TRUE);
+  irqs = hrx.irq_count;
+  HOST_CHECK((overruns != 0xFFFFFFFF) && (overruns > 10));
+  HOST_CHECK((cb_failed == 0) && (publish_failed == 0) && (burst_failed == 0));
+  HOST_CHECK((read_failed == 0) && (lost_silent == 0));
+
+  /* receiver timeout longer than a frame, an odd ring */
+  overruns = replay(61, 35, TRUE);
+  HOST_CHECK((overruns != 0xFFFFFFFF) && (overruns > 10));
+  HOST_CHECK((cb_failed == 0) && (publish_failed == 0) && (burst_failed == 0));
+  HOST_CHECK((read_failed == 0) && (lost_silent == 0));
+
+  /* no callback, the reader alone on a larger ring */
+  overruns = replay(256, 0, FALSE);
+  HOST_CHECK(overruns != 0xFFFFFFFF);
+  HOST_CHECK((publish_failed == 0) && (burst_failed == 0));
+  HOST_CHECK((read_failed == 0) && (lost_silent == 0));
+
+  printf("%u bytes three times, %u interrupts publishing on the ring of 64, %u bytes read, "
+         "%u overruns on the ring of 256\n", STREAM_LEN, irqs, read_total, overruns);
+
+  return host_report("test_usart_rx");
+}